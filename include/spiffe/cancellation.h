@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace spiffe {
+
+struct CancellationState;
+class CancellationToken;
+
+// Cancels the calls given its tokens. A cancel reaches a waiting call immediately: the call is
+// woken instead of checking the token periodically. With cURL 8.0 or later an idle stream then
+// costs no wakeups, before 8.0 the I/O thread still wakes up once per second while a call is
+// active (see grpc_multiplex_supported).
+class CancellationSource {
+   public:
+    CancellationSource();
+
+    // Thread-safe and idempotent. Runs the registered callbacks on the calling thread.
+    void cancel();
+    bool is_cancelled() const;
+
+    CancellationToken token() const;
+
+   private:
+    std::shared_ptr<CancellationState> state_;
+};
+
+// Observes a CancellationSource, cheap to copy
+class CancellationToken {
+   public:
+    // Never cancelled
+    CancellationToken() = default;
+
+    // Compatibility with std::shared_future<void> tokens, cancelled once the future is ready.
+    // A future cannot notify, so calls check it about once per second.
+    CancellationToken(std::shared_future<void> future) : future_(std::move(future)) {}
+
+    bool is_cancelled() const;
+
+    // Whether the token can be cancelled at all, false for default constructed tokens
+    bool can_cancel() const { return state_ != nullptr || future_.valid(); }
+
+    // Whether cancellation is notified through callbacks, false for std::shared_future tokens
+    bool can_notify() const { return state_ != nullptr; }
+
+    // Runs callback once when the source is cancelled, right away if it already is. Returns 0
+    // without registering if the token cannot notify.
+    //
+    // callback runs under the source's lock and must be short, e.g. set a flag and wake a loop.
+    // After unsubscribe() returns it is guaranteed not to be running.
+    uint64_t subscribe(std::function<void()> callback) const;
+    void unsubscribe(uint64_t id) const;
+
+   private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<CancellationState> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<CancellationState> state_;
+    std::shared_future<void> future_;
+};
+
+}  // namespace spiffe
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <spiffe/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace spiffe {
+
+// Offsets of the tables inside the arena of a compact context
+struct CompactLayout {
+    size_t size = 0;
+
+    size_t svids = 0;
+    size_t svid_count = 0;
+
+    size_t crls = 0;
+    size_t crl_count = 0;
+
+    size_t bundles = 0;
+    size_t bundle_count = 0;
+
+    // Every bundle certificate, back to back in the order of the bundle table
+    size_t bundle_der = 0;
+    size_t bundle_der_size = 0;
+    size_t bundle_certificate_count = 0;
+};
+
+// One X.509 SVID of a CompactX509SvidContext, the views point into its arena
+struct CompactX509Svid {
+    BufferView spiffe_id;
+    CertificateRange x509_svid;
+    BufferView x509_svid_key;
+    CertificateRange bundle;
+    BufferView hint;
+};
+
+// Trust domain bundles of a compact context, sorted by trust domain name.
+// Non-owning, valid while the context it came from lives.
+class CompactBundles {
+   public:
+    CompactBundles(const uint8_t* arena, const CompactLayout& layout) : arena_(arena), layout_(&layout) {}
+
+    size_t size() const { return layout_->bundle_count; }
+    bool empty() const { return layout_->bundle_count == 0; }
+
+    BufferView trust_domain(size_t i) const;
+    CertificateRange bundle(size_t i) const;
+
+    // Binary search by trust domain name, false if the trust domain is not present
+    bool find(const TrustDomain& trust_domain, CertificateRange& out) const;
+
+    // Certificates of all bundles in one linear walk over the arena
+    CertificateRange all_certificates() const;
+
+   private:
+    const uint8_t* arena_;
+    const CompactLayout* layout_;
+};
+
+// Frees the arena of a compact context, or releases its owner when the arena lives in memory the
+// context does not own, e.g. a shared memory mapping
+struct CompactArenaDeleter {
+    std::shared_ptr<const void> owner;
+
+    void operator()(const uint8_t* arena) const {
+        if (!owner) {
+            delete[] arena;
+        }
+    }
+};
+
+// Storage shared by the compact contexts: all certificates, keys, CRLs and names of one update
+// live in a single heap allocation, addressed through fixed size offset tables at its front.
+// Dropping the update is a single free, copying it is a single allocation and memcpy.
+class CompactContext {
+   public:
+    CompactContext() = default;
+    CompactContext(const CompactContext& other);
+    CompactContext(CompactContext&& other) noexcept;
+    CompactContext& operator=(const CompactContext& other);
+    CompactContext& operator=(CompactContext&& other) noexcept;
+
+    size_t crl_count() const { return layout_.crl_count; }
+    BufferView crl(size_t i) const;
+
+    // Bytes held by the arena
+    size_t arena_size() const { return layout_.size; }
+
+   protected:
+    friend class CompactContextBuilder;
+    friend class SharedSnapshotPublisher;
+    friend class SharedSnapshotReader;
+
+    std::unique_ptr<const uint8_t[], CompactArenaDeleter> arena_;
+    CompactLayout layout_;
+
+    CompactBundles bundle_table() const { return CompactBundles(arena_.get(), layout_); }
+
+    // Whether every table and span of layout lies within its layout.size bytes of arena, for an
+    // arena written by another process
+    static bool within_arena(const uint8_t* arena, const CompactLayout& layout);
+};
+
+// Compact alternative to X509SvidContext
+class CompactX509SvidContext : public CompactContext {
+   public:
+    size_t svid_count() const { return layout_.svid_count; }
+    CompactX509Svid svid(size_t i) const;
+
+    CompactBundles federated_bundles() const { return bundle_table(); }
+};
+
+// Compact alternative to X509BundlesContext
+class CompactX509BundlesContext : public CompactContext {
+   public:
+    CompactBundles bundles() const { return bundle_table(); }
+};
+
+}  // namespace spiffe
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <spiffe/types.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace spiffe {
+
+// SVIDs are matched across updates by SPIFFE ID and hint
+struct SvidKey {
+    std::string spiffe_id;
+    std::string hint;
+};
+
+inline bool operator==(const SvidKey& a, const SvidKey& b) { return a.spiffe_id == b.spiffe_id && a.hint == b.hint; }
+inline bool operator!=(const SvidKey& a, const SvidKey& b) { return !(a == b); }
+
+// Trust domains whose bundle differs from the previous update
+struct TrustDomainDelta {
+    std::vector<TrustDomain> added;
+    std::vector<TrustDomain> removed;
+    std::vector<TrustDomain> changed;
+
+    bool empty() const { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+// What an update of a watched stream changed, compared byte for byte with the previous one.
+// The first update of a stream reports everything as added.
+//
+// generation starts at 1 and increases by one with every delivered update. Updates identical to
+// the previous one are not delivered.
+struct X509SvidDelta {
+    uint64_t generation = 0;
+
+    std::vector<SvidKey> added;
+    std::vector<SvidKey> removed;
+    std::vector<SvidKey> changed;  // same key, new certificates, key or bundle
+
+    // SVIDs that were kept now come in another order, e.g. another one is the default (first)
+    bool reordered = false;
+
+    TrustDomainDelta federated_bundles;
+    bool crl_changed = false;
+
+    bool empty() const {
+        return added.empty() && removed.empty() && changed.empty() && !reordered && federated_bundles.empty() &&
+               !crl_changed;
+    }
+};
+
+struct X509BundlesDelta {
+    uint64_t generation = 0;
+
+    TrustDomainDelta bundles;
+    bool crl_changed = false;
+
+    bool empty() const { return bundles.empty() && !crl_changed; }
+};
+
+struct JwtBundlesDelta {
+    uint64_t generation = 0;
+
+    TrustDomainDelta bundles;
+
+    bool empty() const { return bundles.empty(); }
+};
+
+}  // namespace spiffe
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <spiffe/status.h>
+#include <spiffe/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spiffe {
+
+// Non-blocking Workload API client for hosts with their own event loop (epoll, libuv, ...).
+//
+// It owns no thread and never blocks. The host watches the file descriptors the client asks
+// for, waits no longer than timeout_ms(), and reports readiness through on_readable(),
+// on_writable() and on_timeout(). All callbacks run inside those calls, on the host's thread.
+//
+// Not thread-safe, use it from the host loop only. Callbacks may start and cancel calls.
+class WorkloadApiEventClient {
+   public:
+    // Bits of the events reported for a file descriptor
+    static const int EVENT_READ = 1;
+    static const int EVENT_WRITE = 2;
+
+    // Identifies a started call, 0 is never a valid call
+    using CallId = uint64_t;
+
+    WorkloadApiEventClient(const std::string& socket_path);
+    ~WorkloadApiEventClient();
+
+    // Disallow copy
+    WorkloadApiEventClient(const WorkloadApiEventClient&) = delete;
+    WorkloadApiEventClient& operator=(const WorkloadApiEventClient&) = delete;
+
+    // Allow move
+    WorkloadApiEventClient(WorkloadApiEventClient&&);
+    WorkloadApiEventClient& operator=(WorkloadApiEventClient&&);
+
+    // Called whenever the client starts, changes or stops (events == 0) watching fd, e.g. to
+    // epoll_ctl it. Must not call back into the client.
+    void set_fd_callback(std::function<void(int fd, int events)> callback);
+
+    // Currently watched file descriptors and their events, for poll-style loops
+    std::vector<std::pair<int, int>> fds() const;
+
+    // Milliseconds until on_timeout() is due, 0 if it is due now, -1 if nothing is scheduled
+    long timeout_ms() const;
+
+    void on_readable(int fd);
+    void on_writable(int fd);
+    void on_timeout();
+
+    // Streaming calls. callback runs for every update until it returns an error, the stream
+    // fails or it is cancelled; on_done then runs once with the final status.
+    // Return 0 if the call could not be created.
+    CallId fetch_x509_svid(                                      //
+        std::function<Status(const X509SvidContext&)> callback,  //
+        std::function<void(const Status&)> on_done              //
+    );
+    CallId fetch_x509_bundles(                                      //
+        std::function<Status(const X509BundlesContext&)> callback,  //
+        std::function<void(const Status&)> on_done                 //
+    );
+    CallId fetch_jwt_bundles(                               //
+        std::function<Status(const JwtBundles&)> callback,  //
+        std::function<void(const Status&)> on_done         //
+    );
+
+    // Unary call, on_done runs once with the status and the SVIDs
+    CallId fetch_jwt_svid(                                                              //
+        const std::vector<std::string>& audience,                                       //
+        const std::string& spiffe_id,                                                   //
+        std::function<void(const Status&, const std::vector<JwtSvid>&)> on_done,        //
+        const std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)       //
+    );
+
+    // on_done of the call runs with code 1, no-op for calls that already finished
+    void cancel(CallId id);
+
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace spiffe
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <spiffe/spiffe_id.h>
+#include <spiffe/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace spiffe {
+
+struct JwtKey;
+
+// Keys of one trust domain's JWT bundle, the JWKS document of JwtBundles::bundles, parsed once
+// and indexed by key ID ("kid"), so that validating a JWT-SVID costs a hash lookup instead of a
+// JWKS parse.
+//
+// Kept are RSA and EC (P-256, P-384, P-521) keys with a "kid" whose "use", if any, is
+// "jwt-svid". Immutable once built and safe to share between threads.
+class JwtKeySet {
+   public:
+    explicit JwtKeySet(std::string jwks);
+
+    const std::string& jwks() const { return jwks_; }
+
+    // Whether jwks parsed as a JWKS document, an invalid one has no keys
+    bool valid() const { return valid_; }
+
+    // Unique to this key set within the process, so a result derived from it can tell whether
+    // the keys it was checked against are still the current ones
+    uint64_t id() const { return id_; }
+
+    size_t size() const { return keys_.size(); }
+
+    // nullptr if not found. Duplicate key IDs resolve to the first usable key.
+    const JwtKey* find(const std::string& key_id) const;
+
+   private:
+    std::string jwks_;
+    uint64_t id_;
+    bool valid_ = false;
+    std::unordered_map<std::string, std::shared_ptr<const JwtKey>> keys_;
+};
+
+// JwtKeySet of every trust domain of a JwtBundles update, keyed like JwtBundles::bundles
+// ("spiffe://example.org").
+//
+// Built from the previous set on every update: key sets of trust domains whose JWKS did not
+// change are shared with it instead of being parsed again.
+class JwtBundleIndexSet {
+   public:
+    JwtBundleIndexSet() = default;
+    explicit JwtBundleIndexSet(const JwtBundles& bundles, const JwtBundleIndexSet* previous = nullptr);
+
+    // nullptr if the trust domain has no bundle
+    const JwtKeySet* get(const TrustDomain& trust_domain) const;
+
+    // Same by interned trust domain, without hashing a string, see X509BundleIndexSet
+    const JwtKeySet* get(InternedTrustDomain trust_domain) const;
+
+    size_t size() const { return key_sets_.size(); }
+
+   private:
+    std::unordered_map<TrustDomain, std::shared_ptr<const JwtKeySet>> key_sets_;
+    std::unordered_map<InternedTrustDomain, const JwtKeySet*, InternedTrustDomainHash> by_interned_;
+};
+
+}  // namespace spiffe
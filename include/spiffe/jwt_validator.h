@@ -0,0 +1,90 @@
+#pragma once
+
+#include <spiffe/jwt_bundle_index.h>
+#include <spiffe/status.h>
+#include <spiffe/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spiffe {
+
+// Claims of a validated JWT-SVID
+struct JwtSvidClaims {
+    std::string spiffe_id;  // "sub"
+    std::vector<std::string> audience;
+    int64_t expiry = 0;  // "exp", seconds since the Unix epoch
+};
+
+// Validates a JWT-SVID locally, in place of the Workload API's ValidateJWTSVID: the token must
+// be signed (RS*, PS* or ES*) by the key its "kid" names in the bundle of the trust domain of
+// its "sub", a SPIFFE ID, must not have expired at now, and its "aud" must contain audience.
+//
+// UNAUTHENTICATED if the token does not validate, INVALID_ARGUMENT if it does not parse.
+Status validate_jwt_svid(const std::string& token, const std::string& audience, const JwtBundleIndexSet& bundles,
+                         JwtSvidClaims& claims,
+                         std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+struct JwtSvidValidatorOptions {
+    // Upper bound on cached tokens, split evenly between shards
+    size_t max_entries = 4096;
+    size_t shards = 16;
+};
+
+// validate_jwt_svid against the bundles of a fetch_jwt_bundles stream, with a cache of the
+// tokens whose signature verified, so that a token seen again only costs a hash lookup and the
+// "exp" and "aud" checks.
+//
+// A cached token only holds while the key set of its trust domain is the one it was verified
+// against (JwtKeySet::id()), which update() keeps for trust domains whose JWKS did not change.
+// Failures are not cached. Thread-safe, tokens are spread over independently locked shards.
+class JwtSvidValidator {
+   public:
+    using Clock = std::chrono::system_clock;
+
+    explicit JwtSvidValidator(const JwtSvidValidatorOptions& options = JwtSvidValidatorOptions());
+    ~JwtSvidValidator();
+
+    // Disallow copy
+    JwtSvidValidator(const JwtSvidValidator&) = delete;
+    JwtSvidValidator& operator=(const JwtSvidValidator&) = delete;
+
+    // Replaces the bundles, e.g. from the fetch_jwt_bundles callback. Only trust domains whose
+    // JWKS changed are parsed.
+    void update(const JwtBundles& bundles);
+
+    // Current bundles, empty before the first update
+    std::shared_ptr<const JwtBundleIndexSet> bundles() const;
+
+    // Against the bundles of the last update
+    Status validate(const std::string& token, const std::string& audience, JwtSvidClaims& claims,
+                    Clock::time_point now = Clock::now());
+
+    // Against bundles managed by the caller
+    Status validate(const std::string& token, const std::string& audience, const JwtBundleIndexSet& bundles,
+                    JwtSvidClaims& claims, Clock::time_point now = Clock::now());
+
+    // Cached tokens, including ones that no longer hold
+    size_t size() const;
+
+   private:
+    struct Entry {
+        JwtSvidClaims claims;
+        InternedTrustDomain trust_domain;
+        uint64_t key_set_id;
+    };
+
+    class Cache;
+    std::unique_ptr<Cache> cache_;
+
+    mutable std::mutex bundles_mutex_;
+    std::shared_ptr<const JwtBundleIndexSet> bundles_;
+
+    static bool holds(const Entry& entry, const JwtBundleIndexSet& bundles, int64_t now);
+};
+
+}  // namespace spiffe
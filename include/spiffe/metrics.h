@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace spiffe {
+
+// Workload API methods, metrics are kept per method
+enum class RpcMethod {
+    X509Svid,     // FetchX509SVID
+    X509Bundles,  // FetchX509Bundles
+    JwtBundles,   // FetchJWTBundles
+    JwtSvid,      // FetchJWTSVID
+};
+
+const size_t RPC_METHOD_COUNT = 4;
+
+// gRPC method name, e.g. "FetchX509SVID"
+const char* rpc_method_name(RpcMethod method);
+
+// Receives measurements from WorkloadApiClient, see ClientOptions::metrics. Every method
+// defaults to doing nothing, override the ones of interest.
+//
+// Called concurrently from calling threads and the client's I/O thread, on the hot path of
+// every response. Implementations must be thread-safe and must not block.
+class Metrics {
+   public:
+    virtual ~Metrics() = default;
+
+    // A call finished with a gRPC status code. latency is the round trip of unary calls and the
+    // lifetime of streams.
+    virtual void on_rpc_done(RpcMethod, int /* status_code */, std::chrono::nanoseconds /* latency */) {}
+
+    // First update of a stream handed to its callback, since the call started
+    virtual void on_first_update(RpcMethod, std::chrono::nanoseconds) {}
+
+    // Response body bytes, as received from cURL
+    virtual void on_bytes_received(RpcMethod, size_t) {}
+
+    // A gRPC message was received. reassembled if it spanned several chunks and had to be
+    // copied together.
+    virtual void on_message(RpcMethod, size_t /* size */, bool /* reassembled */) {}
+
+    // A message was decoded. proto is the protobuf parsing, der is building the context from it,
+    // which for X.509 methods is splitting the DER certificate lists.
+    virtual void on_decode(RpcMethod, std::chrono::nanoseconds /* proto */, std::chrono::nanoseconds /* der */) {}
+
+    // Time spent in the user's stream callback for one update
+    virtual void on_callback(RpcMethod, std::chrono::nanoseconds) {}
+
+    // A stream was started again after the previous stream of the same method on this client
+    // failed
+    virtual void on_stream_restart(RpcMethod) {}
+};
+
+// Latency distribution with buckets 4 per power of two wide, i.e. values are known to within 25%
+struct HistogramSnapshot {
+    static const size_t BUCKETS = 168;  // up to 2^42 ns, about 73 minutes
+
+    uint64_t count = 0;
+    std::chrono::nanoseconds sum{0};
+    std::chrono::nanoseconds max{0};
+    std::array<uint64_t, BUCKETS> buckets{};
+
+    // Upper bound of the bucket holding the q quantile (0 to 1), 0 if empty
+    std::chrono::nanoseconds percentile(double q) const;
+
+    static size_t bucket_of(uint64_t ns);
+    static uint64_t bucket_upper_bound(size_t bucket);
+};
+
+struct RpcMetricsSnapshot {
+    HistogramSnapshot latency;
+    HistogramSnapshot first_update;
+    HistogramSnapshot proto_decode;
+    HistogramSnapshot der_split;
+    HistogramSnapshot callback;
+
+    uint64_t bytes_received = 0;
+    uint64_t messages = 0;
+    uint64_t messages_reassembled = 0;
+    uint64_t stream_restarts = 0;
+
+    // Indexed by gRPC status code, codes outside 0 to 16 are counted as UNKNOWN (2)
+    std::array<uint64_t, 17> status_codes{};
+};
+
+struct MetricsSnapshot {
+    std::array<RpcMetricsSnapshot, RPC_METHOD_COUNT> methods;
+
+    const RpcMetricsSnapshot& operator[](RpcMethod method) const { return methods[static_cast<size_t>(method)]; }
+};
+
+// Built-in Metrics, recording into atomic counters and histograms. Recording is lock-free and
+// wait-free except for the maximum, snapshot() can be taken at any time from any thread.
+// Counters of one snapshot are read one by one, not at a single instant.
+class AtomicMetrics : public Metrics {
+   public:
+    AtomicMetrics() = default;
+
+    // Disallow copy
+    AtomicMetrics(const AtomicMetrics&) = delete;
+    AtomicMetrics& operator=(const AtomicMetrics&) = delete;
+
+    void on_rpc_done(RpcMethod method, int status_code, std::chrono::nanoseconds latency) override;
+    void on_first_update(RpcMethod method, std::chrono::nanoseconds latency) override;
+    void on_bytes_received(RpcMethod method, size_t bytes) override;
+    void on_message(RpcMethod method, size_t size, bool reassembled) override;
+    void on_decode(RpcMethod method, std::chrono::nanoseconds proto, std::chrono::nanoseconds der) override;
+    void on_callback(RpcMethod method, std::chrono::nanoseconds elapsed) override;
+    void on_stream_restart(RpcMethod method) override;
+
+    MetricsSnapshot snapshot() const;
+
+   private:
+    struct Histogram {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+        std::array<std::atomic<uint64_t>, HistogramSnapshot::BUCKETS> buckets{};
+
+        void record(std::chrono::nanoseconds value);
+        HistogramSnapshot snapshot() const;
+    };
+
+    struct RpcMetrics {
+        Histogram latency;
+        Histogram first_update;
+        Histogram proto_decode;
+        Histogram der_split;
+        Histogram callback;
+
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> messages_reassembled{0};
+        std::atomic<uint64_t> stream_restarts{0};
+        std::array<std::atomic<uint64_t>, 17> status_codes{};
+    };
+
+    std::array<RpcMetrics, RPC_METHOD_COUNT> methods_;
+
+    RpcMetrics& of(RpcMethod method) { return methods_[static_cast<size_t>(method)]; }
+};
+
+}  // namespace spiffe
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <spiffe/cancellation.h>
+#include <spiffe/compact_context.h>
+#include <spiffe/spiffe.h>
+#include <spiffe/status.h>
+#include <spiffe/types.h>
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace spiffe {
+
+struct SharedSnapshotOptions {
+    // Directory of the region's files, on a tmpfs so that key material never reaches a disk.
+    // Empty for /dev/shm/spiffe-<uid>, uid the effective user id. The publisher creates it if
+    // needed, searchable by those the mode lets read. It must not be writable by group or others,
+    // nor may the files: anyone who could replace them could hand readers their own SVIDs.
+    std::string directory;
+
+    // The region is <directory>/<name>, each update <directory>/<name>.<rpc>.<generation>
+    std::string name = "spiffe";
+
+    // Permissions of the files, the owner only by default: they hold the SVIDs' private keys.
+    // Readers in other processes must run as the owner, or as its group with 0640.
+    unsigned mode = 0600;
+
+    // User the directory and the files must belong to for a reader to trust them, (uid_t)-1 for
+    // the reader's effective user. Set to the publisher's when reading as another user.
+    uid_t owner = static_cast<uid_t>(-1);
+
+    // How often a reader checks that the region file is still the one it mapped, e.g. after the
+    // directory was cleared and a new publisher created another one
+    std::chrono::milliseconds region_check_interval = std::chrono::seconds(1);
+};
+
+struct SharedSnapshotRegion;
+
+// JWT bundles of a shared snapshot, sorted by trust domain ("spiffe://example.org"). The
+// strings are views into the mapping, valid while the SharedJwtBundles lives.
+class SharedJwtBundles {
+   public:
+    SharedJwtBundles(std::shared_ptr<const void> mapping, const uint8_t* arena, size_t count)
+        : mapping_(std::move(mapping)), arena_(arena), count_(count) {}
+
+    size_t size() const { return count_; }
+    StringView trust_domain(size_t i) const;
+    StringView jwks(size_t i) const;
+
+    // Binary search by trust domain, false if it is not present
+    bool find(StringView trust_domain, StringView& jwks) const;
+
+    // Copy, e.g. for JwtSvidValidator::update
+    JwtBundles to_jwt_bundles() const;
+
+   private:
+    std::shared_ptr<const void> mapping_;
+    const uint8_t* arena_;
+    size_t count_;
+};
+
+// Publisher side of a snapshot shared between the processes of a host, e.g. the workers of a
+// prefork server: one process keeps the Workload API streams and writes every update to shared
+// memory, where any number of SharedSnapshotReader map it, instead of each worker opening its
+// own streams and decoding the same updates.
+//
+// Every update is written once, in the layout of the compact contexts, to a file of its own
+// that is never modified afterwards. The region holds one generation counter per RPC that
+// points readers at the current file. The file of the previous generation is unlinked, readers
+// that mapped it keep it until they move on.
+//
+// A region has at most one publisher at a time. Files outlive the publisher, so readers keep
+// the last snapshot across publisher restarts, and a new publisher continues the generations.
+class SharedSnapshotPublisher {
+   public:
+    SharedSnapshotPublisher(const std::string& socket_path, const SharedSnapshotOptions& options = SharedSnapshotOptions(),
+                            const ClientOptions& client_options = ClientOptions());
+    ~SharedSnapshotPublisher();
+
+    // Disallow copy
+    SharedSnapshotPublisher(const SharedSnapshotPublisher&) = delete;
+    SharedSnapshotPublisher& operator=(const SharedSnapshotPublisher&) = delete;
+
+    // Creates or takes over the region, and removes the files of updates a previous publisher
+    // left behind but the current ones. FAILED_PRECONDITION if another publisher holds it, or if
+    // the directory belongs to another user or is writable by group or others.
+    Status open();
+
+    // Opens the region and starts the FetchX509SVID, FetchX509Bundles and FetchJWTBundles
+    // streams on background threads. They reconnect after agent restarts
+    // (ClientOptions::stream_retry is enabled if it is not), a failure to write ends a stream.
+    Status start();
+
+    // Stops the streams. Published snapshots stay readable.
+    void close();
+
+    // Writes an update to the region, what the streams do. Also for updates received otherwise.
+    Status publish(const CompactX509SvidContext& context);
+    Status publish(const CompactX509BundlesContext& context);
+    Status publish(const JwtBundles& bundles);
+
+   private:
+    SharedSnapshotOptions options_;
+    WorkloadApiClient client_;
+
+    std::mutex mutex_;  // serializes publishing
+    std::unique_ptr<SharedSnapshotRegion> region_;
+
+    CancellationSource cancellation_;
+    std::thread x509_svid_thread_;
+    std::thread x509_bundles_thread_;
+    std::thread jwt_bundles_thread_;
+
+    // Publishes arena as the next generation of rpc. jwt_count only applies to JWT bundles.
+    Status write(uint32_t rpc, const CompactLayout& layout, size_t jwt_count, const uint8_t* arena, size_t arena_size);
+};
+
+// Reader side of a SharedSnapshotPublisher's region, mapped read-only. Getting the current
+// snapshot loads one atomic from the mapping and, unless a new update was published since the
+// previous call, makes no system call and copies nothing. Otherwise it maps the new update.
+//
+// Before the publisher created the region, every call tries to open it. Once mapped, the file at
+// its path is compared with the mapped one every SharedSnapshotOptions::region_check_interval,
+// a replaced region is mapped again. Files of another owner
+// than SharedSnapshotOptions::owner, writable by group or others, or with offsets outside their
+// arena are ignored. A reader must not be shared between threads, e.g. keep one per worker or in
+// a thread_local.
+class SharedSnapshotReader {
+   public:
+    explicit SharedSnapshotReader(const SharedSnapshotOptions& options = SharedSnapshotOptions());
+    ~SharedSnapshotReader();
+
+    // Disallow copy
+    SharedSnapshotReader(const SharedSnapshotReader&) = delete;
+    SharedSnapshotReader& operator=(const SharedSnapshotReader&) = delete;
+
+    // Current update of each stream, nullptr before the first one. The pointer stays valid
+    // until the next call to the same method on this reader.
+    const CompactX509SvidContext* x509_svid();
+    const CompactX509BundlesContext* x509_bundles();
+    const SharedJwtBundles* jwt_bundles();
+
+    // Generation of the update returned last by each method, 0 for none
+    uint64_t x509_svid_generation() const { return x509_svid_.generation; }
+    uint64_t x509_bundles_generation() const { return x509_bundles_.generation; }
+    uint64_t jwt_bundles_generation() const { return jwt_bundles_.generation; }
+
+   private:
+    template <typename Snapshot>
+    struct Cached {
+        uint64_t generation = 0;
+        uint64_t region = 0;  // region_id_ the generation belongs to
+        std::unique_ptr<Snapshot> snapshot;
+    };
+
+    SharedSnapshotOptions options_;
+    std::shared_ptr<const void> region_;
+
+    // Identity of the mapped region file, and when it was last compared with the path. A new
+    // region restarts the generations, region_id_ tells them apart.
+    dev_t region_device_ = 0;
+    ino_t region_inode_ = 0;
+    std::chrono::steady_clock::time_point region_checked_;
+    uint64_t region_id_ = 0;
+
+    Cached<CompactX509SvidContext> x509_svid_;
+    Cached<CompactX509BundlesContext> x509_bundles_;
+    Cached<SharedJwtBundles> jwt_bundles_;
+
+    // Generation currently published for rpc, 0 if none or the region is not there yet
+    uint64_t published(uint32_t rpc);
+
+    // Maps the file of a generation, its header checked. nullptr if it is gone.
+    std::shared_ptr<const void> map(uint32_t rpc, uint64_t generation, const uint8_t*& arena, CompactLayout& layout,
+                                    size_t& jwt_count);
+
+    template <typename Snapshot, typename Make>
+    const Snapshot* get(uint32_t rpc, Cached<Snapshot>& cached, Make make);
+};
+
+}  // namespace spiffe
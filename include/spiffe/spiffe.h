@@ -1,8 +1,13 @@
 #pragma once
 
+#include <spiffe/cancellation.h>
+#include <spiffe/compact_context.h>
+#include <spiffe/delta.h>
+#include <spiffe/metrics.h>
 #include <spiffe/status.h>
 #include <spiffe/types.h>
 
+#include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
@@ -11,9 +16,72 @@
 
 namespace spiffe {
 
+// Opt-in cache for fetch_jwt_svid, see ClientOptions
+struct JwtSvidCacheOptions {
+    bool enabled = false;
+
+    // Cached tokens are served until this fraction of their remaining lifetime at fetch time has
+    // passed, in (0, 1]
+    double refresh_fraction = 0.5;
+
+    // Number of independently locked shards
+    size_t shards = 16;
+
+    // Upper bound on cached (audience, spiffe_id) keys across all shards
+    size_t max_entries = 4096;
+};
+
+// One token request of WorkloadApiClient::fetch_jwt_svids
+struct JwtSvidRequest {
+    std::vector<std::string> audience;
+    std::string spiffe_id;  // empty for the default identity
+};
+
+struct JwtSvidResult {
+    Status status;
+    std::vector<JwtSvid> svids;
+};
+
+// Opt-in reconnection of streaming calls, see ClientOptions
+struct StreamRetryOptions {
+    bool enabled = false;
+
+    // Delay before the first reconnect, multiplied after every failed attempt up to max_backoff.
+    // Each delay is randomly shortened by up to jitter (0 to 1) of itself.
+    std::chrono::milliseconds initial_backoff = std::chrono::milliseconds(200);
+    std::chrono::milliseconds max_backoff = std::chrono::seconds(30);
+    double multiplier = 2.0;
+    double jitter = 0.5;
+
+    // Consecutive reconnects without an update before the stream gives up and returns the last
+    // error, 0 for no limit. An update resets the count and the delay, also one that is not
+    // delivered because it is identical to the last one.
+    size_t max_attempts = 0;
+};
+
+struct ClientOptions {
+    JwtSvidCacheOptions jwt_svid_cache;
+
+    // With stream_retry enabled, streaming calls survive agent restarts: a stream that fails
+    // (other than by cancellation, INVALID_ARGUMENT or an error from the callback) is opened
+    // again after a jittered, exponentially growing delay. The callback is not called in the
+    // meantime, so the last context it received stays current, and the first update after a
+    // reconnect is not delivered if it is identical to the last one.
+    StreamRetryOptions stream_retry;
+
+    // Receives per-method latencies, sizes and status codes, e.g. an AtomicMetrics. nullptr
+    // (the default) skips all measurements, the clock is not even read.
+    std::shared_ptr<Metrics> metrics;
+
+    // Largest response message accepted, gRPC's default maximum receive message size unless
+    // set. Raise it for agents that push larger federated bundles, a larger message fails the
+    // call with INTERNAL.
+    size_t max_message_size = 4 * 1024 * 1024;
+};
+
 class WorkloadApiClient {
    public:
-    WorkloadApiClient(const std::string& socket_path);
+    WorkloadApiClient(const std::string& socket_path, const ClientOptions& options = ClientOptions());
     ~WorkloadApiClient();
 
     // Disallow copy
@@ -27,18 +95,45 @@ class WorkloadApiClient {
     // Streaming calls, only returns when cancelled or error occurs
     Status fetch_x509_svid(                                      //
         std::function<Status(const X509SvidContext&)> callback,  //
-        std::shared_future<void> cancellation_token              //
+        CancellationToken cancellation_token                     //
     );
     Status fetch_x509_bundles(                                      //
         std::function<Status(const X509BundlesContext&)> callback,  //
-        std::shared_future<void> cancellation_token                 //
+        CancellationToken cancellation_token                        //
     );
+    // Same as above, each update delivered as a single arena allocation
+    Status fetch_x509_svid_compact(                                     //
+        std::function<Status(const CompactX509SvidContext&)> callback,  //
+        CancellationToken cancellation_token                            //
+    );
+    Status fetch_x509_bundles_compact(                                     //
+        std::function<Status(const CompactX509BundlesContext&)> callback,  //
+        CancellationToken cancellation_token                               //
+    );
+
     Status fetch_jwt_bundles(                               //
         std::function<Status(const JwtBundles&)> callback,  //
-        std::shared_future<void> cancellation_token         //
+        CancellationToken cancellation_token                //
+    );
+
+    // Same streams, kept up to date in place across updates. An update only decodes the SVIDs and
+    // trust domains whose bytes changed, and the callback receives what changed along with the
+    // full context. Updates identical to the previous one are not delivered.
+    Status watch_x509_svid(                                                           //
+        std::function<Status(const X509SvidContext&, const X509SvidDelta&)> callback,  //
+        CancellationToken cancellation_token                                           //
+    );
+    Status watch_x509_bundles(                                                              //
+        std::function<Status(const X509BundlesContext&, const X509BundlesDelta&)> callback,  //
+        CancellationToken cancellation_token                                                 //
+    );
+    Status watch_jwt_bundles(                                                     //
+        std::function<Status(const JwtBundles&, const JwtBundlesDelta&)> callback,  //
+        CancellationToken cancellation_token                                        //
     );
 
     // Unary calls
+    // With ClientOptions::jwt_svid_cache enabled, tokens are served from the cache while fresh
     Status fetch_jwt_svid(                                                         //
         std::vector<JwtSvid>& out,                                                 //
         const std::vector<std::string>& audience,                                  //
@@ -46,6 +141,16 @@ class WorkloadApiClient {
         const std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)  //
     );
 
+    // Many fetch_jwt_svid calls at once, e.g. to warm up tokens for all audiences at startup.
+    // Requests go out as concurrent streams on the shared connection, so the batch costs about
+    // one round trip, and timeout bounds the whole batch. results gets one entry per request, in
+    // order. Returns the first failed status among them, OK if all succeeded.
+    Status fetch_jwt_svids(                                                        //
+        const std::vector<JwtSvidRequest>& requests,                               //
+        std::vector<JwtSvidResult>& results,                                       //
+        const std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)  //
+    );
+
    private:
     class Impl;
     std::unique_ptr<Impl> impl_;
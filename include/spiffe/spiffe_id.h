@@ -0,0 +1,93 @@
+#pragma once
+
+#include <spiffe/types.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace spiffe {
+
+// Trust domain interned in a process-wide table: there is one instance per distinct name, so
+// copies, equality and hashing are pointer operations and maps keyed by it never hash strings.
+//
+// Interned names are never freed. Only intern names that come from a trusted source, e.g. the
+// bundle keys sent by the agent. Names read off peers are looked up with find(), which does not
+// grow the table.
+class InternedTrustDomain {
+   public:
+    // The null trust domain, equal only to itself
+    InternedTrustDomain() : entry_(nullptr) {}
+
+    // Interns a valid trust domain name ("example.org"), null if name is not one
+    static InternedTrustDomain intern(StringView name);
+
+    // Already interned trust domain, null if name was never interned. Does not allocate.
+    static InternedTrustDomain find(StringView name);
+
+    bool is_null() const { return entry_ == nullptr; }
+
+    // "example.org", and "spiffe://example.org", the TrustDomain form bundle maps are keyed by
+    StringView name() const { return entry_ ? StringView(entry_->name) : StringView(); }
+    StringView id() const { return entry_ ? StringView(entry_->id) : StringView(); }
+
+    bool operator==(const InternedTrustDomain& other) const { return entry_ == other.entry_; }
+    bool operator!=(const InternedTrustDomain& other) const { return entry_ != other.entry_; }
+
+   private:
+    friend struct InternedTrustDomainHash;
+
+    struct Entry {
+        std::string name;
+        std::string id;
+    };
+
+    struct Table;
+    static Table& table();
+
+    explicit InternedTrustDomain(const Entry* entry) : entry_(entry) {}
+
+    const Entry* entry_;
+};
+
+struct InternedTrustDomainHash {
+    size_t operator()(const InternedTrustDomain& trust_domain) const {
+        return std::hash<const void*>()(trust_domain.entry_);
+    }
+};
+
+// SPIFFE ID, spiffe://<trust domain>[/<path>], parsed and validated per the SPIFFE ID
+// specification without copying or allocating: the parts are views into the parsed text,
+// which must outlive the SpiffeId.
+//
+// The trust domain is lowercase letters, digits, '.', '-' and '_'. The path is made of
+// non-empty segments of letters, digits, '.', '-' and '_', none of them "." or "..", without
+// a trailing '/'. No port, user info, query, fragment or percent-encoding.
+class SpiffeId {
+   public:
+    SpiffeId() = default;
+
+    // false, leaving out unchanged, if id is not a valid SPIFFE ID
+    static bool parse(StringView id, SpiffeId& out);
+
+    // Whole ID
+    StringView str() const { return id_; }
+
+    // "example.org", "spiffe://example.org" and "/workload" (empty for the trust domain ID)
+    StringView trust_domain_name() const { return id_.substr(SCHEME_SIZE, trust_domain_size_); }
+    StringView trust_domain_id() const { return id_.substr(0, SCHEME_SIZE + trust_domain_size_); }
+    StringView path() const { return id_.substr(SCHEME_SIZE + trust_domain_size_); }
+
+    // Interned trust domain, null if it was never interned (then no bundle is keyed by it).
+    // Hashes the name once, the result is a pointer.
+    InternedTrustDomain trust_domain() const { return InternedTrustDomain::find(trust_domain_name()); }
+
+    // Length of "spiffe://"
+    static const size_t SCHEME_SIZE = 9;
+
+   private:
+    StringView id_;
+    size_t trust_domain_size_ = 0;
+};
+
+}  // namespace spiffe
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <spiffe/spiffe_id.h>
+#include <spiffe/status.h>
+#include <spiffe/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spiffe {
+
+// Allowlist of SPIFFE IDs, compiled into one deterministic path-segment trie per trust domain:
+// matching an ID is a hash lookup per path segment, whatever the number of rules.
+//
+// A rule is a SPIFFE ID whose path segments may be wildcards:
+//   spiffe://example.org/web           exactly that ID
+//   spiffe://example.org/ns/*/sa/web   "*" matches any one segment
+//   spiffe://example.org/ns/prod/**    "**", last segment only, matches any number of segments,
+//                                      none included: /ns/prod and everything under it
+//   spiffe://example.org/**            any ID of the trust domain
+//
+// Immutable once compiled and safe to share between threads. Not copyable, the trie refers to
+// the rules it keeps.
+class SpiffeIdMatcher {
+   public:
+    // Matches nothing
+    SpiffeIdMatcher() = default;
+
+    SpiffeIdMatcher(const SpiffeIdMatcher&) = delete;
+    SpiffeIdMatcher& operator=(const SpiffeIdMatcher&) = delete;
+    SpiffeIdMatcher(SpiffeIdMatcher&&) = default;
+    SpiffeIdMatcher& operator=(SpiffeIdMatcher&&) = default;
+
+    // INVALID_ARGUMENT naming the first invalid rule, leaving out unchanged
+    static Status compile(const std::vector<std::string>& rules, SpiffeIdMatcher& out);
+
+    // false if id is not a valid SPIFFE ID
+    bool matches(StringView id) const;
+    bool matches(const SpiffeId& id) const;
+
+    // Rules, and trie nodes over all trust domains
+    size_t size() const { return rules_.size(); }
+    size_t node_count() const { return nodes_.size(); }
+
+   private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        // Next node by path segment, then for any other segment
+        std::unordered_map<StringView, uint32_t, StringViewHash> children;
+        uint32_t other = NONE;
+
+        // Whether an ID ending here matches, and whether any ID going through here does
+        bool accept = false;
+        bool accept_rest = false;
+    };
+
+    // Keys of roots_ and of the nodes' children are views into the rules
+    std::vector<std::string> rules_;
+    std::vector<Node> nodes_;
+    std::unordered_map<StringView, uint32_t, StringViewHash> roots_;
+};
+
+// Current SpiffeIdMatcher of a policy that may be reloaded while requests are authorized:
+// reload() compiles the new rules aside, then swaps them in at once, so a request sees either
+// the old or the new policy as a whole. Thread-safe.
+class SpiffeIdAuthorizer {
+   public:
+    // Authorizes nothing until the first reload
+    SpiffeIdAuthorizer();
+
+    // Disallow copy
+    SpiffeIdAuthorizer(const SpiffeIdAuthorizer&) = delete;
+    SpiffeIdAuthorizer& operator=(const SpiffeIdAuthorizer&) = delete;
+
+    // Keeps the current policy if a rule is invalid
+    Status reload(const std::vector<std::string>& rules);
+
+    // Current matcher. Takes a lock, hold on to it to authorize many IDs.
+    std::shared_ptr<const SpiffeIdMatcher> matcher() const;
+
+    bool authorized(StringView id) const { return matcher()->matches(id); }
+
+   private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const SpiffeIdMatcher> matcher_;
+};
+
+}  // namespace spiffe
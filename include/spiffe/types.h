@@ -1,7 +1,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,9 +15,191 @@ namespace spiffe {
 
 using Buffer = std::vector<uint8_t>;
 
+// Non-owning view of contiguous bytes, the viewed memory must outlive it
+class BufferView {
+   public:
+    BufferView() : data_(nullptr), size_(0) {}
+    BufferView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    BufferView(const Buffer& buffer) : data_(buffer.data()), size_(buffer.size()) {}
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+    uint8_t operator[](size_t i) const { return data_[i]; }
+
+    // Owned copies
+    Buffer to_buffer() const { return Buffer(begin(), end()); }
+    std::string to_string() const { return std::string(reinterpret_cast<const char*>(data_), size_); }
+
+   private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+inline bool operator==(const BufferView& a, const BufferView& b) {
+    return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+inline bool operator!=(const BufferView& a, const BufferView& b) { return !(a == b); }
+
+// FNV-1a of the viewed bytes, for hash containers keyed by views
+struct BufferViewHash {
+    size_t operator()(const BufferView& view) const {
+        uint64_t hash = 14695981039346656037ull;
+        for (uint8_t byte : view) {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+// Non-owning view of characters, the viewed memory must outlive it
+class StringView {
+   public:
+    StringView() : data_(nullptr), size_(0) {}
+    StringView(const char* data, size_t size) : data_(data), size_(size) {}
+    StringView(const char* text) : data_(text), size_(std::strlen(text)) {}
+    StringView(const std::string& text) : data_(text.data()), size_(text.size()) {}
+    explicit StringView(BufferView bytes) : data_(reinterpret_cast<const char*>(bytes.data())), size_(bytes.size()) {}
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+    char operator[](size_t i) const { return data_[i]; }
+
+    // Characters [pos, pos + count), clamped to the view
+    StringView substr(size_t pos, size_t count = static_cast<size_t>(-1)) const {
+        pos = pos < size_ ? pos : size_;
+        return StringView(data_ + pos, count < size_ - pos ? count : size_ - pos);
+    }
+
+    std::string to_string() const { return std::string(data_, size_); }
+
+   private:
+    const char* data_;
+    size_t size_;
+};
+
+inline bool operator==(const StringView& a, const StringView& b) {
+    return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+inline bool operator!=(const StringView& a, const StringView& b) { return !(a == b); }
+
+struct StringViewHash {
+    size_t operator()(const StringView& view) const {
+        return BufferViewHash()(BufferView(reinterpret_cast<const uint8_t*>(view.data()), view.size()));
+    }
+};
+
+// Sequence of DER certificates stored back to back in one shared backing allocation.
+//
+// The concatenated DER is kept as received and certificates are found by walking their
+// headers on iteration, so splitting a bundle allocates nothing and copies of a list share
+// the backing. Iteration yields BufferView, valid while any list referencing the backing lives.
+class CertificateList {
+   public:
+    class Iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = BufferView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const BufferView*;
+        using reference = const BufferView&;
+
+        Iterator() : end_(nullptr) {}
+        Iterator(const uint8_t* pos, const uint8_t* end);
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+
+        Iterator& operator++();
+        Iterator operator++(int) {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const Iterator& other) const { return current_.data() == other.current_.data(); }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+       private:
+        const uint8_t* end_;
+        BufferView current_;
+    };
+
+    CertificateList() : offset_(0), size_bytes_(0), count_(0), valid_(true) {}
+
+    // References the certificates in [offset, offset + size) of backing. If the range is not
+    // made of well-formed certificates only, the list is empty and not valid().
+    CertificateList(std::shared_ptr<const Buffer> backing, size_t offset, size_t size);
+
+    // Copies concatenated DER certificates into a new backing allocation
+    static CertificateList from_der(const uint8_t* der, size_t size);
+
+    // Copies individual certificates into one new backing allocation
+    CertificateList(const std::vector<Buffer>& certificates);
+    CertificateList(std::initializer_list<Buffer> certificates) : CertificateList(std::vector<Buffer>(certificates)) {}
+
+    Iterator begin() const { return Iterator(der().begin(), der().end()); }
+    Iterator end() const { return Iterator(der().end(), der().end()); }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // False if the list was made from malformed DER
+    bool valid() const { return valid_; }
+
+    // Walks the list, O(i)
+    BufferView operator[](size_t i) const;
+    BufferView front() const { return *begin(); }
+
+    // All certificates, concatenated
+    BufferView der() const {
+        return backing_ ? BufferView(backing_->data() + offset_, size_bytes_) : BufferView();
+    }
+
+    const std::shared_ptr<const Buffer>& backing() const { return backing_; }
+
+    // Owned copy of every certificate
+    std::vector<Buffer> to_buffers() const;
+
+   private:
+    std::shared_ptr<const Buffer> backing_;
+    size_t offset_;
+    size_t size_bytes_;
+    size_t count_;
+    bool valid_;
+};
+
+inline bool operator==(const CertificateList& a, const CertificateList& b) { return a.der() == b.der(); }
+inline bool operator!=(const CertificateList& a, const CertificateList& b) { return !(a == b); }
+
+// Non-owning sequence of well-formed concatenated DER certificates, see CompactX509SvidContext
+class CertificateRange {
+   public:
+    CertificateRange() : count_(0) {}
+    CertificateRange(BufferView der, size_t count) : der_(der), count_(count) {}
+
+    CertificateList::Iterator begin() const { return CertificateList::Iterator(der_.begin(), der_.end()); }
+    CertificateList::Iterator end() const { return CertificateList::Iterator(der_.end(), der_.end()); }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    BufferView der() const { return der_; }
+
+   private:
+    BufferView der_;
+    size_t count_;
+};
+
 using TrustDomain = std::string;
-using X509CertificateChain = std::vector<Buffer>;
-using X509Bundle = std::vector<Buffer>;
+using X509CertificateChain = CertificateList;
+using X509Bundle = CertificateList;
 
 struct X509Svid {
     std::string spiffe_id;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <spiffe/spiffe.h>
+#include <spiffe/types.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace spiffe {
+
+// Registration of a callback with a WorkloadApiHub, ended by unsubscribe() or destruction
+class Subscription {
+   public:
+    struct Channel;
+
+    // Not subscribed to anything
+    Subscription() = default;
+    Subscription(std::shared_ptr<Channel> channel, uint64_t id) : channel_(std::move(channel)), id_(id) {}
+    ~Subscription() { unsubscribe(); }
+
+    // Disallow copy
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    // Allow move
+    Subscription(Subscription&& other) noexcept;
+    Subscription& operator=(Subscription&& other) noexcept;
+
+    // Once it returns the callback is not running and is not called again, except when called
+    // from the callback itself, which then runs to completion. May outlive the hub.
+    void unsubscribe();
+
+    bool active() const { return channel_ != nullptr; }
+
+   private:
+    std::shared_ptr<Channel> channel_;
+    uint64_t id_ = 0;
+};
+
+// One upstream stream per Workload API RPC, shared by every component of the process that
+// needs it: each update is decoded once, and the same immutable context is handed to every
+// subscriber, instead of every component opening its own stream and decoding the same bytes.
+//
+// A stream is opened by the first subscription to its RPC and runs until the hub is
+// destroyed, reconnecting after agent restarts (ClientOptions::stream_retry is enabled if it
+// is not). A stream that ends anyway, on a status that is not retried or once
+// StreamRetryOptions::max_attempts is reached, is reopened by the next subscription to its
+// RPC. Updates identical to the previous one are not delivered. A subscriber first receives
+// the latest update, if any, from within subscribe(), then every update in order on the
+// stream's thread: callbacks should return quickly, they delay the other subscribers.
+//
+// Thread-safe. The last reference to a hub must not be released from one of its callbacks.
+class WorkloadApiHub {
+   public:
+    template <typename Context>
+    using Callback = std::function<void(const std::shared_ptr<const Context>&)>;
+
+    explicit WorkloadApiHub(const std::string& socket_path, const ClientOptions& options = ClientOptions());
+    ~WorkloadApiHub();
+
+    // Disallow copy
+    WorkloadApiHub(const WorkloadApiHub&) = delete;
+    WorkloadApiHub& operator=(const WorkloadApiHub&) = delete;
+
+    // Process-wide hub of socket_path, created with options if no one holds it
+    static std::shared_ptr<WorkloadApiHub> get(const std::string& socket_path,
+                                               const ClientOptions& options = ClientOptions());
+
+    Subscription subscribe_x509_svid(Callback<X509SvidContext> callback);
+    Subscription subscribe_x509_bundles(Callback<X509BundlesContext> callback);
+    Subscription subscribe_jwt_bundles(Callback<JwtBundles> callback);
+
+    // Latest update, nullptr before the first one or if the RPC has no subscription yet
+    std::shared_ptr<const X509SvidContext> x509_svid() const;
+    std::shared_ptr<const X509BundlesContext> x509_bundles() const;
+    std::shared_ptr<const JwtBundles> jwt_bundles() const;
+
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace spiffe
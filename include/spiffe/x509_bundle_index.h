@@ -0,0 +1,147 @@
+#pragma once
+
+#include <spiffe/spiffe_id.h>
+#include <spiffe/types.h>
+#include <spiffe/x509_certificate.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spiffe {
+
+// Certificates of one X509Bundle, parsed once and indexed by Subject Key Identifier and by
+// subject name, so that chain building finds the issuer of a certificate in O(1) instead of
+// re-parsing every CA of the trust domain.
+//
+// Immutable once built and safe to share between threads. Shares the backing of the bundle,
+// the views it hands out stay valid as long as the index.
+class X509BundleIndex {
+   public:
+    explicit X509BundleIndex(X509Bundle bundle);
+
+    const X509Bundle& bundle() const { return bundle_; }
+
+    // Unique to this index within the process, so a result derived from it can tell whether the
+    // bundle it was checked against is still the current one
+    uint64_t id() const { return id_; }
+
+    // Certificates of the bundle that parsed, in bundle order
+    const std::vector<X509CertificateView>& certificates() const { return certificates_; }
+
+    // CA that issued cert, nullptr if none. Matched on the authority key identifier of cert
+    // when it has one, and on its issuer name otherwise or when no CA has that key identifier.
+    // The candidate's subject must equal the issuer name of cert in both cases.
+    const X509CertificateView* find_issuer(const X509CertificateView& cert) const;
+
+    // Every CA that may have issued cert, passed to accept until it returns true, e.g. once a
+    // signature verifies: several CAs can share a name, like the old and new CA of a rotation.
+    // Those with the authority key identifier of cert come first, then any other with its
+    // issuer name. Returns the accepted CA, nullptr if none was.
+    template <typename Accept>
+    const X509CertificateView* find_issuer(const X509CertificateView& cert, Accept accept) const;
+
+    // Same for anything else a CA signs, e.g. a CRL, by its issuer name and authority key
+    // identifier (may be empty)
+    template <typename Accept>
+    const X509CertificateView* find_issuer(BufferView issuer, BufferView authority_key_id, Accept accept) const;
+
+    // First certificate with this key identifier, nullptr if not found
+    const X509CertificateView* find_by_subject_key_id(BufferView subject_key_id) const;
+
+    // First certificate with this subject (DER Name with its header), nullptr if not found
+    const X509CertificateView* find_by_subject(BufferView subject) const;
+
+   private:
+    X509Bundle bundle_;
+    uint64_t id_;
+    std::vector<X509CertificateView> certificates_;
+
+    // Indices into certificates_, keys view into the bundle
+    std::unordered_multimap<BufferView, size_t, BufferViewHash> by_subject_key_id_;
+    std::unordered_multimap<BufferView, size_t, BufferViewHash> by_subject_;
+};
+
+template <typename Accept>
+const X509CertificateView* X509BundleIndex::find_issuer(const X509CertificateView& cert, Accept accept) const {
+    return find_issuer(cert.issuer(), cert.authority_key_id(), accept);
+}
+
+template <typename Accept>
+const X509CertificateView* X509BundleIndex::find_issuer(BufferView issuer, BufferView authority_key_id,
+                                                        Accept accept) const {
+    if (issuer.empty()) {
+        return nullptr;
+    }
+
+    if (!authority_key_id.empty()) {
+        auto range = by_subject_key_id_.equal_range(authority_key_id);
+        for (auto it = range.first; it != range.second; ++it) {
+            const X509CertificateView& candidate = certificates_[it->second];
+            if (candidate.subject() == issuer && accept(candidate)) {
+                return &candidate;
+            }
+        }
+    }
+
+    // Without a matching key identifier, e.g. a CA without SKI, the name alone decides
+    auto range = by_subject_.equal_range(issuer);
+    for (auto it = range.first; it != range.second; ++it) {
+        const X509CertificateView& candidate = certificates_[it->second];
+        if ((authority_key_id.empty() || candidate.subject_key_id() != authority_key_id) && accept(candidate)) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+// X509BundleIndex of every trust domain of an update, e.g. X509BundlesContext::bundles or
+// X509SvidContext::federated_bundles.
+//
+// Built from the previous set on every update: indexes of bundles whose certificates did not
+// change are shared with it instead of being built again, so only changed trust domains pay.
+// Also holds the revoked serial numbers of the update's CRLs, see set_crls().
+class X509BundleIndexSet {
+   public:
+    X509BundleIndexSet() = default;
+    explicit X509BundleIndexSet(const std::unordered_map<TrustDomain, X509Bundle>& bundles,
+                                const X509BundleIndexSet* previous = nullptr);
+
+    // nullptr if the trust domain has no bundle
+    const X509BundleIndex* get(const TrustDomain& trust_domain) const;
+
+    // Same by interned trust domain, without hashing a string. Trust domains are interned as
+    // they are set, when they are valid "spiffe://<name>" IDs.
+    const X509BundleIndex* get(InternedTrustDomain trust_domain) const;
+
+    size_t size() const { return indexes_.size(); }
+
+    // Adds or replaces one trust domain, reusing the previous index when the bundle is unchanged
+    void set(const TrustDomain& trust_domain, const X509Bundle& bundle, const X509BundleIndexSet* previous);
+
+    // DER CRLs of the update, e.g. X509SvidContext::crl, reusing the previous revocation index
+    // when they and the bundles are unchanged. Each CRL must be signed by a CA of a bundle of
+    // this set with its issuer name, so the bundles come first: set() of a changed bundle checks
+    // the CRLs again. Malformed CRLs and those whose signature does not verify are skipped.
+    void set_crls(const std::vector<Buffer>& crls, const X509BundleIndexSet* previous = nullptr);
+
+    // Changes whenever the CRLs in use change, 0 without any
+    uint64_t crl_revision() const;
+
+    // CRLs in use, the ones of set_crls() that verified
+    const std::vector<Buffer>& crls() const;
+
+    // Whether a CRL of the issuer of cert lists its serial number
+    bool is_revoked(const X509CertificateView& cert) const;
+
+   private:
+    class Revocations;
+
+    std::unordered_map<TrustDomain, std::shared_ptr<const X509BundleIndex>> indexes_;
+    std::unordered_map<InternedTrustDomain, const X509BundleIndex*, InternedTrustDomainHash> by_interned_;
+    std::shared_ptr<const Revocations> revocations_;
+};
+
+}  // namespace spiffe
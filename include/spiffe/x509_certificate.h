@@ -0,0 +1,129 @@
+#pragma once
+
+#include <spiffe/types.h>
+
+#include <chrono>
+#include <cstdint>
+
+namespace spiffe {
+
+// Whole seconds, wide enough for the 9999-12-31 "no expiry" of RFC 5280. Compare with
+// std::chrono::time_point_cast<std::chrono::seconds>(std::chrono::system_clock::now()).
+using X509Time = std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
+
+// Fields of one DER X.509 certificate, read in place out of its bytes, e.g. the BufferViews of
+// a CertificateList.
+//
+// Nothing is copied or allocated, every field is a view into der, which must outlive the view.
+// The TBSCertificate is walked once on the first access to one of its fields, the extensions
+// once on the first access to an extension field, and the results are kept. This is not a
+// validator: signatures are not checked (see verify_x509_svid) and only the structure the
+// fields need is.
+//
+// Not thread-safe, the lazy parsing writes to the view. Views are small, copy one per thread.
+class X509CertificateView {
+   public:
+    // Bits of key_usage(), bit n of the keyUsage BIT STRING as 1 << n
+    enum : uint16_t {
+        KEY_USAGE_DIGITAL_SIGNATURE = 1 << 0,
+        KEY_USAGE_KEY_CERT_SIGN = 1 << 5,
+        KEY_USAGE_CRL_SIGN = 1 << 6,
+    };
+
+    X509CertificateView() = default;
+    explicit X509CertificateView(BufferView der) : der_(der) {}
+
+    // Whether the certificate and its extensions parsed. Fields of an invalid certificate are
+    // empty, zero or false.
+    bool valid() const;
+
+    BufferView der() const { return der_; }
+
+    // TBSCertificate with its header, the bytes the signature covers
+    BufferView tbs_certificate() const;
+
+    // OID content of the signatureAlgorithm (e.g. 2a 86 48 ce 3d 04 03 02 for ecdsa-with-SHA256),
+    // and the signatureValue bytes without the BIT STRING unused bits count
+    BufferView signature_algorithm() const;
+    BufferView signature() const;
+
+    // Content of the serialNumber INTEGER, big-endian two's complement
+    BufferView serial() const;
+
+    // Name and SubjectPublicKeyInfo with their headers, as compared and hashed by chain building
+    BufferView issuer() const;
+    BufferView subject() const;
+    BufferView subject_public_key_info() const;
+
+    X509Time not_before() const;
+    X509Time not_after() const;
+
+    // First URI SAN, which is the SPIFFE ID of an X.509-SVID, and the number of URI SANs
+    // (exactly one for a valid SVID). Empty and 0 without a subjectAltName extension.
+    BufferView uri_san() const;
+    size_t uri_san_count() const;
+
+    // keyIdentifier of the subjectKeyIdentifier and authorityKeyIdentifier extensions
+    BufferView subject_key_id() const;
+    BufferView authority_key_id() const;
+
+    // cA of the basicConstraints extension
+    bool is_ca() const;
+
+    // pathLenConstraint of the basicConstraints extension, -1 without one
+    int path_len_constraint() const;
+
+    // keyUsage extension, KEY_USAGE_* bits. Without one any use is allowed.
+    bool has_key_usage() const;
+    uint16_t key_usage() const;
+
+    // Content of the permittedSubtrees and excludedSubtrees of the nameConstraints extension,
+    // GeneralSubtree elements back to back. Empty without them.
+    BufferView permitted_subtrees() const;
+    BufferView excluded_subtrees() const;
+
+    // Whether an extension marked critical is none of the above, nor extKeyUsage. Users of the
+    // certificate must then reject it (RFC 5280 4.2).
+    bool has_unknown_critical_extension() const;
+
+   private:
+    enum : uint8_t {
+        TBS_PARSED = 1,
+        TBS_VALID = 2,
+        EXTENSIONS_PARSED = 4,
+        EXTENSIONS_VALID = 8,
+    };
+
+    BufferView der_;
+    mutable uint8_t state_ = 0;
+
+    // TBSCertificate, parsed together
+    mutable BufferView tbs_certificate_;
+    mutable BufferView signature_algorithm_;
+    mutable BufferView signature_;
+    mutable BufferView serial_;
+    mutable BufferView issuer_;
+    mutable BufferView subject_;
+    mutable BufferView subject_public_key_info_;
+    mutable BufferView extensions_;
+    mutable X509Time not_before_;
+    mutable X509Time not_after_;
+
+    // Extensions, parsed together
+    mutable BufferView uri_san_;
+    mutable BufferView subject_key_id_;
+    mutable BufferView authority_key_id_;
+    mutable BufferView permitted_subtrees_;
+    mutable BufferView excluded_subtrees_;
+    mutable uint32_t uri_san_count_ = 0;
+    mutable int path_len_constraint_ = -1;
+    mutable uint16_t key_usage_ = 0;
+    mutable bool has_key_usage_ = false;
+    mutable bool is_ca_ = false;
+    mutable bool has_unknown_critical_extension_ = false;
+
+    bool parse_tbs_certificate() const;
+    bool parse_extensions() const;
+};
+
+}  // namespace spiffe
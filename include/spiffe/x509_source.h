@@ -0,0 +1,128 @@
+#pragma once
+
+#include <spiffe/cancellation.h>
+#include <spiffe/spiffe.h>
+#include <spiffe/status.h>
+#include <spiffe/types.h>
+#include <spiffe/x509_bundle_index.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace spiffe {
+
+// Immutable X509SvidContext of one FetchX509SVID update, indexed for O(1) lookups.
+class X509SvidSnapshot {
+   public:
+    // Bundle indexes that did not change since previous are shared with it
+    X509SvidSnapshot(X509SvidContext context, uint64_t generation, const X509SvidSnapshot* previous = nullptr);
+
+    const X509SvidContext& context() const { return context_; }
+
+    // Increases by one with every update published by the source, starting from 1
+    uint64_t generation() const { return generation_; }
+
+    // Default SVID, the first one sent by the agent. nullptr if there is none.
+    const X509Svid* svid() const;
+
+    // nullptr if not found
+    const X509Svid* svid_by_id(const std::string& spiffe_id) const;
+    const X509Svid* svid_by_hint(const std::string& hint) const;
+    const X509Bundle* federated_bundle(const TrustDomain& trust_domain) const;
+
+    // Indexed bundles of the SVIDs' own trust domains ("spiffe://example.org") and of the
+    // federated ones, with the CRLs of the update, to find issuers while building chains and
+    // to verify peers with verify_x509_svid
+    const X509BundleIndexSet& bundle_indexes() const { return bundle_indexes_; }
+
+   private:
+    X509SvidContext context_;
+    uint64_t generation_;
+    X509BundleIndexSet bundle_indexes_;
+
+    std::unordered_map<std::string, size_t> by_id_;
+    std::unordered_map<std::string, size_t> by_hint_;
+};
+
+class X509SourceReader;
+
+// X509Source owns a FetchX509SVID stream and publishes every update as an immutable
+// X509SvidSnapshot. Snapshots are read through X509SourceReader, one per thread.
+class X509Source {
+   public:
+    X509Source(const std::string& socket_path, const ClientOptions& options = ClientOptions());
+    ~X509Source();
+
+    // Disallow copy and move, readers keep a reference to the internal state
+    X509Source(const X509Source&) = delete;
+    X509Source& operator=(const X509Source&) = delete;
+
+    // Starts the stream on a background thread
+    void start();
+
+    // Stops the stream and waits for the background thread. Published snapshots stay readable.
+    void close();
+
+    // Blocks until the first update is published, the stream fails, or timeout expires
+    Status wait_until_ready(std::chrono::milliseconds timeout);
+
+    // Latest snapshot, nullptr before the first update. Copies the shared reference, prefer
+    // X509SourceReader on hot paths.
+    std::shared_ptr<const X509SvidSnapshot> snapshot() const;
+
+    X509SourceReader reader() const;
+
+    // Shared between the source and its readers, so readers may outlive the source
+    struct State {
+        // Written only when an update is published, readers just load it
+        std::atomic<uint64_t> generation{0};
+
+        // Read and written with std::atomic_load / std::atomic_store only
+        std::shared_ptr<const X509SvidSnapshot> current;
+
+        mutable std::mutex mutex;
+        std::condition_variable updated;
+        bool stream_done = false;
+        Status stream_status;
+    };
+
+   private:
+    WorkloadApiClient client_;
+    std::shared_ptr<State> state_;
+
+    CancellationSource cancellation_;
+    std::thread stream_thread_;
+
+    void run(CancellationToken cancellation_token);
+};
+
+// Per-thread cached view of an X509Source. get() is wait-free while no new update has been
+// published: it loads one atomic that is only written by the publisher, so readers on many
+// cores neither take a lock nor touch a shared reference count. After an update it reloads the
+// snapshot with std::atomic_load, without the source's mutex.
+//
+// A reader must not be shared between threads, e.g. keep one in a thread_local.
+class X509SourceReader {
+   public:
+    explicit X509SourceReader(const X509Source& source);
+
+    // Current snapshot, nullptr before the first update. The pointer stays valid until the
+    // next call to get() on this reader.
+    const X509SvidSnapshot* get();
+
+   private:
+    friend class X509Source;
+    explicit X509SourceReader(std::shared_ptr<const X509Source::State> state);
+
+    std::shared_ptr<const X509Source::State> state_;
+    std::shared_ptr<const X509SvidSnapshot> cached_;
+    uint64_t cached_generation_ = 0;
+};
+
+}  // namespace spiffe
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <spiffe/spiffe_id.h>
+#include <spiffe/status.h>
+#include <spiffe/types.h>
+#include <spiffe/x509_bundle_index.h>
+#include <spiffe/x509_certificate.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace spiffe {
+
+// Current time as X509Time
+X509Time x509_now();
+
+// Verifies the X.509-SVID a peer presented, leaf first then any intermediates, against the
+// bundle of the trust domain of its SPIFFE ID in bundles, e.g. X509SvidSnapshot::bundle_indexes().
+//
+// The leaf must not be a CA, must have exactly one URI SAN, a spiffe:// ID, which is stored in
+// spiffe_id, and may only be used for digitalSignature. The path from the leaf through the
+// intermediates of the chain to a certificate of the bundle is validated by OpenSSL
+// (X509_verify_cert) at now, every bundle certificate being a trust anchor, with revocation
+// checked against the CRLs of bundles.
+//
+// UNAUTHENTICATED if the chain does not verify, INVALID_ARGUMENT if it does not parse.
+Status verify_x509_svid(const X509CertificateChain& chain, const X509BundleIndexSet& bundles, std::string& spiffe_id,
+                        X509Time now = x509_now());
+
+struct X509SvidVerifierOptions {
+    // Upper bound on cached chains, split evenly between shards
+    size_t max_entries = 4096;
+    size_t shards = 16;
+};
+
+// verify_x509_svid with a cache of the chains that verified, keyed by a hash of the chain's
+// DER, so that repeat connections from a peer skip path building and signature checks.
+//
+// A cached result only holds while the bundle of its trust domain and the CRLs of bundles are
+// the ones it was verified against (X509BundleIndex::id(), X509BundleIndexSet::crl_revision())
+// and now is within the validity of every certificate on the path. Failures are not cached.
+// Thread-safe, chains are spread over independently locked shards.
+class X509SvidVerifier {
+   public:
+    explicit X509SvidVerifier(const X509SvidVerifierOptions& options = X509SvidVerifierOptions());
+    ~X509SvidVerifier();
+
+    // Disallow copy
+    X509SvidVerifier(const X509SvidVerifier&) = delete;
+    X509SvidVerifier& operator=(const X509SvidVerifier&) = delete;
+
+    Status verify(const X509CertificateChain& chain, const X509BundleIndexSet& bundles, std::string& spiffe_id,
+                  X509Time now = x509_now());
+
+    // Cached chains, including ones that no longer hold
+    size_t size() const;
+
+   private:
+    struct Entry {
+        Buffer chain;
+        std::string spiffe_id;
+        InternedTrustDomain trust_domain;
+        uint64_t bundle_id;
+        uint64_t crl_revision;
+        X509Time not_before;
+        X509Time not_after;
+    };
+
+    class Cache;
+    std::unique_ptr<Cache> cache_;
+
+    static bool holds(const Entry& entry, const X509BundleIndexSet& bundles, X509Time now);
+};
+
+}  // namespace spiffe
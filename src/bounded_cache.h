@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace spiffe {
+
+// Map from Key to Value of at most max_entries values, spread over independently locked shards.
+// A full shard makes room by dropping the values that no longer hold, then the least recently
+// used one.
+//
+// Callers lock the shard of a key themselves, so that a lookup and what follows from it can share
+// one critical section. Extra is state of the caller's own, kept per shard under the same mutex.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Extra = std::tuple<>>
+class BoundedCache {
+   public:
+    class Shard {
+       public:
+        mutable std::mutex mutex;
+        Extra extra;
+
+       private:
+        friend class BoundedCache;
+
+        // Keys point into slots, whose nodes do not move on rehash
+        using Order = std::list<const Key*>;
+
+        struct Slot {
+            Value value;
+            typename Order::iterator position;
+        };
+
+        std::unordered_map<Key, Slot, Hash> slots;
+        Order order;  // most recently used first
+    };
+
+    BoundedCache(size_t max_entries, size_t shards)
+        : shard_count_(std::max<size_t>(shards, 1)), shards_(new Shard[shard_count_]) {
+        max_entries_per_shard_ = std::max<size_t>(max_entries / shard_count_, 1);
+    }
+
+    // Disallow copy
+    BoundedCache(const BoundedCache&) = delete;
+    BoundedCache& operator=(const BoundedCache&) = delete;
+
+    Shard& shard(const Key& key) { return shards_[Hash()(key) % shard_count_]; }
+
+    // Value for key, which becomes the most recently used, nullptr if none. The shard of key must
+    // be locked.
+    Value* find(Shard& shard, const Key& key) {
+        auto it = shard.slots.find(key);
+        if (it == shard.slots.end()) {
+            return nullptr;
+        }
+        shard.order.splice(shard.order.begin(), shard.order, it->second.position);
+        return &it->second.value;
+    }
+
+    // Adds or replaces the value for key. holds(const Value&) tells the values that may go first
+    // when the shard is full. The shard of key must be locked.
+    template <typename Holds>
+    void insert(Shard& shard, const Key& key, Value value, Holds holds) {
+        auto it = shard.slots.find(key);
+        if (it != shard.slots.end()) {
+            it->second.value = std::move(value);
+            shard.order.splice(shard.order.begin(), shard.order, it->second.position);
+            return;
+        }
+
+        if (shard.slots.size() >= max_entries_per_shard_) {
+            for (auto slot = shard.slots.begin(); slot != shard.slots.end();) {
+                if (!holds(static_cast<const Value&>(slot->second.value))) {
+                    shard.order.erase(slot->second.position);
+                    slot = shard.slots.erase(slot);
+                } else {
+                    ++slot;
+                }
+            }
+            if (shard.slots.size() >= max_entries_per_shard_) {
+                auto oldest = shard.slots.find(*shard.order.back());
+                shard.order.pop_back();
+                shard.slots.erase(oldest);
+            }
+        }
+
+        auto inserted = shard.slots.emplace(key, typename Shard::Slot{std::move(value), {}}).first;
+        shard.order.push_front(&inserted->first);
+        inserted->second.position = shard.order.begin();
+    }
+
+    // Cached values, including ones that no longer hold. Locks every shard in turn.
+    size_t size() const {
+        size_t size = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            size += shards_[i].slots.size();
+        }
+        return size;
+    }
+
+   private:
+    size_t shard_count_;
+    size_t max_entries_per_shard_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace spiffe
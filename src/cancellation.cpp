@@ -0,0 +1,71 @@
+#include <spiffe/cancellation.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace spiffe {
+
+struct CancellationState {
+    std::atomic<bool> cancelled{false};
+
+    // Held while callbacks run, so unsubscribe() waits for a running callback
+    std::mutex mutex;
+    uint64_t next_id = 1;
+    std::map<uint64_t, std::function<void()>> callbacks;
+};
+
+CancellationSource::CancellationSource() : state_(std::make_shared<CancellationState>()) {}
+
+void CancellationSource::cancel() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (state_->cancelled.exchange(true)) {
+        return;
+    }
+
+    for (auto& entry : state_->callbacks) {
+        entry.second();
+    }
+    state_->callbacks.clear();
+}
+
+bool CancellationSource::is_cancelled() const { return state_->cancelled.load(std::memory_order_acquire); }
+
+CancellationToken CancellationSource::token() const { return CancellationToken(state_); }
+
+bool CancellationToken::is_cancelled() const {
+    if (state_) {
+        return state_->cancelled.load(std::memory_order_acquire);
+    }
+    if (future_.valid()) {
+        return future_.wait_for(std::chrono::seconds(0)) != std::future_status::timeout;
+    }
+    return false;
+}
+
+uint64_t CancellationToken::subscribe(std::function<void()> callback) const {
+    if (!state_) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    uint64_t id = state_->next_id++;
+    if (state_->cancelled.load(std::memory_order_relaxed)) {
+        callback();
+    } else {
+        state_->callbacks.emplace(id, std::move(callback));
+    }
+    return id;
+}
+
+void CancellationToken::unsubscribe(uint64_t id) const {
+    if (!state_ || id == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->callbacks.erase(id);
+}
+
+}  // namespace spiffe
@@ -0,0 +1,354 @@
+#include <spiffe/compact_context.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "context_decoder.h"
+#include "der.h"
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+
+// Arena records, offsets are relative to the start of the arena. A Workload API message is far
+// below 4 GiB, so 32 bit offsets keep the tables small.
+struct CompactSpan {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct CompactSvidRecord {
+    CompactSpan spiffe_id;
+    CompactSpan x509_svid;
+    CompactSpan x509_svid_key;
+    CompactSpan bundle;
+    CompactSpan hint;
+    uint32_t x509_svid_count;
+    uint32_t bundle_count;
+};
+
+struct CompactBundleRecord {
+    CompactSpan trust_domain;
+    CompactSpan der;
+    uint32_t count;
+};
+
+namespace {
+
+template <typename Record>
+const Record* table(const uint8_t* arena, size_t offset) {
+    return reinterpret_cast<const Record*>(arena + offset);
+}
+
+BufferView view(const uint8_t* arena, const CompactSpan& span) { return BufferView(arena + span.offset, span.size); }
+
+int compare(BufferView a, BufferView b) {
+    size_t common = std::min(a.size(), b.size());
+    int result = common ? std::memcmp(a.data(), b.data(), common) : 0;
+    if (result != 0) {
+        return result;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+// Malformed certificates fail the whole build rather than shortening a chain or bundle
+bool well_formed(const proto_view& der) { return well_formed_certificates(der.data(), der.size()); }
+
+// Length of the leading run of well-formed certificates, the whole field once well_formed
+size_t certificates_prefix(const proto_view& der, size_t& count) {
+    CertificateIter iter(der.data(), der.size());
+    size_t size = 0;
+    count = 0;
+    while (iter.has_next() && !iter.next().empty()) {
+        size = iter.position();
+        ++count;
+    }
+    return size;
+}
+
+size_t certificates_prefix(const proto_view& der) {
+    size_t count;
+    return certificates_prefix(der, count);
+}
+
+bool within(size_t offset, size_t size, size_t arena_size) {
+    return offset <= arena_size && size <= arena_size - offset;
+}
+
+template <typename Record>
+bool table_within(size_t offset, size_t count, size_t arena_size) {
+    return offset % alignof(Record) == 0 && count <= arena_size / sizeof(Record) &&
+           within(offset, count * sizeof(Record), arena_size);
+}
+
+}  // namespace
+
+BufferView CompactBundles::trust_domain(size_t i) const {
+    return view(arena_, table<CompactBundleRecord>(arena_, layout_->bundles)[i].trust_domain);
+}
+
+CertificateRange CompactBundles::bundle(size_t i) const {
+    const CompactBundleRecord& record = table<CompactBundleRecord>(arena_, layout_->bundles)[i];
+    return CertificateRange(view(arena_, record.der), record.count);
+}
+
+bool CompactBundles::find(const TrustDomain& trust_domain, CertificateRange& out) const {
+    const CompactBundleRecord* begin = table<CompactBundleRecord>(arena_, layout_->bundles);
+    const CompactBundleRecord* end = begin + layout_->bundle_count;
+    BufferView key(reinterpret_cast<const uint8_t*>(trust_domain.data()), trust_domain.size());
+
+    const CompactBundleRecord* it = std::lower_bound(begin, end, key, [&](const CompactBundleRecord& record, BufferView k) {
+        return compare(view(arena_, record.trust_domain), k) < 0;
+    });
+    if (it == end || compare(view(arena_, it->trust_domain), key) != 0) {
+        return false;
+    }
+
+    out = CertificateRange(view(arena_, it->der), it->count);
+    return true;
+}
+
+CertificateRange CompactBundles::all_certificates() const {
+    return CertificateRange(BufferView(arena_ + layout_->bundle_der, layout_->bundle_der_size),
+                            layout_->bundle_certificate_count);
+}
+
+CompactContext::CompactContext(const CompactContext& other) : layout_(other.layout_) {
+    if (other.arena_) {
+        uint8_t* arena = new uint8_t[layout_.size];
+        std::memcpy(arena, other.arena_.get(), layout_.size);
+        arena_.reset(arena);
+    }
+}
+
+CompactContext::CompactContext(CompactContext&& other) noexcept
+    : arena_(std::move(other.arena_)), layout_(other.layout_) {
+    other.layout_ = CompactLayout();
+}
+
+CompactContext& CompactContext::operator=(const CompactContext& other) {
+    if (this != &other) {
+        *this = CompactContext(other);
+    }
+    return *this;
+}
+
+CompactContext& CompactContext::operator=(CompactContext&& other) noexcept {
+    arena_ = std::move(other.arena_);
+    layout_ = other.layout_;
+    other.layout_ = CompactLayout();
+    return *this;
+}
+
+BufferView CompactContext::crl(size_t i) const {
+    return view(arena_.get(), table<CompactSpan>(arena_.get(), layout_.crls)[i]);
+}
+
+bool CompactContext::within_arena(const uint8_t* arena, const CompactLayout& layout) {
+    size_t size = layout.size;
+    if (!table_within<CompactSvidRecord>(layout.svids, layout.svid_count, size) ||
+        !table_within<CompactSpan>(layout.crls, layout.crl_count, size) ||
+        !table_within<CompactBundleRecord>(layout.bundles, layout.bundle_count, size) ||
+        !within(layout.bundle_der, layout.bundle_der_size, size)) {
+        return false;
+    }
+    auto span_within = [size](const CompactSpan& span) { return within(span.offset, span.size, size); };
+
+    const CompactSvidRecord* svids = table<CompactSvidRecord>(arena, layout.svids);
+    for (size_t i = 0; i < layout.svid_count; ++i) {
+        const CompactSvidRecord& record = svids[i];
+        if (!span_within(record.spiffe_id) || !span_within(record.x509_svid) || !span_within(record.x509_svid_key) ||
+            !span_within(record.bundle) || !span_within(record.hint)) {
+            return false;
+        }
+    }
+    const CompactSpan* crls = table<CompactSpan>(arena, layout.crls);
+    for (size_t i = 0; i < layout.crl_count; ++i) {
+        if (!span_within(crls[i])) {
+            return false;
+        }
+    }
+    const CompactBundleRecord* bundles = table<CompactBundleRecord>(arena, layout.bundles);
+    for (size_t i = 0; i < layout.bundle_count; ++i) {
+        if (!span_within(bundles[i].trust_domain) || !span_within(bundles[i].der)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CompactX509Svid CompactX509SvidContext::svid(size_t i) const {
+    const uint8_t* arena = arena_.get();
+    const CompactSvidRecord& record = table<CompactSvidRecord>(arena, layout_.svids)[i];
+
+    return CompactX509Svid{
+        .spiffe_id = view(arena, record.spiffe_id),
+        .x509_svid = CertificateRange(view(arena, record.x509_svid), record.x509_svid_count),
+        .x509_svid_key = view(arena, record.x509_svid_key),
+        .bundle = CertificateRange(view(arena, record.bundle), record.bundle_count),
+        .hint = view(arena, record.hint),
+    };
+}
+
+// Builds a compact context from decoded response fields in two passes: the first sizes the
+// arena, the second copies every field into it exactly once.
+class CompactContextBuilder {
+   public:
+    static bool build(const std::vector<ProtoX509Svid>& svids, const std::vector<proto_view>& crls,
+                      const std::vector<ProtoMapItem>& bundles, CompactContext& context) {
+        CompactLayout layout;
+        size_t size = 0;
+
+        layout.svids = size;
+        layout.svid_count = svids.size();
+        size += svids.size() * sizeof(CompactSvidRecord);
+
+        layout.crls = size;
+        layout.crl_count = crls.size();
+        size += crls.size() * sizeof(CompactSpan);
+
+        layout.bundles = size;
+        layout.bundle_count = bundles.size();
+        size += bundles.size() * sizeof(CompactBundleRecord);
+
+        for (const auto& svid : svids) {
+            if (!well_formed(svid.x509_svid.get()) || !well_formed(svid.bundle.get())) {
+                return false;
+            }
+            size += svid.spiffe_id.get().size() + certificates_prefix(svid.x509_svid.get()) +
+                    svid.x509_svid_key.get().size() + certificates_prefix(svid.bundle.get()) + svid.hint.get().size();
+        }
+        for (const auto& crl : crls) {
+            size += crl.size();
+        }
+        for (const auto& item : bundles) {
+            if (!well_formed(item.value.get())) {
+                return false;
+            }
+            size += item.key.get().size() + certificates_prefix(item.value.get());
+        }
+
+        if (size > std::numeric_limits<uint32_t>::max()) {
+            return false;
+        }
+
+        CompactContext built;
+        uint8_t* arena = size ? new uint8_t[size] : nullptr;
+        built.arena_.reset(arena);
+        size_t cursor = layout.bundles + bundles.size() * sizeof(CompactBundleRecord);
+
+        auto write = [&](const uint8_t* data, size_t length) {
+            CompactSpan span{static_cast<uint32_t>(cursor), static_cast<uint32_t>(length)};
+            if (length) {
+                std::memcpy(arena + cursor, data, length);
+            }
+            cursor += length;
+            return span;
+        };
+        auto write_certificates = [&](const proto_view& der, uint32_t& count) {
+            size_t n;
+            CompactSpan span = write(der.data(), certificates_prefix(der, n));
+            count = static_cast<uint32_t>(n);
+            return span;
+        };
+
+        CompactSvidRecord* svid_records = reinterpret_cast<CompactSvidRecord*>(arena + layout.svids);
+        for (size_t i = 0; i < svids.size(); ++i) {
+            const ProtoX509Svid& svid = svids[i];
+            CompactSvidRecord& record = svid_records[i];
+
+            record.spiffe_id = write(svid.spiffe_id.get().data(), svid.spiffe_id.get().size());
+            record.x509_svid = write_certificates(svid.x509_svid.get(), record.x509_svid_count);
+            record.x509_svid_key = write(svid.x509_svid_key.get().data(), svid.x509_svid_key.get().size());
+            record.bundle = write_certificates(svid.bundle.get(), record.bundle_count);
+            record.hint = write(svid.hint.get().data(), svid.hint.get().size());
+        }
+
+        CompactSpan* crl_records = reinterpret_cast<CompactSpan*>(arena + layout.crls);
+        for (size_t i = 0; i < crls.size(); ++i) {
+            crl_records[i] = write(crls[i].data(), crls[i].size());
+        }
+
+        // Names first, sorted for lookup. der.offset temporarily holds the source index.
+        CompactBundleRecord* bundle_records = reinterpret_cast<CompactBundleRecord*>(arena + layout.bundles);
+        for (size_t i = 0; i < bundles.size(); ++i) {
+            const proto_view& key = bundles[i].key.get();
+            bundle_records[i].trust_domain = write(key.data(), key.size());
+            bundle_records[i].der = CompactSpan{static_cast<uint32_t>(i), 0};
+            bundle_records[i].count = 0;
+        }
+
+        std::sort(bundle_records, bundle_records + bundles.size(),
+                  [&](const CompactBundleRecord& a, const CompactBundleRecord& b) {
+                      int result = compare(view(arena, a.trust_domain), view(arena, b.trust_domain));
+                      return result != 0 ? result < 0 : a.der.offset < b.der.offset;
+                  });
+
+        // A repeated map key replaces the earlier entry, as with protobuf maps
+        size_t unique = 0;
+        for (size_t i = 0; i < bundles.size(); ++i) {
+            if (unique > 0 && compare(view(arena, bundle_records[unique - 1].trust_domain),
+                                      view(arena, bundle_records[i].trust_domain)) == 0) {
+                bundle_records[unique - 1] = bundle_records[i];
+            } else {
+                bundle_records[unique++] = bundle_records[i];
+            }
+        }
+        layout.bundle_count = unique;
+
+        // Then the certificates, in table order so that walking all of them is a linear scan
+        layout.bundle_der = cursor;
+        for (size_t i = 0; i < unique; ++i) {
+            CompactBundleRecord& record = bundle_records[i];
+            record.der = write_certificates(bundles[record.der.offset].value.get(), record.count);
+            layout.bundle_certificate_count += record.count;
+        }
+        layout.bundle_der_size = cursor - layout.bundle_der;
+
+        // Repeated keys leave some slack at the end, never read
+        layout.size = size;
+        built.layout_ = layout;
+        context = std::move(built);
+        return true;
+    }
+};
+
+bool decode_compact_x509_svid_context(const uint8_t* data, size_t size, CompactX509SvidContext& context) {
+    return decode_compact_x509_svid_context(data, size, context, nullptr);
+}
+
+bool decode_compact_x509_svid_context(const uint8_t* data, size_t size, CompactX509SvidContext& context,
+                                      DecodeTiming* timing) {
+    DecodeTimer timer(timing);
+    ProtoX509SvidResponse response;
+    if (!decode_proto_message(data, size, response)) {
+        return false;
+    }
+    timer.parsed();
+
+    bool ok = CompactContextBuilder::build(response.svids.get(), response.crl.get(),
+                                           response.federated_bundles.get(), context);
+    timer.built();
+    return ok;
+}
+
+bool decode_compact_x509_bundles_context(const uint8_t* data, size_t size, CompactX509BundlesContext& context) {
+    return decode_compact_x509_bundles_context(data, size, context, nullptr);
+}
+
+bool decode_compact_x509_bundles_context(const uint8_t* data, size_t size, CompactX509BundlesContext& context,
+                                         DecodeTiming* timing) {
+    DecodeTimer timer(timing);
+    ProtoX509BundlesResponse response;
+    if (!decode_proto_message(data, size, response)) {
+        return false;
+    }
+    timer.parsed();
+
+    static const std::vector<ProtoX509Svid> no_svids;
+    bool ok = CompactContextBuilder::build(no_svids, response.crl.get(), response.bundles.get(), context);
+    timer.built();
+    return ok;
+}
+
+}  // namespace spiffe
@@ -0,0 +1,169 @@
+#include "context_decoder.h"
+
+#include <memory>
+
+#include "der.h"
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+
+namespace {
+
+// Certificates of a response share one copy of their fields, reserved to bytes. Only the
+// certificates are copied there: the views must not keep private keys (or anything else of the
+// message) in memory.
+std::shared_ptr<Buffer> make_backing(size_t bytes) {
+    auto backing = std::make_shared<Buffer>();
+    backing->reserve(bytes);
+    return backing;
+}
+
+CertificateList certificate_list(const std::shared_ptr<Buffer>& backing, const proto_view& field) {
+    size_t offset = backing->size();
+    backing->insert(backing->end(), field.begin(), field.end());
+    return CertificateList(backing, offset, field.size());
+}
+
+// Malformed certificates fail the whole message rather than shortening a chain or bundle
+bool well_formed(const proto_view& field) {
+    return well_formed_certificates(reinterpret_cast<const uint8_t*>(field.data()), field.size());
+}
+
+bool well_formed(const ProtoX509SvidResponse& response) {
+    for (const auto& svid : response.svids.get()) {
+        if (!well_formed(svid.x509_svid.get()) || !well_formed(svid.bundle.get())) {
+            return false;
+        }
+    }
+    for (const auto& item : response.federated_bundles.get()) {
+        if (!well_formed(item.value.get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool well_formed(const ProtoX509BundlesResponse& response) {
+    for (const auto& item : response.bundles.get()) {
+        if (!well_formed(item.value.get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool decode_x509_svid_context(const uint8_t* data, size_t size, X509SvidContext& context) {
+    return decode_x509_svid_context(data, size, context, nullptr);
+}
+
+bool decode_x509_svid_context(const uint8_t* data, size_t size, X509SvidContext& context, DecodeTiming* timing) {
+    DecodeTimer timer(timing);
+
+    ProtoX509SvidResponse response;
+    if (!decode_proto_message(data, size, response) || !well_formed(response)) {
+        return false;
+    }
+    timer.parsed();
+
+    size_t certificate_bytes = 0;
+    for (const auto& svid : response.svids.get()) {
+        certificate_bytes += svid.x509_svid.get().size() + svid.bundle.get().size();
+    }
+    for (const auto& item : response.federated_bundles.get()) {
+        certificate_bytes += item.value.get().size();
+    }
+    std::shared_ptr<Buffer> backing = make_backing(certificate_bytes);
+
+    for (const auto& svid : response.svids.get()) {
+        const proto_view& x509_svid = svid.x509_svid.get();
+        const proto_view& x509_svid_key = svid.x509_svid_key.get();
+        const proto_view& bundle = svid.bundle.get();
+
+        context.svids.emplace_back(X509Svid{
+            .spiffe_id = svid.spiffe_id.get().str(),
+            .x509_svid = certificate_list(backing, x509_svid),
+            .x509_svid_key = Buffer(x509_svid_key.begin(), x509_svid_key.end()),
+            .bundle = certificate_list(backing, bundle),
+            .hint = svid.hint.get().str(),
+        });
+    }
+
+    for (const auto& crl : response.crl.get()) {
+        context.crl.emplace_back(crl.begin(), crl.end());
+    }
+
+    for (const auto& item : response.federated_bundles.get()) {
+        const proto_view& bundle = item.value.get();
+        context.federated_bundles[item.key.get().str()] = certificate_list(backing, bundle);
+    }
+
+    timer.built();
+    return true;
+}
+
+bool decode_x509_bundles_context(const uint8_t* data, size_t size, X509BundlesContext& context) {
+    return decode_x509_bundles_context(data, size, context, nullptr);
+}
+
+bool decode_x509_bundles_context(const uint8_t* data, size_t size, X509BundlesContext& context,
+                                 DecodeTiming* timing) {
+    DecodeTimer timer(timing);
+
+    ProtoX509BundlesResponse response;
+    if (!decode_proto_message(data, size, response) || !well_formed(response)) {
+        return false;
+    }
+    timer.parsed();
+
+    size_t certificate_bytes = 0;
+    for (const auto& item : response.bundles.get()) {
+        certificate_bytes += item.value.get().size();
+    }
+    std::shared_ptr<Buffer> backing = make_backing(certificate_bytes);
+
+    for (const auto& crl : response.crl.get()) {
+        context.crl.emplace_back(crl.begin(), crl.end());
+    }
+
+    for (const auto& item : response.bundles.get()) {
+        const proto_view& bundle = item.value.get();
+        context.bundles[item.key.get().str()] = certificate_list(backing, bundle);
+    }
+
+    timer.built();
+    return true;
+}
+
+bool decode_jwt_bundles(const uint8_t* data, size_t size, JwtBundles& bundles) {
+    ProtoJwtBundlesResponse response;
+    if (!decode_proto_message(data, size, response)) {
+        return false;
+    }
+
+    for (const auto& item : response.bundles.get()) {
+        bundles.bundles[item.key.get().str()] = item.value.get().str();
+    }
+
+    return true;
+}
+
+bool decode_jwt_svids(const uint8_t* data, size_t size, std::vector<JwtSvid>& out) {
+    ProtoJwtSvidResponse response;
+    if (!decode_proto_message(data, size, response)) {
+        return false;
+    }
+
+    for (const auto& svid : response.svids.get()) {
+        out.emplace_back(JwtSvid{
+            .spiffe_id = svid.spiffe_id.get().str(),
+            .svid = svid.svid.get().str(),
+            .hint = svid.hint.get().str(),
+        });
+    }
+
+    return true;
+}
+
+}  // namespace spiffe
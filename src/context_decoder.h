@@ -0,0 +1,69 @@
+#pragma once
+
+#include <spiffe/compact_context.h>
+#include <spiffe/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace spiffe {
+
+// Time spent decoding X.509 messages, see Metrics::on_decode
+struct DecodeTiming {
+    std::chrono::nanoseconds proto{0};  // protobuf parsing
+    std::chrono::nanoseconds der{0};    // building the context, mostly splitting certificate lists
+};
+
+// Adds the phases of one decode to timing, does nothing (not even reading the clock) without it
+class DecodeTimer {
+   public:
+    explicit DecodeTimer(DecodeTiming* timing) : timing_(timing) {
+        if (timing_) start_ = Clock::now();
+    }
+
+    // End of the protobuf parsing
+    void parsed() {
+        if (timing_) {
+            Clock::time_point now = Clock::now();
+            timing_->proto += now - start_;
+            start_ = now;
+        }
+    }
+
+    // End of building the context, after parsed()
+    void built() {
+        if (timing_) timing_->der += Clock::now() - start_;
+    }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    DecodeTiming* timing_;
+    Clock::time_point start_;
+};
+
+// Decode Workload API response messages (without gRPC framing) into the public types.
+// Fields are decoded in place and copied exactly once, into the owned output.
+bool decode_x509_svid_context(const uint8_t* data, size_t size, X509SvidContext& context);
+bool decode_x509_bundles_context(const uint8_t* data, size_t size, X509BundlesContext& context);
+bool decode_jwt_bundles(const uint8_t* data, size_t size, JwtBundles& bundles);
+
+// Same, into a single arena allocation per update
+bool decode_compact_x509_svid_context(const uint8_t* data, size_t size, CompactX509SvidContext& context);
+bool decode_compact_x509_bundles_context(const uint8_t* data, size_t size, CompactX509BundlesContext& context);
+
+// Same, adding the time spent to timing (may be nullptr)
+bool decode_x509_svid_context(const uint8_t* data, size_t size, X509SvidContext& context, DecodeTiming* timing);
+bool decode_x509_bundles_context(const uint8_t* data, size_t size, X509BundlesContext& context,
+                                 DecodeTiming* timing);
+bool decode_compact_x509_svid_context(const uint8_t* data, size_t size, CompactX509SvidContext& context,
+                                      DecodeTiming* timing);
+bool decode_compact_x509_bundles_context(const uint8_t* data, size_t size, CompactX509BundlesContext& context,
+                                         DecodeTiming* timing);
+
+// Appends to out
+bool decode_jwt_svids(const uint8_t* data, size_t size, std::vector<JwtSvid>& out);
+
+}  // namespace spiffe
@@ -0,0 +1,248 @@
+#include "delta_tracker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
+
+#include "der.h"
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+
+namespace {
+
+int compare(const proto_view& a, const uint8_t* b, size_t b_size) {
+    size_t common = std::min(a.size(), b_size);
+    int result = common ? std::memcmp(a.data(), b, common) : 0;
+    if (result != 0) {
+        return result;
+    }
+    return a.size() < b_size ? -1 : (a.size() > b_size ? 1 : 0);
+}
+
+bool same(const Buffer& owned, const proto_view& raw) {
+    return owned.size() == raw.size() && (raw.empty() || std::memcmp(owned.data(), raw.data(), raw.size()) == 0);
+}
+
+bool same(const std::string& owned, const proto_view& raw) {
+    return compare(raw, reinterpret_cast<const uint8_t*>(owned.data()), owned.size()) == 0;
+}
+
+// The backing holds exactly the raw field, so the next update can be compared against it
+bool same(const CertificateList& owned, const proto_view& raw) {
+    return owned.backing() ? same(*owned.backing(), raw) : raw.empty();
+}
+
+// Checked before anything is applied, malformed certificates reject the whole update
+bool well_formed(const proto_view& raw) {
+    return well_formed_certificates(reinterpret_cast<const uint8_t*>(raw.data()), raw.size());
+}
+
+bool well_formed(const std::vector<ProtoMapItem>& items) {
+    return std::all_of(items.begin(), items.end(),
+                       [](const ProtoMapItem& item) { return well_formed(item.value.get()); });
+}
+
+CertificateList own_certificates(const proto_view& raw) {
+    return CertificateList(std::make_shared<const Buffer>(raw.begin(), raw.end()), 0, raw.size());
+}
+
+bool same_svid(const X509Svid& owned, const ProtoX509Svid& raw) {
+    return same(owned.x509_svid, raw.x509_svid.get()) && same(owned.x509_svid_key, raw.x509_svid_key.get()) &&
+           same(owned.bundle, raw.bundle.get());
+}
+
+X509Svid own_svid(const ProtoX509Svid& raw) {
+    const proto_view& key = raw.x509_svid_key.get();
+    return X509Svid{
+        .spiffe_id = raw.spiffe_id.get().str(),
+        .x509_svid = own_certificates(raw.x509_svid.get()),
+        .x509_svid_key = Buffer(key.begin(), key.end()),
+        .bundle = own_certificates(raw.bundle.get()),
+        .hint = raw.hint.get().str(),
+    };
+}
+
+void apply_svids(std::vector<X509Svid>& current, const std::vector<ProtoX509Svid>& items, X509SvidDelta& delta) {
+    std::vector<X509Svid> previous = std::move(current);
+    std::vector<bool> matched(previous.size(), false);
+
+    current.clear();
+    current.reserve(items.size());
+
+    // Keeps the order sent by the agent, there are rarely more than a handful of SVIDs. Kept
+    // SVIDs matched out of their previous order are a reorder.
+    size_t last_matched = 0;
+    for (const auto& item : items) {
+        size_t i = 0;
+        for (; i < previous.size(); ++i) {
+            if (!matched[i] && same(previous[i].spiffe_id, item.spiffe_id.get()) &&
+                same(previous[i].hint, item.hint.get())) {
+                break;
+            }
+        }
+
+        if (i == previous.size()) {
+            current.push_back(own_svid(item));
+            delta.added.push_back(SvidKey{current.back().spiffe_id, current.back().hint});
+            continue;
+        }
+
+        matched[i] = true;
+        if (i < last_matched) {
+            delta.reordered = true;
+        }
+        last_matched = i;
+        if (same_svid(previous[i], item)) {
+            current.push_back(std::move(previous[i]));
+        } else {
+            current.push_back(own_svid(item));
+            delta.changed.push_back(SvidKey{current.back().spiffe_id, current.back().hint});
+        }
+    }
+
+    for (size_t i = 0; i < previous.size(); ++i) {
+        if (!matched[i]) {
+            delta.removed.push_back(SvidKey{previous[i].spiffe_id, previous[i].hint});
+        }
+    }
+}
+
+bool apply_crl(std::vector<Buffer>& current, const std::vector<proto_view>& items) {
+    bool changed = current.size() != items.size();
+    for (size_t i = 0; !changed && i < items.size(); ++i) {
+        changed = !same(current[i], items[i]);
+    }
+
+    if (changed) {
+        current.clear();
+        for (const auto& item : items) {
+            current.emplace_back(item.begin(), item.end());
+        }
+    }
+    return changed;
+}
+
+// Applies a protobuf map to current in place, the last occurrence of a repeated key wins
+template <typename Value, typename Build>
+void apply_map(std::unordered_map<TrustDomain, Value>& current, const std::vector<ProtoMapItem>& items,
+               TrustDomainDelta& delta, Build build) {
+    auto key_less = [&](size_t a, size_t b) {
+        const proto_view& b_key = items[b].key.get();
+        return compare(items[a].key.get(), b_key.data(), b_key.size()) < 0;
+    };
+
+    // Items sorted by key, stable so that the last of equal keys is the one kept
+    std::vector<size_t> order(items.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), key_less);
+
+    size_t unique = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i + 1 < order.size() && !key_less(order[i], order[i + 1])) {
+            continue;
+        }
+        order[unique++] = order[i];
+    }
+    order.resize(unique);
+
+    std::string name;
+    for (size_t index : order) {
+        const proto_view& key = items[index].key.get();
+        const proto_view& value = items[index].value.get();
+        name.assign(reinterpret_cast<const char*>(key.data()), key.size());
+
+        auto it = current.find(name);
+        if (it == current.end()) {
+            current.emplace(name, build(value));
+            delta.added.push_back(name);
+        } else if (!same(it->second, value)) {
+            it->second = build(value);
+            delta.changed.push_back(name);
+        }
+    }
+
+    for (auto it = current.begin(); it != current.end();) {
+        const TrustDomain& trust_domain = it->first;
+        const uint8_t* name_data = reinterpret_cast<const uint8_t*>(trust_domain.data());
+
+        auto found = std::lower_bound(order.begin(), order.end(), trust_domain, [&](size_t index, const TrustDomain&) {
+            return compare(items[index].key.get(), name_data, trust_domain.size()) < 0;
+        });
+        if (found != order.end() && compare(items[*found].key.get(), name_data, trust_domain.size()) == 0) {
+            ++it;
+        } else {
+            delta.removed.push_back(trust_domain);
+            it = current.erase(it);
+        }
+    }
+}
+
+template <typename Delta>
+void advance_generation(uint64_t& generation, Delta& delta) {
+    if (generation == 0 || !delta.empty()) {
+        delta.generation = ++generation;
+    }
+}
+
+}  // namespace
+
+bool X509SvidTracker::apply(const uint8_t* data, size_t size, X509SvidDelta& delta, DecodeTiming* timing) {
+    DecodeTimer timer(timing);
+    ProtoX509SvidResponse response;
+    if (!decode_proto_message(data, size, response) || !well_formed(response.federated_bundles.get())) {
+        return false;
+    }
+    for (const auto& svid : response.svids.get()) {
+        if (!well_formed(svid.x509_svid.get()) || !well_formed(svid.bundle.get())) {
+            return false;
+        }
+    }
+    timer.parsed();
+
+    delta = X509SvidDelta();
+    apply_svids(context_.svids, response.svids.get(), delta);
+    delta.crl_changed = apply_crl(context_.crl, response.crl.get());
+    apply_map(context_.federated_bundles, response.federated_bundles.get(), delta.federated_bundles,
+              own_certificates);
+
+    advance_generation(generation_, delta);
+    timer.built();
+    return true;
+}
+
+bool X509BundlesTracker::apply(const uint8_t* data, size_t size, X509BundlesDelta& delta, DecodeTiming* timing) {
+    DecodeTimer timer(timing);
+    ProtoX509BundlesResponse response;
+    if (!decode_proto_message(data, size, response) || !well_formed(response.bundles.get())) {
+        return false;
+    }
+    timer.parsed();
+
+    delta = X509BundlesDelta();
+    delta.crl_changed = apply_crl(context_.crl, response.crl.get());
+    apply_map(context_.bundles, response.bundles.get(), delta.bundles, own_certificates);
+
+    advance_generation(generation_, delta);
+    timer.built();
+    return true;
+}
+
+bool JwtBundlesTracker::apply(const uint8_t* data, size_t size, JwtBundlesDelta& delta, DecodeTiming* timing) {
+    DecodeTimer timer(timing);
+    ProtoJwtBundlesResponse response;
+    if (!decode_proto_message(data, size, response)) {
+        return false;
+    }
+    timer.parsed();
+
+    delta = JwtBundlesDelta();
+    apply_map(bundles_.bundles, response.bundles.get(), delta.bundles, [](const proto_view& raw) { return raw.str(); });
+
+    advance_generation(generation_, delta);
+    timer.built();
+    return true;
+}
+
+}  // namespace spiffe
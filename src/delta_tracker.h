@@ -0,0 +1,58 @@
+#pragma once
+
+#include <spiffe/delta.h>
+#include <spiffe/types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "context_decoder.h"
+
+namespace spiffe {
+
+// Trackers keep the context of a stream across updates and apply each new response message to
+// it in place. Every SVID and trust domain is compared with the raw proto bytes it was built
+// from; byte-identical entries are kept as they are, without splitting DER or copying anything,
+// and only the entries that changed are decoded.
+//
+// Certificate lists built by a tracker own a copy of exactly their raw field, which doubles as
+// the reference for the next comparison.
+//
+// apply() returns false if the message cannot be decoded, the context is then left untouched.
+// Otherwise delta describes the differences to the previous update. Its generation is left at 0
+// when the update is identical to the previous one and should not be delivered; the first
+// update is always delivered.
+//
+// With timing, the time spent is added to it: building covers only the entries that changed.
+
+class X509SvidTracker {
+   public:
+    bool apply(const uint8_t* data, size_t size, X509SvidDelta& delta, DecodeTiming* timing = nullptr);
+    const X509SvidContext& context() const { return context_; }
+
+   private:
+    X509SvidContext context_;
+    uint64_t generation_ = 0;
+};
+
+class X509BundlesTracker {
+   public:
+    bool apply(const uint8_t* data, size_t size, X509BundlesDelta& delta, DecodeTiming* timing = nullptr);
+    const X509BundlesContext& context() const { return context_; }
+
+   private:
+    X509BundlesContext context_;
+    uint64_t generation_ = 0;
+};
+
+class JwtBundlesTracker {
+   public:
+    bool apply(const uint8_t* data, size_t size, JwtBundlesDelta& delta, DecodeTiming* timing = nullptr);
+    const JwtBundles& context() const { return bundles_; }
+
+   private:
+    JwtBundles bundles_;
+    uint64_t generation_ = 0;
+};
+
+}  // namespace spiffe
@@ -61,21 +61,55 @@ TlvResult read_der_tlv(const uint8_t* der, size_t size) {
     return TlvResult(total_len, Tlv(tag, len, rem));
 }
 
+void write_der_tlv(Buffer& out, uint8_t tag, BufferView value) {
+    out.push_back(tag);
+    if (value.size() < 0x80) {
+        out.push_back(static_cast<uint8_t>(value.size()));
+    } else {
+        // Long form, the fewest length bytes that hold the size
+        uint8_t len_len = 0;
+        for (size_t size = value.size(); size; size >>= 8) {
+            ++len_len;
+        }
+        out.push_back(0x80 | len_len);
+        for (uint8_t i = len_len; i > 0; --i) {
+            out.push_back(static_cast<uint8_t>(value.size() >> (8 * (i - 1))));
+        }
+    }
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+void write_der_unsigned(Buffer& out, BufferView magnitude) {
+    const uint8_t* begin = magnitude.begin();
+    while (begin != magnitude.end() && *begin == 0) {
+        ++begin;
+    }
+
+    // A leading 0 keeps the high bit from reading as a sign, and zero itself is one 0 byte
+    Buffer value;
+    value.reserve(static_cast<size_t>(magnitude.end() - begin) + 1);
+    if (begin == magnitude.end() || (*begin & 0x80)) {
+        value.push_back(0);
+    }
+    value.insert(value.end(), begin, magnitude.end());
+    write_der_tlv(out, 0x02, value);
+}
+
 CertificateIter::CertificateIter(const uint8_t* data, size_t size)
-    : der_data(data, data + size), current_pos(0), error_occurred(false) {}
+    : der_data(data), der_size(size), current_pos(0), error_occurred(false) {}
 
-bool CertificateIter::has_next() const { return current_pos < der_data.size() && !error_occurred; }
+bool CertificateIter::has_next() const { return current_pos < der_size && !error_occurred; }
 
 bool CertificateIter::has_error() const { return error_occurred; }
 
-Buffer CertificateIter::next() {
-    if (current_pos >= der_data.size() || error_occurred) {
+BufferView CertificateIter::next() {
+    if (current_pos >= der_size || error_occurred) {
         return {};
     }
 
     // boundary safety: we have already checked boundaries in read_der_tlv
-    const uint8_t* current_data = der_data.data() + current_pos;
-    size_t remaining_size = der_data.size() - current_pos;
+    const uint8_t* current_data = der_data + current_pos;
+    size_t remaining_size = der_size - current_pos;
 
     TlvResult result = read_der_tlv(current_data, remaining_size);
     if (!result.valid || result.tlv.tag != 0x30) {
@@ -83,25 +117,32 @@ Buffer CertificateIter::next() {
         return {};
     }
 
-    Buffer cert(current_data, current_data + result.tlv_len);
     current_pos += result.tlv_len;
-    return cert;
+    return BufferView(current_data, result.tlv_len);
 }
 
 std::vector<Buffer> CertificateIter::collect() {
     std::vector<Buffer> certs;
 
     while (has_next()) {
-        Buffer cert = next();
+        BufferView cert = next();
         if (cert.empty()) {
             break;
         }
-        certs.push_back(cert);
+        certs.push_back(cert.to_buffer());
     }
 
     return certs;
 }
 
+bool well_formed_certificates(const uint8_t* data, size_t size) {
+    CertificateIter iter(data, size);
+    while (iter.has_next()) {
+        iter.next();
+    }
+    return !iter.has_error();
+}
+
 std::vector<Buffer> extract_all_certificates(const uint8_t* data, size_t size) {
     return CertificateIter(data, size).collect();
 }
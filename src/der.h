@@ -8,13 +8,13 @@
 
 namespace spiffe {
 
-// TLV
+// TLV, value points into the parsed input
 struct Tlv {
     uint8_t tag;
-    Buffer value;
+    BufferView value;
 
     Tlv() : tag(0) {}
-    explicit Tlv(uint8_t t, size_t len, const uint8_t* data) : tag(t), value(data, data + len) {}
+    explicit Tlv(uint8_t t, size_t len, const uint8_t* data) : tag(t), value(data, len) {}
 };
 
 struct TlvResult {
@@ -28,10 +28,53 @@ struct TlvResult {
 
 TlvResult read_der_tlv(const uint8_t* der, size_t size);
 
-// Certificate Iterator
+// Appends one TLV, the content written as is
+void write_der_tlv(Buffer& out, uint8_t tag, BufferView value);
+
+// Appends an INTEGER holding the unsigned big-endian number magnitude, in minimal form
+void write_der_unsigned(Buffer& out, BufferView magnitude);
+
+// Walks the elements of a constructed value in order
+class DerReader {
+   public:
+    explicit DerReader(BufferView der) : pos_(der.data()), end_(der.data() + der.size()) {}
+
+    bool done() const { return pos_ == end_; }
+    bool peek(uint8_t tag) const { return pos_ != end_ && *pos_ == tag; }
+
+    // Reads the next element, which must have tag. value gets its content, element the whole
+    // TLV.
+    bool read(uint8_t tag, BufferView* value, BufferView* element = nullptr) {
+        TlvResult result = read_der_tlv(pos_, static_cast<size_t>(end_ - pos_));
+        if (!result.valid || result.tlv.tag != tag) {
+            return false;
+        }
+
+        if (value) {
+            *value = result.tlv.value;
+        }
+        if (element) {
+            *element = BufferView(pos_, result.tlv_len);
+        }
+        pos_ += result.tlv_len;
+        return true;
+    }
+
+    bool skip(uint8_t tag) { return read(tag, nullptr); }
+    bool skip_optional(uint8_t tag) { return !peek(tag) || skip(tag); }
+    bool skip_any() { return !done() && skip(*pos_); }
+
+   private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+};
+
+// Certificate Iterator, walks concatenated DER certificates without copying them.
+// The input must outlive the iterator and the views it returns.
 class CertificateIter {
    private:
-    Buffer der_data;
+    const uint8_t* der_data;
+    size_t der_size;
     size_t current_pos;
     bool error_occurred;
 
@@ -40,10 +83,20 @@ class CertificateIter {
 
     bool has_next() const;
     bool has_error() const;
-    Buffer next();
+
+    // Offset of the next certificate within the input
+    size_t position() const { return current_pos; }
+
+    // View of the next certificate within the input, empty at the end or on error
+    BufferView next();
+
+    // Owned copy of every remaining certificate
     std::vector<Buffer> collect();
 };
 
+// True if data is nothing but concatenated well-formed certificates, or empty
+bool well_formed_certificates(const uint8_t* data, size_t size);
+
 // Convenience functions
 std::vector<Buffer> extract_all_certificates(const uint8_t* data, size_t size);
 std::vector<Buffer> extract_all_certificates(const Buffer& der);
@@ -0,0 +1,141 @@
+#include <spiffe/event_client.h>
+
+#include "context_decoder.h"
+#include "grpc_event_client.h"
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+
+const int WorkloadApiEventClient::EVENT_READ;
+const int WorkloadApiEventClient::EVENT_WRITE;
+
+static_assert(WorkloadApiEventClient::EVENT_READ == GrpcEventClient::EVENT_READ, "event bits must match");
+static_assert(WorkloadApiEventClient::EVENT_WRITE == GrpcEventClient::EVENT_WRITE, "event bits must match");
+
+class WorkloadApiEventClient::Impl {
+   public:
+    Impl(const std::string& socket_path) {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        client_.reset(new GrpcEventClient(socket_path));
+    }
+    ~Impl() {
+        client_.reset();
+        curl_global_cleanup();
+    }
+
+    GrpcEventClient& client() { return *client_; }
+
+    // Decodes every message of a response stream into Context and hands it to callback
+    template <typename Context>
+    CallId stream(const std::string& method, Buffer request_buf,
+                  bool (*decode)(const uint8_t*, size_t, Context&), std::function<Status(const Context&)> callback,
+                  std::function<void(const Status&)> on_done) {
+        return client_->start(
+            "SpiffeWorkloadAPI", method, std::move(request_buf),
+            [decode, callback](BufferView message) {
+                Context context;
+                if (!decode(message.data(), message.size(), context)) {
+                    return GrpcStatus{
+                        .code = 13,
+                        .message = "decode gRPC response failed",
+                    };
+                }
+
+                Status status = callback(context);
+                return GrpcStatus{
+                    .code = status.code,
+                    .message = status.message,
+                };
+            },
+            [on_done](const GrpcStatus& status) {
+                on_done(Status{.code = status.code, .message = status.message});
+            },
+            DEFAULT_SPIFFE_GRPC_METADATA, std::chrono::milliseconds(0));
+    }
+
+   private:
+    std::unique_ptr<GrpcEventClient> client_;
+};
+
+WorkloadApiEventClient::WorkloadApiEventClient(const std::string& socket_path)
+    : impl_(std::make_unique<WorkloadApiEventClient::Impl>(socket_path)) {}
+WorkloadApiEventClient::~WorkloadApiEventClient() = default;
+
+WorkloadApiEventClient::WorkloadApiEventClient(WorkloadApiEventClient&&) = default;
+WorkloadApiEventClient& WorkloadApiEventClient::operator=(WorkloadApiEventClient&&) = default;
+
+void WorkloadApiEventClient::set_fd_callback(std::function<void(int fd, int events)> callback) {
+    impl_->client().set_fd_callback(std::move(callback));
+}
+
+std::vector<std::pair<int, int>> WorkloadApiEventClient::fds() const {
+    const auto& fds = impl_->client().fds();
+    return std::vector<std::pair<int, int>>(fds.begin(), fds.end());
+}
+
+long WorkloadApiEventClient::timeout_ms() const { return impl_->client().timeout_ms(); }
+
+void WorkloadApiEventClient::on_readable(int fd) { impl_->client().on_readable(fd); }
+
+void WorkloadApiEventClient::on_writable(int fd) { impl_->client().on_writable(fd); }
+
+void WorkloadApiEventClient::on_timeout() { impl_->client().on_timeout(); }
+
+WorkloadApiEventClient::CallId WorkloadApiEventClient::fetch_x509_svid(
+    std::function<Status(const X509SvidContext&)> callback, std::function<void(const Status&)> on_done) {
+    ProtoX509SvidRequest request;
+    return impl_->stream("FetchX509SVID", encode_grpc_message(request), decode_x509_svid_context, callback, on_done);
+}
+
+WorkloadApiEventClient::CallId WorkloadApiEventClient::fetch_x509_bundles(
+    std::function<Status(const X509BundlesContext&)> callback, std::function<void(const Status&)> on_done) {
+    ProtoX509BundlesRequest request;
+    return impl_->stream("FetchX509Bundles", encode_grpc_message(request), decode_x509_bundles_context, callback,
+                         on_done);
+}
+
+WorkloadApiEventClient::CallId WorkloadApiEventClient::fetch_jwt_bundles(
+    std::function<Status(const JwtBundles&)> callback, std::function<void(const Status&)> on_done) {
+    ProtoJwtBundlesRequest request;
+    return impl_->stream("FetchJWTBundles", encode_grpc_message(request), decode_jwt_bundles, callback, on_done);
+}
+
+WorkloadApiEventClient::CallId WorkloadApiEventClient::fetch_jwt_svid(
+    const std::vector<std::string>& audience, const std::string& spiffe_id,
+    std::function<void(const Status&, const std::vector<JwtSvid>&)> on_done, const std::chrono::milliseconds timeout) {
+    ProtoJwtSvidRequest request;
+    request.audience.set(audience);
+    request.spiffe_id.set(spiffe_id);
+
+    // Shared by both callbacks, a unary response carries exactly one message
+    struct Result {
+        bool has_message = false;
+        std::vector<JwtSvid> svids;
+    };
+    std::shared_ptr<Result> result = std::make_shared<Result>();
+
+    return impl_->client().start(
+        "SpiffeWorkloadAPI", "FetchJWTSVID", encode_grpc_message(request),
+        [result](BufferView message) {
+            if (result->has_message) {
+                return GrpcStatus{.code = 13, .message = "Failed to unpack gRPC message"};
+            }
+            result->has_message = true;
+            if (!decode_jwt_svids(message.data(), message.size(), result->svids)) {
+                return GrpcStatus{.code = 13, .message = "decode gRPC response failed"};
+            }
+            return GrpcStatus{};
+        },
+        [result, on_done](const GrpcStatus& status) {
+            if (status.is_ok() && !result->has_message) {
+                on_done(Status{.code = 13, .message = "Failed to unpack gRPC message"}, result->svids);
+                return;
+            }
+            on_done(Status{.code = status.code, .message = status.message}, result->svids);
+        },
+        DEFAULT_SPIFFE_GRPC_METADATA, timeout);
+}
+
+void WorkloadApiEventClient::cancel(CallId id) { impl_->client().cancel(id); }
+
+}  // namespace spiffe
@@ -1,133 +1,319 @@
 #include "grpc_client.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include "http2_client.h"
 
-#if LIBCURL_VERSION_NUM < 0x073100  // 7.49.0
-#error \
-    "cURL version is too old. Minimum required version is 7.49.0, which introduced CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE."
-#endif
-
-#ifndef CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE
-#error "CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE not defined. Please make sure cURL is built with HTTP/2 support."
+// 7.83.0 introduced curl_easy_header, which is used to read gRPC trailers. Multiplexing and
+// curl_multi_poll/curl_multi_wakeup are older than that. HTTP/2 support itself is a build-time
+// feature of libcurl and cannot be checked here, because CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE is an
+// enumerator (not a macro) in most cURL releases.
+#if LIBCURL_VERSION_NUM < 0x075300  // 7.83.0
+#error "cURL version is too old. Minimum required version is 7.83.0, which introduced curl_easy_header."
 #endif
 
 namespace spiffe {
 
 struct ResponseData {
-    Buffer data;
+    GrpcFrameAssembler assembler;
+    bool has_message = false;
+    Buffer data;  // the message, without gRPC framing
     std::vector<GrpcMetadata> headers;
     long response_code = 0;
+
+    Metrics* metrics = nullptr;
+    RpcMethod method = RpcMethod::JwtSvid;
+};
+
+struct GrpcClient::Call {
+    CURL* easy = nullptr;
+    struct curl_slist* headers = nullptr;
+    std::string url;
+    Buffer request;  // gRPC framed, CURLOPT_POSTFIELDS does not copy it
+
+    ResponseData response;     // unary calls
+    GrpcStreamData stream;     // streaming calls
+
+    CancellationToken cancellation_token;
+    std::atomic<bool> cancel_requested{false};  // set by the token, acted on by the I/O thread
+    bool polled = false;                        // the token cannot notify, check it periodically
+
+    // Fulfilled by the I/O thread once the transfer is finished and detached from the multi handle
+    std::promise<CURLcode> done;
+
+    ~Call() {
+        if (headers) curl_slist_free_all(headers);
+        if (easy) curl_easy_cleanup(easy);
+    }
 };
 
 int GrpcClient::progress_callback(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
                                   curl_off_t ulnow) {
-    const std::shared_future<void>* cancelation_token = static_cast<const std::shared_future<void>*>(clientp);
-    if (cancelation_token && cancelation_token->valid()) {
-        if (cancelation_token->wait_for(std::chrono::seconds(0)) == std::future_status::timeout) {
-            return 0;
-        }
-    }
-    return 1;  // Abort transfer
+    const CancellationToken* cancellation_token = static_cast<const CancellationToken*>(clientp);
+    return cancellation_token->is_cancelled() ? 1 : 0;  // non-zero aborts the transfer
 }
 
 size_t GrpcClient::write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
     size_t total_size = size * nmemb;
     ResponseData* response = static_cast<ResponseData*>(userp);
+    if (response->metrics) {
+        response->metrics->on_bytes_received(response->method, total_size);
+    }
 
-    const uint8_t* data = static_cast<const uint8_t*>(contents);
-    response->data.insert(response->data.end(), data, data + total_size);
+    // Unary response carries a single message, keep it (and only it) as the response data
+    bool ok = response->assembler.feed(static_cast<const uint8_t*>(contents), total_size, [&](BufferView message) {
+        if (response->has_message) {
+            return false;
+        }
+        if (response->metrics) {
+            response->metrics->on_message(response->method, message.size(), response->assembler.reassembled());
+        }
+        response->has_message = true;
+        response->data.assign(message.begin(), message.end());
+        return true;
+    });
 
-    return total_size;
+    return ok ? total_size : 0;
 }
 
-size_t GrpcClient::stream_write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
-    size_t total_size = size * nmemb;
-    StreamCallbackData* stream_data = static_cast<StreamCallbackData*>(userp);
+bool grpc_multiplex_supported() { return curl_version_info(CURLVERSION_NOW)->version_num >= 0x080000; }
 
-    const uint8_t* data = static_cast<const uint8_t*>(contents);
-    stream_data->buffer.insert(stream_data->buffer.end(), data, data + total_size);
+size_t grpc_stream_write(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t total_size = size * nmemb;
+    GrpcStreamData* stream_data = static_cast<GrpcStreamData*>(userp);
+    if (stream_data->metrics) {
+        stream_data->metrics->on_bytes_received(stream_data->method, total_size);
+    }
 
-    while (true) {
-        size_t message_size;
-        if (!GrpcFraming::has_complete_message(stream_data->buffer, message_size)) {
-            break;  // No complete message yet
+    bool ok = stream_data->assembler.feed(static_cast<const uint8_t*>(contents), total_size, [&](BufferView message) {
+        if (stream_data->metrics) {
+            stream_data->metrics->on_message(stream_data->method, message.size(),
+                                             stream_data->assembler.reassembled());
         }
+        stream_data->last_status = stream_data->on_response(message);
+        // If the callback returns an error, we can stop processing
+        return stream_data->last_status.is_ok();
+    });
 
-        // Extract the complete message
-        Buffer grpc_message(stream_data->buffer.begin(), stream_data->buffer.begin() + message_size);
-
-        // Remove processed message from buffer
-        stream_data->buffer.erase(stream_data->buffer.begin(), stream_data->buffer.begin() + message_size);
-
-        // Unpack the message
-        Buffer proto_message;
-        if (GrpcFraming::unpack_message(grpc_message, proto_message)) {
-            GrpcResponse response;
-            response.data = proto_message;
-            stream_data->last_status = stream_data->on_response(response);
-            if (!stream_data->last_status.is_ok()) {
-                // If the callback returns an error, we can stop processing
-                return 0;  // Stop further processing
-            }
-        } else {
-            // If unpacking fails, we can log or handle the error
-            stream_data->last_status = GrpcStatus{.code = 13, .message = "Failed to unpack gRPC message"};
-            // Cancel curl operation
-            return 0;
-        }
+    if (!ok && stream_data->assembler.error()) {
+        stream_data->last_status = GrpcStatus{.code = 13, .message = "Failed to unpack gRPC message"};
     }
 
-    return total_size;
+    // Returning less than total_size cancels the curl operation
+    return ok ? total_size : 0;
 }
 
-GrpcClient::GrpcClient(const std::string& socket_path) : socket_path_(socket_path), curl_(nullptr) {
-    curl_ = curl_easy_init();
-    setup_curl();
+GrpcClient::GrpcClient(const std::string& socket_path, Metrics* metrics, size_t max_message_size)
+    : socket_path_(socket_path),
+      metrics_(metrics),
+      max_message_size_(max_message_size),
+      multi_(nullptr),
+      multiplex_(false) {
+    multi_ = curl_multi_init();
+    if (!multi_) return;
+
+    // Without multiplexing every call gets its own connection, still driven by the single I/O thread
+    multiplex_ = grpc_multiplex_supported();
+
+    if (multiplex_) {
+        // All calls share one HTTP/2 connection to the agent, each call is a stream on it
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, 1L);
+    } else {
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_NOTHING);
+    }
 }
 
 GrpcClient::~GrpcClient() {
-    if (curl_) {
-        curl_easy_cleanup(curl_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
     }
-}
 
-void GrpcClient::setup_curl() {
-    if (!curl_) return;
+    if (multi_) {
+        curl_multi_wakeup(multi_);
+    }
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+}
 
+void grpc_setup_easy(CURL* curl, const std::string& socket_path, bool multiplex, const std::string& url,
+                     const Buffer& request, struct curl_slist* headers) {
     // Force HTTP/2 without upgrade (direct HTTP/2)
-    curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
 
     // Unix Domain Socket specific settings
-    curl_easy_setopt(curl_, CURLOPT_UNIX_SOCKET_PATH, socket_path_.c_str());
+    curl_easy_setopt(curl, CURLOPT_UNIX_SOCKET_PATH, socket_path.c_str());
+
+    if (multiplex) {
+        // Wait for the shared connection instead of opening a new one while it is being set up
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    } else {
+        // Connection reuse is broken on these cURL versions, see grpc_multiplex_supported
+        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+    }
 
-    // For non-HTTPS connections, forbid connection reuse to avoid cURL HTTP/2 framing issues
-    // Not used currently. We create one GrpcClient per call.
-    // curl_easy_setopt(curl_, CURLOPT_FORBID_REUSE, 1L);
+    // Largest receive buffer (CURL_MAX_READ_SIZE), large updates reach the write callback in
+    // fewer chunks and older cURL versions are less likely to stall on them
+    curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 512L * 1024);
 
     // Enable verbose output for debugging
-    // curl_easy_setopt(curl_, CURLOPT_VERBOSE, 1L);
+    // curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
 
     // Set timeout
-    curl_easy_setopt(curl_, CURLOPT_TIMEOUT, 0L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 0L);
 
     // Enable TCP keepalive
-    curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
 
     // Disable Expect: 100-continue header
-    curl_easy_setopt(curl_, CURLOPT_EXPECT_100_TIMEOUT_MS, 0L);
+    curl_easy_setopt(curl, CURLOPT_EXPECT_100_TIMEOUT_MS, 0L);
 
     // Prevent cURL from installing signal handlers
-    curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    // Request
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.data());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.size()));
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+}
+
+CURL* GrpcClient::create_easy(Call* call) {
+    CURL* curl = curl_easy_init();
+    if (!curl) return nullptr;
+
+    call->easy = curl;
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, call);
+    grpc_setup_easy(curl, socket_path_, multiplex_, call->url, call->request, call->headers);
+
+    return curl;
+}
+
+void GrpcClient::submit(const std::vector<Call*>& calls) {
+    if (calls.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            for (Call* call : calls) {
+                call->done.set_value(CURLE_ABORTED_BY_CALLBACK);
+            }
+            return;
+        }
+
+        pending_.insert(pending_.end(), calls.begin(), calls.end());
+
+        // The I/O thread is started on first use
+        if (!io_thread_.joinable()) {
+            io_thread_ = std::thread(&GrpcClient::io_loop, this);
+        }
+    }
+
+    curl_multi_wakeup(multi_);
+}
+
+CURLcode GrpcClient::wait(Call* call) {
+    std::future<CURLcode> done = call->done.get_future();
+    submit({call});
+    return done.get();
+}
+
+void GrpcClient::io_loop() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                break;
+            }
+
+            for (Call* call : pending_) {
+                if (call->cancel_requested.load(std::memory_order_acquire)) {
+                    call->done.set_value(CURLE_ABORTED_BY_CALLBACK);
+                    continue;
+                }
+                if (curl_multi_add_handle(multi_, call->easy) != CURLM_OK) {
+                    call->done.set_value(CURLE_FAILED_INIT);
+                    continue;
+                }
+                active_.push_back(call);
+            }
+            pending_.clear();
+        }
+
+        // Cancelled streams are detached at once, no need to wait for their next transfer
+        for (auto it = active_.begin(); it != active_.end();) {
+            Call* call = *it;
+            if (call->cancel_requested.load(std::memory_order_acquire)) {
+                curl_multi_remove_handle(multi_, call->easy);
+                it = active_.erase(it);
+                call->done.set_value(CURLE_ABORTED_BY_CALLBACK);
+            } else {
+                ++it;
+            }
+        }
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+
+        int msgs_left = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            CURL* easy = msg->easy_handle;
+            CURLcode result = msg->data.result;
+
+            Call* call = nullptr;
+            curl_easy_getinfo(easy, CURLINFO_PRIVATE, &call);
+            curl_multi_remove_handle(multi_, easy);
+            active_.erase(std::remove(active_.begin(), active_.end(), call), active_.end());
+
+            // The caller owns the call and may destroy it as soon as it is notified
+            call->done.set_value(result);
+        }
+
+        // Calls and cancellations arrive through curl_multi_wakeup, and curl_multi_poll already
+        // honours cURL's own timers. Only std::shared_future tokens need a periodic check, from
+        // the progress callback, which only runs when cURL drives the transfer. cURL before 8.0
+        // (see grpc_multiplex_supported) can also hold received HTTP/2 data until it is driven
+        // again, so active transfers keep the bound there.
+        bool polled = (!multiplex_ && !active_.empty()) ||
+                      std::any_of(active_.begin(), active_.end(), [](const Call* call) { return call->polled; });
+        int timeout_ms = polled ? 1000 : std::numeric_limits<int>::max();
+        curl_multi_poll(multi_, nullptr, 0, timeout_ms, nullptr);
+    }
+
+    // Client is shutting down, abort everything still in flight
+    for (Call* call : active_) {
+        curl_multi_remove_handle(multi_, call->easy);
+        call->done.set_value(CURLE_ABORTED_BY_CALLBACK);
+    }
+    active_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Call* call : pending_) {
+        call->done.set_value(CURLE_ABORTED_BY_CALLBACK);
+    }
+    pending_.clear();
 }
 
-std::string GrpcClient::build_url(const std::string& service, const std::string& method) {
+std::string grpc_url(const std::string& service, const std::string& method) {
     std::ostringstream url;
 
     // For Unix Domain Socket, use a dummy host since the socket path is set separately
@@ -136,7 +322,19 @@ std::string GrpcClient::build_url(const std::string& service, const std::string&
     return url.str();
 }
 
-struct curl_slist* GrpcClient::build_headers(const std::vector<GrpcMetadata>& metadata) {
+bool grpc_rpc_method(const std::string& method, RpcMethod& out) {
+    static const RpcMethod METHODS[] = {RpcMethod::X509Svid, RpcMethod::X509Bundles, RpcMethod::JwtBundles,
+                                        RpcMethod::JwtSvid};
+    for (RpcMethod candidate : METHODS) {
+        if (method == rpc_method_name(candidate)) {
+            out = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct curl_slist* grpc_headers(const std::vector<GrpcMetadata>& metadata) {
     struct curl_slist* headers = nullptr;
 
     // Required gRPC headers
@@ -153,60 +351,49 @@ struct curl_slist* GrpcClient::build_headers(const std::vector<GrpcMetadata>& me
     return headers;
 }
 
-GrpcResult GrpcClient::call(                    //
-    const std::string& service,                 //
-    const std::string& method,                  //
-    const Buffer& request_data,                 //
-    const std::vector<GrpcMetadata>& metadata,  //
-    const std::chrono::milliseconds timeout     //
-) {
-    if (!curl_) {
-        return GrpcResult(GrpcStatus{.code = 13, .message = "cURL not initialized"});
-    }
-
-    // Prepare gRPC framed message
-    Buffer grpc_message = GrpcFraming::pack_message(request_data);
+bool GrpcClient::prepare_unary(Call& call, const std::string& service, const std::string& method,
+                               Buffer framed_request, const std::vector<GrpcMetadata>& metadata,
+                               const std::chrono::milliseconds timeout) {
+    // Prepare request
+    call.request = std::move(framed_request);
+    call.url = grpc_url(service, method);
+    call.headers = grpc_headers(metadata);
 
-    // Setup request
-    std::string url = build_url(service, method);
-    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, grpc_message.data());
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, grpc_message.size());
+    CURL* curl = create_easy(&call);
+    if (!curl) {
+        return false;
+    }
 
-    // Setup headers
-    struct curl_slist* headers = build_headers(metadata);
-    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
+    call.response.assembler = GrpcFrameAssembler(max_message_size_);
+    if (metrics_ && grpc_rpc_method(method, call.response.method)) {
+        call.response.metrics = metrics_;
+    }
 
     // Setup response callback
-    ResponseData response_data;
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_data);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &call.response);
 
     // Unary call need a timeout
-    curl_easy_setopt(curl_, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
-
-    // Perform the request
-    CURLcode res = curl_easy_perform(curl_);
-
-    // Cleanup headers
-    curl_slist_free_all(headers);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
+    return true;
+}
 
+GrpcResult GrpcClient::unary_result(Call& call, CURLcode res) {
     if (res != CURLE_OK) {
         return GrpcResult(GrpcStatus{.code = 13, .message = curl_easy_strerror(res)});
     }
 
     // Get response code
-    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &response_data.response_code);
+    curl_easy_getinfo(call.easy, CURLINFO_RESPONSE_CODE, &call.response.response_code);
 
     // Check if HTTP response is successful
-    if (response_data.response_code != 200) {
+    if (call.response.response_code != 200) {
         return GrpcResult(
-            GrpcStatus{.code = 13, .message = "HTTP error: " + std::to_string(response_data.response_code)});
+            GrpcStatus{.code = 13, .message = "HTTP error: " + std::to_string(call.response.response_code)});
     }
 
     // Extract gRPC status
-    GrpcStatus grpc_status = extract_grpc_status(curl_);
+    GrpcStatus grpc_status = grpc_trailer_status(call.easy);
 
     // If gRPC status is not OK, return status
     if (!grpc_status.is_ok()) {
@@ -214,88 +401,156 @@ GrpcResult GrpcClient::call(                    //
     }
 
     // If successful, return response data
-    GrpcResponse response;
-
-    // Unpack gRPC message
-    Buffer proto_message;
-    if (GrpcFraming::unpack_message(response_data.data, proto_message)) {
-        response.data = proto_message;
-    } else {
+    if (!call.response.has_message || call.response.assembler.has_partial()) {
         return GrpcResult(GrpcStatus{.code = 13, .message = "Failed to unpack gRPC message"});
     }
 
+    GrpcResponse response;
+    response.data = std::move(call.response.data);
+
     return GrpcResult(response);
 }
 
-GrpcStatus GrpcClient::call_stream(                                    //
-    const std::string& service,                                        //
-    const std::string& method,                                         //
-    const Buffer& request_data,                                        //
-    const std::function<GrpcStatus(const GrpcResponse&)> on_response,  //
-    const std::vector<GrpcMetadata>& metadata,                         //
-    const std::shared_future<void> cancelation_token                   //
+GrpcResult GrpcClient::call(                    //
+    const std::string& service,                 //
+    const std::string& method,                  //
+    Buffer framed_request,                      //
+    const std::vector<GrpcMetadata>& metadata,  //
+    const std::chrono::milliseconds timeout     //
+) {
+    if (!multi_) {
+        return GrpcResult(GrpcStatus{.code = 13, .message = "cURL not initialized"});
+    }
+
+    Call call;
+    if (!prepare_unary(call, service, method, std::move(framed_request), metadata, timeout)) {
+        return GrpcResult(GrpcStatus{.code = 13, .message = "cURL not initialized"});
+    }
+
+    // Perform the request on the I/O thread
+    CURLcode res = wait(&call);
+    return unary_result(call, res);
+}
+
+std::vector<GrpcResult> GrpcClient::call_many(  //
+    const std::string& service,                 //
+    const std::string& method,                  //
+    std::vector<Buffer> framed_requests,        //
+    const std::vector<GrpcMetadata>& metadata,  //
+    const std::chrono::milliseconds timeout     //
 ) {
-    if (!curl_) {
-        return GrpcStatus{.code = 13, .message = "cURL not initialized"};
+    std::vector<GrpcResult> results(framed_requests.size(),
+                                    GrpcResult(GrpcStatus{.code = 13, .message = "cURL not initialized"}));
+    if (!multi_ || framed_requests.empty()) {
+        return results;
+    }
+
+    std::vector<std::unique_ptr<Call>> calls(framed_requests.size());
+    std::vector<std::future<CURLcode>> done(framed_requests.size());
+    std::vector<Call*> prepared;
+    prepared.reserve(framed_requests.size());
+    for (size_t i = 0; i < framed_requests.size(); ++i) {
+        calls[i].reset(new Call);
+        if (prepare_unary(*calls[i], service, method, std::move(framed_requests[i]), metadata, timeout)) {
+            done[i] = calls[i]->done.get_future();
+            prepared.push_back(calls[i].get());
+        }
     }
 
-    // Prepare gRPC framed message
-    Buffer grpc_message = GrpcFraming::pack_message(request_data);
+    // All streams are attached in the same I/O loop iteration, so their timeouts share a deadline
+    submit(prepared);
 
-    // Setup request
-    std::string url = build_url(service, method);
-    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, grpc_message.data());
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, grpc_message.size());
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (done[i].valid()) {
+            results[i] = unary_result(*calls[i], done[i].get());
+        }
+    }
+    return results;
+}
 
-    // Setup headers
-    struct curl_slist* headers = build_headers(metadata);
-    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
+GrpcStatus GrpcClient::call_stream(                             //
+    const std::string& service,                                 //
+    const std::string& method,                                  //
+    Buffer framed_request,                                      //
+    const std::function<GrpcStatus(BufferView)> on_response,    //
+    const std::vector<GrpcMetadata>& metadata,                  //
+    const CancellationToken& cancellation_token                 //
+) {
+    if (!multi_) {
+        return GrpcStatus{.code = 13, .message = "cURL not initialized"};
+    }
 
-    // Setup streaming callback
-    StreamCallbackData stream_data;
-    stream_data.on_response = on_response;
+    // Prepare request
+    Call call;
+    call.request = std::move(framed_request);
+    call.url = grpc_url(service, method);
+    call.headers = grpc_headers(metadata);
+    call.cancellation_token = cancellation_token;
 
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, stream_write_callback);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &stream_data);
+    CURL* curl = create_easy(&call);
+    if (!curl) {
+        return GrpcStatus{.code = 13, .message = "cURL not initialized"};
+    }
+
+    // Setup streaming callback
+    call.stream.on_response = on_response;
+    call.stream.assembler = GrpcFrameAssembler(max_message_size_);
+    if (metrics_ && grpc_rpc_method(method, call.stream.method)) {
+        call.stream.metrics = metrics_;
+    }
 
-    // Setup cancellation
-    curl_easy_setopt(curl_, CURLOPT_XFERINFOFUNCTION, progress_callback);
-    curl_easy_setopt(curl_, CURLOPT_XFERINFODATA, &cancelation_token);
-    curl_easy_setopt(curl_, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, grpc_stream_write);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &call.stream);
+
+    // Setup cancellation, the call outlives the subscription
+    uint64_t subscription = call.cancellation_token.subscribe([this, &call] {
+        call.cancel_requested.store(true, std::memory_order_release);
+        curl_multi_wakeup(multi_);
+    });
+    if (call.cancellation_token.can_cancel() && !call.cancellation_token.can_notify()) {
+        call.polled = true;
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress_callback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &call.cancellation_token);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
 
-    // Perform the request
-    CURLcode res = curl_easy_perform(curl_);
+    // Perform the request on the I/O thread
+    CURLcode res = wait(&call);
+    call.cancellation_token.unsubscribe(subscription);
 
-    // Cleanup headers
-    curl_slist_free_all(headers);
+    return grpc_stream_status(curl, res, call.stream);
+}
 
-    if (!stream_data.last_status.is_ok()) {
+GrpcStatus grpc_stream_status(CURL* curl, CURLcode result, const GrpcStreamData& stream) {
+    if (!stream.last_status.is_ok()) {
         // If the last status is not OK, return it
-        return stream_data.last_status;
+        return stream.last_status;
     }
 
-    if (res != CURLE_OK) {
-        if (res == CURLE_ABORTED_BY_CALLBACK) {
+    if (result != CURLE_OK) {
+        if (result == CURLE_ABORTED_BY_CALLBACK) {
             return GrpcStatus{.code = 1, .message = "user cancelled"};
         }
-        return GrpcStatus{.code = 13, .message = curl_easy_strerror(res)};
+        return GrpcStatus{.code = 13, .message = curl_easy_strerror(result)};
     }
 
     // Check HTTP response code
     long response_code;
-    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &response_code);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
 
     if (response_code != 200) {
         return GrpcStatus{.code = 13, .message = "HTTP error: " + std::to_string(response_code)};
     }
 
     // Extract and return gRPC status
-    return extract_grpc_status(curl_);
+    GrpcStatus grpc_status = grpc_trailer_status(curl);
+    if (grpc_status.is_ok() && stream.assembler.has_partial()) {
+        return GrpcStatus{.code = 13, .message = "Stream ended inside a gRPC message"};
+    }
+    return grpc_status;
 }
 
-GrpcStatus GrpcClient::extract_grpc_status(CURL* curl) {
+GrpcStatus grpc_trailer_status(CURL* curl) {
     if (!curl) {
         return GrpcStatus{.code = 13, .message = "cURL not initialized"};
     }
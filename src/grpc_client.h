@@ -1,13 +1,18 @@
 #pragma once
 
 #include <curl/curl.h>
+#include <spiffe/cancellation.h>
+#include <spiffe/metrics.h>
 #include <spiffe/types.h>
 
+#include "http2_client.h"
+
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace spiffe {
@@ -44,56 +49,131 @@ struct GrpcResult {
     GrpcResult(const GrpcStatus& stat) : has_response(false), status(stat) {}
 };
 
+// Metadata the agent requires on every Workload API call
+extern const std::vector<GrpcMetadata> DEFAULT_SPIFFE_GRPC_METADATA;
+
+// Building blocks shared by GrpcClient and GrpcEventClient
+
+// cURL before 8.0.0 fails with "Error in the HTTP2 framing layer" when a second stream is opened
+// on a reused prior-knowledge connection, calls need one connection each there
+bool grpc_multiplex_supported();
+
+std::string grpc_url(const std::string& service, const std::string& method);
+
+// Workload API method by gRPC method name, false for any other method
+bool grpc_rpc_method(const std::string& method, RpcMethod& out);
+struct curl_slist* grpc_headers(const std::vector<GrpcMetadata>& metadata);
+
+// Configures curl for one call over the agent socket. url, request (gRPC framed) and headers
+// must outlive the transfer.
+void grpc_setup_easy(CURL* curl, const std::string& socket_path, bool multiplex, const std::string& url,
+                     const Buffer& request, struct curl_slist* headers);
+
+// State of one streaming call, CURLOPT_WRITEDATA for grpc_stream_write
+struct GrpcStreamData {
+    std::function<GrpcStatus(BufferView)> on_response;
+    GrpcStatus last_status;  // for user to filling last status, and passing to original call_stream result
+
+    GrpcFrameAssembler assembler;
+
+    // Optional, receives the bytes and messages of the call
+    Metrics* metrics = nullptr;
+    RpcMethod method = RpcMethod::X509Svid;
+};
+
+size_t grpc_stream_write(void* contents, size_t size, size_t nmemb, void* userp);
+
+// Status from the grpc-status and grpc-message trailers
+GrpcStatus grpc_trailer_status(CURL* curl);
+
+// Final status of a finished streaming call
+GrpcStatus grpc_stream_status(CURL* curl, CURLcode result, const GrpcStreamData& stream);
+
+// GrpcClient owns a single HTTP/2 connection to the agent socket. Every call, unary or
+// streaming, becomes one HTTP/2 stream on that connection, and all of them are driven by
+// one internal I/O thread built on a curl multi handle. cURL releases that cannot multiplex
+// prior-knowledge connections get one connection per call instead, see the constructor.
+//
+// call(), call_many() and call_stream() are thread-safe and block the calling thread until the RPC
+// finishes. Streaming callbacks are invoked on the I/O thread, so they must not block on
+// another call made through the same client.
+//
+// Cancelling a stream wakes the I/O thread, which detaches it right away. While no stream
+// uses a polled std::shared_future token, the I/O thread sleeps until there is traffic.
+//
+// With metrics, bytes and messages received by Workload API calls are reported to it from the
+// I/O thread.
 class GrpcClient {
    public:
-    GrpcClient(const std::string& socket_path);
+    GrpcClient(const std::string& socket_path, Metrics* metrics = nullptr,
+               size_t max_message_size = ClientOptions().max_message_size);
     ~GrpcClient();
 
     // Disable copy
     GrpcClient(const GrpcClient&) = delete;
     GrpcClient& operator=(const GrpcClient&) = delete;
 
+    // Request bodies are already framed, e.g. by encode_grpc_message, and are sent as they are
+
     // Unary call - returns either response or status
     GrpcResult call(                                //
         const std::string& service,                 //
         const std::string& method,                  //
-        const Buffer& request_data,                 //
+        Buffer framed_request,                      //
+        const std::vector<GrpcMetadata>& metadata,  //
+        const std::chrono::milliseconds timeout     //
+    );
+
+    // Unary calls of one method, issued together as concurrent streams on the shared connection
+    // instead of one round trip after the other. timeout bounds the whole batch. Returns one
+    // result per request, in order.
+    std::vector<GrpcResult> call_many(              //
+        const std::string& service,                 //
+        const std::string& method,                  //
+        std::vector<Buffer> framed_requests,        //
         const std::vector<GrpcMetadata>& metadata,  //
         const std::chrono::milliseconds timeout     //
     );
 
     // Server streaming call - returns final status
-    GrpcStatus call_stream(                                                //
-        const std::string& service,                                        //
-        const std::string& method,                                         //
-        const Buffer& request_data,                                        //
-        const std::function<GrpcStatus(const GrpcResponse&)> on_response,  //
-        const std::vector<GrpcMetadata>& metadata,                         //
-        const std::shared_future<void> cancelation_token                   //
+    // on_response gets each message without its gRPC header, valid only during the call
+    GrpcStatus call_stream(                                         //
+        const std::string& service,                                 //
+        const std::string& method,                                  //
+        Buffer framed_request,                                      //
+        const std::function<GrpcStatus(BufferView)> on_response,    //
+        const std::vector<GrpcMetadata>& metadata,                  //
+        const CancellationToken& cancellation_token                 //
     );
 
    private:
-    std::string socket_path_;
-    CURL* curl_;
-
-    void setup_curl();
-    std::string build_url(const std::string& service, const std::string& method);
-    struct curl_slist* build_headers(const std::vector<GrpcMetadata>& metadata);
-    GrpcStatus extract_grpc_status(CURL* curl);
+    // One in-flight RPC, i.e. one easy handle / HTTP/2 stream
+    struct Call;
 
-    // Callback data structure for streaming
-    struct StreamCallbackData {
-        std::function<GrpcStatus(const GrpcResponse&)> on_response;
-        GrpcStatus last_status;  // for user to filling last status, and passing to original call_stream result
-
-        Buffer buffer;
-        bool in_message = false;
-        uint32_t message_length = 0;
-        size_t bytes_read = 0;
-    };
+    std::string socket_path_;
+    Metrics* metrics_;
+    size_t max_message_size_;
+    CURLM* multi_;
+    bool multiplex_;
+
+    // Guards everything below, shared between callers and the I/O thread
+    std::mutex mutex_;
+    std::vector<Call*> pending_;  // submitted, not yet attached to multi_
+    bool stopping_ = false;
+    std::thread io_thread_;
+
+    // Owned by the I/O thread
+    std::vector<Call*> active_;
+
+    CURL* create_easy(Call* call);
+    bool prepare_unary(Call& call, const std::string& service, const std::string& method, Buffer framed_request,
+                       const std::vector<GrpcMetadata>& metadata, const std::chrono::milliseconds timeout);
+    GrpcResult unary_result(Call& call, CURLcode res);
+    void submit(const std::vector<Call*>& calls);
+    CURLcode wait(Call* call);
+    void io_loop();
 
     static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp);
-    static size_t stream_write_callback(void* contents, size_t size, size_t nmemb, void* userp);
     static int progress_callback(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
                                  curl_off_t ulnow);
 };
@@ -0,0 +1,279 @@
+#include "grpc_event_client.h"
+
+#include <algorithm>
+
+namespace spiffe {
+
+struct GrpcEventClient::Call {
+    CallId id = 0;
+    CURL* easy = nullptr;
+    struct curl_slist* headers = nullptr;
+    std::string url;
+    Buffer request;  // gRPC framed, CURLOPT_POSTFIELDS does not copy it
+
+    GrpcStreamData stream;
+    DoneCallback on_done;
+
+    bool attached = false;  // added to the multi handle
+    bool cancelled = false;
+
+    ~Call() {
+        if (headers) curl_slist_free_all(headers);
+        if (easy) curl_easy_cleanup(easy);
+    }
+};
+
+const int GrpcEventClient::EVENT_READ;
+const int GrpcEventClient::EVENT_WRITE;
+
+GrpcEventClient::GrpcEventClient(const std::string& socket_path)
+    : socket_path_(socket_path), multi_(nullptr), multiplex_(false) {
+    multi_ = curl_multi_init();
+    if (!multi_) return;
+
+    multiplex_ = grpc_multiplex_supported();
+    if (multiplex_) {
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, 1L);
+    } else {
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_NOTHING);
+    }
+
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, socket_callback);
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, timer_callback);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+}
+
+GrpcEventClient::~GrpcEventClient() {
+    // The sockets are closed below, the host loop is not told about it
+    fd_callback_ = nullptr;
+
+    for (auto& entry : calls_) {
+        if (entry.second->attached) {
+            curl_multi_remove_handle(multi_, entry.second->easy);
+        }
+    }
+    calls_.clear();
+
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+}
+
+int GrpcEventClient::socket_callback(CURL*, curl_socket_t fd, int what, void* userp, void*) {
+    GrpcEventClient* self = static_cast<GrpcEventClient*>(userp);
+
+    int events = 0;
+    switch (what) {
+        case CURL_POLL_IN:
+            events = EVENT_READ;
+            break;
+        case CURL_POLL_OUT:
+            events = EVENT_WRITE;
+            break;
+        case CURL_POLL_INOUT:
+            events = EVENT_READ | EVENT_WRITE;
+            break;
+        default:  // CURL_POLL_REMOVE
+            break;
+    }
+
+    if (events) {
+        self->fds_[fd] = events;
+    } else {
+        self->fds_.erase(fd);
+    }
+
+    if (self->fd_callback_) {
+        self->fd_callback_(fd, events);
+    }
+    return 0;
+}
+
+int GrpcEventClient::timer_callback(CURLM*, long timeout_ms, void* userp) {
+    GrpcEventClient* self = static_cast<GrpcEventClient*>(userp);
+
+    self->timer_armed_ = timeout_ms >= 0;
+    if (self->timer_armed_) {
+        self->deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+    return 0;
+}
+
+long GrpcEventClient::timeout_ms() const {
+    if (!timer_armed_) {
+        return -1;
+    }
+
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline_ - std::chrono::steady_clock::now());
+    return std::max<long>(static_cast<long>(remaining.count()), 0);
+}
+
+void GrpcEventClient::on_readable(int fd) {
+    socket_action(fd, CURL_CSELECT_IN);
+    complete();
+}
+
+void GrpcEventClient::on_writable(int fd) {
+    socket_action(fd, CURL_CSELECT_OUT);
+    complete();
+}
+
+void GrpcEventClient::on_timeout() {
+    timer_armed_ = false;
+    socket_action(CURL_SOCKET_TIMEOUT, 0);
+    complete();
+}
+
+GrpcEventClient::CallId GrpcEventClient::start(           //
+    const std::string& service,                           //
+    const std::string& method,                            //
+    Buffer framed_request,                                //
+    std::function<GrpcStatus(BufferView)> on_message,     //
+    DoneCallback on_done,                                 //
+    const std::vector<GrpcMetadata>& metadata,            //
+    std::chrono::milliseconds timeout                     //
+) {
+    if (!multi_) {
+        return 0;
+    }
+
+    std::unique_ptr<Call> call(new Call);
+    call->id = next_id_++;
+    call->request = std::move(framed_request);
+    call->url = grpc_url(service, method);
+    call->headers = grpc_headers(metadata);
+    call->on_done = std::move(on_done);
+
+    call->easy = curl_easy_init();
+    if (!call->easy) {
+        return 0;
+    }
+
+    CURL* curl = call->easy;
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, call.get());
+    grpc_setup_easy(curl, socket_path_, multiplex_, call->url, call->request, call->headers);
+
+    // Messages still buffered in the current chunk are dropped once the call is cancelled
+    Call* raw = call.get();
+    call->stream.on_response = [raw, on_message](BufferView message) {
+        if (raw->cancelled) {
+            return GrpcStatus{.code = 1, .message = "user cancelled"};
+        }
+        return on_message(message);
+    };
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, grpc_stream_write);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &call->stream);
+
+    if (timeout.count() > 0) {
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
+    }
+
+    CallId id = call->id;
+    calls_.emplace(id, std::move(call));
+
+    if (dispatching_) {
+        deferred_start_.push_back(id);
+    } else {
+        attach(raw);
+    }
+    return id;
+}
+
+void GrpcEventClient::attach(Call* call) {
+    if (curl_multi_add_handle(multi_, call->easy) == CURLM_OK) {
+        call->attached = true;
+        return;
+    }
+
+    // Reported through the regular completion path, on_done never runs inside start()
+    call->cancelled = true;
+    call->stream.last_status = GrpcStatus{.code = 13, .message = "cURL not initialized"};
+    deferred_cancel_.push_back(call->id);
+    timer_armed_ = true;
+    deadline_ = std::chrono::steady_clock::now();
+}
+
+void GrpcEventClient::cancel(CallId id) {
+    auto it = calls_.find(id);
+    if (it == calls_.end() || it->second->cancelled) {
+        return;
+    }
+
+    it->second->cancelled = true;
+    deferred_cancel_.push_back(id);
+
+    if (!dispatching_) {
+        complete();
+    }
+}
+
+void GrpcEventClient::finish(std::map<CallId, std::unique_ptr<Call>>::iterator it, const GrpcStatus& status,
+                             std::vector<std::pair<std::unique_ptr<Call>, GrpcStatus>>& finished) {
+    std::unique_ptr<Call> call = std::move(it->second);
+    calls_.erase(it);
+
+    if (call->attached) {
+        curl_multi_remove_handle(multi_, call->easy);
+        call->attached = false;
+    }
+    finished.emplace_back(std::move(call), status);
+}
+
+void GrpcEventClient::socket_action(curl_socket_t fd, int ev_bitmask) {
+    int running = 0;
+    dispatching_ = true;
+    curl_multi_socket_action(multi_, fd, ev_bitmask, &running);
+    dispatching_ = false;
+}
+
+void GrpcEventClient::complete() {
+    std::vector<std::pair<std::unique_ptr<Call>, GrpcStatus>> finished;
+
+    int msgs_left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        Call* call = nullptr;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &call);
+
+        GrpcStatus status = grpc_stream_status(msg->easy_handle, msg->data.result, call->stream);
+        if (call->cancelled && call->stream.last_status.is_ok()) {
+            status = GrpcStatus{.code = 1, .message = "user cancelled"};
+        }
+        finish(calls_.find(call->id), status, finished);
+    }
+
+    for (CallId id : deferred_cancel_) {
+        auto it = calls_.find(id);
+        if (it != calls_.end()) {
+            GrpcStatus status = it->second->stream.last_status;
+            if (status.is_ok()) {
+                status = GrpcStatus{.code = 1, .message = "user cancelled"};
+            }
+            finish(it, status, finished);
+        }
+    }
+    deferred_cancel_.clear();
+
+    std::vector<CallId> deferred_start;
+    deferred_start.swap(deferred_start_);
+    for (CallId id : deferred_start) {
+        auto it = calls_.find(id);
+        if (it != calls_.end() && !it->second->attached) {
+            attach(it->second.get());
+        }
+    }
+
+    // Callbacks last, they may start and cancel calls
+    for (auto& entry : finished) {
+        if (entry.first->on_done) {
+            entry.first->on_done(entry.second);
+        }
+    }
+}
+
+}  // namespace spiffe
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <curl/curl.h>
+#include <spiffe/types.h>
+
+#include "grpc_client.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spiffe {
+
+// Non-blocking counterpart of GrpcClient for hosts that run their own event loop, built on the
+// cURL multi-socket API. It owns no thread and never blocks: the host watches the sockets
+// reported through fds() or the fd callback, waits at most timeout_ms(), and then calls
+// on_readable(), on_writable() or on_timeout(). Message and completion callbacks run inside
+// those calls, on the host's thread.
+//
+// Not thread-safe, all methods must be called from the host loop. Callbacks may start and
+// cancel calls, the fd callback must not call back into the client.
+class GrpcEventClient {
+   public:
+    static const int EVENT_READ = 1;
+    static const int EVENT_WRITE = 2;
+
+    using CallId = uint64_t;
+    using FdCallback = std::function<void(int fd, int events)>;
+    using DoneCallback = std::function<void(const GrpcStatus&)>;
+
+    GrpcEventClient(const std::string& socket_path);
+
+    // Drops in-flight calls without invoking their callbacks
+    ~GrpcEventClient();
+
+    // Disable copy
+    GrpcEventClient(const GrpcEventClient&) = delete;
+    GrpcEventClient& operator=(const GrpcEventClient&) = delete;
+
+    // Called whenever the client starts, changes or stops (events == 0) watching fd
+    void set_fd_callback(FdCallback callback) { fd_callback_ = std::move(callback); }
+
+    // Watched fds and their events
+    const std::map<int, int>& fds() const { return fds_; }
+
+    // Milliseconds until on_timeout() is due, 0 if it is due now, -1 if no timer is armed
+    long timeout_ms() const;
+
+    void on_readable(int fd);
+    void on_writable(int fd);
+    void on_timeout();
+
+    // Starts a call. on_message gets each message without its gRPC header, valid only during the
+    // callback; returning an error ends the call with it. on_done runs exactly once with the
+    // final status, also after cancel(). timeout of 0 means none. framed_request is sent as it
+    // is, see encode_grpc_message.
+    // Returns 0 if the call could not be created.
+    CallId start(                                                 //
+        const std::string& service,                               //
+        const std::string& method,                                //
+        Buffer framed_request,                                    //
+        std::function<GrpcStatus(BufferView)> on_message,         //
+        DoneCallback on_done,                                     //
+        const std::vector<GrpcMetadata>& metadata,                //
+        std::chrono::milliseconds timeout                         //
+    );
+
+    // on_done runs with code 1, no-op for calls that already finished
+    void cancel(CallId id);
+
+    size_t active_calls() const { return calls_.size(); }
+
+   private:
+    struct Call;
+
+    std::string socket_path_;
+    CURLM* multi_;
+    bool multiplex_;
+
+    CallId next_id_ = 1;
+    std::map<CallId, std::unique_ptr<Call>> calls_;
+
+    // Inside curl_multi_socket_action, where handles must not be added or removed
+    bool dispatching_ = false;
+    std::vector<CallId> deferred_start_;
+    std::vector<CallId> deferred_cancel_;
+
+    FdCallback fd_callback_;
+    std::map<int, int> fds_;
+
+    bool timer_armed_ = false;
+    std::chrono::steady_clock::time_point deadline_;
+
+    void socket_action(curl_socket_t fd, int ev_bitmask);
+
+    // Detaches finished and cancelled calls, attaches deferred ones, then runs on_done callbacks
+    void complete();
+    void attach(Call* call);
+    void finish(std::map<CallId, std::unique_ptr<Call>>::iterator it, const GrpcStatus& status,
+                std::vector<std::pair<std::unique_ptr<Call>, GrpcStatus>>& finished);
+
+    static int socket_callback(CURL* easy, curl_socket_t fd, int what, void* userp, void* socketp);
+    static int timer_callback(CURLM* multi, long timeout_ms, void* userp);
+};
+
+}  // namespace spiffe
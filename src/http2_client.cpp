@@ -6,20 +6,10 @@
 
 namespace spiffe {
 
-const size_t GRPC_FRAME_HEADER_LEN = 1 + sizeof(uint32_t);
-
 Buffer GrpcFraming::pack_message(const Buffer& message) {
     Buffer result;
     result.resize(GRPC_FRAME_HEADER_LEN + message.size());
-
-    // gRPC message format:
-    // 1 byte: compressed flag (0 = not compressed)
-    result[0] = 0;
-
-    // 4 bytes: message length (big-endian)
-    // TODO: Handle messages larger than 4GB if needed
-    const uint32_t length = htonl(static_cast<uint32_t>(message.size()));
-    std::memcpy(&result[1], &length, sizeof(length));
+    write_header(result.data(), message.size());
 
     // Message data
     if (!message.empty()) {
@@ -29,6 +19,17 @@ Buffer GrpcFraming::pack_message(const Buffer& message) {
     return result;
 }
 
+void GrpcFraming::write_header(uint8_t* header, size_t message_size) {
+    // gRPC message format:
+    // 1 byte: compressed flag (0 = not compressed)
+    header[0] = 0;
+
+    // 4 bytes: message length (big-endian)
+    // TODO: Handle messages larger than 4GB if needed
+    const uint32_t length = htonl(static_cast<uint32_t>(message_size));
+    std::memcpy(header + 1, &length, sizeof(length));
+}
+
 bool GrpcFraming::unpack_message(const Buffer& grpc_data, Buffer& message) {
     if (grpc_data.size() < GRPC_FRAME_HEADER_LEN) {
         return false;
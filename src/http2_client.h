@@ -1,15 +1,25 @@
 #pragma once
 
+#include <spiffe/spiffe.h>
 #include <spiffe/types.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
 namespace spiffe {
 
+const size_t GRPC_FRAME_HEADER_LEN = 1 + sizeof(uint32_t);
+
 // gRPC message framing utilities
 class GrpcFraming {
    public:
     // Pack protobuf message with gRPC framing (5-byte header + message)
     static Buffer pack_message(const Buffer& message);
 
+    // Writes the 5-byte header of an uncompressed message of message_size bytes at header
+    static void write_header(uint8_t* header, size_t message_size);
+
     // Unpack gRPC message (remove 5-byte header)
     // user must ensure grpc_data contains a complete message
     static bool unpack_message(const Buffer& grpc_data, Buffer& message);
@@ -18,4 +28,127 @@ class GrpcFraming {
     static bool has_complete_message(const Buffer& buffer, size_t& message_size);
 };
 
+// Reassembles gRPC messages from the chunks of a response body, as handed out by cURL.
+//
+// Messages that arrive whole within one chunk are passed to the callback straight out of the
+// chunk, without copying. Only a message split across chunks is buffered, in a buffer reserved
+// once for the size announced by its 5-byte header. That size is checked against
+// max_message_size first, a larger message is an error.
+class GrpcFrameAssembler {
+   public:
+    explicit GrpcFrameAssembler(size_t max_message_size = ClientOptions().max_message_size)
+        : max_message_size_(max_message_size) {}
+
+    // on_message is called as bool(BufferView message) with the message without its header,
+    // valid only during the call. Returning false stops feeding.
+    //
+    // Returns false if on_message returned false or a frame is malformed, see error().
+    template <typename OnMessage>
+    bool feed(const uint8_t* data, size_t size, OnMessage&& on_message);
+
+    // A message has started but not completed
+    bool has_partial() const { return header_len_ > 0; }
+
+    // Set when feed() failed because of a malformed frame (e.g. compressed, or larger than
+    // max_message_size)
+    bool error() const { return error_; }
+
+    // Whether the message being handed to on_message spanned several chunks and was copied
+    // together, valid inside on_message
+    bool reassembled() const { return reassembled_; }
+
+   private:
+    size_t max_message_size_;
+    uint8_t header_[5];
+    size_t header_len_ = 0;  // header bytes buffered for the current message, 5 once complete
+    uint32_t message_len_ = 0;
+    Buffer message_;  // partial message body
+    bool error_ = false;
+    bool reassembled_ = false;
+
+    bool parse_header(const uint8_t* header);
+};
+
+inline bool GrpcFrameAssembler::parse_header(const uint8_t* header) {
+    // Compressed messages are not supported
+    if (header[0] != 0) {
+        error_ = true;
+        return false;
+    }
+
+    message_len_ = (static_cast<uint32_t>(header[1]) << 24) | (static_cast<uint32_t>(header[2]) << 16) |
+                   (static_cast<uint32_t>(header[3]) << 8) | static_cast<uint32_t>(header[4]);
+    if (message_len_ > max_message_size_) {
+        error_ = true;
+        return false;
+    }
+    return true;
+}
+
+template <typename OnMessage>
+bool GrpcFrameAssembler::feed(const uint8_t* data, size_t size, OnMessage&& on_message) {
+    if (error_) {
+        return false;
+    }
+
+    while (size > 0) {
+        if (header_len_ == 0 && size >= GRPC_FRAME_HEADER_LEN) {
+            // Fast path, the header is in this chunk
+            if (!parse_header(data)) {
+                return false;
+            }
+            data += GRPC_FRAME_HEADER_LEN;
+            size -= GRPC_FRAME_HEADER_LEN;
+
+            if (size >= message_len_) {
+                // Whole message is in this chunk, hand it out in place
+                BufferView message(data, message_len_);
+                data += message_len_;
+                size -= message_len_;
+                reassembled_ = false;
+                if (!on_message(message)) {
+                    return false;
+                }
+                continue;
+            }
+
+            header_len_ = GRPC_FRAME_HEADER_LEN;
+            message_.clear();
+            message_.reserve(message_len_);
+        } else if (header_len_ < GRPC_FRAME_HEADER_LEN) {
+            // Header split across chunks
+            size_t take = std::min(GRPC_FRAME_HEADER_LEN - header_len_, size);
+            std::copy(data, data + take, header_ + header_len_);
+            header_len_ += take;
+            data += take;
+            size -= take;
+
+            if (header_len_ < GRPC_FRAME_HEADER_LEN) {
+                return true;
+            }
+            if (!parse_header(header_)) {
+                return false;
+            }
+            message_.clear();
+            message_.reserve(message_len_);
+        }
+
+        // Continue a partial message
+        size_t take = std::min(static_cast<size_t>(message_len_) - message_.size(), size);
+        message_.insert(message_.end(), data, data + take);
+        data += take;
+        size -= take;
+
+        if (message_.size() == message_len_) {
+            header_len_ = 0;
+            reassembled_ = true;
+            if (!on_message(BufferView(message_))) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 }  // namespace spiffe
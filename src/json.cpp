@@ -0,0 +1,303 @@
+#include "json.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace spiffe {
+
+const int JSON_MAX_DEPTH = 64;
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    if (type != Type::Object) {
+        return nullptr;
+    }
+    for (const auto& member : object) {
+        if (member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+namespace {
+
+class JsonParser {
+   public:
+    JsonParser(const char* data, size_t size) : cur_(data), end_(data + size) {}
+
+    bool parse_document(JsonValue& out) {
+        if (!parse_value(out, 0)) {
+            return false;
+        }
+        skip_whitespace();
+        return cur_ == end_;
+    }
+
+   private:
+    const char* cur_;
+    const char* end_;
+
+    void skip_whitespace() {
+        while (cur_ < end_ && (*cur_ == ' ' || *cur_ == '\t' || *cur_ == '\n' || *cur_ == '\r')) {
+            ++cur_;
+        }
+    }
+
+    bool consume(char c) {
+        skip_whitespace();
+        if (cur_ < end_ && *cur_ == c) {
+            ++cur_;
+            return true;
+        }
+        return false;
+    }
+
+    bool consume_literal(const char* literal) {
+        size_t len = std::strlen(literal);
+        if (static_cast<size_t>(end_ - cur_) < len || std::memcmp(cur_, literal, len) != 0) {
+            return false;
+        }
+        cur_ += len;
+        return true;
+    }
+
+    bool parse_value(JsonValue& out, int depth) {
+        if (depth > JSON_MAX_DEPTH) {
+            return false;
+        }
+
+        skip_whitespace();
+        if (cur_ >= end_) {
+            return false;
+        }
+
+        switch (*cur_) {
+            case '{':
+                return parse_object(out, depth);
+            case '[':
+                return parse_array(out, depth);
+            case '"':
+                out.type = JsonValue::Type::String;
+                return parse_string(out.string);
+            case 't':
+                out.type = JsonValue::Type::Bool;
+                out.boolean = true;
+                return consume_literal("true");
+            case 'f':
+                out.type = JsonValue::Type::Bool;
+                out.boolean = false;
+                return consume_literal("false");
+            case 'n':
+                out.type = JsonValue::Type::Null;
+                return consume_literal("null");
+            default:
+                out.type = JsonValue::Type::Number;
+                return parse_number(out.number);
+        }
+    }
+
+    bool parse_object(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Object;
+        ++cur_;  // '{'
+
+        if (consume('}')) {
+            return true;
+        }
+
+        while (true) {
+            skip_whitespace();
+            std::string key;
+            if (cur_ >= end_ || *cur_ != '"' || !parse_string(key)) {
+                return false;
+            }
+            if (!consume(':')) {
+                return false;
+            }
+
+            out.object.emplace_back(std::move(key), JsonValue());
+            if (!parse_value(out.object.back().second, depth + 1)) {
+                return false;
+            }
+
+            if (consume(',')) {
+                continue;
+            }
+            return consume('}');
+        }
+    }
+
+    bool parse_array(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Array;
+        ++cur_;  // '['
+
+        if (consume(']')) {
+            return true;
+        }
+
+        while (true) {
+            out.array.emplace_back();
+            if (!parse_value(out.array.back(), depth + 1)) {
+                return false;
+            }
+
+            if (consume(',')) {
+                continue;
+            }
+            return consume(']');
+        }
+    }
+
+    bool parse_hex4(uint32_t& out) {
+        if (end_ - cur_ < 4) {
+            return false;
+        }
+        out = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *cur_++;
+            out <<= 4;
+            if (c >= '0' && c <= '9') {
+                out |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                out |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                out |= c - 'A' + 10;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void append_utf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        } else {
+            out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+    }
+
+    bool parse_string(std::string& out) {
+        ++cur_;  // '"'
+
+        while (cur_ < end_) {
+            char c = *cur_++;
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return false;  // control characters must be escaped
+            }
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+
+            if (cur_ >= end_) {
+                return false;
+            }
+            switch (*cur_++) {
+                case '"':
+                    out.push_back('"');
+                    break;
+                case '\\':
+                    out.push_back('\\');
+                    break;
+                case '/':
+                    out.push_back('/');
+                    break;
+                case 'b':
+                    out.push_back('\b');
+                    break;
+                case 'f':
+                    out.push_back('\f');
+                    break;
+                case 'n':
+                    out.push_back('\n');
+                    break;
+                case 'r':
+                    out.push_back('\r');
+                    break;
+                case 't':
+                    out.push_back('\t');
+                    break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!parse_hex4(cp)) {
+                        return false;
+                    }
+                    // Surrogate pair
+                    if (cp >= 0xd800 && cp <= 0xdbff) {
+                        uint32_t low;
+                        if (!consume_literal("\\u") || !parse_hex4(low) || low < 0xdc00 || low > 0xdfff) {
+                            return false;
+                        }
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                    } else if (cp >= 0xdc00 && cp <= 0xdfff) {
+                        return false;
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        return false;  // unterminated
+    }
+
+    bool parse_number(double& out) {
+        const char* start = cur_;
+
+        if (cur_ < end_ && *cur_ == '-') ++cur_;
+        if (cur_ >= end_) return false;
+
+        if (*cur_ == '0') {
+            ++cur_;
+        } else if (*cur_ >= '1' && *cur_ <= '9') {
+            while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') ++cur_;
+        } else {
+            return false;
+        }
+
+        if (cur_ < end_ && *cur_ == '.') {
+            ++cur_;
+            if (cur_ >= end_ || *cur_ < '0' || *cur_ > '9') return false;
+            while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') ++cur_;
+        }
+
+        if (cur_ < end_ && (*cur_ == 'e' || *cur_ == 'E')) {
+            ++cur_;
+            if (cur_ < end_ && (*cur_ == '+' || *cur_ == '-')) ++cur_;
+            if (cur_ >= end_ || *cur_ < '0' || *cur_ > '9') return false;
+            while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') ++cur_;
+        }
+
+        // strtod needs a terminated string, the grammar above already validated the token
+        std::string token(start, cur_);
+        out = std::strtod(token.c_str(), nullptr);
+        return true;
+    }
+};
+
+}  // namespace
+
+bool parse_json(const char* data, size_t size, JsonValue& out) {
+    out = JsonValue();
+    return JsonParser(data, size).parse_document(out);
+}
+
+bool parse_json(const std::string& text, JsonValue& out) { return parse_json(text.data(), text.size(), out); }
+
+}  // namespace spiffe
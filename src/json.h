@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spiffe {
+
+// Minimal JSON document model, enough for JWT claims and JWKS documents
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;  // in document order
+
+    bool is_null() const { return type == Type::Null; }
+    bool is_bool() const { return type == Type::Bool; }
+    bool is_number() const { return type == Type::Number; }
+    bool is_string() const { return type == Type::String; }
+    bool is_array() const { return type == Type::Array; }
+    bool is_object() const { return type == Type::Object; }
+
+    // Member of an object, nullptr if this is not an object or the key is missing.
+    // Duplicate keys resolve to the first occurrence.
+    const JsonValue* find(const std::string& key) const;
+};
+
+// Parses a complete JSON text (RFC 8259). Returns false on malformed input, trailing data,
+// or nesting deeper than 64 levels.
+bool parse_json(const char* data, size_t size, JsonValue& out);
+bool parse_json(const std::string& text, JsonValue& out);
+
+}  // namespace spiffe
@@ -0,0 +1,245 @@
+#include "jwt.h"
+
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#include <cstring>
+
+#include "der.h"
+
+namespace spiffe {
+
+namespace {
+
+const uint8_t OID_RSA_ENCRYPTION[] = {0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01};
+const uint8_t OID_EC_PUBLIC_KEY[] = {0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01};
+
+struct Curve {
+    const char* name;
+    uint8_t oid[8];
+    size_t oid_size;
+    size_t coordinate_size;
+};
+
+const Curve CURVES[] = {
+    {"P-256", {0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07}, 8, 32},
+    {"P-384", {0x2b, 0x81, 0x04, 0x00, 0x22}, 5, 48},
+    {"P-521", {0x2b, 0x81, 0x04, 0x00, 0x23}, 5, 66},
+};
+
+struct JwsAlgorithm {
+    const char* name;
+    const EVP_MD* (*digest)();
+    int key_type;
+    bool pss;
+    size_t coordinate_size;  // ES* only
+};
+
+const JwsAlgorithm JWS_ALGORITHMS[] = {
+    {"RS256", EVP_sha256, EVP_PKEY_RSA, false, 0}, {"RS384", EVP_sha384, EVP_PKEY_RSA, false, 0},
+    {"RS512", EVP_sha512, EVP_PKEY_RSA, false, 0}, {"PS256", EVP_sha256, EVP_PKEY_RSA, true, 0},
+    {"PS384", EVP_sha384, EVP_PKEY_RSA, true, 0},  {"PS512", EVP_sha512, EVP_PKEY_RSA, true, 0},
+    {"ES256", EVP_sha256, EVP_PKEY_EC, false, 32}, {"ES384", EVP_sha384, EVP_PKEY_EC, false, 48},
+    {"ES512", EVP_sha512, EVP_PKEY_EC, false, 66},
+};
+
+// Base64url string member of a JWK, decoded
+bool read_jwk_bytes(const JsonValue& jwk, const char* name, std::string& out) {
+    const JsonValue* value = jwk.find(name);
+    return value && value->is_string() && base64url_decode(value->string.data(), value->string.size(), out) &&
+           !out.empty();
+}
+
+BufferView bytes_of(const std::string& s) { return BufferView(reinterpret_cast<const uint8_t*>(s.data()), s.size()); }
+
+// SubjectPublicKeyInfo ::= SEQUENCE { AlgorithmIdentifier, subjectPublicKey BIT STRING }
+Buffer make_spki(const Buffer& algorithm, const Buffer& public_key) {
+    Buffer bits;
+    bits.reserve(public_key.size() + 1);
+    bits.push_back(0);  // no unused bits
+    bits.insert(bits.end(), public_key.begin(), public_key.end());
+
+    Buffer content = algorithm;
+    write_der_tlv(content, 0x03, bits);
+    Buffer spki;
+    write_der_tlv(spki, 0x30, content);
+    return spki;
+}
+
+}  // namespace
+
+static int base64url_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-') return 62;
+    if (c == '_') return 63;
+    return -1;
+}
+
+bool base64url_decode(const char* data, size_t size, std::string& out) {
+    // A single dangling character cannot encode a full byte
+    if (size % 4 == 1) {
+        return false;
+    }
+
+    out.clear();
+    out.reserve(size * 3 / 4);
+
+    uint32_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < size; ++i) {
+        int v = base64url_value(data[i]);
+        if (v < 0) {
+            return false;
+        }
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((acc >> bits) & 0xff));
+        }
+    }
+
+    return true;
+}
+
+bool decode_jwt_claims(const std::string& token, JsonValue& claims) {
+    size_t first_dot = token.find('.');
+    if (first_dot == std::string::npos) {
+        return false;
+    }
+    size_t second_dot = token.find('.', first_dot + 1);
+    if (second_dot == std::string::npos) {
+        return false;
+    }
+
+    std::string payload;
+    if (!base64url_decode(token.data() + first_dot + 1, second_dot - first_dot - 1, payload)) {
+        return false;
+    }
+
+    return parse_json(payload, claims) && claims.is_object();
+}
+
+bool read_jwt_expiry(const std::string& token, int64_t& exp) {
+    JsonValue claims;
+    if (!decode_jwt_claims(token, claims)) {
+        return false;
+    }
+
+    const JsonValue* value = claims.find("exp");
+    if (!value || !value->is_number()) {
+        return false;
+    }
+
+    // NumericDate seconds, bounded so that the conversion and later time arithmetic cannot overflow
+    if (!(value->number > 0 && value->number < 1e15)) {
+        return false;
+    }
+
+    exp = static_cast<int64_t>(value->number);
+    return true;
+}
+
+bool parse_jwk(const JsonValue& jwk, JwtKey& out) {
+    const JsonValue* kty = jwk.find("kty");
+    if (!kty || !kty->is_string()) {
+        return false;
+    }
+
+    // The key is wrapped in the SubjectPublicKeyInfo OpenSSL decodes, which also checks that
+    // EC points are on their curve
+    Buffer algorithm, public_key;
+    if (kty->string == "RSA") {
+        std::string n, e;
+        if (!read_jwk_bytes(jwk, "n", n) || !read_jwk_bytes(jwk, "e", e)) {
+            return false;
+        }
+        Buffer parameters;
+        write_der_tlv(parameters, 0x06, BufferView(OID_RSA_ENCRYPTION, sizeof(OID_RSA_ENCRYPTION)));
+        write_der_tlv(parameters, 0x05, BufferView());  // NULL
+        write_der_tlv(algorithm, 0x30, parameters);
+
+        // RSAPublicKey ::= SEQUENCE { modulus INTEGER, publicExponent INTEGER }
+        Buffer integers;
+        write_der_unsigned(integers, bytes_of(n));
+        write_der_unsigned(integers, bytes_of(e));
+        write_der_tlv(public_key, 0x30, integers);
+        out.type = EVP_PKEY_RSA;
+    } else if (kty->string == "EC") {
+        const JsonValue* crv = jwk.find("crv");
+        const Curve* curve = nullptr;
+        for (const Curve& candidate : CURVES) {
+            if (crv && crv->is_string() && crv->string == candidate.name) {
+                curve = &candidate;
+            }
+        }
+        std::string x, y;
+        if (!curve || !read_jwk_bytes(jwk, "x", x) || !read_jwk_bytes(jwk, "y", y) ||
+            x.size() != curve->coordinate_size || y.size() != curve->coordinate_size) {
+            return false;
+        }
+        Buffer parameters;
+        write_der_tlv(parameters, 0x06, BufferView(OID_EC_PUBLIC_KEY, sizeof(OID_EC_PUBLIC_KEY)));
+        write_der_tlv(parameters, 0x06, BufferView(curve->oid, curve->oid_size));
+        write_der_tlv(algorithm, 0x30, parameters);
+
+        // Uncompressed point
+        public_key.push_back(0x04);
+        public_key.insert(public_key.end(), x.begin(), x.end());
+        public_key.insert(public_key.end(), y.begin(), y.end());
+        out.type = EVP_PKEY_EC;
+        out.coordinate_size = curve->coordinate_size;
+    } else {
+        return false;
+    }
+
+    Buffer spki = make_spki(algorithm, public_key);
+    const unsigned char* data = spki.data();
+    out.key = d2i_PUBKEY(nullptr, &data, static_cast<long>(spki.size()));
+    return out.key != nullptr && EVP_PKEY_base_id(out.key) == out.type;
+}
+
+bool verify_jws_signature(const JwtKey& key, const std::string& alg, const char* signing_input, size_t size,
+                          const std::string& signature) {
+    const JwsAlgorithm* algorithm = nullptr;
+    for (const JwsAlgorithm& candidate : JWS_ALGORITHMS) {
+        if (alg == candidate.name) {
+            algorithm = &candidate;
+        }
+    }
+    // The key decides the family and, for ECDSA, the curve, never the token alone
+    if (!algorithm || !key.key || algorithm->key_type != key.type ||
+        algorithm->coordinate_size != key.coordinate_size) {
+        return false;
+    }
+
+    // JWS ECDSA signatures are R || S, OpenSSL takes Ecdsa-Sig-Value ::= SEQUENCE { r, s }
+    BufferView raw = bytes_of(signature);
+    Buffer der;
+    if (algorithm->key_type == EVP_PKEY_EC) {
+        if (raw.size() != 2 * key.coordinate_size) {
+            return false;
+        }
+        Buffer integers;
+        write_der_unsigned(integers, BufferView(raw.data(), key.coordinate_size));
+        write_der_unsigned(integers, BufferView(raw.data() + key.coordinate_size, key.coordinate_size));
+        write_der_tlv(der, 0x30, integers);
+        raw = der;
+    }
+
+    bool verified = false;
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    EVP_PKEY_CTX* key_context = nullptr;
+    if (context && EVP_DigestVerifyInit(context, &key_context, algorithm->digest(), nullptr, key.key) == 1 &&
+        (!algorithm->pss || (EVP_PKEY_CTX_set_rsa_padding(key_context, RSA_PKCS1_PSS_PADDING) > 0 &&
+                             EVP_PKEY_CTX_set_rsa_pss_saltlen(key_context, RSA_PSS_SALTLEN_DIGEST) > 0))) {
+        verified = EVP_DigestVerify(context, raw.data(), raw.size(), reinterpret_cast<const unsigned char*>(signing_input),
+                                    size) == 1;
+    }
+    EVP_MD_CTX_free(context);
+    return verified;
+}
+
+}  // namespace spiffe
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <openssl/evp.h>
+
+#include "json.h"
+
+namespace spiffe {
+
+// Public key of one JWK of a JwtKeySet
+struct JwtKey {
+    EVP_PKEY* key = nullptr;
+    int type = 0;                // EVP_PKEY_RSA or EVP_PKEY_EC
+    size_t coordinate_size = 0;  // EC only, bytes of one coordinate: 32 for P-256
+
+    JwtKey() = default;
+    ~JwtKey() { EVP_PKEY_free(key); }
+
+    // Disallow copy
+    JwtKey(const JwtKey&) = delete;
+    JwtKey& operator=(const JwtKey&) = delete;
+};
+
+// Builds the key of a JWK object (RFC 7518 section 6): "kty" RSA with "n" and "e", or EC with
+// "crv" P-256, P-384 or P-521 and "x" and "y"
+bool parse_jwk(const JsonValue& jwk, JwtKey& out);
+
+// Verifies a JWS signature made with alg, one of RS256/384/512, PS256/384/512 or ES256/384/512.
+// signature is decoded, for ES* the fixed-size R || S of RFC 7518 section 3.4.
+bool verify_jws_signature(const JwtKey& key, const std::string& alg, const char* signing_input, size_t size,
+                          const std::string& signature);
+
+// Decodes unpadded base64url (RFC 4648 section 5), as used by JWS compact serialization
+bool base64url_decode(const char* data, size_t size, std::string& out);
+
+// Decodes the claims (payload) of a JWS compact serialized token. The signature is NOT verified.
+bool decode_jwt_claims(const std::string& token, JsonValue& claims);
+
+// Reads the "exp" claim (seconds since the Unix epoch). The signature is NOT verified.
+bool read_jwt_expiry(const std::string& token, int64_t& exp);
+
+}  // namespace spiffe
@@ -0,0 +1,83 @@
+#include <spiffe/jwt_bundle_index.h>
+
+#include <atomic>
+
+#include "jwt.h"
+
+namespace spiffe {
+
+namespace {
+
+// Key set ids, never 0
+std::atomic<uint64_t> next_id{1};
+
+}  // namespace
+
+JwtKeySet::JwtKeySet(std::string jwks)
+    : jwks_(std::move(jwks)), id_(next_id.fetch_add(1, std::memory_order_relaxed)) {
+    // { "keys": [ JWK, ... ], ... }
+    JsonValue document;
+    if (!parse_json(jwks_, document) || !document.is_object()) {
+        return;
+    }
+    const JsonValue* keys = document.find("keys");
+    if (!keys || !keys->is_array()) {
+        return;
+    }
+    valid_ = true;
+
+    keys_.reserve(keys->array.size());
+    for (const JsonValue& jwk : keys->array) {
+        const JsonValue* kid = jwk.find("kid");
+        const JsonValue* use = jwk.find("use");
+        if (!kid || !kid->is_string() || (use && (!use->is_string() || use->string != "jwt-svid")) ||
+            keys_.count(kid->string)) {
+            continue;
+        }
+
+        // Unusable keys are skipped, the others still validate tokens
+        auto key = std::make_shared<JwtKey>();
+        if (parse_jwk(jwk, *key)) {
+            keys_.emplace(kid->string, std::move(key));
+        }
+    }
+}
+
+const JwtKey* JwtKeySet::find(const std::string& key_id) const {
+    auto it = keys_.find(key_id);
+    return it == keys_.end() ? nullptr : it->second.get();
+}
+
+JwtBundleIndexSet::JwtBundleIndexSet(const JwtBundles& bundles, const JwtBundleIndexSet* previous) {
+    key_sets_.reserve(bundles.bundles.size());
+    by_interned_.reserve(bundles.bundles.size());
+    for (const auto& entry : bundles.bundles) {
+        std::shared_ptr<const JwtKeySet>& key_set = key_sets_[entry.first];
+        if (previous) {
+            auto it = previous->key_sets_.find(entry.first);
+            if (it != previous->key_sets_.end() && it->second->jwks() == entry.second) {
+                key_set = it->second;
+            }
+        }
+        if (!key_set) {
+            key_set = std::make_shared<const JwtKeySet>(entry.second);
+        }
+
+        SpiffeId id;
+        if (SpiffeId::parse(entry.first, id) && id.path().empty()) {
+            by_interned_[InternedTrustDomain::intern(id.trust_domain_name())] = key_set.get();
+        }
+    }
+}
+
+const JwtKeySet* JwtBundleIndexSet::get(const TrustDomain& trust_domain) const {
+    auto it = key_sets_.find(trust_domain);
+    return it == key_sets_.end() ? nullptr : it->second.get();
+}
+
+const JwtKeySet* JwtBundleIndexSet::get(InternedTrustDomain trust_domain) const {
+    auto it = by_interned_.find(trust_domain);
+    return it == by_interned_.end() ? nullptr : it->second;
+}
+
+}  // namespace spiffe
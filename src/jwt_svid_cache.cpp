@@ -0,0 +1,168 @@
+#include "jwt_svid_cache.h"
+
+#include <algorithm>
+
+#include "jwt.h"
+
+namespace spiffe {
+
+JwtSvidCache::JwtSvidCache(const JwtSvidCacheOptions& options)
+    : options_(options), cache_(options.max_entries, options.shards) {
+    if (!(options_.refresh_fraction > 0 && options_.refresh_fraction <= 1)) {
+        options_.refresh_fraction = JwtSvidCacheOptions().refresh_fraction;
+    }
+}
+
+std::string JwtSvidCache::make_key(const std::vector<std::string>& audience, const std::string& spiffe_id) {
+    std::vector<std::string> sorted(audience);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    // NUL cannot appear in an audience or a SPIFFE ID, so it is a safe separator
+    std::string key = spiffe_id;
+    for (const auto& aud : sorted) {
+        key.push_back('\0');
+        key.append(aud);
+    }
+    return key;
+}
+
+bool JwtSvidCache::make_entry(const std::vector<JwtSvid>& svids, Clock::time_point now, Entry& entry) const {
+    if (svids.empty()) {
+        return false;
+    }
+
+    // The result is as fresh as its shortest lived token
+    int64_t exp = 0;
+    for (const auto& svid : svids) {
+        int64_t svid_exp;
+        if (!read_jwt_expiry(svid.svid, svid_exp)) {
+            return false;
+        }
+        if (exp == 0 || svid_exp < exp) {
+            exp = svid_exp;
+        }
+    }
+
+    entry.expires_at = Clock::time_point(std::chrono::seconds(exp));
+    if (entry.expires_at <= now) {
+        return false;
+    }
+
+    auto lifetime = std::chrono::duration_cast<std::chrono::milliseconds>(entry.expires_at - now);
+    entry.refresh_at = now + std::chrono::milliseconds(static_cast<int64_t>(lifetime.count() * options_.refresh_fraction));
+    entry.svids = svids;
+    return true;
+}
+
+Status JwtSvidCache::get(std::vector<JwtSvid>& out, const std::vector<std::string>& audience,
+                         const std::string& spiffe_id, const Fetch& fetch) {
+    std::vector<JwtSvidRequest> requests(1);
+    requests[0].audience = audience;
+    requests[0].spiffe_id = spiffe_id;
+
+    std::vector<JwtSvidResult> results;
+    get_many(requests, results, [&](const std::vector<JwtSvidRequest>&, const std::vector<size_t>&,
+                                    std::vector<JwtSvidResult>& fetched) {
+        fetched[0].status = fetch(fetched[0].svids);
+    });
+
+    out.insert(out.end(), results[0].svids.begin(), results[0].svids.end());
+    return results[0].status;
+}
+
+void JwtSvidCache::get_many(const std::vector<JwtSvidRequest>& requests, std::vector<JwtSvidResult>& results,
+                            const FetchMany& fetch) {
+    results.assign(requests.size(), JwtSvidResult());
+
+    std::vector<std::string> keys(requests.size());
+    std::vector<size_t> misses;
+    std::vector<std::unique_ptr<std::promise<Result>>> leaders(requests.size());
+    std::vector<std::shared_future<Result>> joined(requests.size());
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        keys[i] = make_key(requests[i].audience, requests[i].spiffe_id);
+        Cache::Shard& shard = cache_.shard(keys[i]);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Clock::time_point now = Clock::now();
+
+        const Entry* entry = cache_.find(shard, keys[i]);
+        if (entry && now < entry->refresh_at) {
+            results[i].svids = entry->svids;
+            continue;
+        }
+
+        // Someone is already fetching this key, wait for their result. That may be this very
+        // call when the key repeats, so waiting only starts after fetching.
+        InFlight& in_flight = shard.extra;
+        auto flight = in_flight.find(keys[i]);
+        if (flight != in_flight.end()) {
+            joined[i] = flight->second;
+            continue;
+        }
+
+        leaders[i].reset(new std::promise<Result>());
+        in_flight.emplace(keys[i], leaders[i]->get_future().share());
+        misses.push_back(i);
+    }
+
+    if (!misses.empty()) {
+        try {
+            fetch(requests, misses, results);
+        } catch (...) {
+            // Callers waiting for these keys get the exception too, the next call fetches again
+            for (size_t i : misses) {
+                abandon(keys[i], *leaders[i], std::current_exception());
+            }
+            throw;
+        }
+    }
+
+    for (size_t i : misses) {
+        Result result;
+        result.status = std::move(results[i].status);
+        result.svids = std::move(results[i].svids);
+        complete(keys[i], result, *leaders[i]);
+
+        results[i].status = result.status;
+        results[i].svids = result.svids;
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (joined[i].valid()) {
+            const Result& shared = joined[i].get();
+            results[i].status = shared.status;
+            results[i].svids = shared.svids;
+        }
+    }
+}
+
+void JwtSvidCache::complete(const std::string& key, Result& result, std::promise<Result>& leader) {
+    Cache::Shard& shard = cache_.shard(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Clock::time_point now = Clock::now();
+        shard.extra.erase(key);
+
+        // Errors are returned as the agent sent them, a denied workload must not keep its tokens
+        Entry entry;
+        if (result.status.is_ok() && make_entry(result.svids, now, entry)) {
+            cache_.insert(shard, key, std::move(entry), [&](const Entry& cached) { return cached.expires_at > now; });
+        }
+    }
+
+    leader.set_value(result);
+}
+
+void JwtSvidCache::abandon(const std::string& key, std::promise<Result>& leader, std::exception_ptr error) {
+    Cache::Shard& shard = cache_.shard(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.extra.erase(key);
+    }
+
+    leader.set_exception(error);
+}
+
+}  // namespace spiffe
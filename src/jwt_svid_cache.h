@@ -0,0 +1,79 @@
+#pragma once
+
+#include <spiffe/spiffe.h>
+#include <spiffe/status.h>
+#include <spiffe/types.h>
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bounded_cache.h"
+
+namespace spiffe {
+
+// Cache of FetchJWTSVID results keyed by (sorted audience set, spiffe_id).
+//
+// A cached result is served until refresh_fraction of its lifetime (fetch time to the
+// earliest "exp" of the returned tokens) has passed. Concurrent misses for one key share a
+// single in-flight fetch. Keys are spread over independently locked shards.
+class JwtSvidCache {
+   public:
+    using Fetch = std::function<Status(std::vector<JwtSvid>& out)>;
+
+    // Fetches requests[i] for each i in misses into results[i]
+    using FetchMany = std::function<void(const std::vector<JwtSvidRequest>& requests,
+                                         const std::vector<size_t>& misses, std::vector<JwtSvidResult>& results)>;
+
+    explicit JwtSvidCache(const JwtSvidCacheOptions& options);
+
+    // Disallow copy
+    JwtSvidCache(const JwtSvidCache&) = delete;
+    JwtSvidCache& operator=(const JwtSvidCache&) = delete;
+
+    // Appends the tokens for the key to out, calling fetch on a miss
+    Status get(std::vector<JwtSvid>& out, const std::vector<std::string>& audience, const std::string& spiffe_id,
+               const Fetch& fetch);
+
+    // Same for many keys, results gets one entry per request. All misses not already in flight
+    // are fetched with a single call to fetch.
+    void get_many(const std::vector<JwtSvidRequest>& requests, std::vector<JwtSvidResult>& results,
+                  const FetchMany& fetch);
+
+    static std::string make_key(const std::vector<std::string>& audience, const std::string& spiffe_id);
+
+   private:
+    using Clock = std::chrono::system_clock;
+
+    struct Result {
+        Status status;
+        std::vector<JwtSvid> svids;
+    };
+
+    struct Entry {
+        std::vector<JwtSvid> svids;
+        Clock::time_point refresh_at;
+        Clock::time_point expires_at;
+    };
+
+    // Fetches in progress, by key, kept with the entries of their shard
+    using InFlight = std::unordered_map<std::string, std::shared_future<Result>>;
+    using Cache = BoundedCache<std::string, Entry, std::hash<std::string>, InFlight>;
+
+    JwtSvidCacheOptions options_;
+    Cache cache_;
+
+    bool make_entry(const std::vector<JwtSvid>& svids, Clock::time_point now, Entry& entry) const;
+
+    // Caches a fetched result and wakes the callers waiting for it
+    void complete(const std::string& key, Result& result, std::promise<Result>& leader);
+
+    // Ends a fetch that threw, the waiting callers get its exception
+    void abandon(const std::string& key, std::promise<Result>& leader, std::exception_ptr error);
+};
+
+}  // namespace spiffe
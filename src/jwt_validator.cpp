@@ -0,0 +1,219 @@
+#include <spiffe/jwt_validator.h>
+
+#include <algorithm>
+
+#include "bounded_cache.h"
+#include "jwt.h"
+
+namespace spiffe {
+
+namespace {
+
+// Token whose signature verified, before the time and audience checks
+struct VerifiedToken {
+    JwtSvidClaims claims;
+    InternedTrustDomain trust_domain;
+    uint64_t key_set_id = 0;
+};
+
+Status invalid_argument(const std::string& message) { return Status{.code = 3, .message = message}; }
+Status unauthenticated(const std::string& message) { return Status{.code = 16, .message = message}; }
+
+bool decode_json_part(const std::string& token, size_t begin, size_t end, JsonValue& out) {
+    std::string json;
+    return base64url_decode(token.data() + begin, end - begin, json) && parse_json(json, out) && out.is_object();
+}
+
+const std::string* find_string(const JsonValue& object, const char* key) {
+    const JsonValue* value = object.find(key);
+    return value && value->is_string() ? &value->string : nullptr;
+}
+
+// header.payload.signature (JWS compact serialization), signature checked against bundles
+Status verify_token(const std::string& token, const JwtBundleIndexSet& bundles, VerifiedToken& out) {
+    size_t first_dot = token.find('.');
+    size_t second_dot = first_dot == std::string::npos ? first_dot : token.find('.', first_dot + 1);
+    if (second_dot == std::string::npos || token.find('.', second_dot + 1) != std::string::npos) {
+        return invalid_argument("Malformed token");
+    }
+
+    JsonValue header, payload;
+    std::string signature;
+    if (!decode_json_part(token, 0, first_dot, header) || !decode_json_part(token, first_dot + 1, second_dot, payload) ||
+        !base64url_decode(token.data() + second_dot + 1, token.size() - second_dot - 1, signature)) {
+        return invalid_argument("Malformed token");
+    }
+
+    const std::string* alg = find_string(header, "alg");
+    const std::string* kid = find_string(header, "kid");
+    const std::string* typ = find_string(header, "typ");
+    if (!alg || !kid || (header.find("typ") && (!typ || (*typ != "JWT" && *typ != "JOSE")))) {
+        return unauthenticated("Token header must have \"alg\" and \"kid\", and \"typ\" JWT or JOSE if any");
+    }
+
+    // "sub" is the SPIFFE ID, its trust domain keys the bundle
+    const std::string* sub = find_string(payload, "sub");
+    if (!sub) {
+        return unauthenticated("Token has no \"sub\"");
+    }
+    SpiffeId id;
+    if (!SpiffeId::parse(*sub, id)) {
+        return unauthenticated("Invalid SPIFFE ID: " + *sub);
+    }
+    out.trust_domain = id.trust_domain();
+
+    // "aud" is one string or an array of them
+    const JsonValue* aud = payload.find("aud");
+    if (aud && aud->is_string()) {
+        out.claims.audience.push_back(aud->string);
+    } else if (aud && aud->is_array()) {
+        for (const JsonValue& value : aud->array) {
+            if (!value.is_string()) {
+                return unauthenticated("Invalid \"aud\"");
+            }
+            out.claims.audience.push_back(value.string);
+        }
+    }
+    if (out.claims.audience.empty()) {
+        return unauthenticated("Token has no \"aud\"");
+    }
+
+    const JsonValue* exp = payload.find("exp");
+    if (!exp || !exp->is_number() || !(exp->number > 0 && exp->number < 1e15)) {
+        return unauthenticated("Token has no valid \"exp\"");
+    }
+    out.claims.expiry = static_cast<int64_t>(exp->number);
+
+    const JwtKeySet* key_set = out.trust_domain.is_null() ? nullptr : bundles.get(out.trust_domain);
+    if (!key_set) {
+        return unauthenticated("No bundle for trust domain " + id.trust_domain_id().to_string());
+    }
+    const JwtKey* key = key_set->find(*kid);
+    if (!key) {
+        return unauthenticated("No key " + *kid + " in the bundle of " + id.trust_domain_id().to_string());
+    }
+    if (!verify_jws_signature(*key, *alg, token.data(), second_dot, signature)) {
+        return unauthenticated("Invalid token signature");
+    }
+
+    out.claims.spiffe_id = *sub;
+    out.key_set_id = key_set->id();
+    return Status();
+}
+
+Status check_claims(const JwtSvidClaims& claims, const std::string& audience, int64_t now) {
+    if (now >= claims.expiry) {
+        return unauthenticated("Token expired");
+    }
+    if (std::find(claims.audience.begin(), claims.audience.end(), audience) == claims.audience.end()) {
+        return unauthenticated("Token audience does not contain " + audience);
+    }
+    return Status();
+}
+
+int64_t unix_seconds(std::chrono::system_clock::time_point now) {
+    return std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+}
+
+}  // namespace
+
+Status validate_jwt_svid(const std::string& token, const std::string& audience, const JwtBundleIndexSet& bundles,
+                         JwtSvidClaims& claims, std::chrono::system_clock::time_point now) {
+    VerifiedToken verified;
+    Status status = verify_token(token, bundles, verified);
+    if (!status.is_ok()) {
+        return status;
+    }
+    status = check_claims(verified.claims, audience, unix_seconds(now));
+    if (status.is_ok()) {
+        claims = std::move(verified.claims);
+    }
+    return status;
+}
+
+class JwtSvidValidator::Cache : public BoundedCache<std::string, Entry> {
+   public:
+    using BoundedCache::BoundedCache;
+};
+
+JwtSvidValidator::JwtSvidValidator(const JwtSvidValidatorOptions& options)
+    : cache_(new Cache(options.max_entries, options.shards)),
+      bundles_(std::make_shared<const JwtBundleIndexSet>()) {}
+
+JwtSvidValidator::~JwtSvidValidator() = default;
+
+void JwtSvidValidator::update(const JwtBundles& bundles) {
+    // Updates come from one stream, the previous set cannot change while the next one is built
+    std::shared_ptr<const JwtBundleIndexSet> previous = this->bundles();
+    auto next = std::make_shared<const JwtBundleIndexSet>(bundles, previous.get());
+
+    std::lock_guard<std::mutex> lock(bundles_mutex_);
+    bundles_ = std::move(next);
+}
+
+std::shared_ptr<const JwtBundleIndexSet> JwtSvidValidator::bundles() const {
+    std::lock_guard<std::mutex> lock(bundles_mutex_);
+    return bundles_;
+}
+
+Status JwtSvidValidator::validate(const std::string& token, const std::string& audience, JwtSvidClaims& claims,
+                                  Clock::time_point now) {
+    std::shared_ptr<const JwtBundleIndexSet> bundles = this->bundles();
+    return validate(token, audience, *bundles, claims, now);
+}
+
+bool JwtSvidValidator::holds(const Entry& entry, const JwtBundleIndexSet& bundles, int64_t now) {
+    if (now >= entry.claims.expiry) {
+        return false;
+    }
+    const JwtKeySet* key_set = bundles.get(entry.trust_domain);
+    return key_set && key_set->id() == entry.key_set_id;
+}
+
+Status JwtSvidValidator::validate(const std::string& token, const std::string& audience,
+                                  const JwtBundleIndexSet& bundles, JwtSvidClaims& claims, Clock::time_point now) {
+    int64_t now_seconds = unix_seconds(now);
+    Cache::Shard& shard = cache_->shard(token);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const Entry* cached = cache_->find(shard, token);
+        if (cached && holds(*cached, bundles, now_seconds)) {
+            Status status = check_claims(cached->claims, audience, now_seconds);
+            if (status.is_ok()) {
+                claims = cached->claims;
+            }
+            return status;
+        }
+    }
+
+    // Verified outside of the lock, concurrent misses for one token each verify it
+    VerifiedToken verified;
+    Status status = verify_token(token, bundles, verified);
+    if (!status.is_ok()) {
+        return status;
+    }
+    status = check_claims(verified.claims, audience, now_seconds);
+    if (!status.is_ok()) {
+        // Expired tokens are not worth keeping, a signed token for another audience is
+        if (now_seconds >= verified.claims.expiry) {
+            return status;
+        }
+    } else {
+        claims = verified.claims;
+    }
+
+    Entry entry{
+        .claims = std::move(verified.claims),
+        .trust_domain = verified.trust_domain,
+        .key_set_id = verified.key_set_id,
+    };
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    cache_->insert(shard, token, std::move(entry),
+                   [&](const Entry& cached) { return holds(cached, bundles, now_seconds); });
+    return status;
+}
+
+size_t JwtSvidValidator::size() const { return cache_->size(); }
+
+}  // namespace spiffe
@@ -0,0 +1,160 @@
+#include <spiffe/metrics.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace spiffe {
+
+namespace {
+
+uint64_t to_ns(std::chrono::nanoseconds value) { return value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0; }
+
+uint64_t bucket_lower_bound(size_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    size_t exponent = (bucket - 4) / 4 + 2;
+    uint64_t sub = (bucket - 4) % 4;
+    return (4 + sub) << (exponent - 2);
+}
+
+}  // namespace
+
+const char* rpc_method_name(RpcMethod method) {
+    switch (method) {
+        case RpcMethod::X509Svid:
+            return "FetchX509SVID";
+        case RpcMethod::X509Bundles:
+            return "FetchX509Bundles";
+        case RpcMethod::JwtBundles:
+            return "FetchJWTBundles";
+        case RpcMethod::JwtSvid:
+            return "FetchJWTSVID";
+    }
+    return "";
+}
+
+size_t HistogramSnapshot::bucket_of(uint64_t ns) {
+    if (ns < 4) {
+        return static_cast<size_t>(ns);
+    }
+
+    // 4 linear sub-buckets per power of two, from the two bits below the leading one
+    size_t exponent = 63 - __builtin_clzll(ns);
+    size_t sub = (ns >> (exponent - 2)) & 3;
+    return std::min(4 + (exponent - 2) * 4 + sub, BUCKETS - 1);
+}
+
+uint64_t HistogramSnapshot::bucket_upper_bound(size_t bucket) {
+    if (bucket + 1 >= BUCKETS) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return bucket_lower_bound(bucket + 1) - 1;
+}
+
+std::chrono::nanoseconds HistogramSnapshot::percentile(double q) const {
+    uint64_t total = 0;
+    for (uint64_t n : buckets) {
+        total += n;
+    }
+    if (total == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    // Rank of the quantile, 1-based
+    uint64_t rank = static_cast<uint64_t>(std::max(0.0, std::min(1.0, q)) * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint64_t bound = std::min(bucket_upper_bound(i), to_ns(max));
+            return std::chrono::nanoseconds(static_cast<int64_t>(bound));
+        }
+    }
+    return max;
+}
+
+void AtomicMetrics::Histogram::record(std::chrono::nanoseconds value) {
+    uint64_t ns = to_ns(value);
+    buckets[HistogramSnapshot::bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum_ns.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t current = max_ns.load(std::memory_order_relaxed);
+    while (ns > current && !max_ns.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot AtomicMetrics::Histogram::snapshot() const {
+    HistogramSnapshot out;
+    out.count = count.load(std::memory_order_relaxed);
+    out.sum = std::chrono::nanoseconds(static_cast<int64_t>(sum_ns.load(std::memory_order_relaxed)));
+    out.max = std::chrono::nanoseconds(static_cast<int64_t>(max_ns.load(std::memory_order_relaxed)));
+    for (size_t i = 0; i < HistogramSnapshot::BUCKETS; ++i) {
+        out.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+    return out;
+}
+
+void AtomicMetrics::on_rpc_done(RpcMethod method, int status_code, std::chrono::nanoseconds latency) {
+    RpcMetrics& metrics = of(method);
+    metrics.latency.record(latency);
+
+    size_t code = status_code >= 0 && status_code < 17 ? static_cast<size_t>(status_code) : 2;
+    metrics.status_codes[code].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AtomicMetrics::on_first_update(RpcMethod method, std::chrono::nanoseconds latency) {
+    of(method).first_update.record(latency);
+}
+
+void AtomicMetrics::on_bytes_received(RpcMethod method, size_t bytes) {
+    of(method).bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AtomicMetrics::on_message(RpcMethod method, size_t, bool reassembled) {
+    RpcMetrics& metrics = of(method);
+    metrics.messages.fetch_add(1, std::memory_order_relaxed);
+    if (reassembled) {
+        metrics.messages_reassembled.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AtomicMetrics::on_decode(RpcMethod method, std::chrono::nanoseconds proto, std::chrono::nanoseconds der) {
+    RpcMetrics& metrics = of(method);
+    metrics.proto_decode.record(proto);
+    metrics.der_split.record(der);
+}
+
+void AtomicMetrics::on_callback(RpcMethod method, std::chrono::nanoseconds elapsed) {
+    of(method).callback.record(elapsed);
+}
+
+void AtomicMetrics::on_stream_restart(RpcMethod method) {
+    of(method).stream_restarts.fetch_add(1, std::memory_order_relaxed);
+}
+
+MetricsSnapshot AtomicMetrics::snapshot() const {
+    MetricsSnapshot out;
+    for (size_t i = 0; i < RPC_METHOD_COUNT; ++i) {
+        const RpcMetrics& metrics = methods_[i];
+        RpcMetricsSnapshot& method = out.methods[i];
+
+        method.latency = metrics.latency.snapshot();
+        method.first_update = metrics.first_update.snapshot();
+        method.proto_decode = metrics.proto_decode.snapshot();
+        method.der_split = metrics.der_split.snapshot();
+        method.callback = metrics.callback.snapshot();
+
+        method.bytes_received = metrics.bytes_received.load(std::memory_order_relaxed);
+        method.messages = metrics.messages.load(std::memory_order_relaxed);
+        method.messages_reassembled = metrics.messages_reassembled.load(std::memory_order_relaxed);
+        method.stream_restarts = metrics.stream_restarts.load(std::memory_order_relaxed);
+        for (size_t code = 0; code < method.status_codes.size(); ++code) {
+            method.status_codes[code] = metrics.status_codes[code].load(std::memory_order_relaxed);
+        }
+    }
+    return out;
+}
+
+}  // namespace spiffe
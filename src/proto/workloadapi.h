@@ -2,6 +2,9 @@
 
 #include <cstring>  // SimpleProtos.h requires stdlib.h
 #include <cstdint>
+#include <vector>
+
+#include "../http2_client.h"
 
 // DO NOT EXPOSE ME, OR YOU WILL POLLUTE NAMESPACE
 #include <SimpleProtos.h>
@@ -9,14 +12,18 @@
 namespace spiffe {
 
 // ProtoMessage is the polyfill for protobuf 3
+//
+// Response messages declare their bytes/string fields as proto_view: they are decoded in place
+// and point into the received frame, which must outlive the message. Owned copies are only made
+// when the public types are built from them.
 struct ProtoMapItem {
     FIELDS(                     //
         FIELD_BUFFER(1, key)    // string
         FIELD_BUFFER(2, value)  // string
     )
 
-    ADD_FIELD_OPTIONAL(std::string, key);
-    ADD_FIELD_OPTIONAL(std::string, value);
+    ADD_FIELD_OPTIONAL(proto_view, key);
+    ADD_FIELD_OPTIONAL(proto_view, value);
 };
 
 // X.509 SVIDs
@@ -30,11 +37,11 @@ struct ProtoX509Svid {
         FIELD_BUFFER(5, hint)           // string
     )
 
-    ADD_FIELD_OPTIONAL(std::string, spiffe_id);
-    ADD_FIELD_OPTIONAL(std::string, x509_svid);
-    ADD_FIELD_OPTIONAL(std::string, x509_svid_key);
-    ADD_FIELD_OPTIONAL(std::string, bundle);
-    ADD_FIELD_OPTIONAL(std::string, hint);
+    ADD_FIELD_OPTIONAL(proto_view, spiffe_id);
+    ADD_FIELD_OPTIONAL(proto_view, x509_svid);
+    ADD_FIELD_OPTIONAL(proto_view, x509_svid_key);
+    ADD_FIELD_OPTIONAL(proto_view, bundle);
+    ADD_FIELD_OPTIONAL(proto_view, hint);
 };
 
 struct ProtoX509SvidRequest {
@@ -49,7 +56,7 @@ struct ProtoX509SvidResponse {
     )
 
     ADD_FIELD_OPTIONAL(std::vector<ProtoX509Svid>, svids);
-    ADD_FIELD_OPTIONAL(std::vector<std::string>, crl);
+    ADD_FIELD_OPTIONAL(std::vector<proto_view>, crl);
     ADD_FIELD_OPTIONAL(std::vector<ProtoMapItem>, federated_bundles);
 };
 
@@ -63,7 +70,7 @@ struct ProtoX509BundlesResponse {
         REPEATED_FIELD_MESSAGE(2, bundles)  // map<string, bytes>
     )
 
-    ADD_FIELD_OPTIONAL(std::vector<std::string>, crl);
+    ADD_FIELD_OPTIONAL(std::vector<proto_view>, crl);
     ADD_FIELD_OPTIONAL(std::vector<ProtoMapItem>, bundles);
 };
 
@@ -76,9 +83,9 @@ struct ProtoJwtSvid {
         FIELD_BUFFER(3, hint)       // string
     )
 
-    ADD_FIELD_OPTIONAL(std::string, spiffe_id);
-    ADD_FIELD_OPTIONAL(std::string, svid);
-    ADD_FIELD_OPTIONAL(std::string, hint);
+    ADD_FIELD_OPTIONAL(proto_view, spiffe_id);
+    ADD_FIELD_OPTIONAL(proto_view, svid);
+    ADD_FIELD_OPTIONAL(proto_view, hint);
 };
 
 struct ProtoJwtSvidRequest {
@@ -111,17 +118,34 @@ struct ProtoJwtBundlesResponse {
     ADD_FIELD_OPTIONAL(std::vector<ProtoMapItem>, bundles);
 };
 
+// Sized up front and written in a single allocation, nested messages included. The first
+// reserved bytes are left zeroed for the caller, e.g. the gRPC frame header.
 template <typename ProtoMessage>
-std::vector<uint8_t> encode_proto_message(ProtoMessage& message) {
-    auto writer = message.serialize();
-    std::vector<uint8_t> buffer(writer->m_buf, writer->m_buf + writer->m_pos);
-    delete writer;
+std::vector<uint8_t> encode_proto_message(ProtoMessage& message, size_t reserved = 0) {
+    std::vector<uint8_t> buffer(reserved + message.serialized_size());
+    proto_writer writer(buffer.data() + reserved, buffer.size() - reserved);
+    message.serialize_to(&writer);
 
     return buffer;
 }
 
+// Framed request body, ready to send, without the copy of GrpcFraming::pack_message
+template <typename ProtoMessage>
+std::vector<uint8_t> encode_grpc_message(ProtoMessage& message) {
+    std::vector<uint8_t> buffer = encode_proto_message(message, GRPC_FRAME_HEADER_LEN);
+    GrpcFraming::write_header(buffer.data(), buffer.size() - GRPC_FRAME_HEADER_LEN);
+
+    return buffer;
+}
+
+// proto_view fields of message point into data
+template <typename ProtoMessage>
+bool decode_proto_message(const uint8_t* data, size_t size, ProtoMessage& message) {
+    return message.deserialize(data, size);
+}
+
 template <typename ProtoMessage>
-bool decode_proto_message(std::vector<uint8_t>& buffer, ProtoMessage& message) {
+bool decode_proto_message(const std::vector<uint8_t>& buffer, ProtoMessage& message) {
     return message.deserialize(buffer.data(), buffer.size());
 }
 
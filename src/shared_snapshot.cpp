@@ -0,0 +1,543 @@
+#include <spiffe/shared_snapshot.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "stream_retry.h"
+
+namespace spiffe {
+
+namespace {
+
+const uint64_t REGION_MAGIC = 0x4e4f494745524653;  // "SFREGION"
+const uint64_t DATA_MAGIC = 0x415441444e505346;    // "FSPNDATA"
+const uint32_t VERSION = 1;
+
+enum : uint32_t { X509_SVID = 0, X509_BUNDLES = 1, JWT_BUNDLES = 2, RPC_COUNT = 3 };
+const char* const RPC_NAMES[RPC_COUNT] = {"x509_svid", "x509_bundles", "jwt_bundles"};
+
+// Generations are loaded and stored by unrelated processes, which needs address-free atomics
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "64 bit atomics must be lock-free");
+
+// The region file, written by the publisher only
+struct RegionHeader {
+    std::atomic<uint64_t> magic;  // stored last, once the rest is initialized
+    uint32_t version;
+    uint32_t rpc_count;
+
+    // Generation of the current file of each RPC, 0 before the first update
+    std::atomic<uint64_t> generations[RPC_COUNT];
+};
+
+// Front of the file of one update, followed by its arena. Aligned so that the arena's records are.
+struct alignas(16) DataHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t rpc;
+    uint64_t generation;
+    uint64_t arena_size;
+    CompactLayout layout;  // compact contexts
+    uint64_t jwt_count;    // JWT bundles
+};
+
+// JWT bundles arena: jwt_count records sorted by trust domain, then the strings
+struct JwtBundleRecord {
+    uint32_t trust_domain_offset;
+    uint32_t trust_domain_size;
+    uint32_t jwks_offset;
+    uint32_t jwks_size;
+};
+
+// Options with the defaults that depend on the process filled in
+SharedSnapshotOptions resolved(SharedSnapshotOptions options) {
+    if (options.directory.empty()) {
+        options.directory = "/dev/shm/spiffe-" + std::to_string(geteuid());
+    }
+    if (options.owner == static_cast<uid_t>(-1)) {
+        options.owner = geteuid();
+    }
+    return options;
+}
+
+// Only the owner can have put the contents there
+bool trusted(const struct stat& st, uid_t owner) { return st.st_uid == owner && (st.st_mode & 022) == 0; }
+
+bool within(size_t offset, size_t size, size_t arena_size) {
+    return offset <= arena_size && size <= arena_size - offset;
+}
+
+std::string region_path(const SharedSnapshotOptions& options) { return options.directory + "/" + options.name; }
+
+std::string data_path(const SharedSnapshotOptions& options, uint32_t rpc, uint64_t generation) {
+    return region_path(options) + "." + RPC_NAMES[rpc] + "." + std::to_string(generation);
+}
+
+Status io_error(const char* operation, const std::string& path, int error) {
+    return Status{.code = 13, .message = std::string(operation) + " " + path + ": " + std::strerror(error)};
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const uint8_t* cursor = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, cursor, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        cursor += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Whole file mapped read-only, unmapped with the last reference. nullptr if it cannot be opened
+// or is not a regular file trusted for owner. st gets the file's status.
+std::shared_ptr<const void> map_read_only(const std::string& path, uid_t owner, size_t& size, struct stat& st) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && trusted(st, owner) && st.st_size > 0) {
+        size = static_cast<size_t>(st.st_size);
+        data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    size_t mapped = size;
+    return std::shared_ptr<const void>(data, [mapped](const void* p) { munmap(const_cast<void*>(p), mapped); });
+}
+
+// Generation of a file name "<name>.<rpc>.<generation>" of rpc, 0 if it is not one
+uint64_t data_file_generation(const std::string& file, const std::string& name, uint32_t rpc) {
+    std::string prefix = name + "." + RPC_NAMES[rpc] + ".";
+    if (file.size() <= prefix.size() || file.compare(0, prefix.size(), prefix) != 0) {
+        return 0;
+    }
+    uint64_t generation = 0;
+    for (size_t i = prefix.size(); i < file.size(); ++i) {
+        if (file[i] < '0' || file[i] > '9' || generation > (UINT64_MAX - 9) / 10) {
+            return 0;
+        }
+        generation = generation * 10 + static_cast<uint64_t>(file[i] - '0');
+    }
+    return generation;
+}
+
+int compare(StringView a, StringView b) {
+    size_t common = std::min(a.size(), b.size());
+    int result = common ? std::memcmp(a.data(), b.data(), common) : 0;
+    if (result != 0) {
+        return result;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+}  // namespace
+
+// Region file held by a publisher: locked, so that there is one publisher at a time, and mapped
+// read-write
+struct SharedSnapshotRegion {
+    int fd = -1;
+    RegionHeader* header = nullptr;
+
+    ~SharedSnapshotRegion() {
+        if (header) {
+            munmap(header, sizeof(RegionHeader));
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+StringView SharedJwtBundles::trust_domain(size_t i) const {
+    const JwtBundleRecord& record = reinterpret_cast<const JwtBundleRecord*>(arena_)[i];
+    return StringView(reinterpret_cast<const char*>(arena_) + record.trust_domain_offset, record.trust_domain_size);
+}
+
+StringView SharedJwtBundles::jwks(size_t i) const {
+    const JwtBundleRecord& record = reinterpret_cast<const JwtBundleRecord*>(arena_)[i];
+    return StringView(reinterpret_cast<const char*>(arena_) + record.jwks_offset, record.jwks_size);
+}
+
+bool SharedJwtBundles::find(StringView trust_domain, StringView& jwks) const {
+    size_t begin = 0;
+    size_t end = count_;
+    while (begin < end) {
+        size_t middle = begin + (end - begin) / 2;
+        int result = compare(this->trust_domain(middle), trust_domain);
+        if (result == 0) {
+            jwks = this->jwks(middle);
+            return true;
+        }
+        if (result < 0) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return false;
+}
+
+JwtBundles SharedJwtBundles::to_jwt_bundles() const {
+    JwtBundles bundles;
+    bundles.bundles.reserve(count_);
+    for (size_t i = 0; i < count_; ++i) {
+        bundles.bundles.emplace(trust_domain(i).to_string(), jwks(i).to_string());
+    }
+    return bundles;
+}
+
+SharedSnapshotPublisher::SharedSnapshotPublisher(const std::string& socket_path, const SharedSnapshotOptions& options,
+                                                 const ClientOptions& client_options)
+    : options_(resolved(options)), client_(socket_path, with_stream_retry(client_options)) {}
+
+SharedSnapshotPublisher::~SharedSnapshotPublisher() { close(); }
+
+Status SharedSnapshotPublisher::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (region_) {
+        return Status();
+    }
+
+    // Private, or only searchable by those the mode lets read: files are opened by name
+    const std::string& directory = options_.directory;
+    mode_t directory_mode = 0700 | ((options_.mode & 0044) >> 2);
+    if (mkdir(directory.c_str(), directory_mode) != 0 && errno != EEXIST) {
+        return io_error("create", directory, errno);
+    }
+    struct stat st;
+    if (lstat(directory.c_str(), &st) != 0) {
+        return io_error("stat", directory, errno);
+    }
+    if (!S_ISDIR(st.st_mode) || !trusted(st, geteuid())) {
+        return Status{.code = 9, .message = directory + " must be a directory of this user, not writable by others"};
+    }
+
+    std::string path = region_path(options_);
+    std::unique_ptr<SharedSnapshotRegion> region(new SharedSnapshotRegion());
+    region->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, options_.mode);
+    if (region->fd < 0) {
+        return io_error("open", path, errno);
+    }
+    if (flock(region->fd, LOCK_EX | LOCK_NB) != 0) {
+        if (errno == EWOULDBLOCK) {
+            return Status{.code = 9, .message = "Another publisher holds " + path};
+        }
+        return io_error("lock", path, errno);
+    }
+
+    // The mode applies as given, whatever the umask or a previous publisher left
+    if (fchmod(region->fd, options_.mode) != 0 || ftruncate(region->fd, sizeof(RegionHeader)) != 0) {
+        return io_error("prepare", path, errno);
+    }
+    void* data = mmap(nullptr, sizeof(RegionHeader), PROT_READ | PROT_WRITE, MAP_SHARED, region->fd, 0);
+    if (data == MAP_FAILED) {
+        return io_error("map", path, errno);
+    }
+    region->header = static_cast<RegionHeader*>(data);
+
+    // The generations of a previous publisher are continued, a reader must never see a
+    // generation it cached come back with other contents
+    RegionHeader& header = *region->header;
+    if (header.magic.load(std::memory_order_relaxed) != REGION_MAGIC || header.version != VERSION ||
+        header.rpc_count != RPC_COUNT) {
+        header.magic.store(0, std::memory_order_relaxed);
+        header.version = VERSION;
+        header.rpc_count = RPC_COUNT;
+        for (std::atomic<uint64_t>& generation : header.generations) {
+            generation.store(0, std::memory_order_relaxed);
+        }
+        header.magic.store(REGION_MAGIC, std::memory_order_release);
+    }
+
+    // Files of older generations whose unlink a publisher did not get to, and of newer ones it
+    // died before publishing. Readers that mapped them keep them.
+    if (DIR* dir = opendir(directory.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            for (uint32_t rpc = 0; rpc < RPC_COUNT; ++rpc) {
+                uint64_t generation = data_file_generation(entry->d_name, options_.name, rpc);
+                if (generation != 0 && generation != header.generations[rpc].load(std::memory_order_relaxed)) {
+                    unlinkat(dirfd(dir), entry->d_name, 0);
+                }
+            }
+        }
+        closedir(dir);
+    }
+
+    region_ = std::move(region);
+    return Status();
+}
+
+Status SharedSnapshotPublisher::start() {
+    Status status = open();
+    if (!status.is_ok() || x509_svid_thread_.joinable()) {
+        return status;
+    }
+
+    cancellation_ = CancellationSource();
+    CancellationToken token = cancellation_.token();
+    x509_svid_thread_ = std::thread([this, token] {
+        client_.fetch_x509_svid_compact([this](const CompactX509SvidContext& context) { return publish(context); },
+                                        token);
+    });
+    x509_bundles_thread_ = std::thread([this, token] {
+        client_.fetch_x509_bundles_compact(
+            [this](const CompactX509BundlesContext& context) { return publish(context); }, token);
+    });
+    jwt_bundles_thread_ = std::thread([this, token] {
+        client_.fetch_jwt_bundles([this](const JwtBundles& bundles) { return publish(bundles); }, token);
+    });
+    return Status();
+}
+
+void SharedSnapshotPublisher::close() {
+    if (!x509_svid_thread_.joinable()) {
+        return;
+    }
+
+    cancellation_.cancel();
+    x509_svid_thread_.join();
+    x509_bundles_thread_.join();
+    jwt_bundles_thread_.join();
+}
+
+Status SharedSnapshotPublisher::publish(const CompactX509SvidContext& context) {
+    return write(X509_SVID, context.layout_, 0, context.arena_.get(), context.layout_.size);
+}
+
+Status SharedSnapshotPublisher::publish(const CompactX509BundlesContext& context) {
+    return write(X509_BUNDLES, context.layout_, 0, context.arena_.get(), context.layout_.size);
+}
+
+Status SharedSnapshotPublisher::publish(const JwtBundles& bundles) {
+    std::vector<std::pair<StringView, StringView>> sorted;
+    sorted.reserve(bundles.bundles.size());
+    size_t size = bundles.bundles.size() * sizeof(JwtBundleRecord);
+    for (const auto& entry : bundles.bundles) {
+        sorted.emplace_back(entry.first, entry.second);
+        size += entry.first.size() + entry.second.size();
+    }
+    if (size > UINT32_MAX) {
+        return Status{.code = 3, .message = "JWT bundles too large to share"};
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<StringView, StringView>& a,
+                                               const std::pair<StringView, StringView>& b) {
+        return compare(a.first, b.first) < 0;
+    });
+
+    std::vector<uint8_t> arena(size);
+    size_t cursor = sorted.size() * sizeof(JwtBundleRecord);
+    auto append = [&](StringView text) {
+        uint32_t offset = static_cast<uint32_t>(cursor);
+        std::memcpy(arena.data() + cursor, text.data(), text.size());
+        cursor += text.size();
+        return offset;
+    };
+    JwtBundleRecord* records = reinterpret_cast<JwtBundleRecord*>(arena.data());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        records[i].trust_domain_offset = append(sorted[i].first);
+        records[i].trust_domain_size = static_cast<uint32_t>(sorted[i].first.size());
+        records[i].jwks_offset = append(sorted[i].second);
+        records[i].jwks_size = static_cast<uint32_t>(sorted[i].second.size());
+    }
+
+    return write(JWT_BUNDLES, CompactLayout(), sorted.size(), arena.data(), arena.size());
+}
+
+Status SharedSnapshotPublisher::write(uint32_t rpc, const CompactLayout& layout, size_t jwt_count,
+                                      const uint8_t* arena, size_t arena_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!region_) {
+        return Status{.code = 9, .message = "Shared snapshot region is not open"};
+    }
+
+    std::atomic<uint64_t>& published = region_->header->generations[rpc];
+    uint64_t previous = published.load(std::memory_order_relaxed);
+    uint64_t generation = previous + 1;
+
+    DataHeader header{};
+    header.magic = DATA_MAGIC;
+    header.version = VERSION;
+    header.rpc = rpc;
+    header.generation = generation;
+    header.arena_size = arena_size;
+    header.layout = layout;
+    header.jwt_count = jwt_count;
+
+    // Written aside, the file only becomes visible to readers once complete. A file of this
+    // generation can only be left over by a publisher that died before publishing it.
+    std::string path = data_path(options_, rpc, generation);
+    ::unlink(path.c_str());
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC | O_NOFOLLOW, options_.mode);
+    if (fd < 0) {
+        return io_error("create", path, errno);
+    }
+    bool written = fchmod(fd, options_.mode) == 0 && write_all(fd, &header, sizeof(header)) &&
+                   write_all(fd, arena, arena_size);
+    int error = errno;
+    ::close(fd);
+    if (!written) {
+        ::unlink(path.c_str());
+        return io_error("write", path, error);
+    }
+
+    published.store(generation, std::memory_order_release);
+
+    // Readers that mapped the previous file keep it until they unmap it
+    if (previous) {
+        ::unlink(data_path(options_, rpc, previous).c_str());
+    }
+    return Status();
+}
+
+SharedSnapshotReader::SharedSnapshotReader(const SharedSnapshotOptions& options) : options_(resolved(options)) {}
+
+SharedSnapshotReader::~SharedSnapshotReader() = default;
+
+uint64_t SharedSnapshotReader::published(uint32_t rpc) {
+    // A publisher that found no region file creates a new one, with generations from 1 again
+    if (region_) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - region_checked_ >= options_.region_check_interval) {
+            region_checked_ = now;
+            struct stat st;
+            if (stat(region_path(options_).c_str(), &st) == 0 &&
+                (st.st_dev != region_device_ || st.st_ino != region_inode_)) {
+                region_.reset();
+            }
+        }
+    }
+
+    if (!region_) {
+        // The directory first: whoever can write to it can swap the files
+        struct stat st;
+        if (lstat(options_.directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || !trusted(st, options_.owner)) {
+            return 0;
+        }
+        size_t size = 0;
+        std::shared_ptr<const void> region = map_read_only(region_path(options_), options_.owner, size, st);
+        if (!region || size < sizeof(RegionHeader)) {
+            return 0;
+        }
+        region_ = std::move(region);
+        region_device_ = st.st_dev;
+        region_inode_ = st.st_ino;
+        region_checked_ = std::chrono::steady_clock::now();
+        ++region_id_;
+    }
+
+    const RegionHeader& header = *static_cast<const RegionHeader*>(region_.get());
+    if (header.magic.load(std::memory_order_acquire) != REGION_MAGIC || header.version != VERSION) {
+        return 0;
+    }
+    return header.generations[rpc].load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const void> SharedSnapshotReader::map(uint32_t rpc, uint64_t generation, const uint8_t*& arena,
+                                                      CompactLayout& layout, size_t& jwt_count) {
+    size_t size = 0;
+    struct stat st;
+    std::shared_ptr<const void> mapping = map_read_only(data_path(options_, rpc, generation), options_.owner, size, st);
+    if (!mapping || size < sizeof(DataHeader)) {
+        return nullptr;
+    }
+
+    const DataHeader& header = *static_cast<const DataHeader*>(mapping.get());
+    if (header.magic != DATA_MAGIC || header.version != VERSION || header.rpc != rpc ||
+        header.generation != generation || header.arena_size > size - sizeof(DataHeader) ||
+        header.layout.size > header.arena_size || header.jwt_count > header.arena_size / sizeof(JwtBundleRecord)) {
+        return nullptr;
+    }
+    arena = static_cast<const uint8_t*>(mapping.get()) + sizeof(DataHeader);
+
+    // Every offset within the arena, the views of the snapshot are not checked again
+    if (rpc == JWT_BUNDLES) {
+        const JwtBundleRecord* records = reinterpret_cast<const JwtBundleRecord*>(arena);
+        for (size_t i = 0; i < header.jwt_count; ++i) {
+            if (!within(records[i].trust_domain_offset, records[i].trust_domain_size, header.arena_size) ||
+                !within(records[i].jwks_offset, records[i].jwks_size, header.arena_size)) {
+                return nullptr;
+            }
+        }
+    } else if (!CompactContext::within_arena(arena, header.layout)) {
+        return nullptr;
+    }
+    layout = header.layout;
+    jwt_count = header.jwt_count;
+    return mapping;
+}
+
+template <typename Snapshot, typename Make>
+const Snapshot* SharedSnapshotReader::get(uint32_t rpc, Cached<Snapshot>& cached, Make make) {
+    // The file of a generation is unlinked once the next one is published, a reader that lost
+    // the race reads the generation again
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        uint64_t generation = published(rpc);
+        if (generation == cached.generation && region_id_ == cached.region) {
+            break;
+        }
+        if (generation == 0) {
+            cached = Cached<Snapshot>();
+            break;
+        }
+
+        const uint8_t* arena = nullptr;
+        CompactLayout layout;
+        size_t jwt_count = 0;
+        std::shared_ptr<const void> mapping = map(rpc, generation, arena, layout, jwt_count);
+        if (mapping) {
+            cached.snapshot = make(std::move(mapping), arena, layout, jwt_count);
+            cached.generation = generation;
+            cached.region = region_id_;
+            break;
+        }
+    }
+    return cached.snapshot.get();
+}
+
+const CompactX509SvidContext* SharedSnapshotReader::x509_svid() {
+    return get(X509_SVID, x509_svid_,
+               [](std::shared_ptr<const void> mapping, const uint8_t* arena, const CompactLayout& layout, size_t) {
+                   std::unique_ptr<CompactX509SvidContext> context(new CompactX509SvidContext());
+                   context->arena_ = std::unique_ptr<const uint8_t[], CompactArenaDeleter>(
+                       arena, CompactArenaDeleter{std::move(mapping)});
+                   context->layout_ = layout;
+                   return context;
+               });
+}
+
+const CompactX509BundlesContext* SharedSnapshotReader::x509_bundles() {
+    return get(X509_BUNDLES, x509_bundles_,
+               [](std::shared_ptr<const void> mapping, const uint8_t* arena, const CompactLayout& layout, size_t) {
+                   std::unique_ptr<CompactX509BundlesContext> context(new CompactX509BundlesContext());
+                   context->arena_ = std::unique_ptr<const uint8_t[], CompactArenaDeleter>(
+                       arena, CompactArenaDeleter{std::move(mapping)});
+                   context->layout_ = layout;
+                   return context;
+               });
+}
+
+const SharedJwtBundles* SharedSnapshotReader::jwt_bundles() {
+    return get(JWT_BUNDLES, jwt_bundles_,
+               [](std::shared_ptr<const void> mapping, const uint8_t* arena, const CompactLayout&, size_t count) {
+                   return std::unique_ptr<SharedJwtBundles>(new SharedJwtBundles(std::move(mapping), arena, count));
+               });
+}
+
+}  // namespace spiffe
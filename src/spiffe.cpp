@@ -1,8 +1,16 @@
 #include <spiffe/spiffe.h>
 
-#include "der.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <random>
+
+#include "context_decoder.h"
+#include "delta_tracker.h"
 #include "grpc_client.h"
+#include "jwt_svid_cache.h"
 #include "proto/workloadapi.h"
+#include "stream_retry.h"
 
 namespace spiffe {
 
@@ -10,230 +18,506 @@ const std::vector<GrpcMetadata> DEFAULT_SPIFFE_GRPC_METADATA = {
     {"workload.spiffe.io", "true"},
 };
 
+namespace {
+
+// Measures one call for ClientOptions::metrics, does nothing without metrics
+class CallMetrics {
+   public:
+    CallMetrics(Metrics* metrics, RpcMethod method) : metrics_(metrics), method_(method) {
+        if (metrics_) start_ = Clock::now();
+    }
+
+    // Timing for decoding one message, nullptr without metrics
+    DecodeTiming* decode_timing() {
+        timing_ = DecodeTiming();
+        return metrics_ ? &timing_ : nullptr;
+    }
+
+    // The message was decoded with decode_timing()
+    void decoded() {
+        if (metrics_) metrics_->on_decode(method_, timing_.proto, timing_.der);
+    }
+
+    // Hands an update to the user callback, as Status()
+    template <typename Callback>
+    Status update(const Callback& callback) {
+        if (!metrics_) {
+            return callback();
+        }
+
+        Clock::time_point begin = Clock::now();
+        if (first_update_) {
+            first_update_ = false;
+            metrics_->on_first_update(method_, begin - start_);
+        }
+        Status status = callback();
+        metrics_->on_callback(method_, Clock::now() - begin);
+        return status;
+    }
+
+    void done(int status_code) {
+        if (metrics_) metrics_->on_rpc_done(method_, status_code, Clock::now() - start_);
+    }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    Metrics* metrics_;
+    RpcMethod method_;
+    Clock::time_point start_;
+    DecodeTiming timing_;
+    bool first_update_ = true;
+};
+
+// State of one streaming call across reconnects, see WorkloadApiClient::Impl::run_stream
+class StreamRun {
+   public:
+    explicit StreamRun(bool retry) : retry_(retry) {}
+
+    void begin_attempt() {
+        first_ = true;
+        received_ = false;
+    }
+
+    // An update arrived during the current attempt, whether or not the callback received it:
+    // an agent that restarts and sends the same update again is up, and the backoff starts over
+    bool received() const { return received_; }
+
+    // An update arrived that left the context unchanged
+    void unchanged() { received_ = true; }
+
+    // The callback returned an error, which ends the call for good
+    bool callback_failed() const { return callback_failed_; }
+
+    // Whether message is the first of a reconnected stream and identical to the last update
+    // delivered, which the callback then does not receive again
+    bool repeated(BufferView message) {
+        bool first = first_;
+        first_ = false;
+        if (first && has_last_ && last_.size() == message.size() &&
+            std::equal(message.begin(), message.end(), last_.begin())) {
+            unchanged();
+            return true;
+        }
+        return false;
+    }
+
+    // Hands the update decoded from message to the callback, as the stream status
+    template <typename Callback>
+    GrpcStatus deliver(CallMetrics& call, BufferView message, const Callback& callback) {
+        if (retry_) {
+            last_.assign(message.begin(), message.end());
+            has_last_ = true;
+        }
+        return deliver(call, callback);
+    }
+
+    // Same, for streams detecting repeated updates on their own
+    template <typename Callback>
+    GrpcStatus deliver(CallMetrics& call, const Callback& callback) {
+        received_ = true;
+
+        Status status = call.update(callback);
+        if (!status.is_ok()) {
+            callback_failed_ = true;
+            return GrpcStatus{
+                .code = status.code,
+                .message = status.message,
+            };
+        }
+        return GrpcStatus{
+            .code = 0,  // OK
+        };
+    }
+
+   private:
+    bool retry_;
+    bool first_ = true;  // no message yet during the current attempt
+    bool received_ = false;
+    bool callback_failed_ = false;
+
+    // Last message delivered, only kept with retry
+    Buffer last_;
+    bool has_last_ = false;
+};
+
+}  // namespace
+
 class WorkloadApiClient::Impl {
    public:
-    Impl(const std::string& socket_path) : socket_path_(socket_path) { curl_global_init(CURL_GLOBAL_DEFAULT); }
-    ~Impl() { curl_global_cleanup(); }
+    Impl(const std::string& socket_path, const ClientOptions& options)
+        : socket_path_(socket_path), stream_retry_(options.stream_retry), metrics_(options.metrics) {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        client_.reset(new GrpcClient(socket_path_, metrics_.get(), options.max_message_size));
+
+        if (options.jwt_svid_cache.enabled) {
+            jwt_svid_cache_.reset(new JwtSvidCache(options.jwt_svid_cache));
+        }
+    }
+    ~Impl() {
+        client_.reset();
+        curl_global_cleanup();
+    }
 
     Status fetch_x509_svid(std::function<Status(const X509SvidContext&)> callback,
-                           std::shared_future<void> cancellation_token) {
-        GrpcClient client(socket_path_);
+                           CancellationToken cancellation_token) {
+        ProtoX509SvidRequest request;
+        return fetch_stream(RpcMethod::X509Svid, encode_grpc_message(request), decode_x509_svid_context, callback,
+                            cancellation_token);
+    }
 
+    Status fetch_x509_svid_compact(std::function<Status(const CompactX509SvidContext&)> callback,
+                                   CancellationToken cancellation_token) {
         ProtoX509SvidRequest request;
+        return fetch_stream(RpcMethod::X509Svid, encode_grpc_message(request), decode_compact_x509_svid_context,
+                            callback, cancellation_token);
+    }
 
-        Buffer request_buf = encode_proto_message(request);
-
-        GrpcStatus grpc_status = client.call_stream(
-            "SpiffeWorkloadAPI", "FetchX509SVID", request_buf,
-            [&](const GrpcResponse& response) {
-                ProtoX509SvidResponse proto_response;
-                Buffer cloned_data(response.data);
-                if (!decode_proto_message(cloned_data, proto_response)) {
-                    return GrpcStatus{
-                        .code = 13,
-                        .message = "decode gRPC response failed",
-                    };
-                }
-
-                X509SvidContext context;
-                for (auto svid : proto_response.svids.get()) {
-                    auto x509_svid = extract_all_certificates(svid.x509_svid.get());
-                    auto x509_svid_key = svid.x509_svid_key.get();
-                    auto bundle = extract_all_certificates(svid.bundle.get());
-
-                    context.svids.emplace_back(X509Svid{
-                        .spiffe_id = svid.spiffe_id.get(),
-                        .x509_svid = x509_svid,
-                        .x509_svid_key = Buffer(x509_svid_key.begin(), x509_svid_key.end()),
-                        .bundle = bundle,
-                        .hint = svid.hint.get(),
-                    });
-                }
-
-                for (const auto& crl : proto_response.crl.get()) {
-                    context.crl.push_back(Buffer(crl.begin(), crl.end()));
-                }
-
-                for (auto& item : proto_response.federated_bundles.get()) {
-                    context.federated_bundles[item.key.get()] = extract_all_certificates(item.value.get());
-                }
-
-                Status status = callback(context);
-                if (!status.is_ok()) {
-                    return GrpcStatus{
-                        .code = status.code,
-                        .message = status.message,
-                    };
-                }
-                return GrpcStatus{
-                    .code = 0,  // OK
-                };
-            },
-            DEFAULT_SPIFFE_GRPC_METADATA, cancellation_token);
+    Status fetch_x509_bundle(std::function<Status(const X509BundlesContext&)> callback,
+                             CancellationToken cancellation_token) {
+        ProtoJwtBundlesRequest request;
+        return fetch_stream(RpcMethod::X509Bundles, encode_grpc_message(request), decode_x509_bundles_context,
+                            callback, cancellation_token);
+    }
 
-        return Status{.code = grpc_status.code, .message = grpc_status.message};
+    Status fetch_x509_bundle_compact(std::function<Status(const CompactX509BundlesContext&)> callback,
+                                     CancellationToken cancellation_token) {
+        ProtoJwtBundlesRequest request;
+        return fetch_stream(RpcMethod::X509Bundles, encode_grpc_message(request), decode_compact_x509_bundles_context,
+                            callback, cancellation_token);
     }
 
-    Status fetch_x509_bundle(std::function<Status(const X509BundlesContext&)> callback,
-                             std::shared_future<void> cancellation_token) {
-        GrpcClient client(socket_path_);
+    template <typename Tracker, typename Context, typename Delta>
+    Status watch(RpcMethod method, const Buffer& request_buf,
+                 const std::function<Status(const Context&, const Delta&)>& callback,
+                 CancellationToken cancellation_token) {
+        // Kept across reconnects, so an unchanged update after one is not delivered
+        Tracker tracker;
+
+        return run_stream(method, cancellation_token, [&](CallMetrics& call, StreamRun& run) {
+            return client_->call_stream(
+                "SpiffeWorkloadAPI", rpc_method_name(method), request_buf,
+                [&](BufferView message) {
+                    Delta delta;
+                    if (!tracker.apply(message.data(), message.size(), delta, call.decode_timing())) {
+                        return GrpcStatus{
+                            .code = 13,
+                            .message = "decode gRPC response failed",
+                        };
+                    }
+                    call.decoded();
+                    if (delta.generation == 0) {
+                        run.unchanged();
+                        return GrpcStatus{
+                            .code = 0,  // OK, nothing changed
+                        };
+                    }
+
+                    return run.deliver(call, [&] { return callback(tracker.context(), delta); });
+                },
+                DEFAULT_SPIFFE_GRPC_METADATA, cancellation_token);
+        });
+    }
 
+    Status get_jwt_bundles(std::function<Status(const JwtBundles&)> callback,
+                           CancellationToken cancellation_token) {
         ProtoJwtBundlesRequest request;
 
-        Buffer request_buf = encode_proto_message(request);
-
-        GrpcStatus grpc_status = client.call_stream(
-            "SpiffeWorkloadAPI", "FetchX509Bundles", request_buf,
-            [&](const GrpcResponse& response) {
-                ProtoX509BundlesResponse proto_response;
-                Buffer cloned_data(response.data);
-                if (!decode_proto_message(cloned_data, proto_response)) {
-                    return GrpcStatus{
-                        .code = 13,
-                        .message = "decode gRPC response failed",
-                    };
-                }
-
-                X509BundlesContext context;
-                for (const auto& crl : proto_response.crl.get()) {
-                    context.crl.push_back(Buffer(crl.begin(), crl.end()));
-                }
-
-                for (auto& item : proto_response.bundles.get()) {
-                    context.bundles[item.key.get()] = extract_all_certificates(item.value.get());
-                }
-
-                Status status = callback(context);
-                if (!status.is_ok()) {
-                    return GrpcStatus{
-                        .code = status.code,
-                        .message = status.message,
-                    };
-                }
-                return GrpcStatus{
-                    .code = 0,  // OK
-                };
-            },
-            DEFAULT_SPIFFE_GRPC_METADATA, cancellation_token);
+        Buffer request_buf = encode_grpc_message(request);
+
+        return run_stream(RpcMethod::JwtBundles, cancellation_token, [&](CallMetrics& call, StreamRun& run) {
+            return client_->call_stream(
+                "SpiffeWorkloadAPI", "FetchJWTBundles", request_buf,
+                [&](BufferView message) {
+                    if (run.repeated(message)) {
+                        return GrpcStatus{
+                            .code = 0,  // OK, nothing changed since before the reconnect
+                        };
+                    }
+
+                    JwtBundles bundles;
+                    DecodeTimer timer(call.decode_timing());
+                    if (!decode_jwt_bundles(message.data(), message.size(), bundles)) {
+                        return GrpcStatus{
+                            .code = 13,
+                            .message = "decode gRPC response failed",
+                        };
+                    }
+                    timer.parsed();
+                    call.decoded();
+
+                    return run.deliver(call, message, [&] { return callback(bundles); });
+                },
+                DEFAULT_SPIFFE_GRPC_METADATA, cancellation_token);
+        });
+    }
 
-        return Status{
-            .code = grpc_status.code,
-            .message = grpc_status.message,
+    Status get_jwt_svid(std::vector<JwtSvid>& out, const std::vector<std::string>& audience,
+                        const std::string& spiffe_id, const std::chrono::milliseconds timeout) {
+        if (!jwt_svid_cache_) {
+            return fetch_jwt_svid_uncached(out, audience, spiffe_id, timeout);
+        }
+
+        return jwt_svid_cache_->get(out, audience, spiffe_id, [&](std::vector<JwtSvid>& fetched) {
+            return fetch_jwt_svid_uncached(fetched, audience, spiffe_id, timeout);
+        });
+    }
+
+    Status get_jwt_svids(const std::vector<JwtSvidRequest>& requests, std::vector<JwtSvidResult>& results,
+                         const std::chrono::milliseconds timeout) {
+        JwtSvidCache::FetchMany fetch = [&](const std::vector<JwtSvidRequest>& all, const std::vector<size_t>& misses,
+                                            std::vector<JwtSvidResult>& fetched) {
+            fetch_jwt_svids_uncached(all, misses, fetched, timeout);
         };
+
+        if (jwt_svid_cache_) {
+            jwt_svid_cache_->get_many(requests, results, fetch);
+        } else {
+            std::vector<size_t> all(requests.size());
+            for (size_t i = 0; i < all.size(); ++i) {
+                all[i] = i;
+            }
+            results.assign(requests.size(), JwtSvidResult());
+            fetch(requests, all, results);
+        }
+
+        for (const auto& result : results) {
+            if (!result.status.is_ok()) {
+                return result.status;
+            }
+        }
+        return Status{};
     }
 
-    Status get_jwt_bundles(std::function<Status(const JwtBundles&)> callback,
-                           std::shared_future<void> cancellation_token) {
-        GrpcClient client(socket_path_);
+   private:
+    std::string socket_path_;
 
-        ProtoJwtBundlesRequest request;
+    // Shared by all calls, multiplexes them over one connection to the agent
+    std::unique_ptr<GrpcClient> client_;
 
-        Buffer request_buf = encode_proto_message(request);
-
-        GrpcStatus grpc_status = client.call_stream(
-            "SpiffeWorkloadAPI", "FetchJWTBundles", request_buf,
-            [&](const GrpcResponse& response) {
-                ProtoJwtBundlesResponse proto_response;
-                Buffer cloned_data(response.data);
-                if (!decode_proto_message(cloned_data, proto_response)) {
-                    return GrpcStatus{
-                        .code = 13,
-                        .message = "decode gRPC response failed",
-                    };
-                }
-
-                JwtBundles bundles;
-                for (auto item : proto_response.bundles.get()) {
-                    bundles.bundles[item.key.get()] = item.value.get();
-                }
-
-                Status status = callback(bundles);
-                if (!status.is_ok()) {
-                    return GrpcStatus{
-                        .code = status.code,
-                        .message = status.message,
-                    };
-                }
-
-                return GrpcStatus{
-                    .code = 0,  // OK
-                };
-            },
-            DEFAULT_SPIFFE_GRPC_METADATA, cancellation_token);
+    // nullptr unless enabled in ClientOptions
+    std::unique_ptr<JwtSvidCache> jwt_svid_cache_;
 
-        return Status{
-            .code = grpc_status.code,
-            .message = grpc_status.message,
-        };
+    StreamRetryOptions stream_retry_;
+
+    // nullptr unless set in ClientOptions
+    std::shared_ptr<Metrics> metrics_;
+
+    // Set when the last stream of a method failed, the next one is then a restart
+    std::array<std::atomic<bool>, RPC_METHOD_COUNT> stream_failed_{};
+
+    CallMetrics start_stream(RpcMethod method) {
+        if (metrics_ && stream_failed_[static_cast<size_t>(method)].exchange(false)) {
+            metrics_->on_stream_restart(method);
+        }
+        return CallMetrics(metrics_.get(), method);
     }
 
-    Status get_jwt_svid(std::vector<JwtSvid>& out, const std::vector<std::string>& audience,
-                        const std::string& spiffe_id, const std::chrono::milliseconds timeout) {
-        GrpcClient client(socket_path_);
+    void finish_stream(CallMetrics& call, RpcMethod method, const GrpcStatus& status) {
+        call.done(status.code);
 
-        ProtoJwtSvidRequest request;
-        request.audience.set(audience);
-        request.spiffe_id.set(spiffe_id);
+        // Cancelled by the user, not a failure
+        if (metrics_ && !status.is_ok() && status.code != 1) {
+            stream_failed_[static_cast<size_t>(method)].store(true);
+        }
+    }
+
+    // Decodes every message of a response stream into Context and hands it to callback
+    template <typename Context>
+    Status fetch_stream(RpcMethod method, const Buffer& request_buf,
+                        bool (*decode)(const uint8_t*, size_t, Context&, DecodeTiming*),
+                        const std::function<Status(const Context&)>& callback,
+                        CancellationToken cancellation_token) {
+        return run_stream(method, cancellation_token, [&](CallMetrics& call, StreamRun& run) {
+            return client_->call_stream(
+                "SpiffeWorkloadAPI", rpc_method_name(method), request_buf,
+                [&](BufferView message) {
+                    if (run.repeated(message)) {
+                        return GrpcStatus{
+                            .code = 0,  // OK, nothing changed since before the reconnect
+                        };
+                    }
+
+                    Context context;
+                    if (!decode(message.data(), message.size(), context, call.decode_timing())) {
+                        return GrpcStatus{
+                            .code = 13,
+                            .message = "decode gRPC response failed",
+                        };
+                    }
+                    call.decoded();
+
+                    return run.deliver(call, message, [&] { return callback(context); });
+                },
+                DEFAULT_SPIFFE_GRPC_METADATA, cancellation_token);
+        });
+    }
+
+    // Runs attempts of a stream, each opening it once, until the stream ends for good. Without
+    // ClientOptions::stream_retry that is after the first attempt.
+    template <typename Attempt>
+    Status run_stream(RpcMethod method, const CancellationToken& cancellation_token, const Attempt& attempt) {
+        StreamRun run(stream_retry_.enabled);
+        std::unique_ptr<StreamBackoff> backoff;
+
+        while (true) {
+            run.begin_attempt();
+            CallMetrics call = start_stream(method);
+            GrpcStatus grpc_status = attempt(call, run);
+            finish_stream(call, method, grpc_status);
+
+            Status status{
+                .code = grpc_status.code,
+                .message = grpc_status.message,
+            };
+            if (!stream_retry_.enabled || run.callback_failed() || !stream_retryable(status.code) ||
+                cancellation_token.is_cancelled()) {
+                return status;
+            }
+
+            if (!backoff) {
+                backoff.reset(new StreamBackoff(stream_retry_, std::random_device()()));
+            }
+            if (run.received()) {
+                backoff->reset();
+            }
+            if (stream_retry_.max_attempts != 0 && backoff->attempts() >= stream_retry_.max_attempts) {
+                return status;
+            }
+            if (!sleep_unless_cancelled(cancellation_token, backoff->next())) {
+                return Status{.code = 1, .message = "user cancelled"};
+            }
+        }
+    }
 
-        Buffer request_buf = encode_proto_message(request);
+    Status fetch_jwt_svid_uncached(std::vector<JwtSvid>& out, const std::vector<std::string>& audience,
+                                   const std::string& spiffe_id, const std::chrono::milliseconds timeout) {
+        CallMetrics call(metrics_.get(), RpcMethod::JwtSvid);
 
-        GrpcResult result = client.call(          //
-            "SpiffeWorkloadAPI", "FetchJWTSVID",  //
-            request_buf,                          //
-            DEFAULT_SPIFFE_GRPC_METADATA,         //
-            timeout                               //
+        GrpcResult result = client_->call(                  //
+            "SpiffeWorkloadAPI", "FetchJWTSVID",           //
+            encode_jwt_svid_request(audience, spiffe_id),  //
+            DEFAULT_SPIFFE_GRPC_METADATA,                  //
+            timeout                                        //
         );
 
+        return jwt_svid_status(call, result, out);
+    }
+
+    // Fetches requests[i] for each i in indices into results[i], all in one batch
+    void fetch_jwt_svids_uncached(const std::vector<JwtSvidRequest>& requests, const std::vector<size_t>& indices,
+                                  std::vector<JwtSvidResult>& results, const std::chrono::milliseconds timeout) {
+        std::vector<Buffer> request_bufs;
+        request_bufs.reserve(indices.size());
+        for (size_t i : indices) {
+            request_bufs.push_back(encode_jwt_svid_request(requests[i].audience, requests[i].spiffe_id));
+        }
+
+        std::vector<CallMetrics> calls(indices.size(), CallMetrics(metrics_.get(), RpcMethod::JwtSvid));
+        std::vector<GrpcResult> grpc_results = client_->call_many(  //
+            "SpiffeWorkloadAPI", "FetchJWTSVID",                    //
+            std::move(request_bufs),                                //
+            DEFAULT_SPIFFE_GRPC_METADATA,                           //
+            timeout                                                 //
+        );
+
+        for (size_t n = 0; n < indices.size(); ++n) {
+            JwtSvidResult& result = results[indices[n]];
+            result.status = jwt_svid_status(calls[n], grpc_results[n], result.svids);
+        }
+    }
+
+    static Buffer encode_jwt_svid_request(const std::vector<std::string>& audience, const std::string& spiffe_id) {
+        ProtoJwtSvidRequest request;
+        request.audience.set(audience);
+        request.spiffe_id.set(spiffe_id);
+        return encode_grpc_message(request);
+    }
+
+    // Decodes the response of a FetchJWTSVID call into out
+    static Status jwt_svid_status(CallMetrics& call, const GrpcResult& result, std::vector<JwtSvid>& out) {
         if (result.has_response) {
-            ProtoJwtSvidResponse response;
-            if (!decode_proto_message(result.response.data, response)) {
+            DecodeTimer timer(call.decode_timing());
+            if (!decode_jwt_svids(result.response.data.data(), result.response.data.size(), out)) {
+                call.done(13);
                 return Status{
                     .code = 13,
                     .message = "decode gRPC response failed",
                 };
             }
-
-            for (auto svid : response.svids.get()) {
-                out.emplace_back(JwtSvid{
-                    .spiffe_id = svid.spiffe_id.get(),
-                    .svid = svid.svid.get(),
-                    .hint = svid.hint.get(),
-                });
-            }
+            timer.parsed();
+            call.decoded();
         }
 
+        call.done(result.status.code);
         return Status{.code = result.status.code, .message = result.status.message};
     }
-
-   private:
-    std::string socket_path_;
 };
 
-WorkloadApiClient::WorkloadApiClient(const std::string& socket_path)
-    : impl_(std::make_unique<WorkloadApiClient::Impl>(socket_path)) {}
+WorkloadApiClient::WorkloadApiClient(const std::string& socket_path, const ClientOptions& options)
+    : impl_(std::make_unique<WorkloadApiClient::Impl>(socket_path, options)) {}
 WorkloadApiClient::~WorkloadApiClient() = default;
 
 WorkloadApiClient::WorkloadApiClient(WorkloadApiClient&&) = default;
 WorkloadApiClient& WorkloadApiClient::operator=(WorkloadApiClient&&) = default;
 
 Status WorkloadApiClient::fetch_x509_svid(std::function<Status(const X509SvidContext&)> callback,
-                                          std::shared_future<void> cancellation_token) {
+                                          CancellationToken cancellation_token) {
     return impl_->fetch_x509_svid(callback, cancellation_token);
 }
 
 Status WorkloadApiClient::fetch_x509_bundles(std::function<Status(const X509BundlesContext&)> callback,
-                                             std::shared_future<void> cancellation_token) {
+                                             CancellationToken cancellation_token) {
     return impl_->fetch_x509_bundle(callback, cancellation_token);
 }
 
+Status WorkloadApiClient::fetch_x509_svid_compact(std::function<Status(const CompactX509SvidContext&)> callback,
+                                                  CancellationToken cancellation_token) {
+    return impl_->fetch_x509_svid_compact(callback, cancellation_token);
+}
+
+Status WorkloadApiClient::fetch_x509_bundles_compact(std::function<Status(const CompactX509BundlesContext&)> callback,
+                                                     CancellationToken cancellation_token) {
+    return impl_->fetch_x509_bundle_compact(callback, cancellation_token);
+}
+
 Status WorkloadApiClient::fetch_jwt_bundles(std::function<Status(const JwtBundles&)> callback,
-                                            std::shared_future<void> cancellation_token) {
+                                            CancellationToken cancellation_token) {
     return impl_->get_jwt_bundles(callback, cancellation_token);
 }
 
+Status WorkloadApiClient::watch_x509_svid(
+    std::function<Status(const X509SvidContext&, const X509SvidDelta&)> callback,
+    CancellationToken cancellation_token) {
+    ProtoX509SvidRequest request;
+    return impl_->watch<X509SvidTracker>(RpcMethod::X509Svid, encode_grpc_message(request), callback,
+                                         cancellation_token);
+}
+
+Status WorkloadApiClient::watch_x509_bundles(
+    std::function<Status(const X509BundlesContext&, const X509BundlesDelta&)> callback,
+    CancellationToken cancellation_token) {
+    ProtoX509BundlesRequest request;
+    return impl_->watch<X509BundlesTracker>(RpcMethod::X509Bundles, encode_grpc_message(request), callback,
+                                            cancellation_token);
+}
+
+Status WorkloadApiClient::watch_jwt_bundles(std::function<Status(const JwtBundles&, const JwtBundlesDelta&)> callback,
+                                            CancellationToken cancellation_token) {
+    ProtoJwtBundlesRequest request;
+    return impl_->watch<JwtBundlesTracker>(RpcMethod::JwtBundles, encode_grpc_message(request), callback,
+                                           cancellation_token);
+}
+
 Status WorkloadApiClient::fetch_jwt_svid(std::vector<JwtSvid>& out, const std::vector<std::string>& audience,
                                          const std::string& spiffe_id, const std::chrono::milliseconds timeout) {
     return impl_->get_jwt_svid(out, audience, spiffe_id, timeout);
 }
 
+Status WorkloadApiClient::fetch_jwt_svids(const std::vector<JwtSvidRequest>& requests,
+                                          std::vector<JwtSvidResult>& results,
+                                          const std::chrono::milliseconds timeout) {
+    return impl_->get_jwt_svids(requests, results, timeout);
+}
+
 }  // namespace spiffe
@@ -0,0 +1,114 @@
+#include <spiffe/spiffe_id.h>
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace spiffe {
+
+const size_t SpiffeId::SCHEME_SIZE;
+
+namespace {
+
+// Limits of the SPIFFE ID specification
+const size_t MAX_ID_SIZE = 2048;
+const size_t MAX_TRUST_DOMAIN_SIZE = 255;
+
+bool is_trust_domain_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '_';
+}
+
+bool is_path_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '-' ||
+           c == '_';
+}
+
+bool is_trust_domain_name(StringView name) {
+    if (name.empty() || name.size() > MAX_TRUST_DOMAIN_SIZE) {
+        return false;
+    }
+    for (char c : name) {
+        if (!is_trust_domain_char(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+// Keys are views of the entries' names. Entries are never freed, so handles stay valid for the
+// lifetime of the process, including during static destruction.
+struct InternedTrustDomain::Table {
+    std::shared_timed_mutex mutex;
+    std::unordered_map<StringView, const Entry*, StringViewHash> entries;
+};
+
+InternedTrustDomain::Table& InternedTrustDomain::table() {
+    static Table* table = new Table();
+    return *table;
+}
+
+InternedTrustDomain InternedTrustDomain::intern(StringView name) {
+    if (!is_trust_domain_name(name)) {
+        return InternedTrustDomain();
+    }
+    InternedTrustDomain found = find(name);
+    if (!found.is_null()) {
+        return found;
+    }
+
+    Table& interned = table();
+    std::lock_guard<std::shared_timed_mutex> lock(interned.mutex);
+    auto it = interned.entries.find(name);
+    if (it == interned.entries.end()) {
+        Entry* entry = new Entry{name.to_string(), "spiffe://" + name.to_string()};
+        it = interned.entries.emplace(StringView(entry->name), entry).first;
+    }
+    return InternedTrustDomain(it->second);
+}
+
+InternedTrustDomain InternedTrustDomain::find(StringView name) {
+    Table& interned = table();
+    std::shared_lock<std::shared_timed_mutex> lock(interned.mutex);
+    auto it = interned.entries.find(name);
+    return it == interned.entries.end() ? InternedTrustDomain() : InternedTrustDomain(it->second);
+}
+
+bool SpiffeId::parse(StringView id, SpiffeId& out) {
+    const StringView SCHEME("spiffe://", SCHEME_SIZE);
+    if (id.size() > MAX_ID_SIZE || id.substr(0, SCHEME_SIZE) != SCHEME) {
+        return false;
+    }
+
+    // Trust domain, up to the first '/'
+    size_t pos = SCHEME_SIZE;
+    while (pos < id.size() && id[pos] != '/') {
+        ++pos;
+    }
+    size_t trust_domain_size = pos - SCHEME_SIZE;
+    if (!is_trust_domain_name(id.substr(SCHEME_SIZE, trust_domain_size))) {
+        return false;
+    }
+
+    // Path, "/segment" repeated
+    while (pos < id.size()) {
+        size_t start = ++pos;  // past the '/'
+        while (pos < id.size() && id[pos] != '/') {
+            if (!is_path_char(id[pos])) {
+                return false;
+            }
+            ++pos;
+        }
+        StringView segment = id.substr(start, pos - start);
+        if (segment.empty() || segment == StringView(".") || segment == StringView("..")) {
+            return false;
+        }
+    }
+
+    out.id_ = id;
+    out.trust_domain_size_ = trust_domain_size;
+    return true;
+}
+
+}  // namespace spiffe
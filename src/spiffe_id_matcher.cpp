@@ -0,0 +1,213 @@
+#include <spiffe/spiffe_id_matcher.h>
+
+#include <algorithm>
+#include <map>
+
+namespace spiffe {
+
+const uint32_t SpiffeIdMatcher::NONE;
+
+namespace {
+
+const size_t NO_NODE = SIZE_MAX;
+
+// Trie of the rules as written, where a segment may take both a literal and a wildcard branch
+struct RuleNode {
+    std::unordered_map<StringView, size_t, StringViewHash> literal;
+    size_t wildcard = NO_NODE;
+    bool accept = false;
+    bool accept_rest = false;
+};
+
+// Validated as a SPIFFE ID with its wildcard segments taken as literals. The parts are views
+// into rule.
+bool parse_rule(const std::string& rule, StringView& trust_domain, std::vector<StringView>& segments) {
+    std::string literal = rule;
+    segments.clear();
+    size_t path = rule.find('/', SpiffeId::SCHEME_SIZE);
+    for (size_t pos = path; pos < rule.size();) {
+        size_t start = pos + 1;
+        size_t end = std::min(rule.find('/', start), rule.size());
+        StringView segment(rule.data() + start, end - start);
+        if (segment == StringView("*") || segment == StringView("**")) {
+            if (segment.size() == 2 && end != rule.size()) {
+                return false;
+            }
+            std::fill(literal.begin() + start, literal.begin() + end, 'x');
+        }
+        segments.push_back(segment);
+        pos = end;
+    }
+
+    SpiffeId id;
+    if (!SpiffeId::parse(literal, id)) {
+        return false;
+    }
+    trust_domain = StringView(rule).substr(SpiffeId::SCHEME_SIZE, id.trust_domain_name().size());
+    return true;
+}
+
+}  // namespace
+
+Status SpiffeIdMatcher::compile(const std::vector<std::string>& rules, SpiffeIdMatcher& out) {
+    SpiffeIdMatcher matcher;
+
+    // Reserved so that the rules never move, the tries keep views into them
+    matcher.rules_.reserve(rules.size());
+
+    std::vector<RuleNode> rule_nodes;
+    std::unordered_map<StringView, size_t, StringViewHash> rule_roots;
+    std::vector<StringView> segments;
+    for (const std::string& text : rules) {
+        matcher.rules_.push_back(text);
+        const std::string& rule = matcher.rules_.back();
+
+        StringView trust_domain;
+        if (!parse_rule(rule, trust_domain, segments)) {
+            return Status{.code = 3, .message = "Invalid SPIFFE ID rule: " + rule};
+        }
+
+        auto root = rule_roots.find(trust_domain);
+        if (root == rule_roots.end()) {
+            root = rule_roots.emplace(trust_domain, rule_nodes.size()).first;
+            rule_nodes.emplace_back();
+        }
+        size_t node = root->second;
+        bool accept_rest = false;
+        for (StringView segment : segments) {
+            if (segment == StringView("**")) {
+                accept_rest = true;
+                break;
+            }
+            size_t& slot = segment == StringView("*") ? rule_nodes[node].wildcard
+                                                        : rule_nodes[node].literal.emplace(segment, NO_NODE).first->second;
+            if (slot == NO_NODE) {
+                slot = rule_nodes.size();
+            }
+            node = slot;
+            if (node == rule_nodes.size()) {
+                rule_nodes.emplace_back();
+            }
+        }
+        (accept_rest ? rule_nodes[node].accept_rest : rule_nodes[node].accept) = true;
+    }
+
+    // Subset construction: one node per set of rule nodes an ID prefix can be in, so that a
+    // segment always leads to a single next node
+    std::map<std::vector<size_t>, uint32_t> states;
+    std::vector<std::vector<size_t>> sets;
+    auto state = [&](std::vector<size_t> set) {
+        std::sort(set.begin(), set.end());
+        set.erase(std::unique(set.begin(), set.end()), set.end());
+        auto it = states.find(set);
+        if (it == states.end()) {
+            it = states.emplace(set, static_cast<uint32_t>(sets.size())).first;
+            sets.push_back(std::move(set));
+        }
+        return it->second;
+    };
+    for (const auto& root : rule_roots) {
+        matcher.roots_[root.first] = state({root.second});
+    }
+
+    for (size_t i = 0; i < sets.size(); ++i) {
+        const std::vector<size_t> set = sets[i];
+        Node node;
+        std::vector<size_t> wildcards;
+        for (size_t member : set) {
+            node.accept |= rule_nodes[member].accept;
+            node.accept_rest |= rule_nodes[member].accept_rest;
+            if (rule_nodes[member].wildcard != NO_NODE) {
+                wildcards.push_back(rule_nodes[member].wildcard);
+            }
+        }
+
+        // Everything below matches, there is nothing left to tell apart
+        if (node.accept_rest) {
+            node.accept = true;
+        } else {
+            // A literal segment also takes the wildcard branches
+            for (size_t member : set) {
+                for (const auto& child : rule_nodes[member].literal) {
+                    if (node.children.count(child.first)) {
+                        continue;
+                    }
+                    std::vector<size_t> next = wildcards;
+                    for (size_t other : set) {
+                        auto it = rule_nodes[other].literal.find(child.first);
+                        if (it != rule_nodes[other].literal.end()) {
+                            next.push_back(it->second);
+                        }
+                    }
+                    node.children[child.first] = state(std::move(next));
+                }
+            }
+            if (!wildcards.empty()) {
+                node.other = state(std::move(wildcards));
+            }
+        }
+
+        // Sets are numbered in the order they are built
+        matcher.nodes_.push_back(std::move(node));
+    }
+
+    out = std::move(matcher);
+    return Status();
+}
+
+bool SpiffeIdMatcher::matches(StringView id) const {
+    SpiffeId parsed;
+    return SpiffeId::parse(id, parsed) && matches(parsed);
+}
+
+bool SpiffeIdMatcher::matches(const SpiffeId& id) const {
+    auto root = roots_.find(id.trust_domain_name());
+    if (root == roots_.end()) {
+        return false;
+    }
+
+    // Path is "/segment" repeated
+    StringView path = id.path();
+    uint32_t node = root->second;
+    for (size_t pos = 0; pos < path.size();) {
+        if (nodes_[node].accept_rest) {
+            return true;
+        }
+        size_t start = pos + 1;
+        size_t end = start;
+        while (end < path.size() && path[end] != '/') {
+            ++end;
+        }
+        auto it = nodes_[node].children.find(path.substr(start, end - start));
+        node = it != nodes_[node].children.end() ? it->second : nodes_[node].other;
+        if (node == NONE) {
+            return false;
+        }
+        pos = end;
+    }
+    return nodes_[node].accept;
+}
+
+SpiffeIdAuthorizer::SpiffeIdAuthorizer() : matcher_(std::make_shared<const SpiffeIdMatcher>()) {}
+
+Status SpiffeIdAuthorizer::reload(const std::vector<std::string>& rules) {
+    SpiffeIdMatcher compiled;
+    Status status = SpiffeIdMatcher::compile(rules, compiled);
+    if (!status.is_ok()) {
+        return status;
+    }
+    std::shared_ptr<const SpiffeIdMatcher> next = std::make_shared<const SpiffeIdMatcher>(std::move(compiled));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        matcher_.swap(next);
+    }
+    // The previous matcher, if no request holds it anymore, is freed outside of the lock
+    return Status();
+}
+
+std::shared_ptr<const SpiffeIdMatcher> SpiffeIdAuthorizer::matcher() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return matcher_;
+}
+
+}  // namespace spiffe
@@ -0,0 +1,83 @@
+#include "stream_retry.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace spiffe {
+
+StreamBackoff::StreamBackoff(const StreamRetryOptions& options, uint64_t seed)
+    : options_(options), backoff_ms_(static_cast<double>(options.initial_backoff.count())), random_(seed) {}
+
+std::chrono::milliseconds StreamBackoff::next() {
+    double max_ms = static_cast<double>(options_.max_backoff.count());
+    double backoff_ms = std::min(backoff_ms_, max_ms);
+    double jitter = std::max(0.0, std::min(1.0, options_.jitter));
+
+    std::uniform_real_distribution<double> distribution(backoff_ms * (1 - jitter), backoff_ms);
+    double delay_ms = jitter > 0 ? distribution(random_) : backoff_ms;
+
+    backoff_ms_ = std::min(backoff_ms * std::max(1.0, options_.multiplier), max_ms);
+    ++attempts_;
+    return std::chrono::milliseconds(static_cast<int64_t>(delay_ms));
+}
+
+void StreamBackoff::reset() {
+    backoff_ms_ = static_cast<double>(options_.initial_backoff.count());
+    attempts_ = 0;
+}
+
+bool stream_retryable(int code) {
+    return code != 1      // CANCELLED
+           && code != 3;  // INVALID_ARGUMENT
+}
+
+ClientOptions with_stream_retry(ClientOptions options) {
+    options.stream_retry.enabled = true;
+    return options;
+}
+
+bool sleep_unless_cancelled(const CancellationToken& cancellation_token, std::chrono::milliseconds delay) {
+    if (cancellation_token.is_cancelled()) {
+        return false;
+    }
+    if (!cancellation_token.can_cancel()) {
+        std::this_thread::sleep_for(delay);
+        return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + delay;
+
+    if (!cancellation_token.can_notify()) {
+        // std::shared_future token, checked about once per second like in streaming calls
+        while (std::chrono::steady_clock::now() < deadline) {
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(remaining, std::chrono::seconds(1)));
+            if (cancellation_token.is_cancelled()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool cancelled = false;
+    uint64_t subscription = cancellation_token.subscribe([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        cv.notify_all();
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_until(lock, deadline, [&] { return cancelled; });
+    }
+    cancellation_token.unsubscribe(subscription);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return !cancelled;
+}
+
+}  // namespace spiffe
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <spiffe/cancellation.h>
+#include <spiffe/spiffe.h>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+namespace spiffe {
+
+// Delays between reconnects of a stream, see StreamRetryOptions. Each delay is drawn from
+// [(1 - jitter) * backoff, backoff], backoff growing by multiplier up to max_backoff, so that
+// clients disconnected at the same moment do not come back at the same moment.
+//
+// Not thread-safe, one per stream.
+class StreamBackoff {
+   public:
+    StreamBackoff(const StreamRetryOptions& options, uint64_t seed);
+
+    // Delay before the next attempt, growing with every call
+    std::chrono::milliseconds next();
+
+    // Back to initial_backoff, once a reconnected stream delivered an update
+    void reset();
+
+    // Number of next() calls since the last reset()
+    size_t attempts() const { return attempts_; }
+
+   private:
+    StreamRetryOptions options_;
+    double backoff_ms_;
+    size_t attempts_ = 0;
+    std::mt19937_64 random_;
+};
+
+// Whether a stream that ended with code (not through the user callback) should reconnect.
+// Cancellation and invalid requests are final, everything else may be an agent restart.
+bool stream_retryable(int code);
+
+// options with stream_retry enabled, for streams shared by a whole process that must outlive
+// agent restarts, e.g. those of WorkloadApiHub and SharedSnapshotPublisher
+ClientOptions with_stream_retry(ClientOptions options);
+
+// Sleeps for delay, returns false right away when cancellation_token is cancelled
+bool sleep_unless_cancelled(const CancellationToken& cancellation_token, std::chrono::milliseconds delay);
+
+}  // namespace spiffe
@@ -0,0 +1,82 @@
+#include <spiffe/types.h>
+
+#include "der.h"
+
+namespace spiffe {
+
+CertificateList::Iterator::Iterator(const uint8_t* pos, const uint8_t* end) : end_(end), current_(end, 0) {
+    if (pos < end) {
+        // The list was validated on construction, this only re-reads the header
+        TlvResult result = read_der_tlv(pos, end - pos);
+        if (result.valid) {
+            current_ = BufferView(pos, result.tlv_len);
+        }
+    }
+}
+
+CertificateList::Iterator& CertificateList::Iterator::operator++() {
+    *this = Iterator(current_.end(), end_);
+    return *this;
+}
+
+CertificateList::CertificateList(std::shared_ptr<const Buffer> backing, size_t offset, size_t size)
+    : backing_(std::move(backing)), offset_(offset), size_bytes_(0), count_(0), valid_(false) {
+    if (!backing_ || offset > backing_->size() || size > backing_->size() - offset) {
+        backing_.reset();
+        offset_ = 0;
+        return;
+    }
+
+    CertificateIter iter(backing_->data() + offset_, size);
+    while (iter.has_next() && !iter.next().empty()) {
+        ++count_;
+    }
+    if (iter.has_error()) {
+        backing_.reset();
+        offset_ = 0;
+        count_ = 0;
+        return;
+    }
+    size_bytes_ = size;
+    valid_ = true;
+}
+
+CertificateList CertificateList::from_der(const uint8_t* der, size_t size) {
+    auto backing = std::make_shared<const Buffer>(der, der + size);
+    return CertificateList(std::move(backing), 0, size);
+}
+
+CertificateList::CertificateList(const std::vector<Buffer>& certificates)
+    : offset_(0), size_bytes_(0), count_(0), valid_(true) {
+    size_t total = 0;
+    for (const auto& cert : certificates) {
+        total += cert.size();
+    }
+
+    auto backing = std::make_shared<Buffer>();
+    backing->reserve(total);
+    for (const auto& cert : certificates) {
+        backing->insert(backing->end(), cert.begin(), cert.end());
+    }
+
+    *this = CertificateList(std::move(backing), 0, total);
+}
+
+BufferView CertificateList::operator[](size_t i) const {
+    Iterator it = begin();
+    for (; i > 0 && it != end(); --i) {
+        ++it;
+    }
+    return *it;
+}
+
+std::vector<Buffer> CertificateList::to_buffers() const {
+    std::vector<Buffer> certs;
+    certs.reserve(count_);
+    for (const BufferView& cert : *this) {
+        certs.push_back(cert.to_buffer());
+    }
+    return certs;
+}
+
+}  // namespace spiffe
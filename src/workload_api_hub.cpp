@@ -0,0 +1,274 @@
+#include <spiffe/workload_api_hub.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "stream_retry.h"
+
+namespace spiffe {
+
+namespace {
+
+struct Subscriber {
+    // Held while the callback runs, recursive so that the callback may unsubscribe itself
+    std::recursive_mutex mutex;
+    bool active = true;
+
+    // Generation of the last update delivered, the replay of subscribe() and the stream's
+    // thread may race to deliver
+    uint64_t delivered = 0;
+
+    std::function<void(const std::shared_ptr<const void>&)> callback;
+};
+
+void deliver(Subscriber& subscriber, const std::shared_ptr<const void>& value, uint64_t generation) {
+    std::lock_guard<std::recursive_mutex> lock(subscriber.mutex);
+    if (subscriber.active && generation > subscriber.delivered) {
+        subscriber.delivered = generation;
+        subscriber.callback(value);
+    }
+}
+
+}  // namespace
+
+// Subscribers of one RPC and its latest update, type-erased: every subscriber of a channel
+// takes the same context type
+struct Subscription::Channel : std::enable_shared_from_this<Subscription::Channel> {
+    mutable std::mutex mutex;
+    uint64_t next_id = 1;
+    uint64_t generation = 0;
+    std::shared_ptr<const void> latest;
+    std::unordered_map<uint64_t, std::shared_ptr<Subscriber>> subscribers;
+
+    Subscription subscribe(std::function<void(const std::shared_ptr<const void>&)> callback) {
+        auto subscriber = std::make_shared<Subscriber>();
+        subscriber->callback = std::move(callback);
+
+        uint64_t id;
+        uint64_t latest_generation;
+        std::shared_ptr<const void> value;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = next_id++;
+            subscribers.emplace(id, subscriber);
+            latest_generation = generation;
+            value = latest;
+        }
+        if (value) {
+            deliver(*subscriber, value, latest_generation);
+        }
+        return Subscription(shared_from_this(), id);
+    }
+
+    void unsubscribe(uint64_t id) {
+        std::shared_ptr<Subscriber> subscriber;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = subscribers.find(id);
+            if (it == subscribers.end()) {
+                return;
+            }
+            subscriber = std::move(it->second);
+            subscribers.erase(it);
+        }
+
+        // Waits for a callback in progress
+        std::lock_guard<std::recursive_mutex> lock(subscriber->mutex);
+        subscriber->active = false;
+    }
+
+    // Only called from the stream's thread
+    void publish(std::shared_ptr<const void> value) {
+        uint64_t published;
+        std::vector<std::shared_ptr<Subscriber>> targets;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            published = ++generation;
+            latest = value;
+            targets.reserve(subscribers.size());
+            for (const auto& entry : subscribers) {
+                targets.push_back(entry.second);
+            }
+        }
+        for (const std::shared_ptr<Subscriber>& subscriber : targets) {
+            deliver(*subscriber, value, published);
+        }
+    }
+
+    std::shared_ptr<const void> get() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return latest;
+    }
+};
+
+Subscription::Subscription(Subscription&& other) noexcept : channel_(std::move(other.channel_)), id_(other.id_) {}
+
+Subscription& Subscription::operator=(Subscription&& other) noexcept {
+    if (this != &other) {
+        unsubscribe();
+        channel_ = std::move(other.channel_);
+        id_ = other.id_;
+    }
+    return *this;
+}
+
+void Subscription::unsubscribe() {
+    if (channel_) {
+        channel_->unsubscribe(id_);
+        channel_.reset();
+    }
+}
+
+namespace {
+
+template <typename Context>
+std::function<void(const std::shared_ptr<const void>&)> erase_type(WorkloadApiHub::Callback<Context> callback) {
+    return [callback](const std::shared_ptr<const void>& value) {
+        callback(std::static_pointer_cast<const Context>(value));
+    };
+}
+
+}  // namespace
+
+class WorkloadApiHub::Impl {
+   public:
+    struct Stream {
+        std::shared_ptr<Subscription::Channel> channel = std::make_shared<Subscription::Channel>();
+        std::thread thread;
+
+        // Cleared by the thread once the stream ended, e.g. on INVALID_ARGUMENT or after
+        // ClientOptions::stream_retry gave up
+        std::atomic<bool> running{false};
+    };
+
+    Impl(const std::string& socket_path, const ClientOptions& options) : client_(socket_path, with_stream_retry(options)) {}
+
+    ~Impl() {
+        cancellation_.cancel();
+        for (Stream* stream : {&x509_svid_, &x509_bundles_, &jwt_bundles_}) {
+            if (stream->thread.joinable()) {
+                stream->thread.join();
+            }
+        }
+    }
+
+    Stream x509_svid_;
+    Stream x509_bundles_;
+    Stream jwt_bundles_;
+
+    // Opens the stream of an RPC on its first subscription, or on the next one once it ended
+    void start_x509_svid() {
+        start(x509_svid_, [this](std::shared_ptr<Subscription::Channel> channel, CancellationToken token) {
+            return client_.watch_x509_svid(
+                [&](const X509SvidContext& context, const X509SvidDelta&) {
+                    channel->publish(std::make_shared<const X509SvidContext>(context));
+                    return Status{};
+                },
+                token);
+        });
+    }
+
+    void start_x509_bundles() {
+        start(x509_bundles_, [this](std::shared_ptr<Subscription::Channel> channel, CancellationToken token) {
+            return client_.watch_x509_bundles(
+                [&](const X509BundlesContext& context, const X509BundlesDelta&) {
+                    channel->publish(std::make_shared<const X509BundlesContext>(context));
+                    return Status{};
+                },
+                token);
+        });
+    }
+
+    void start_jwt_bundles() {
+        start(jwt_bundles_, [this](std::shared_ptr<Subscription::Channel> channel, CancellationToken token) {
+            return client_.watch_jwt_bundles(
+                [&](const JwtBundles& bundles, const JwtBundlesDelta&) {
+                    channel->publish(std::make_shared<const JwtBundles>(bundles));
+                    return Status{};
+                },
+                token);
+        });
+    }
+
+   private:
+    WorkloadApiClient client_;
+    CancellationSource cancellation_;
+    std::mutex mutex_;
+
+    template <typename Run>
+    void start(Stream& stream, Run run) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stream.running) {
+            return;
+        }
+
+        // The thread of an ended stream is done but for returning
+        if (stream.thread.joinable()) {
+            stream.thread.join();
+        }
+        stream.running = true;
+        stream.thread = std::thread(
+            [run, &stream](std::shared_ptr<Subscription::Channel> channel, CancellationToken token) {
+                // Whatever ended the stream, subscribers keep the latest update until the next
+                // subscription reopens it
+                run(std::move(channel), std::move(token));
+                stream.running = false;
+            },
+            stream.channel, cancellation_.token());
+    }
+};
+
+WorkloadApiHub::WorkloadApiHub(const std::string& socket_path, const ClientOptions& options)
+    : impl_(new Impl(socket_path, options)) {}
+
+WorkloadApiHub::~WorkloadApiHub() = default;
+
+std::shared_ptr<WorkloadApiHub> WorkloadApiHub::get(const std::string& socket_path, const ClientOptions& options) {
+    // Hubs are owned by their users, the registry only finds the live ones
+    static std::mutex& mutex = *new std::mutex();
+    static auto& hubs = *new std::unordered_map<std::string, std::weak_ptr<WorkloadApiHub>>();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = hubs.begin(); it != hubs.end();) {
+        it = it->second.expired() && it->first != socket_path ? hubs.erase(it) : std::next(it);
+    }
+    std::weak_ptr<WorkloadApiHub>& entry = hubs[socket_path];
+    std::shared_ptr<WorkloadApiHub> hub = entry.lock();
+    if (!hub) {
+        hub = std::make_shared<WorkloadApiHub>(socket_path, options);
+        entry = hub;
+    }
+    return hub;
+}
+
+Subscription WorkloadApiHub::subscribe_x509_svid(Callback<X509SvidContext> callback) {
+    impl_->start_x509_svid();
+    return impl_->x509_svid_.channel->subscribe(erase_type(std::move(callback)));
+}
+
+Subscription WorkloadApiHub::subscribe_x509_bundles(Callback<X509BundlesContext> callback) {
+    impl_->start_x509_bundles();
+    return impl_->x509_bundles_.channel->subscribe(erase_type(std::move(callback)));
+}
+
+Subscription WorkloadApiHub::subscribe_jwt_bundles(Callback<JwtBundles> callback) {
+    impl_->start_jwt_bundles();
+    return impl_->jwt_bundles_.channel->subscribe(erase_type(std::move(callback)));
+}
+
+std::shared_ptr<const X509SvidContext> WorkloadApiHub::x509_svid() const {
+    return std::static_pointer_cast<const X509SvidContext>(impl_->x509_svid_.channel->get());
+}
+
+std::shared_ptr<const X509BundlesContext> WorkloadApiHub::x509_bundles() const {
+    return std::static_pointer_cast<const X509BundlesContext>(impl_->x509_bundles_.channel->get());
+}
+
+std::shared_ptr<const JwtBundles> WorkloadApiHub::jwt_bundles() const {
+    return std::static_pointer_cast<const JwtBundles>(impl_->jwt_bundles_.channel->get());
+}
+
+}  // namespace spiffe
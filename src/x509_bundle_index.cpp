@@ -0,0 +1,261 @@
+#include <spiffe/x509_bundle_index.h>
+
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "der.h"
+
+namespace spiffe {
+
+namespace {
+
+const uint8_t TAG_INTEGER = 0x02;
+const uint8_t TAG_BIT_STRING = 0x03;
+const uint8_t TAG_UTC_TIME = 0x17;
+const uint8_t TAG_GENERALIZED_TIME = 0x18;
+const uint8_t TAG_SEQUENCE = 0x30;
+
+// Bundle index ids and CRL revisions, never 0
+std::atomic<uint64_t> next_id{1};
+
+uint64_t make_id() { return next_id.fetch_add(1, std::memory_order_relaxed); }
+
+// Lowest certificate index in range, so duplicates resolve to the earliest one in the bundle
+template <typename Range>
+size_t first_index(Range range) {
+    size_t first = range.first->second;
+    for (auto it = range.first; it != range.second; ++it) {
+        first = std::min(first, it->second);
+    }
+    return first;
+}
+
+}  // namespace
+
+// Revoked serial numbers of the CRLs whose signature verified against a CA of the bundles. Keys
+// view into the owned copy of the given CRLs.
+class X509BundleIndexSet::Revocations {
+   public:
+    Revocations(const std::vector<Buffer>& crls, const X509BundleIndexSet& bundles)
+        : given_(crls), bundle_ids_(bundle_ids(bundles)), revision_(make_id()) {
+        for (const Buffer& crl : given_) {
+            add(crl, bundles);
+        }
+    }
+
+    const std::vector<Buffer>& given() const { return given_; }
+    const std::vector<Buffer>& crls() const { return crls_; }
+    uint64_t revision() const { return revision_; }
+
+    // Whether these revocations were built from crls against the same bundle indexes
+    bool built_from(const std::vector<Buffer>& crls, const X509BundleIndexSet& bundles) const {
+        return given_ == crls && bundle_ids_ == bundle_ids(bundles);
+    }
+
+    bool contains(BufferView issuer, BufferView serial) const {
+        auto range = issuer_by_serial_.equal_range(serial);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == issuer) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+   private:
+    std::vector<Buffer> given_;
+    std::vector<Buffer> crls_;
+    std::vector<uint64_t> bundle_ids_;
+    uint64_t revision_;
+    std::unordered_multimap<BufferView, BufferView, BufferViewHash> issuer_by_serial_;
+
+    static std::vector<uint64_t> bundle_ids(const X509BundleIndexSet& bundles) {
+        std::vector<uint64_t> ids;
+        ids.reserve(bundles.indexes_.size());
+        for (const auto& entry : bundles.indexes_) {
+            ids.push_back(entry.second->id());
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    // Whether a CA of the bundles named issuer, allowed to sign CRLs, signed der
+    static bool signed_by_bundle_ca(const Buffer& der, BufferView issuer, const X509BundleIndexSet& bundles) {
+        const unsigned char* data = der.data();
+        X509_CRL* crl = d2i_X509_CRL(nullptr, &data, static_cast<long>(der.size()));
+        if (!crl) {
+            return false;
+        }
+
+        bool verified = false;
+        auto accept = [&](const X509CertificateView& ca) {
+            if (!ca.is_ca() || (ca.has_key_usage() && !(ca.key_usage() & X509CertificateView::KEY_USAGE_CRL_SIGN))) {
+                return false;
+            }
+            BufferView spki = ca.subject_public_key_info();
+            const unsigned char* key_data = spki.data();
+            EVP_PKEY* key = d2i_PUBKEY(nullptr, &key_data, static_cast<long>(spki.size()));
+            verified = key && X509_CRL_verify(crl, key) == 1;
+            EVP_PKEY_free(key);
+            return verified;
+        };
+        for (auto it = bundles.indexes_.begin(); !verified && it != bundles.indexes_.end(); ++it) {
+            it->second->find_issuer(issuer, BufferView(), accept);
+        }
+        X509_CRL_free(crl);
+        return verified;
+    }
+
+    // CertificateList ::= SEQUENCE { tbsCertList, signatureAlgorithm, signatureValue }
+    // TBSCertList ::= SEQUENCE { version OPTIONAL, signature, issuer, thisUpdate, nextUpdate
+    //     OPTIONAL, revokedCertificates SEQUENCE OF SEQUENCE { userCertificate, ... } OPTIONAL,
+    //     crlExtensions [0] OPTIONAL }
+    void add(const Buffer& der, const X509BundleIndexSet& bundles) {
+        BufferView certificate_list, tbs_cert_list, issuer;
+        DerReader outer{BufferView(der)};
+        if (!outer.read(TAG_SEQUENCE, &certificate_list) || !outer.done()) {
+            return;
+        }
+        DerReader fields(certificate_list);
+        if (!fields.read(TAG_SEQUENCE, &tbs_cert_list) || !fields.skip(TAG_SEQUENCE) ||
+            !fields.skip(TAG_BIT_STRING) || !fields.done()) {
+            return;
+        }
+
+        DerReader tbs(tbs_cert_list);
+        if (!tbs.skip_optional(TAG_INTEGER) || !tbs.skip(TAG_SEQUENCE) || !tbs.read(TAG_SEQUENCE, nullptr, &issuer) ||
+            !(tbs.skip(TAG_UTC_TIME) || tbs.skip(TAG_GENERALIZED_TIME)) ||
+            !tbs.skip_optional(TAG_UTC_TIME) || !tbs.skip_optional(TAG_GENERALIZED_TIME)) {
+            return;
+        }
+        if (!signed_by_bundle_ca(der, issuer, bundles)) {
+            return;
+        }
+
+        // A CRL without revoked certificates is still in use, the issuer revoked nothing
+        crls_.push_back(der);
+        BufferView revoked;
+        if (!tbs.peek(TAG_SEQUENCE) || !tbs.read(TAG_SEQUENCE, &revoked)) {
+            return;
+        }
+
+        // Entries are added as they are read, a malformed tail only loses itself
+        DerReader entries(revoked);
+        while (!entries.done()) {
+            BufferView entry, serial;
+            if (!entries.read(TAG_SEQUENCE, &entry)) {
+                return;
+            }
+            DerReader entry_fields(entry);
+            if (!entry_fields.read(TAG_INTEGER, &serial)) {
+                return;
+            }
+            issuer_by_serial_.emplace(serial, issuer);
+        }
+    }
+};
+
+X509BundleIndex::X509BundleIndex(X509Bundle bundle) : bundle_(std::move(bundle)), id_(make_id()) {
+    certificates_.reserve(bundle_.size());
+    for (const BufferView& der : bundle_) {
+        // valid() parses every field, later reads from other threads only load them
+        X509CertificateView certificate(der);
+        if (certificate.valid()) {
+            certificates_.push_back(certificate);
+        }
+    }
+
+    by_subject_key_id_.reserve(certificates_.size());
+    by_subject_.reserve(certificates_.size());
+    for (size_t i = 0; i < certificates_.size(); ++i) {
+        if (!certificates_[i].subject_key_id().empty()) {
+            by_subject_key_id_.emplace(certificates_[i].subject_key_id(), i);
+        }
+        by_subject_.emplace(certificates_[i].subject(), i);
+    }
+}
+
+const X509CertificateView* X509BundleIndex::find_issuer(const X509CertificateView& cert) const {
+    return find_issuer(cert, [](const X509CertificateView&) { return true; });
+}
+
+const X509CertificateView* X509BundleIndex::find_by_subject_key_id(BufferView subject_key_id) const {
+    auto range = by_subject_key_id_.equal_range(subject_key_id);
+    return range.first == range.second ? nullptr : &certificates_[first_index(range)];
+}
+
+const X509CertificateView* X509BundleIndex::find_by_subject(BufferView subject) const {
+    auto range = by_subject_.equal_range(subject);
+    return range.first == range.second ? nullptr : &certificates_[first_index(range)];
+}
+
+X509BundleIndexSet::X509BundleIndexSet(const std::unordered_map<TrustDomain, X509Bundle>& bundles,
+                                       const X509BundleIndexSet* previous) {
+    indexes_.reserve(bundles.size());
+    by_interned_.reserve(bundles.size());
+    for (const auto& entry : bundles) {
+        set(entry.first, entry.second, previous);
+    }
+}
+
+const X509BundleIndex* X509BundleIndexSet::get(const TrustDomain& trust_domain) const {
+    auto it = indexes_.find(trust_domain);
+    return it == indexes_.end() ? nullptr : it->second.get();
+}
+
+const X509BundleIndex* X509BundleIndexSet::get(InternedTrustDomain trust_domain) const {
+    auto it = by_interned_.find(trust_domain);
+    return it == by_interned_.end() ? nullptr : it->second;
+}
+
+void X509BundleIndexSet::set(const TrustDomain& trust_domain, const X509Bundle& bundle,
+                             const X509BundleIndexSet* previous) {
+    // Reuses the previous index of an unchanged bundle, a changed one replaces any index this set
+    // already holds for the trust domain
+    std::shared_ptr<const X509BundleIndex> reused;
+    if (previous) {
+        auto it = previous->indexes_.find(trust_domain);
+        if (it != previous->indexes_.end() && it->second->bundle() == bundle) {
+            reused = it->second;
+        }
+    }
+    std::shared_ptr<const X509BundleIndex>& index = indexes_[trust_domain];
+    const X509BundleIndex* replaced = index.get();
+    index = reused ? std::move(reused) : std::make_shared<const X509BundleIndex>(bundle);
+
+    SpiffeId id;
+    if (SpiffeId::parse(trust_domain, id) && id.path().empty()) {
+        by_interned_[InternedTrustDomain::intern(id.trust_domain_name())] = index.get();
+    }
+
+    // The CAs that signed the CRLs may have changed
+    if (revocations_ && index.get() != replaced) {
+        revocations_ = std::make_shared<const Revocations>(revocations_->given(), *this);
+    }
+}
+
+void X509BundleIndexSet::set_crls(const std::vector<Buffer>& crls, const X509BundleIndexSet* previous) {
+    if (crls.empty()) {
+        revocations_.reset();
+    } else if (previous && previous->revocations_ && previous->revocations_->built_from(crls, *this)) {
+        revocations_ = previous->revocations_;
+    } else {
+        revocations_ = std::make_shared<const Revocations>(crls, *this);
+    }
+}
+
+uint64_t X509BundleIndexSet::crl_revision() const { return revocations_ ? revocations_->revision() : 0; }
+
+const std::vector<Buffer>& X509BundleIndexSet::crls() const {
+    static const std::vector<Buffer> none;
+    return revocations_ ? revocations_->crls() : none;
+}
+
+bool X509BundleIndexSet::is_revoked(const X509CertificateView& cert) const {
+    return revocations_ && revocations_->contains(cert.issuer(), cert.serial());
+}
+
+}  // namespace spiffe
@@ -0,0 +1,346 @@
+#include <spiffe/x509_certificate.h>
+
+#include <cstring>
+
+#include "der.h"
+
+namespace spiffe {
+
+namespace {
+
+// DER tags used by certificates
+const uint8_t TAG_BOOLEAN = 0x01;
+const uint8_t TAG_INTEGER = 0x02;
+const uint8_t TAG_BIT_STRING = 0x03;
+const uint8_t TAG_OCTET_STRING = 0x04;
+const uint8_t TAG_OID = 0x06;
+const uint8_t TAG_UTC_TIME = 0x17;
+const uint8_t TAG_GENERALIZED_TIME = 0x18;
+const uint8_t TAG_SEQUENCE = 0x30;
+
+const uint8_t TAG_VERSION = 0xa0;            // [0] EXPLICIT
+const uint8_t TAG_ISSUER_UNIQUE_ID = 0x81;   // [1] IMPLICIT
+const uint8_t TAG_SUBJECT_UNIQUE_ID = 0x82;  // [2] IMPLICIT
+const uint8_t TAG_EXTENSIONS = 0xa3;         // [3] EXPLICIT
+const uint8_t TAG_URI = 0x86;                // GeneralName uniformResourceIdentifier [6]
+const uint8_t TAG_KEY_IDENTIFIER = 0x80;     // AuthorityKeyIdentifier keyIdentifier [0]
+const uint8_t TAG_PERMITTED_SUBTREES = 0xa0;  // NameConstraints permittedSubtrees [0]
+const uint8_t TAG_EXCLUDED_SUBTREES = 0xa1;   // NameConstraints excludedSubtrees [1]
+
+// id-ce extensions, OID contents
+const uint8_t OID_SUBJECT_KEY_ID[] = {0x55, 0x1d, 0x0e};
+const uint8_t OID_KEY_USAGE[] = {0x55, 0x1d, 0x0f};
+const uint8_t OID_SUBJECT_ALT_NAME[] = {0x55, 0x1d, 0x11};
+const uint8_t OID_BASIC_CONSTRAINTS[] = {0x55, 0x1d, 0x13};
+const uint8_t OID_NAME_CONSTRAINTS[] = {0x55, 0x1d, 0x1e};
+const uint8_t OID_AUTHORITY_KEY_ID[] = {0x55, 0x1d, 0x23};
+const uint8_t OID_EXT_KEY_USAGE[] = {0x55, 0x1d, 0x25};
+
+template <size_t N>
+bool oid_equals(BufferView oid, const uint8_t (&expected)[N]) {
+    return oid.size() == N && std::memcmp(oid.data(), expected, N) == 0;
+}
+
+bool read_digits(const uint8_t* text, size_t count, int& out) {
+    out = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        out = out * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t days_from_civil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t year_of_era = year - era * 400;
+    int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+// UTCTime YYMMDDHHMMSSZ or GeneralizedTime YYYYMMDDHHMMSSZ, the only forms RFC 5280 allows
+bool parse_time(DerReader& reader, X509Time& out) {
+    BufferView text;
+    int year = 0;
+    if (reader.read(TAG_UTC_TIME, &text)) {
+        if (text.size() != 13 || !read_digits(text.data(), 2, year)) {
+            return false;
+        }
+        year += year < 50 ? 2000 : 1900;
+    } else if (reader.read(TAG_GENERALIZED_TIME, &text)) {
+        if (text.size() != 15 || !read_digits(text.data(), 4, year)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    const uint8_t* rest = text.data() + text.size() - 11;
+    int month, day, hour, minute, second;
+    if (!read_digits(rest, 2, month) || !read_digits(rest + 2, 2, day) || !read_digits(rest + 4, 2, hour) ||
+        !read_digits(rest + 6, 2, minute) || !read_digits(rest + 8, 2, second) || rest[10] != 'Z') {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59) {
+        return false;
+    }
+
+    int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    out = X509Time(std::chrono::seconds(seconds));
+    return true;
+}
+
+}  // namespace
+
+bool X509CertificateView::valid() const { return parse_tbs_certificate() && parse_extensions(); }
+
+BufferView X509CertificateView::tbs_certificate() const {
+    return parse_tbs_certificate() ? tbs_certificate_ : BufferView();
+}
+
+BufferView X509CertificateView::signature_algorithm() const {
+    return parse_tbs_certificate() ? signature_algorithm_ : BufferView();
+}
+
+BufferView X509CertificateView::signature() const { return parse_tbs_certificate() ? signature_ : BufferView(); }
+
+BufferView X509CertificateView::serial() const { return parse_tbs_certificate() ? serial_ : BufferView(); }
+
+BufferView X509CertificateView::issuer() const { return parse_tbs_certificate() ? issuer_ : BufferView(); }
+
+BufferView X509CertificateView::subject() const { return parse_tbs_certificate() ? subject_ : BufferView(); }
+
+BufferView X509CertificateView::subject_public_key_info() const {
+    return parse_tbs_certificate() ? subject_public_key_info_ : BufferView();
+}
+
+X509Time X509CertificateView::not_before() const { return parse_tbs_certificate() ? not_before_ : X509Time(); }
+
+X509Time X509CertificateView::not_after() const { return parse_tbs_certificate() ? not_after_ : X509Time(); }
+
+BufferView X509CertificateView::uri_san() const { return parse_extensions() ? uri_san_ : BufferView(); }
+
+size_t X509CertificateView::uri_san_count() const { return parse_extensions() ? uri_san_count_ : 0; }
+
+BufferView X509CertificateView::subject_key_id() const {
+    return parse_extensions() ? subject_key_id_ : BufferView();
+}
+
+BufferView X509CertificateView::authority_key_id() const {
+    return parse_extensions() ? authority_key_id_ : BufferView();
+}
+
+bool X509CertificateView::is_ca() const { return parse_extensions() && is_ca_; }
+
+int X509CertificateView::path_len_constraint() const { return parse_extensions() ? path_len_constraint_ : -1; }
+
+bool X509CertificateView::has_key_usage() const { return parse_extensions() && has_key_usage_; }
+
+uint16_t X509CertificateView::key_usage() const { return parse_extensions() ? key_usage_ : 0; }
+
+BufferView X509CertificateView::permitted_subtrees() const {
+    return parse_extensions() ? permitted_subtrees_ : BufferView();
+}
+
+BufferView X509CertificateView::excluded_subtrees() const {
+    return parse_extensions() ? excluded_subtrees_ : BufferView();
+}
+
+bool X509CertificateView::has_unknown_critical_extension() const {
+    return parse_extensions() && has_unknown_critical_extension_;
+}
+
+bool X509CertificateView::parse_tbs_certificate() const {
+    if (state_ & TBS_PARSED) {
+        return state_ & TBS_VALID;
+    }
+    state_ |= TBS_PARSED;
+
+    // Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signatureValue }, alone
+    BufferView certificate;
+    DerReader outer(der_);
+    if (!outer.read(TAG_SEQUENCE, &certificate) || !outer.done()) {
+        return false;
+    }
+
+    DerReader fields(certificate);
+    BufferView tbs_certificate, algorithm, algorithm_element, signature;
+    if (!fields.read(TAG_SEQUENCE, &tbs_certificate, &tbs_certificate_) ||
+        !fields.read(TAG_SEQUENCE, &algorithm, &algorithm_element) || !fields.read(TAG_BIT_STRING, &signature) ||
+        !fields.done()) {
+        return false;
+    }
+
+    // AlgorithmIdentifier ::= SEQUENCE { algorithm OID, parameters ANY OPTIONAL }
+    DerReader algorithm_fields(algorithm);
+    if (!algorithm_fields.read(TAG_OID, &signature_algorithm_)) {
+        return false;
+    }
+
+    // Signatures are whole bytes, the leading unused bits count must be 0
+    if (signature.empty() || signature[0] != 0) {
+        return false;
+    }
+    signature_ = BufferView(signature.data() + 1, signature.size() - 1);
+
+    BufferView validity, inner_algorithm;
+    DerReader tbs(tbs_certificate);
+    if (!tbs.skip_optional(TAG_VERSION) ||                              //
+        !tbs.read(TAG_INTEGER, &serial_) ||                             //
+        !tbs.read(TAG_SEQUENCE, nullptr, &inner_algorithm) ||           // signature
+        !tbs.read(TAG_SEQUENCE, nullptr, &issuer_) ||                   //
+        !tbs.read(TAG_SEQUENCE, &validity) ||                           //
+        !tbs.read(TAG_SEQUENCE, nullptr, &subject_) ||                  //
+        !tbs.read(TAG_SEQUENCE, nullptr, &subject_public_key_info_) ||  //
+        !tbs.skip_optional(TAG_ISSUER_UNIQUE_ID) ||                     //
+        !tbs.skip_optional(TAG_SUBJECT_UNIQUE_ID)) {
+        return false;
+    }
+
+    BufferView extensions;
+    if (tbs.peek(TAG_EXTENSIONS)) {
+        tbs.read(TAG_EXTENSIONS, &extensions);
+        DerReader wrapper(extensions);
+        if (!wrapper.read(TAG_SEQUENCE, &extensions_) || !wrapper.done()) {
+            return false;
+        }
+    }
+    if (!tbs.done()) {
+        return false;
+    }
+
+    // RFC 5280 4.1.1.2, the signed copy of the algorithm must match the outer one
+    if (inner_algorithm != algorithm_element) {
+        return false;
+    }
+
+    DerReader times(validity);
+    if (!parse_time(times, not_before_) || !parse_time(times, not_after_) || !times.done()) {
+        return false;
+    }
+
+    state_ |= TBS_VALID;
+    return true;
+}
+
+bool X509CertificateView::parse_extensions() const {
+    if (state_ & EXTENSIONS_PARSED) {
+        return state_ & EXTENSIONS_VALID;
+    }
+    state_ |= EXTENSIONS_PARSED;
+
+    if (!parse_tbs_certificate()) {
+        return false;
+    }
+
+    // Extension ::= SEQUENCE { extnID, critical BOOLEAN DEFAULT FALSE, extnValue OCTET STRING }
+    DerReader extensions(extensions_);
+    while (!extensions.done()) {
+        BufferView extension, oid, critical, value;
+        if (!extensions.read(TAG_SEQUENCE, &extension)) {
+            return false;
+        }
+
+        DerReader fields(extension);
+        if (!fields.read(TAG_OID, &oid) ||
+            (fields.peek(TAG_BOOLEAN) && (!fields.read(TAG_BOOLEAN, &critical) || critical.size() != 1)) ||
+            !fields.read(TAG_OCTET_STRING, &value) || !fields.done()) {
+            return false;
+        }
+
+        DerReader reader(value);
+        BufferView content;
+        if (oid_equals(oid, OID_SUBJECT_ALT_NAME)) {
+            // GeneralNames ::= SEQUENCE OF GeneralName, only URIs are kept
+            if (!reader.read(TAG_SEQUENCE, &content) || !reader.done()) {
+                return false;
+            }
+            DerReader names(content);
+            while (!names.done()) {
+                BufferView uri;
+                if (names.read(TAG_URI, &uri)) {
+                    if (uri_san_count_++ == 0) {
+                        uri_san_ = uri;
+                    }
+                } else if (!names.skip_any()) {
+                    return false;
+                }
+            }
+        } else if (oid_equals(oid, OID_SUBJECT_KEY_ID)) {
+            if (!reader.read(TAG_OCTET_STRING, &subject_key_id_) || !reader.done()) {
+                return false;
+            }
+        } else if (oid_equals(oid, OID_AUTHORITY_KEY_ID)) {
+            // AuthorityKeyIdentifier ::= SEQUENCE { keyIdentifier [0] OPTIONAL, ... }
+            if (!reader.read(TAG_SEQUENCE, &content) || !reader.done()) {
+                return false;
+            }
+            DerReader key_id(content);
+            if (key_id.peek(TAG_KEY_IDENTIFIER) && !key_id.read(TAG_KEY_IDENTIFIER, &authority_key_id_)) {
+                return false;
+            }
+        } else if (oid_equals(oid, OID_BASIC_CONSTRAINTS)) {
+            // BasicConstraints ::= SEQUENCE { cA BOOLEAN DEFAULT FALSE, pathLenConstraint OPTIONAL }
+            if (!reader.read(TAG_SEQUENCE, &content) || !reader.done()) {
+                return false;
+            }
+            DerReader constraints(content);
+            BufferView ca;
+            if (constraints.peek(TAG_BOOLEAN) && (!constraints.read(TAG_BOOLEAN, &ca) || ca.size() != 1)) {
+                return false;
+            }
+            is_ca_ = !ca.empty() && ca[0] != 0;
+
+            // A non-negative INTEGER, anything past what a chain could use is as good as no limit
+            BufferView path_len;
+            if (constraints.peek(TAG_INTEGER)) {
+                if (!constraints.read(TAG_INTEGER, &path_len) || path_len.empty() || (path_len[0] & 0x80)) {
+                    return false;
+                }
+                path_len_constraint_ = 0;
+                for (uint8_t byte : path_len) {
+                    if (path_len_constraint_ > 0xffff) {
+                        path_len_constraint_ = 0x7fffffff;
+                        break;
+                    }
+                    path_len_constraint_ = path_len_constraint_ * 256 + byte;
+                }
+            }
+        } else if (oid_equals(oid, OID_KEY_USAGE)) {
+            // KeyUsage ::= BIT STRING, bit 0 (digitalSignature) first
+            BufferView bits;
+            if (!reader.read(TAG_BIT_STRING, &bits) || !reader.done() || bits.empty() || bits[0] > 7) {
+                return false;
+            }
+            has_key_usage_ = true;
+            for (size_t bit = 0; bit < 16 && 1 + bit / 8 < bits.size(); ++bit) {
+                if (bits[1 + bit / 8] & (0x80 >> (bit % 8))) {
+                    key_usage_ |= static_cast<uint16_t>(1u << bit);
+                }
+            }
+        } else if (oid_equals(oid, OID_NAME_CONSTRAINTS)) {
+            // NameConstraints ::= SEQUENCE { permittedSubtrees [0], excludedSubtrees [1] }, both optional
+            if (!reader.read(TAG_SEQUENCE, &content) || !reader.done()) {
+                return false;
+            }
+            DerReader subtrees(content);
+            if ((subtrees.peek(TAG_PERMITTED_SUBTREES) &&
+                 !subtrees.read(TAG_PERMITTED_SUBTREES, &permitted_subtrees_)) ||
+                (subtrees.peek(TAG_EXCLUDED_SUBTREES) && !subtrees.read(TAG_EXCLUDED_SUBTREES, &excluded_subtrees_)) ||
+                !subtrees.done()) {
+                return false;
+            }
+        } else if (!critical.empty() && critical[0] != 0 && !oid_equals(oid, OID_EXT_KEY_USAGE)) {
+            has_unknown_critical_extension_ = true;
+        }
+    }
+
+    state_ |= EXTENSIONS_VALID;
+    return true;
+}
+
+}  // namespace spiffe
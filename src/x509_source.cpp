@@ -0,0 +1,156 @@
+#include <spiffe/x509_source.h>
+
+namespace spiffe {
+
+X509SvidSnapshot::X509SvidSnapshot(X509SvidContext context, uint64_t generation, const X509SvidSnapshot* previous)
+    : context_(std::move(context)),
+      generation_(generation),
+      bundle_indexes_(context_.federated_bundles, previous ? &previous->bundle_indexes_ : nullptr) {
+    for (size_t i = 0; i < context_.svids.size(); ++i) {
+        const X509Svid& svid = context_.svids[i];
+
+        // First one wins, the agent sends SVIDs in order of preference
+        bool first = by_id_.emplace(svid.spiffe_id, i).second;
+        if (!svid.hint.empty()) {
+            by_hint_.emplace(svid.hint, i);
+        }
+
+        // Keyed by "spiffe://example.org", the form of federated bundles
+        SpiffeId id;
+        if (!first || svid.bundle.empty() || !SpiffeId::parse(svid.spiffe_id, id)) {
+            continue;
+        }
+        TrustDomain trust_domain = id.trust_domain_id().to_string();
+        if (!bundle_indexes_.get(trust_domain)) {
+            bundle_indexes_.set(trust_domain, svid.bundle, previous ? &previous->bundle_indexes_ : nullptr);
+        }
+    }
+
+    // After the bundles, the CRLs are checked against their CAs
+    bundle_indexes_.set_crls(context_.crl, previous ? &previous->bundle_indexes_ : nullptr);
+}
+
+const X509Svid* X509SvidSnapshot::svid() const {
+    if (context_.svids.empty()) {
+        return nullptr;
+    }
+    return &context_.svids.front();
+}
+
+const X509Svid* X509SvidSnapshot::svid_by_id(const std::string& spiffe_id) const {
+    auto it = by_id_.find(spiffe_id);
+    if (it == by_id_.end()) {
+        return nullptr;
+    }
+    return &context_.svids[it->second];
+}
+
+const X509Svid* X509SvidSnapshot::svid_by_hint(const std::string& hint) const {
+    auto it = by_hint_.find(hint);
+    if (it == by_hint_.end()) {
+        return nullptr;
+    }
+    return &context_.svids[it->second];
+}
+
+const X509Bundle* X509SvidSnapshot::federated_bundle(const TrustDomain& trust_domain) const {
+    auto it = context_.federated_bundles.find(trust_domain);
+    if (it == context_.federated_bundles.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+X509Source::X509Source(const std::string& socket_path, const ClientOptions& options)
+    : client_(socket_path, options), state_(std::make_shared<State>()) {}
+
+X509Source::~X509Source() { close(); }
+
+void X509Source::start() {
+    if (stream_thread_.joinable()) {
+        return;
+    }
+
+    // A restart after close() waits for the new stream, not for the status of the old one
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stream_done = false;
+        state_->stream_status = Status();
+    }
+    cancellation_ = CancellationSource();
+    stream_thread_ = std::thread(&X509Source::run, this, cancellation_.token());
+}
+
+void X509Source::close() {
+    if (!stream_thread_.joinable()) {
+        return;
+    }
+
+    cancellation_.cancel();
+    stream_thread_.join();
+}
+
+Status X509Source::wait_until_ready(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    bool ready = state_->updated.wait_for(
+        lock, timeout, [&] { return std::atomic_load(&state_->current) || state_->stream_done; });
+
+    if (std::atomic_load(&state_->current)) {
+        return Status{};
+    }
+    if (!ready) {
+        return Status{.code = 4, .message = "no X.509 SVID received before timeout"};
+    }
+    return state_->stream_status;
+}
+
+std::shared_ptr<const X509SvidSnapshot> X509Source::snapshot() const { return std::atomic_load(&state_->current); }
+
+X509SourceReader X509Source::reader() const { return X509SourceReader(state_); }
+
+void X509Source::run(CancellationToken cancellation_token) {
+    // Identical updates are not delivered, so readers only see a new generation on change.
+    // Certificates of unchanged SVIDs and bundles, and the indexes of unchanged bundles, are
+    // shared with the previous snapshot.
+    Status status = client_.watch_x509_svid(
+        [this](const X509SvidContext& context, const X509SvidDelta&) {
+            uint64_t generation = state_->generation.load(std::memory_order_relaxed) + 1;
+
+            // Only this thread replaces current, it cannot change while the next one is built
+            std::shared_ptr<const X509SvidSnapshot> previous = std::atomic_load(&state_->current);
+            auto snapshot = std::make_shared<const X509SvidSnapshot>(context, generation, previous.get());
+
+            // Snapshot first, so a reader that sees the new generation loads the new snapshot
+            std::atomic_store(&state_->current, std::shared_ptr<const X509SvidSnapshot>(std::move(snapshot)));
+            state_->generation.store(generation, std::memory_order_release);
+
+            // Waiters check current under the lock, taking it here keeps them from missing the wakeup
+            { std::lock_guard<std::mutex> lock(state_->mutex); }
+            state_->updated.notify_all();
+
+            return Status{};
+        },
+        cancellation_token);
+
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stream_done = true;
+        state_->stream_status = status;
+    }
+    state_->updated.notify_all();
+}
+
+X509SourceReader::X509SourceReader(const X509Source& source) : X509SourceReader(source.reader()) {}
+
+X509SourceReader::X509SourceReader(std::shared_ptr<const X509Source::State> state) : state_(std::move(state)) {}
+
+const X509SvidSnapshot* X509SourceReader::get() {
+    uint64_t generation = state_->generation.load(std::memory_order_acquire);
+    if (generation != cached_generation_) {
+        cached_ = std::atomic_load(&state_->current);
+        cached_generation_ = cached_ ? cached_->generation() : 0;
+    }
+    return cached_.get();
+}
+
+}  // namespace spiffe
@@ -0,0 +1,288 @@
+#include <spiffe/x509_verifier.h>
+
+#include <openssl/x509.h>
+#include <openssl/x509_vfy.h>
+#include <openssl/x509v3.h>
+
+#include <algorithm>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+#include "bounded_cache.h"
+
+namespace spiffe {
+
+namespace {
+
+struct VerifiedChain {
+    std::string spiffe_id;
+    InternedTrustDomain trust_domain;
+    uint64_t bundle_id = 0;
+
+    // Intersection of the validity periods on the path
+    X509Time not_before = X509Time::min();
+    X509Time not_after = X509Time::max();
+};
+
+Status unauthenticated(const std::string& message) { return Status{.code = 16, .message = message}; }
+
+// A CRL is optional for each issuer, revocation is only checked against the ones there are
+int ignore_missing_crls(int ok, X509_STORE_CTX* context) {
+    return ok || X509_STORE_CTX_get_error(context) == X509_V_ERR_UNABLE_TO_GET_CRL;
+}
+
+// OpenSSL objects of one verification, freed with it. Every parsed certificate is kept with the
+// DER view it came from, so the verified path maps back to the views.
+struct OpenSslChain {
+    X509_STORE* store = X509_STORE_new();
+    X509_STORE_CTX* context = X509_STORE_CTX_new();
+    STACK_OF(X509)* untrusted = sk_X509_new_null();
+    std::vector<std::pair<X509*, const X509CertificateView*>> certificates;
+
+    OpenSslChain() = default;
+    OpenSslChain(const OpenSslChain&) = delete;
+    OpenSslChain& operator=(const OpenSslChain&) = delete;
+
+    ~OpenSslChain() {
+        X509_STORE_CTX_free(context);
+        sk_X509_free(untrusted);
+        X509_STORE_free(store);
+        for (const auto& certificate : certificates) {
+            X509_free(certificate.first);
+        }
+    }
+
+    bool ready() const { return store && context && untrusted; }
+
+    X509* parse(const X509CertificateView& view) {
+        BufferView der = view.der();
+        const unsigned char* data = der.data();
+        X509* certificate = d2i_X509(nullptr, &data, static_cast<long>(der.size()));
+        if (certificate) {
+            certificates.emplace_back(certificate, &view);
+        }
+        return certificate;
+    }
+
+    const X509CertificateView* view_of(const X509* certificate) const {
+        for (const auto& parsed : certificates) {
+            if (parsed.first == certificate) {
+                return parsed.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Every bundle certificate is a trust anchor, like a CA of the bundle in a chain. Only the
+// candidate issuers of the chain's certificates are handed to OpenSSL, which spares parsing the
+// rest of the bundle.
+bool add_trust_anchors(OpenSslChain& openssl, const std::vector<X509CertificateView>& chain,
+                       const X509BundleIndex& bundle) {
+    std::vector<const X509CertificateView*> anchors;
+    for (const X509CertificateView& cert : chain) {
+        bundle.find_issuer(cert, [&](const X509CertificateView& candidate) {
+            if (std::find(anchors.begin(), anchors.end(), &candidate) == anchors.end()) {
+                anchors.push_back(&candidate);
+            }
+            return false;
+        });
+    }
+
+    for (const X509CertificateView* anchor : anchors) {
+        X509* certificate = openssl.parse(*anchor);
+        if (!certificate || X509_STORE_add_cert(openssl.store, certificate) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool add_crls(OpenSslChain& openssl, const std::vector<Buffer>& crls) {
+    for (const Buffer& der : crls) {
+        const unsigned char* data = der.data();
+        X509_CRL* crl = d2i_X509_CRL(nullptr, &data, static_cast<long>(der.size()));
+        if (!crl) {
+            continue;  // skipped like in the revocation index
+        }
+        int added = X509_STORE_add_crl(openssl.store, crl);
+        X509_CRL_free(crl);
+        if (added != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Status verify_chain(const X509CertificateChain& chain, const X509BundleIndexSet& bundles, X509Time now,
+                    VerifiedChain& out) {
+    if (chain.empty()) {
+        return Status{.code = 3, .message = "Empty certificate chain"};
+    }
+
+    std::vector<X509CertificateView> certificates;
+    certificates.reserve(chain.size());
+    for (const BufferView& der : chain) {
+        certificates.emplace_back(der);
+        if (!certificates.back().valid()) {
+            return Status{.code = 3, .message = "Malformed certificate in chain"};
+        }
+    }
+
+    // X509-SVID leaf rules, the path itself is left to OpenSSL
+    const X509CertificateView& leaf = certificates.front();
+    if (leaf.is_ca()) {
+        return unauthenticated("Leaf certificate is a CA");
+    }
+    if (leaf.uri_san_count() != 1) {
+        return unauthenticated("Leaf certificate must have exactly one URI SAN");
+    }
+    uint16_t key_usage = leaf.key_usage();
+    if (leaf.has_key_usage() &&
+        (!(key_usage & X509CertificateView::KEY_USAGE_DIGITAL_SIGNATURE) ||
+         (key_usage & (X509CertificateView::KEY_USAGE_KEY_CERT_SIGN | X509CertificateView::KEY_USAGE_CRL_SIGN)))) {
+        return unauthenticated("Leaf certificate key usage must be digitalSignature");
+    }
+
+    // The trust domain keys the bundle
+    SpiffeId id;
+    if (!SpiffeId::parse(StringView(leaf.uri_san()), id)) {
+        return unauthenticated("Invalid SPIFFE ID: " + leaf.uri_san().to_string());
+    }
+    out.trust_domain = id.trust_domain();
+    const X509BundleIndex* bundle = out.trust_domain.is_null() ? nullptr : bundles.get(out.trust_domain);
+    if (!bundle) {
+        return unauthenticated("No bundle for trust domain " + id.trust_domain_id().to_string());
+    }
+    out.spiffe_id = id.str().to_string();
+    out.bundle_id = bundle->id();
+
+    OpenSslChain openssl;
+    if (!openssl.ready()) {
+        return Status{.code = 13, .message = "Out of memory"};
+    }
+    X509* target = openssl.parse(leaf);
+    for (size_t i = 1; target && i < certificates.size(); ++i) {
+        X509* intermediate = openssl.parse(certificates[i]);
+        if (!intermediate || !sk_X509_push(openssl.untrusted, intermediate)) {
+            target = nullptr;
+        }
+    }
+    if (!target) {
+        return Status{.code = 3, .message = "Malformed certificate in chain"};
+    }
+    if (!add_trust_anchors(openssl, certificates, *bundle) || !add_crls(openssl, bundles.crls())) {
+        return Status{.code = 13, .message = "Failed to set up the trust store"};
+    }
+
+    // Any bundle certificate ends the path (partial chains), SVIDs authenticate clients and
+    // servers alike (any purpose), and revocation is checked on the whole path when there are CRLs
+    unsigned long flags = X509_V_FLAG_X509_STRICT | X509_V_FLAG_PARTIAL_CHAIN;
+    if (!bundles.crls().empty()) {
+        flags |= X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL;
+        X509_STORE_set_verify_cb(openssl.store, ignore_missing_crls);
+    }
+    if (X509_STORE_CTX_init(openssl.context, openssl.store, target, openssl.untrusted) != 1) {
+        return Status{.code = 13, .message = "Failed to set up the verification"};
+    }
+    X509_VERIFY_PARAM* param = X509_STORE_CTX_get0_param(openssl.context);
+    X509_VERIFY_PARAM_set_flags(param, flags);
+    X509_VERIFY_PARAM_set_purpose(param, X509_PURPOSE_ANY);
+    X509_VERIFY_PARAM_set_time(param, static_cast<time_t>(now.time_since_epoch().count()));
+
+    if (X509_verify_cert(openssl.context) != 1) {
+        int error = X509_STORE_CTX_get_error(openssl.context);
+        if (error == X509_V_ERR_UNABLE_TO_GET_ISSUER_CERT_LOCALLY || error == X509_V_ERR_UNABLE_TO_GET_ISSUER_CERT) {
+            return unauthenticated("No path to the bundle of " + out.trust_domain.id().to_string());
+        }
+        return unauthenticated(std::string("Certificate verification failed: ") +
+                               X509_verify_cert_error_string(error));
+    }
+
+    STACK_OF(X509)* path = X509_STORE_CTX_get0_chain(openssl.context);
+    for (int i = 0; i < sk_X509_num(path); ++i) {
+        const X509CertificateView* cert = openssl.view_of(sk_X509_value(path, i));
+        if (!cert) {
+            return Status{.code = 13, .message = "Verified path has an unknown certificate"};
+        }
+        out.not_before = std::max(out.not_before, cert->not_before());
+        out.not_after = std::min(out.not_after, cert->not_after());
+    }
+    return Status();
+}
+
+}  // namespace
+
+X509Time x509_now() { return std::chrono::time_point_cast<std::chrono::seconds>(std::chrono::system_clock::now()); }
+
+Status verify_x509_svid(const X509CertificateChain& chain, const X509BundleIndexSet& bundles, std::string& spiffe_id,
+                        X509Time now) {
+    VerifiedChain verified;
+    Status status = verify_chain(chain, bundles, now, verified);
+    if (status.is_ok()) {
+        spiffe_id = std::move(verified.spiffe_id);
+    }
+    return status;
+}
+
+// Keyed by the hash of the chain's DER, which is already spread
+class X509SvidVerifier::Cache : public BoundedCache<size_t, Entry> {
+   public:
+    using BoundedCache::BoundedCache;
+};
+
+X509SvidVerifier::X509SvidVerifier(const X509SvidVerifierOptions& options)
+    : cache_(new Cache(options.max_entries, options.shards)) {}
+
+X509SvidVerifier::~X509SvidVerifier() = default;
+
+bool X509SvidVerifier::holds(const Entry& entry, const X509BundleIndexSet& bundles, X509Time now) {
+    if (now < entry.not_before || now > entry.not_after || entry.crl_revision != bundles.crl_revision()) {
+        return false;
+    }
+    const X509BundleIndex* bundle = bundles.get(entry.trust_domain);
+    return bundle && bundle->id() == entry.bundle_id;
+}
+
+Status X509SvidVerifier::verify(const X509CertificateChain& chain, const X509BundleIndexSet& bundles,
+                                std::string& spiffe_id, X509Time now) {
+    BufferView der = chain.der();
+    size_t hash = BufferViewHash()(der);
+    Cache::Shard& shard = cache_->shard(hash);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const Entry* cached = cache_->find(shard, hash);
+        // Same hash is not enough, the bytes must match
+        if (cached && BufferView(cached->chain) == der && holds(*cached, bundles, now)) {
+            spiffe_id = cached->spiffe_id;
+            return Status();
+        }
+    }
+
+    // Verified outside of the lock, concurrent misses for one chain each verify it
+    VerifiedChain verified;
+    Status status = verify_chain(chain, bundles, now, verified);
+    if (!status.is_ok()) {
+        return status;
+    }
+    spiffe_id = verified.spiffe_id;
+
+    Entry entry{
+        .chain = der.to_buffer(),
+        .spiffe_id = std::move(verified.spiffe_id),
+        .trust_domain = verified.trust_domain,
+        .bundle_id = verified.bundle_id,
+        .crl_revision = bundles.crl_revision(),
+        .not_before = verified.not_before,
+        .not_after = verified.not_after,
+    };
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    cache_->insert(shard, hash, std::move(entry), [&](const Entry& cached) { return holds(cached, bundles, now); });
+    return status;
+}
+
+size_t X509SvidVerifier::size() const { return cache_->size(); }
+
+}  // namespace spiffe
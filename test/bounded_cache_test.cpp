@@ -0,0 +1,89 @@
+#include "bounded_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+
+namespace spiffe {
+
+namespace {
+
+using Cache = BoundedCache<std::string, int>;
+
+bool always_holds(const int&) { return true; }
+
+bool cached(Cache& cache, const std::string& key) {
+    Cache::Shard& shard = cache.shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return cache.find(shard, key) != nullptr;
+}
+
+void put(Cache& cache, const std::string& key, int value) {
+    Cache::Shard& shard = cache.shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    cache.insert(shard, key, value, always_holds);
+}
+
+}  // namespace
+
+TEST(BoundedCacheTest, EvictsLeastRecentlyUsed) {
+    Cache cache(3, 1);
+    put(cache, "a", 1);
+    put(cache, "b", 2);
+    put(cache, "c", 3);
+
+    // "a" was used last, "b" goes first
+    EXPECT_TRUE(cached(cache, "a"));
+    put(cache, "d", 4);
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_FALSE(cached(cache, "b"));
+
+    // Replacing is a use too, and does not evict
+    put(cache, "c", 30);
+    EXPECT_EQ(cache.size(), 3u);
+    put(cache, "e", 5);
+    EXPECT_FALSE(cached(cache, "a"));
+    EXPECT_TRUE(cached(cache, "c"));
+    EXPECT_TRUE(cached(cache, "d"));
+    EXPECT_TRUE(cached(cache, "e"));
+
+    Cache::Shard& shard = cache.shard("c");
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    EXPECT_EQ(*cache.find(shard, "c"), 30);
+}
+
+TEST(BoundedCacheTest, EvictsValuesThatNoLongerHoldFirst) {
+    Cache cache(3, 1);
+    put(cache, "a", 1);
+    put(cache, "b", -2);
+    put(cache, "c", -3);
+
+    // Negative values no longer hold, both go and the least recently used one stays
+    Cache::Shard& shard = cache.shard("d");
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        cache.insert(shard, "d", 4, [](const int& value) { return value > 0; });
+    }
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_TRUE(cached(cache, "a"));
+    EXPECT_TRUE(cached(cache, "d"));
+}
+
+TEST(BoundedCacheTest, SplitsBoundBetweenShards) {
+    Cache cache(8, 4);
+    for (int i = 0; i < 100; ++i) {
+        put(cache, std::to_string(i), i);
+    }
+    EXPECT_LE(cache.size(), 8u);
+
+    // Never less than one per shard
+    Cache tiny(1, 4);
+    for (int i = 0; i < 100; ++i) {
+        put(tiny, std::to_string(i), i);
+    }
+    EXPECT_LE(tiny.size(), 4u);
+    EXPECT_GE(tiny.size(), 1u);
+}
+
+}  // namespace spiffe
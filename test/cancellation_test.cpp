@@ -0,0 +1,146 @@
+#include <spiffe/cancellation.h>
+#include <spiffe/spiffe.h>
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace spiffe {
+
+namespace {
+
+// Unix socket that accepts connections into its backlog but never answers, so a call on it
+// only ends when cancelled
+class SilentSocket {
+   public:
+    SilentSocket() {
+        path_ = "/tmp/spiffe-cpp-cancellation-" + std::to_string(getpid()) + ".sock";
+        unlink(path_.c_str());
+
+        fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+        if (fd_ < 0 || bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd_, 8) != 0) {
+            path_.clear();
+        }
+    }
+
+    ~SilentSocket() {
+        if (fd_ >= 0) close(fd_);
+        if (!path_.empty()) unlink(path_.c_str());
+    }
+
+    const std::string& path() const { return path_; }
+
+   private:
+    int fd_ = -1;
+    std::string path_;
+};
+
+}  // namespace
+
+TEST(CancellationTest, DefaultTokenNeverCancels) {
+    CancellationToken token;
+    EXPECT_FALSE(token.can_cancel());
+    EXPECT_FALSE(token.can_notify());
+    EXPECT_FALSE(token.is_cancelled());
+    EXPECT_EQ(token.subscribe([] { FAIL(); }), 0);
+}
+
+TEST(CancellationTest, SourceRunsCallbacksOnce) {
+    CancellationSource source;
+    CancellationToken token = source.token();
+    EXPECT_TRUE(token.can_cancel());
+    EXPECT_TRUE(token.can_notify());
+
+    int calls = 0;
+    uint64_t id = token.subscribe([&] { ++calls; });
+    EXPECT_NE(id, 0);
+    EXPECT_EQ(calls, 0);
+
+    source.cancel();
+    source.cancel();
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(source.is_cancelled());
+    EXPECT_TRUE(token.is_cancelled());
+
+    // Already cancelled, runs right away
+    token.subscribe([&] { ++calls; });
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(CancellationTest, Unsubscribe) {
+    CancellationSource source;
+    CancellationToken token = source.token();
+
+    int calls = 0;
+    uint64_t id = token.subscribe([&] { ++calls; });
+    token.unsubscribe(id);
+    source.cancel();
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(CancellationTest, SharedFutureToken) {
+    std::promise<void> promise;
+    CancellationToken token(promise.get_future().share());
+    EXPECT_TRUE(token.can_cancel());
+    EXPECT_FALSE(token.can_notify());
+    EXPECT_EQ(token.subscribe([] {}), 0);
+
+    EXPECT_FALSE(token.is_cancelled());
+    promise.set_value();
+    EXPECT_TRUE(token.is_cancelled());
+}
+
+TEST(CancellationTest, CancelWakesStreamingCall) {
+    SilentSocket agent;
+    ASSERT_FALSE(agent.path().empty());
+
+    WorkloadApiClient client(agent.path());
+    CancellationSource source;
+
+    std::promise<Status> result;
+    std::thread stream([&] {
+        result.set_value(
+            client.fetch_x509_svid([](const X509SvidContext&) { return Status{}; }, source.token()));
+    });
+
+    // Let the call connect and start waiting on the silent agent
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    auto cancelled_at = std::chrono::steady_clock::now();
+    source.cancel();
+    std::future<Status> status = result.get_future();
+    bool returned = status.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    auto elapsed = std::chrono::steady_clock::now() - cancelled_at;
+    stream.join();
+
+    ASSERT_TRUE(returned);
+    EXPECT_EQ(status.get().code, 1);
+
+    // Well below the one second a polled token may take
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 100);
+}
+
+TEST(CancellationTest, CancelBeforeCall) {
+    SilentSocket agent;
+    ASSERT_FALSE(agent.path().empty());
+
+    WorkloadApiClient client(agent.path());
+    CancellationSource source;
+    source.cancel();
+
+    Status status = client.fetch_jwt_bundles([](const JwtBundles&) { return Status{}; }, source.token());
+    EXPECT_EQ(status.code, 1);
+}
+
+}  // namespace spiffe
@@ -0,0 +1,169 @@
+#include <spiffe/compact_context.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "context_decoder.h"
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+
+namespace {
+
+Buffer bytes(const std::string& s) { return Buffer(s.begin(), s.end()); }
+
+std::vector<uint8_t> make_bundles_response(const std::vector<std::pair<std::string, std::string>>& bundles) {
+    ProtoX509BundlesResponse response;
+    std::vector<ProtoMapItem> items;
+    for (const auto& bundle : bundles) {
+        ProtoMapItem item;
+        item.key.set(bundle.first);
+        item.value.set(bundle.second);
+        items.push_back(item);
+    }
+    response.bundles.set(items);
+    return encode_proto_message(response);
+}
+
+}  // namespace
+
+TEST(CompactContextTest, DecodeX509SvidContext) {
+    std::string spiffe_id = "spiffe://example.org/w";
+    std::string chain("\x30\x01\xaa\x30\x02\xbb\xcc", 7);
+    std::string key = "key";
+    std::string hint = "internal";
+    std::string crl = "crl";
+    std::string federated = "spiffe://federated.org";
+
+    ProtoX509SvidResponse response;
+    ProtoX509Svid svid;
+    svid.spiffe_id.set(spiffe_id);
+    svid.x509_svid.set(chain);
+    svid.x509_svid_key.set(key);
+    svid.bundle.set(chain);
+    svid.hint.set(hint);
+    response.svids.set({svid});
+    response.crl.set({proto_view(crl)});
+    ProtoMapItem item;
+    item.key.set(federated);
+    item.value.set(chain);
+    response.federated_bundles.set({item});
+
+    std::vector<uint8_t> frame = encode_proto_message(response);
+
+    CompactX509SvidContext context;
+    ASSERT_TRUE(decode_compact_x509_svid_context(frame.data(), frame.size(), context));
+
+    ASSERT_EQ(context.svid_count(), 1);
+    CompactX509Svid compact = context.svid(0);
+    EXPECT_EQ(compact.spiffe_id.to_string(), spiffe_id);
+    EXPECT_EQ(compact.x509_svid.size(), 2);
+    EXPECT_EQ(compact.x509_svid.der(), BufferView(Buffer{0x30, 0x01, 0xaa, 0x30, 0x02, 0xbb, 0xcc}));
+    EXPECT_EQ(compact.x509_svid_key, BufferView(bytes(key)));
+    EXPECT_EQ(compact.bundle.size(), 2);
+    EXPECT_EQ(compact.hint.to_string(), hint);
+
+    ASSERT_EQ(context.crl_count(), 1);
+    EXPECT_EQ(context.crl(0), BufferView(bytes(crl)));
+
+    CertificateRange bundle;
+    ASSERT_TRUE(context.federated_bundles().find(federated, bundle));
+    EXPECT_EQ(bundle.size(), 2);
+    EXPECT_FALSE(context.federated_bundles().find("spiffe://other.org", bundle));
+
+    // Same content as the owned representation
+    X509SvidContext owned;
+    ASSERT_TRUE(decode_x509_svid_context(frame.data(), frame.size(), owned));
+    EXPECT_EQ(compact.x509_svid.der(), owned.svids[0].x509_svid.der());
+    EXPECT_EQ(bundle.der(), owned.federated_bundles[federated].der());
+}
+
+TEST(CompactContextTest, BundlesSortedAndLinear) {
+    std::string a("\x30\x01\x0a", 3);
+    std::string b("\x30\x01\x0b\x30\x01\x0c", 6);
+    std::string c("\x30\x00", 2);
+    std::vector<uint8_t> frame = make_bundles_response({
+        {"spiffe://c.org", c},
+        {"spiffe://a.org", a},
+        {"spiffe://b.org", b},
+    });
+
+    CompactX509BundlesContext context;
+    ASSERT_TRUE(decode_compact_x509_bundles_context(frame.data(), frame.size(), context));
+
+    CompactBundles bundles = context.bundles();
+    ASSERT_EQ(bundles.size(), 3);
+    EXPECT_EQ(bundles.trust_domain(0).to_string(), "spiffe://a.org");
+    EXPECT_EQ(bundles.trust_domain(1).to_string(), "spiffe://b.org");
+    EXPECT_EQ(bundles.trust_domain(2).to_string(), "spiffe://c.org");
+
+    // Bundle certificates follow each other in table order
+    EXPECT_EQ(bundles.bundle(0).der().end(), bundles.bundle(1).der().begin());
+    EXPECT_EQ(bundles.bundle(1).der().end(), bundles.bundle(2).der().begin());
+
+    CertificateRange all = bundles.all_certificates();
+    EXPECT_EQ(all.size(), 4);
+    EXPECT_EQ(all.der(), BufferView(bytes(a + b + c)));
+
+    std::vector<Buffer> walked;
+    for (const BufferView& cert : all) {
+        walked.push_back(cert.to_buffer());
+    }
+    EXPECT_EQ(walked, (std::vector<Buffer>{bytes(a), {0x30, 0x01, 0x0b}, {0x30, 0x01, 0x0c}, bytes(c)}));
+}
+
+TEST(CompactContextTest, RepeatedTrustDomainKeepsLast) {
+    std::string first("\x30\x01\x01", 3);
+    std::string last("\x30\x01\x02", 3);
+    std::vector<uint8_t> frame = make_bundles_response({
+        {"spiffe://a.org", first},
+        {"spiffe://b.org", first},
+        {"spiffe://a.org", last},
+    });
+
+    CompactX509BundlesContext context;
+    ASSERT_TRUE(decode_compact_x509_bundles_context(frame.data(), frame.size(), context));
+
+    ASSERT_EQ(context.bundles().size(), 2);
+    CertificateRange bundle;
+    ASSERT_TRUE(context.bundles().find("spiffe://a.org", bundle));
+    EXPECT_EQ(bundle.der(), BufferView(bytes(last)));
+    EXPECT_EQ(context.bundles().all_certificates().size(), 2);
+}
+
+TEST(CompactContextTest, CopyAndMove) {
+    std::vector<uint8_t> frame = make_bundles_response({{"spiffe://a.org", std::string("\x30\x00", 2)}});
+
+    CompactX509BundlesContext context;
+    ASSERT_TRUE(decode_compact_x509_bundles_context(frame.data(), frame.size(), context));
+
+    CompactX509BundlesContext copy = context;
+    EXPECT_EQ(copy.arena_size(), context.arena_size());
+    EXPECT_NE(copy.bundles().trust_domain(0).data(), context.bundles().trust_domain(0).data());
+    EXPECT_EQ(copy.bundles().trust_domain(0), context.bundles().trust_domain(0));
+
+    CompactX509BundlesContext moved = std::move(context);
+    EXPECT_EQ(moved.bundles().size(), 1);
+    EXPECT_EQ(context.bundles().size(), 0);
+    EXPECT_EQ(context.arena_size(), 0);
+
+    CompactX509SvidContext empty;
+    EXPECT_EQ(empty.svid_count(), 0);
+    EXPECT_TRUE(empty.federated_bundles().all_certificates().empty());
+}
+
+TEST(CompactContextTest, RejectTruncated) {
+    std::vector<uint8_t> frame = make_bundles_response({{"spiffe://a.org", std::string("\x30\x00", 2)}});
+    frame.pop_back();
+
+    CompactX509BundlesContext context;
+    EXPECT_FALSE(decode_compact_x509_bundles_context(frame.data(), frame.size(), context));
+
+    // Trailing garbage after the certificates of a bundle
+    frame = make_bundles_response({{"spiffe://a.org", std::string("\x30\x00\xff", 3)}});
+    EXPECT_FALSE(decode_compact_x509_bundles_context(frame.data(), frame.size(), context));
+}
+
+}  // namespace spiffe
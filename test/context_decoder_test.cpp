@@ -0,0 +1,206 @@
+#include "context_decoder.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+
+TEST(ContextDecoderTest, DecodeX509SvidContext) {
+    // Response messages hold views, the backing strings must outlive encoding
+    std::string spiffe_id = "spiffe://example.org/w";
+    std::string chain("\x30\x01\xaa\x30\x02\xbb\xcc", 7);
+    std::string key = "key";
+    std::string hint = "internal";
+    std::string crl = "crl";
+    std::string federated = "spiffe://federated.org";
+
+    ProtoX509SvidResponse response;
+    ProtoX509Svid svid;
+    svid.spiffe_id.set(spiffe_id);
+    svid.x509_svid.set(chain);
+    svid.x509_svid_key.set(key);
+    svid.bundle.set(chain);
+    svid.hint.set(hint);
+    response.svids.set({svid});
+    response.crl.set({proto_view(crl)});
+    ProtoMapItem item;
+    item.key.set(federated);
+    item.value.set(chain);
+    response.federated_bundles.set({item});
+
+    std::vector<uint8_t> frame = encode_proto_message(response);
+
+    X509SvidContext context;
+    ASSERT_TRUE(decode_x509_svid_context(frame.data(), frame.size(), context));
+
+    ASSERT_EQ(context.svids.size(), 1);
+    EXPECT_EQ(context.svids[0].spiffe_id, spiffe_id);
+    ASSERT_EQ(context.svids[0].x509_svid.size(), 2);
+    EXPECT_EQ(context.svids[0].x509_svid[1], Buffer({0x30, 0x02, 0xbb, 0xcc}));
+    EXPECT_EQ(context.svids[0].x509_svid_key, Buffer(key.begin(), key.end()));
+    EXPECT_EQ(context.svids[0].bundle.size(), 2);
+    EXPECT_EQ(context.svids[0].hint, hint);
+
+    ASSERT_EQ(context.crl.size(), 1);
+    EXPECT_EQ(context.crl[0], Buffer(crl.begin(), crl.end()));
+
+    ASSERT_EQ(context.federated_bundles.count(federated), 1);
+    EXPECT_EQ(context.federated_bundles[federated].size(), 2);
+
+    // The certificates share one backing that holds them and nothing else, not the key
+    const std::shared_ptr<const Buffer>& backing = context.svids[0].x509_svid.backing();
+    EXPECT_EQ(context.svids[0].bundle.backing(), backing);
+    EXPECT_EQ(context.federated_bundles[federated].backing(), backing);
+    EXPECT_EQ(backing->size(), 3 * chain.size());
+}
+
+TEST(ContextDecoderTest, DecodeJwtSvids) {
+    std::string spiffe_id = "spiffe://example.org/w";
+    std::string token = "header.payload.signature";
+
+    ProtoJwtSvidResponse response;
+    ProtoJwtSvid svid;
+    svid.spiffe_id.set(spiffe_id);
+    svid.svid.set(token);
+    response.svids.set({svid, svid});
+
+    std::vector<uint8_t> frame = encode_proto_message(response);
+
+    std::vector<JwtSvid> out;
+    ASSERT_TRUE(decode_jwt_svids(frame.data(), frame.size(), out));
+    ASSERT_EQ(out.size(), 2);
+    EXPECT_EQ(out[0].spiffe_id, spiffe_id);
+    EXPECT_EQ(out[1].svid, token);
+    EXPECT_EQ(out[1].hint, "");
+}
+
+TEST(ContextDecoderTest, RejectTruncated) {
+    std::string federated = "spiffe://federated.org";
+    std::string bundle = "{}";
+
+    ProtoJwtBundlesResponse response;
+    ProtoMapItem item;
+    item.key.set(federated);
+    item.value.set(bundle);
+    response.bundles.set({item});
+
+    std::vector<uint8_t> frame = encode_proto_message(response);
+    frame.pop_back();
+
+    JwtBundles bundles;
+    EXPECT_FALSE(decode_jwt_bundles(frame.data(), frame.size(), bundles));
+}
+
+TEST(ContextDecoderTest, RejectMalformedCertificates) {
+    // A well-formed certificate followed by garbage fails the message instead of shortening the chain
+    std::string chain("\x30\x01\xaa\xff", 4);
+
+    ProtoX509SvidResponse response;
+    ProtoX509Svid svid;
+    svid.x509_svid.set(chain);
+    response.svids.set({svid});
+    std::vector<uint8_t> frame = encode_proto_message(response);
+
+    X509SvidContext context;
+    EXPECT_FALSE(decode_x509_svid_context(frame.data(), frame.size(), context));
+    EXPECT_TRUE(context.svids.empty());
+
+    std::string federated = "spiffe://federated.org";
+    ProtoX509BundlesResponse bundles_response;
+    ProtoMapItem item;
+    item.key.set(federated);
+    item.value.set(chain);
+    bundles_response.bundles.set({item});
+    frame = encode_proto_message(bundles_response);
+
+    X509BundlesContext bundles;
+    EXPECT_FALSE(decode_x509_bundles_context(frame.data(), frame.size(), bundles));
+}
+
+TEST(ContextDecoderTest, SkipUnknownFields) {
+    std::string spiffe_id = "spiffe://example.org/w";
+    std::string token = "header.payload.signature";
+
+    ProtoJwtSvid svid;
+    svid.spiffe_id.set(spiffe_id);
+    svid.svid.set(token);
+    std::vector<uint8_t> inner = encode_proto_message(svid);
+
+    // Fields a newer agent might add: varint 9, fixed64 10, bytes 11, fixed32 12, and a key of
+    // field 300 that takes two bytes
+    const uint8_t unknown[] = {
+        0x48, 0xac, 0x02,                                      // 9: 300
+        0x51, 1, 2, 3, 4, 5, 6, 7, 8,                          // 10: fixed64
+        0x5a, 0x03, 'a', 'b', 'c',                             // 11: "abc"
+        0x65, 1, 2, 3, 4,                                      // 12: fixed32
+        0xe0, 0x12, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01,  // 300: large varint
+    };
+    inner.insert(inner.end(), std::begin(unknown), std::end(unknown));
+
+    std::vector<uint8_t> frame = {0x0a, static_cast<uint8_t>(inner.size())};
+    frame.insert(frame.end(), inner.begin(), inner.end());
+    frame.insert(frame.end(), std::begin(unknown), std::end(unknown));
+
+    std::vector<JwtSvid> out;
+    ASSERT_TRUE(decode_jwt_svids(frame.data(), frame.size(), out));
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].spiffe_id, spiffe_id);
+    EXPECT_EQ(out[0].svid, token);
+
+    // Truncated unknown field, groups and field number 0 are still errors
+    std::vector<uint8_t> truncated(frame.begin(), frame.end() - 1);
+    EXPECT_FALSE(decode_jwt_svids(truncated.data(), truncated.size(), out));
+    const uint8_t group[] = {0x4b};
+    EXPECT_FALSE(decode_jwt_svids(group, sizeof(group), out));
+    const uint8_t field_zero[] = {0x00, 0x01};
+    EXPECT_FALSE(decode_jwt_svids(field_zero, sizeof(field_zero), out));
+}
+
+TEST(ContextDecoderTest, RejectOverlongVarint) {
+    // Length of 11 continuation bytes, no valid varint is longer than 10
+    std::vector<uint8_t> frame = {0x0a};
+    frame.insert(frame.end(), 11, 0x80);
+    frame.push_back(0x00);
+
+    std::vector<JwtSvid> out;
+    EXPECT_FALSE(decode_jwt_svids(frame.data(), frame.size(), out));
+}
+
+TEST(ContextDecoderTest, EncodeNestedInPlace) {
+    // Tokens over 127 bytes, so nested lengths take two varint bytes
+    std::vector<std::string> tokens = {std::string(200, 'a'), "", std::string(20000, 'b')};
+    std::string spiffe_id = "spiffe://example.org/w";
+
+    ProtoJwtSvidResponse response;
+    response.svids.set({});
+    for (const std::string& token : tokens) {
+        ProtoJwtSvid svid;
+        svid.spiffe_id.set(spiffe_id);
+        svid.svid.set(token);
+        response.svids.get().push_back(svid);
+    }
+
+    std::vector<uint8_t> frame = encode_proto_message(response);
+    EXPECT_EQ(frame.size(), response.serialized_size());
+
+    proto_writer* writer = response.serialize();
+    EXPECT_EQ(std::vector<uint8_t>(writer->m_buf, writer->m_buf + writer->m_pos), frame);
+    delete writer;
+
+    std::vector<JwtSvid> out;
+    ASSERT_TRUE(decode_jwt_svids(frame.data(), frame.size(), out));
+    ASSERT_EQ(out.size(), tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        EXPECT_EQ(out[i].spiffe_id, spiffe_id);
+        EXPECT_EQ(out[i].svid, tokens[i]);
+    }
+
+    // Framed in the same allocation, header included
+    EXPECT_EQ(encode_grpc_message(response), GrpcFraming::pack_message(frame));
+}
+
+}  // namespace spiffe
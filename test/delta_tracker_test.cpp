@@ -0,0 +1,215 @@
+#include "delta_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+
+namespace {
+
+// Response messages hold views, the strings in these fixtures outlive encoding
+struct SvidFixture {
+    std::string spiffe_id;
+    std::string chain;
+    std::string key;
+    std::string hint;
+};
+
+std::vector<uint8_t> make_x509_svid_response(const std::vector<SvidFixture>& svids,
+                                             const std::vector<std::pair<std::string, std::string>>& bundles) {
+    ProtoX509SvidResponse response;
+
+    std::vector<ProtoX509Svid> items;
+    for (const auto& fixture : svids) {
+        ProtoX509Svid svid;
+        svid.spiffe_id.set(fixture.spiffe_id);
+        svid.x509_svid.set(fixture.chain);
+        svid.x509_svid_key.set(fixture.key);
+        svid.bundle.set(fixture.chain);
+        svid.hint.set(fixture.hint);
+        items.push_back(svid);
+    }
+    response.svids.set(items);
+
+    std::vector<ProtoMapItem> map;
+    for (const auto& bundle : bundles) {
+        ProtoMapItem item;
+        item.key.set(bundle.first);
+        item.value.set(bundle.second);
+        map.push_back(item);
+    }
+    response.federated_bundles.set(map);
+
+    return encode_proto_message(response);
+}
+
+std::vector<uint8_t> make_jwt_bundles_response(const std::vector<std::pair<std::string, std::string>>& bundles) {
+    ProtoJwtBundlesResponse response;
+    std::vector<ProtoMapItem> map;
+    for (const auto& bundle : bundles) {
+        ProtoMapItem item;
+        item.key.set(bundle.first);
+        item.value.set(bundle.second);
+        map.push_back(item);
+    }
+    response.bundles.set(map);
+    return encode_proto_message(response);
+}
+
+const std::string CHAIN_A("\x30\x01\x0a", 3);
+const std::string CHAIN_B("\x30\x01\x0b", 3);
+
+}  // namespace
+
+TEST(DeltaTrackerTest, FirstUpdateAddsEverything) {
+    X509SvidTracker tracker;
+    std::vector<uint8_t> frame = make_x509_svid_response({{"spiffe://example.org/w", CHAIN_A, "key", ""}},
+                                                         {{"spiffe://a.org", CHAIN_A}, {"spiffe://b.org", CHAIN_B}});
+
+    X509SvidDelta delta;
+    ASSERT_TRUE(tracker.apply(frame.data(), frame.size(), delta));
+    EXPECT_EQ(delta.generation, 1);
+    ASSERT_EQ(delta.added.size(), 1);
+    EXPECT_EQ(delta.added[0], (SvidKey{"spiffe://example.org/w", ""}));
+    EXPECT_EQ(delta.federated_bundles.added.size(), 2);
+    EXPECT_TRUE(delta.federated_bundles.removed.empty());
+
+    ASSERT_EQ(tracker.context().svids.size(), 1);
+    EXPECT_EQ(tracker.context().svids[0].x509_svid.size(), 1);
+    EXPECT_EQ(tracker.context().federated_bundles.size(), 2);
+}
+
+TEST(DeltaTrackerTest, IdenticalUpdateIsNotDelivered) {
+    X509SvidTracker tracker;
+    std::vector<uint8_t> frame =
+        make_x509_svid_response({{"spiffe://example.org/w", CHAIN_A, "key", ""}}, {{"spiffe://a.org", CHAIN_A}});
+
+    X509SvidDelta delta;
+    ASSERT_TRUE(tracker.apply(frame.data(), frame.size(), delta));
+    const Buffer* bundle = tracker.context().federated_bundles.at("spiffe://a.org").backing().get();
+
+    ASSERT_TRUE(tracker.apply(frame.data(), frame.size(), delta));
+    EXPECT_EQ(delta.generation, 0);
+    EXPECT_TRUE(delta.empty());
+
+    // Unchanged entries are kept, not rebuilt
+    EXPECT_EQ(tracker.context().federated_bundles.at("spiffe://a.org").backing().get(), bundle);
+}
+
+TEST(DeltaTrackerTest, ReportsChanges) {
+    X509SvidTracker tracker;
+    X509SvidDelta delta;
+
+    std::vector<uint8_t> first = make_x509_svid_response(
+        {{"spiffe://example.org/a", CHAIN_A, "key", ""}, {"spiffe://example.org/b", CHAIN_A, "key", ""}},
+        {{"spiffe://a.org", CHAIN_A}, {"spiffe://b.org", CHAIN_A}, {"spiffe://c.org", CHAIN_A}});
+    ASSERT_TRUE(tracker.apply(first.data(), first.size(), delta));
+    const Buffer* unchanged = tracker.context().federated_bundles.at("spiffe://a.org").backing().get();
+
+    std::vector<uint8_t> second = make_x509_svid_response(
+        {{"spiffe://example.org/b", CHAIN_B, "key", ""}, {"spiffe://example.org/c", CHAIN_A, "key", ""}},
+        {{"spiffe://a.org", CHAIN_A}, {"spiffe://b.org", CHAIN_B}, {"spiffe://d.org", CHAIN_A}});
+    ASSERT_TRUE(tracker.apply(second.data(), second.size(), delta));
+
+    EXPECT_EQ(delta.generation, 2);
+    EXPECT_EQ(delta.added, (std::vector<SvidKey>{{"spiffe://example.org/c", ""}}));
+    EXPECT_EQ(delta.removed, (std::vector<SvidKey>{{"spiffe://example.org/a", ""}}));
+    EXPECT_EQ(delta.changed, (std::vector<SvidKey>{{"spiffe://example.org/b", ""}}));
+    EXPECT_EQ(delta.federated_bundles.added, (std::vector<TrustDomain>{"spiffe://d.org"}));
+    EXPECT_EQ(delta.federated_bundles.removed, (std::vector<TrustDomain>{"spiffe://c.org"}));
+    EXPECT_EQ(delta.federated_bundles.changed, (std::vector<TrustDomain>{"spiffe://b.org"}));
+    EXPECT_FALSE(delta.crl_changed);
+    EXPECT_FALSE(delta.reordered);
+
+    // The agent's order is kept
+    const X509SvidContext& context = tracker.context();
+    ASSERT_EQ(context.svids.size(), 2);
+    EXPECT_EQ(context.svids[0].spiffe_id, "spiffe://example.org/b");
+    EXPECT_EQ(context.svids[0].x509_svid.der(), BufferView(Buffer(CHAIN_B.begin(), CHAIN_B.end())));
+    EXPECT_EQ(context.svids[1].spiffe_id, "spiffe://example.org/c");
+
+    EXPECT_EQ(context.federated_bundles.size(), 3);
+    EXPECT_EQ(context.federated_bundles.at("spiffe://a.org").backing().get(), unchanged);
+    EXPECT_EQ(context.federated_bundles.count("spiffe://c.org"), 0);
+}
+
+TEST(DeltaTrackerTest, ReportsReorder) {
+    X509SvidTracker tracker;
+    X509SvidDelta delta;
+
+    std::vector<uint8_t> first = make_x509_svid_response(
+        {{"spiffe://example.org/a", CHAIN_A, "key", ""}, {"spiffe://example.org/b", CHAIN_B, "key", ""}}, {});
+    ASSERT_TRUE(tracker.apply(first.data(), first.size(), delta));
+
+    // Same SVIDs, b is the new default
+    std::vector<uint8_t> second = make_x509_svid_response(
+        {{"spiffe://example.org/b", CHAIN_B, "key", ""}, {"spiffe://example.org/a", CHAIN_A, "key", ""}}, {});
+    ASSERT_TRUE(tracker.apply(second.data(), second.size(), delta));
+    EXPECT_EQ(delta.generation, 2);
+    EXPECT_TRUE(delta.reordered);
+    EXPECT_TRUE(delta.added.empty() && delta.removed.empty() && delta.changed.empty());
+    EXPECT_EQ(tracker.context().svids[0].spiffe_id, "spiffe://example.org/b");
+
+    // Removing one keeps the order of the others
+    std::vector<uint8_t> third = make_x509_svid_response({{"spiffe://example.org/a", CHAIN_A, "key", ""}}, {});
+    ASSERT_TRUE(tracker.apply(third.data(), third.size(), delta));
+    EXPECT_EQ(delta.generation, 3);
+    EXPECT_FALSE(delta.reordered);
+    EXPECT_EQ(delta.removed, (std::vector<SvidKey>{{"spiffe://example.org/b", ""}}));
+}
+
+TEST(DeltaTrackerTest, JwtBundles) {
+    JwtBundlesTracker tracker;
+    JwtBundlesDelta delta;
+
+    std::vector<uint8_t> first = make_jwt_bundles_response({{"spiffe://a.org", "{}"}, {"spiffe://b.org", "{}"}});
+    ASSERT_TRUE(tracker.apply(first.data(), first.size(), delta));
+    EXPECT_EQ(delta.generation, 1);
+
+    // A repeated key keeps its last value
+    std::vector<uint8_t> second = make_jwt_bundles_response(
+        {{"spiffe://a.org", "{}"}, {"spiffe://b.org", "{}"}, {"spiffe://b.org", "{\"keys\":[]}"}});
+    ASSERT_TRUE(tracker.apply(second.data(), second.size(), delta));
+    EXPECT_EQ(delta.generation, 2);
+    EXPECT_TRUE(delta.bundles.added.empty());
+    EXPECT_EQ(delta.bundles.changed, (std::vector<TrustDomain>{"spiffe://b.org"}));
+    EXPECT_EQ(tracker.context().bundles.at("spiffe://b.org"), "{\"keys\":[]}");
+}
+
+TEST(DeltaTrackerTest, RejectTruncatedKeepsContext) {
+    X509BundlesTracker tracker;
+    X509BundlesDelta delta;
+
+    ProtoX509BundlesResponse response;
+    ProtoMapItem item;
+    std::string trust_domain = "spiffe://a.org";
+    item.key.set(trust_domain);
+    item.value.set(CHAIN_A);
+    response.bundles.set({item});
+    std::vector<uint8_t> frame = encode_proto_message(response);
+
+    ASSERT_TRUE(tracker.apply(frame.data(), frame.size(), delta));
+    frame.pop_back();
+    EXPECT_FALSE(tracker.apply(frame.data(), frame.size(), delta));
+    EXPECT_EQ(tracker.context().bundles.size(), 1);
+
+    // Malformed certificates reject the update as a whole
+    std::string garbage = CHAIN_A + std::string("\xff", 1);
+    item.value.set(garbage);
+    ProtoMapItem other;
+    std::string other_domain = "spiffe://b.org";
+    other.key.set(other_domain);
+    other.value.set(CHAIN_A);
+    response.bundles.set({other, item});
+    frame = encode_proto_message(response);
+    EXPECT_FALSE(tracker.apply(frame.data(), frame.size(), delta));
+    EXPECT_EQ(tracker.context().bundles.size(), 1);
+    EXPECT_EQ(tracker.context().bundles.count(other_domain), 0);
+}
+
+}  // namespace spiffe
@@ -4,5 +4,10 @@
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
     spiffe::extract_all_certificates(Data, Size);
+
+    spiffe::CertificateList list = spiffe::CertificateList::from_der(Data, Size);
+    for (const auto& cert : list) {
+        (void)cert;
+    }
     return 0;
 }
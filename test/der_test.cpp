@@ -67,4 +67,90 @@ TEST(DerTest, ExtractCertificatesGarbage) {
     EXPECT_EQ(certs.size(), 0);
 }
 
+TEST(DerTest, CertificateIterViewsInput) {
+    std::vector<uint8_t> data = {
+        0x30, 0x02, 0x01, 0x01,
+        0x30, 0x02, 0x02, 0x02
+    };
+
+    CertificateIter iter(data.data(), data.size());
+    BufferView first = iter.next();
+    EXPECT_EQ(first.data(), data.data());
+    EXPECT_EQ(first.size(), 4);
+    EXPECT_EQ(iter.position(), 4);
+
+    BufferView second = iter.next();
+    EXPECT_EQ(second.data(), data.data() + 4);
+    EXPECT_FALSE(iter.has_next());
+    EXPECT_TRUE(iter.next().empty());
+}
+
+TEST(DerTest, CertificateListSharesBacking) {
+    auto backing = std::make_shared<const Buffer>(Buffer{
+        0xAA,
+        0x30, 0x02, 0x01, 0x01,
+        0x30, 0x02, 0x02, 0x02,
+        0xFF, 0xFF
+    });
+
+    CertificateList list(backing, 1, 8);
+    ASSERT_TRUE(list.valid());
+    ASSERT_EQ(list.size(), 2);
+    EXPECT_EQ(list.der().data(), backing->data() + 1);
+    EXPECT_EQ(list.der().size(), 8);
+
+    size_t count = 0;
+    for (const BufferView& cert : list) {
+        EXPECT_EQ(cert.data(), backing->data() + 1 + count * 4);
+        EXPECT_EQ(cert.size(), 4);
+        ++count;
+    }
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(list[1][2], 0x02);
+    EXPECT_EQ(list.front()[2], 0x01);
+
+    CertificateList copy = list;
+    EXPECT_EQ(copy.backing(), backing);
+    EXPECT_EQ(copy, list);
+
+    // Trailing garbage is an error, not a shorter list
+    CertificateList garbage(backing, 1, backing->size() - 1);
+    EXPECT_FALSE(garbage.valid());
+    EXPECT_TRUE(garbage.empty());
+    EXPECT_TRUE(garbage.der().empty());
+    EXPECT_FALSE(CertificateList(std::vector<Buffer>{{0x30, 0x00}, {0x05}}).valid());
+}
+
+TEST(DerTest, CertificateListFromBuffers) {
+    CertificateList list(std::vector<Buffer>{{0x30, 0x00}, {0x30, 0x01, 0x05}});
+    ASSERT_EQ(list.size(), 2);
+    EXPECT_EQ(list[1], BufferView(Buffer{0x30, 0x01, 0x05}));
+    EXPECT_EQ(list.to_buffers(), (std::vector<Buffer>{{0x30, 0x00}, {0x30, 0x01, 0x05}}));
+
+    CertificateList empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.valid());
+    EXPECT_EQ(empty.begin(), empty.end());
+
+    EXPECT_TRUE(CertificateList::from_der(nullptr, 0).empty());
+}
+
+TEST(DerTest, WriteTlv) {
+    Buffer out;
+    write_der_unsigned(out, Buffer{0x00, 0x00, 0x7f});
+    write_der_unsigned(out, Buffer{0x80});
+    write_der_unsigned(out, Buffer());
+    EXPECT_EQ(out, (Buffer{0x02, 0x01, 0x7f, 0x02, 0x02, 0x00, 0x80, 0x02, 0x01, 0x00}));
+
+    // Long form lengths read back
+    for (size_t size : {127u, 128u, 255u, 256u, 70000u}) {
+        Buffer tlv;
+        write_der_tlv(tlv, 0x04, Buffer(size, 0xaa));
+        TlvResult result = read_der_tlv(tlv.data(), tlv.size());
+        ASSERT_TRUE(result.valid) << size;
+        EXPECT_EQ(result.tlv_len, tlv.size());
+        EXPECT_EQ(result.tlv.value.size(), size);
+    }
+}
+
 } // namespace spiffe
@@ -0,0 +1,107 @@
+#include <spiffe/event_client.h>
+
+#include <gtest/gtest.h>
+#include <poll.h>
+
+#include <chrono>
+#include <vector>
+
+namespace spiffe {
+
+namespace {
+
+const char* UNREACHABLE_SOCKET = "/nonexistent/spiffe-cpp-test.sock";
+
+// Minimal host loop: poll the watched fds and report readiness until done or the deadline
+template <typename Done>
+void run_loop(WorkloadApiEventClient& client, Done done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        std::vector<pollfd> fds;
+        for (const auto& fd : client.fds()) {
+            short events = 0;
+            if (fd.second & WorkloadApiEventClient::EVENT_READ) events |= POLLIN;
+            if (fd.second & WorkloadApiEventClient::EVENT_WRITE) events |= POLLOUT;
+            fds.push_back(pollfd{fd.first, events, 0});
+        }
+
+        long timeout = client.timeout_ms();
+        int ready = poll(fds.data(), fds.size(), timeout < 0 ? 100 : static_cast<int>(timeout));
+        for (int i = 0; ready > 0 && i < static_cast<int>(fds.size()); ++i) {
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) client.on_readable(fds[i].fd);
+            if (fds[i].revents & POLLOUT) client.on_writable(fds[i].fd);
+        }
+        if (client.timeout_ms() == 0) {
+            client.on_timeout();
+        }
+    }
+}
+
+}  // namespace
+
+TEST(EventClientTest, UnreachableAgent) {
+    WorkloadApiEventClient client(UNREACHABLE_SOCKET);
+
+    int done = 0;
+    Status stream_status;
+    WorkloadApiEventClient::CallId id = client.fetch_x509_svid(
+        [](const X509SvidContext&) { return Status{}; },
+        [&](const Status& status) {
+            ++done;
+            stream_status = status;
+        });
+    ASSERT_NE(id, 0);
+
+    // Nothing happens until the host loop drives the client
+    EXPECT_EQ(done, 0);
+    EXPECT_GE(client.timeout_ms(), 0);
+
+    run_loop(client, [&] { return done > 0; });
+    EXPECT_EQ(done, 1);
+    EXPECT_FALSE(stream_status.is_ok());
+    EXPECT_NE(stream_status.code, 1);
+    EXPECT_TRUE(client.fds().empty());
+
+    // Finished calls are no longer known
+    client.cancel(id);
+    EXPECT_EQ(done, 1);
+}
+
+TEST(EventClientTest, CancelRunsOnDoneOnce) {
+    WorkloadApiEventClient client(UNREACHABLE_SOCKET);
+
+    int done = 0;
+    Status svid_status;
+    WorkloadApiEventClient::CallId id = client.fetch_jwt_svid(
+        {"audience"}, "",
+        [&](const Status& status, const std::vector<JwtSvid>& svids) {
+            ++done;
+            svid_status = status;
+            EXPECT_TRUE(svids.empty());
+        });
+
+    client.cancel(id);
+    EXPECT_EQ(done, 1);
+    EXPECT_EQ(svid_status.code, 1);
+
+    client.cancel(id);
+    run_loop(client, [&] { return client.timeout_ms() < 0; });
+    EXPECT_EQ(done, 1);
+}
+
+TEST(EventClientTest, StartFromCallback) {
+    WorkloadApiEventClient client(UNREACHABLE_SOCKET);
+
+    std::vector<int> order;
+    client.fetch_jwt_bundles([](const JwtBundles&) { return Status{}; },
+                             [&](const Status&) {
+                                 order.push_back(1);
+                                 client.fetch_x509_bundles([](const X509BundlesContext&) { return Status{}; },
+                                                           [&](const Status&) { order.push_back(2); });
+                             });
+
+    run_loop(client, [&] { return order.size() == 2; });
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+}
+
+}  // namespace spiffe
@@ -1,5 +1,6 @@
 #include "http2_client.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <vector>
 
 namespace spiffe {
@@ -58,4 +59,114 @@ TEST(GrpcFramingTest, HasCompleteMessageMultiple) {
     EXPECT_EQ(msg_size, 6);
 }
 
+static std::vector<Buffer> feed_in_chunks(const Buffer& stream, size_t chunk_size, bool* ok = nullptr) {
+    GrpcFrameAssembler assembler;
+    std::vector<Buffer> messages;
+    bool result = true;
+    for (size_t pos = 0; pos < stream.size() && result; pos += chunk_size) {
+        size_t size = std::min(chunk_size, stream.size() - pos);
+        result = assembler.feed(stream.data() + pos, size, [&](BufferView message) {
+            messages.push_back(message.to_buffer());
+            return true;
+        });
+    }
+    if (ok) *ok = result && !assembler.has_partial();
+    return messages;
+}
+
+TEST(GrpcFrameAssemblerTest, WholeMessagesAreNotCopied) {
+    std::vector<uint8_t> stream = {
+        0x00, 0x00, 0x00, 0x00, 0x01, 0xAA,       // Msg 1 (len 1)
+        0x00, 0x00, 0x00, 0x00, 0x02, 0xBB, 0xCC  // Msg 2 (len 2)
+    };
+
+    GrpcFrameAssembler assembler;
+    std::vector<const uint8_t*> pointers;
+    ASSERT_TRUE(assembler.feed(stream.data(), stream.size(), [&](BufferView message) {
+        pointers.push_back(message.data());
+        return true;
+    }));
+
+    ASSERT_EQ(pointers.size(), 2);
+    EXPECT_EQ(pointers[0], stream.data() + 5);
+    EXPECT_EQ(pointers[1], stream.data() + 11);
+    EXPECT_FALSE(assembler.has_partial());
+}
+
+TEST(GrpcFrameAssemblerTest, SplitAtEveryBoundary) {
+    Buffer first(300, 0x11);
+    Buffer empty;
+    Buffer second(70000, 0x22);
+
+    Buffer stream = GrpcFraming::pack_message(first);
+    Buffer packed = GrpcFraming::pack_message(empty);
+    stream.insert(stream.end(), packed.begin(), packed.end());
+    packed = GrpcFraming::pack_message(second);
+    stream.insert(stream.end(), packed.begin(), packed.end());
+
+    for (size_t chunk_size : {1, 2, 3, 4, 5, 6, 7, 299, 305, 306, 4096, 16384, 100000}) {
+        bool ok = false;
+        std::vector<Buffer> messages = feed_in_chunks(stream, chunk_size, &ok);
+        ASSERT_TRUE(ok) << chunk_size;
+        ASSERT_EQ(messages.size(), 3) << chunk_size;
+        EXPECT_EQ(messages[0], first);
+        EXPECT_EQ(messages[1], empty);
+        EXPECT_EQ(messages[2], second);
+    }
+}
+
+TEST(GrpcFrameAssemblerTest, PartialMessage) {
+    std::vector<uint8_t> stream = {0x00, 0x00, 0x00, 0x00, 0x03, 0x0A, 0x0B};
+
+    bool ok = true;
+    std::vector<Buffer> messages = feed_in_chunks(stream, 2, &ok);
+    EXPECT_FALSE(ok);
+    EXPECT_TRUE(messages.empty());
+}
+
+TEST(GrpcFrameAssemblerTest, RejectCompressed) {
+    std::vector<uint8_t> stream = {0x01, 0x00, 0x00, 0x00, 0x01, 0xAA};
+
+    GrpcFrameAssembler assembler;
+    EXPECT_FALSE(assembler.feed(stream.data(), stream.size(), [](BufferView) { return true; }));
+    EXPECT_TRUE(assembler.error());
+}
+
+TEST(GrpcFrameAssemblerTest, RejectOversized) {
+    // 4 GiB announced, nothing is allocated for it, whether the header comes whole or split
+    std::vector<uint8_t> stream = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xAA};
+    for (size_t chunk_size : {1, 6}) {
+        bool ok = true;
+        EXPECT_TRUE(feed_in_chunks(stream, chunk_size, &ok).empty());
+        EXPECT_FALSE(ok);
+    }
+
+    Buffer stream_of_8 = GrpcFraming::pack_message(Buffer(8, 0x11));
+    Buffer stream_of_9 = GrpcFraming::pack_message(Buffer(9, 0x11));
+
+    GrpcFrameAssembler accepts(8);
+    EXPECT_TRUE(accepts.feed(stream_of_8.data(), stream_of_8.size(), [](BufferView) { return true; }));
+
+    GrpcFrameAssembler rejects(8);
+    EXPECT_TRUE(rejects.feed(stream_of_9.data(), 3, [](BufferView) { return true; }));
+    EXPECT_FALSE(rejects.feed(stream_of_9.data() + 3, 3, [](BufferView) { return true; }));
+    EXPECT_TRUE(rejects.error());
+}
+
+TEST(GrpcFrameAssemblerTest, StopFromCallback) {
+    std::vector<uint8_t> stream = {
+        0x00, 0x00, 0x00, 0x00, 0x01, 0xAA,  // Msg 1
+        0x00, 0x00, 0x00, 0x00, 0x01, 0xBB   // Msg 2
+    };
+
+    GrpcFrameAssembler assembler;
+    int calls = 0;
+    EXPECT_FALSE(assembler.feed(stream.data(), stream.size(), [&](BufferView) {
+        ++calls;
+        return false;
+    }));
+    EXPECT_EQ(calls, 1);
+    EXPECT_FALSE(assembler.error());
+}
+
 } // namespace spiffe
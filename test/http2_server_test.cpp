@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <spiffe/spiffe.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "grpc_client.h"
+#include "http2_client.h"
+#include "mock/hpack.h"
+#include "mock/http2_server.h"
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+namespace mock {
+
+namespace {
+
+std::vector<uint8_t> from_hex(const std::string& hex) {
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+}
+
+std::string test_socket_path() { return "/tmp/spiffe-cpp-http2-" + std::to_string(getpid()) + ".sock"; }
+
+const HeaderList RESPONSE_HEADERS = {{":status", "200"}, {"content-type", "application/grpc"}};
+
+}  // namespace
+
+// RFC 7541 C.4, requests with Huffman coding sharing one dynamic table
+TEST(HpackTest, DecodesRfcExamples) {
+    HpackDecoder decoder;
+
+    HeaderList first;
+    std::vector<uint8_t> block = from_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff");
+    ASSERT_TRUE(decoder.decode(block.data(), block.size(), first));
+    HeaderList expected = {{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}};
+    EXPECT_EQ(first, expected);
+
+    HeaderList second;
+    block = from_hex("828684be5886a8eb10649cbf");
+    ASSERT_TRUE(decoder.decode(block.data(), block.size(), second));
+    expected.emplace_back("cache-control", "no-cache");
+    EXPECT_EQ(second, expected);
+
+    HeaderList third;
+    block = from_hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf");
+    ASSERT_TRUE(decoder.decode(block.data(), block.size(), third));
+    expected = {{":method", "GET"},
+                {":scheme", "https"},
+                {":path", "/index.html"},
+                {":authority", "www.example.com"},
+                {"custom-key", "custom-value"}};
+    EXPECT_EQ(third, expected);
+}
+
+TEST(HpackTest, RejectsMalformedBlocks) {
+    HpackDecoder decoder;
+    HeaderList headers;
+
+    // Index 0, index past the tables, truncated literal
+    for (const char* hex : {"80", "ff00", "400a6b6579"}) {
+        std::vector<uint8_t> block = from_hex(hex);
+        EXPECT_FALSE(decoder.decode(block.data(), block.size(), headers)) << hex;
+    }
+
+    // Padding longer than 7 bits
+    std::string out;
+    std::vector<uint8_t> padded = from_hex("f1e3c2e5f23a6ba0ab90f4ffff");
+    EXPECT_FALSE(huffman_decode(padded.data(), padded.size(), out));
+}
+
+TEST(HpackTest, EncodeRoundTrip) {
+    HeaderList headers = {{":status", "200"}, {"grpc-message", std::string(200, 'm')}};
+    std::vector<uint8_t> block;
+    hpack_encode(headers, block);
+
+    HpackDecoder decoder;
+    HeaderList decoded;
+    ASSERT_TRUE(decoder.decode(block.data(), block.size(), decoded));
+    EXPECT_EQ(decoded, headers);
+}
+
+TEST(Http2ServerTest, ServesUnaryCall) {
+    std::string path;
+    Http2Server* server = nullptr;
+    Http2Server http2_server(test_socket_path(), [&](Http2Server::StreamId id, const Http2Request& request) {
+        path = request.path;
+
+        ProtoJwtSvidRequest decoded;
+        Buffer message;
+        if (!GrpcFraming::unpack_message(request.body, message) || !decode_proto_message(message, decoded)) {
+            server->send_headers(id, {{":status", "200"}, {"grpc-status", "3"}}, true);
+            return;
+        }
+
+        std::string spiffe_id = "spiffe://example.org/" + decoded.audience.get().front();
+        std::string token = "token";
+        ProtoJwtSvid svid;
+        svid.spiffe_id.set(proto_view(spiffe_id));
+        svid.svid.set(proto_view(token));
+        ProtoJwtSvidResponse response;
+        response.svids.set({svid});
+
+        server->send_headers(id, RESPONSE_HEADERS, false);
+        server->send_data(id, GrpcFraming::pack_message(encode_proto_message(response)), false);
+        server->send_headers(id, {{"grpc-status", "0"}}, true);
+    });
+    server = &http2_server;
+    ASSERT_TRUE(http2_server.start());
+
+    WorkloadApiClient client(http2_server.socket_path());
+    for (const char* audience : {"a", "b"}) {
+        std::vector<JwtSvid> svids;
+        Status status = client.fetch_jwt_svid(svids, {audience});
+        ASSERT_TRUE(status.is_ok()) << status.message;
+        ASSERT_EQ(svids.size(), 1u);
+        EXPECT_EQ(svids[0].spiffe_id, std::string("spiffe://example.org/") + audience);
+        EXPECT_EQ(svids[0].svid, "token");
+    }
+    EXPECT_EQ(path, "/SpiffeWorkloadAPI/FetchJWTSVID");
+
+    // Both calls shared the connection, unless cURL is too old to multiplex
+    EXPECT_EQ(http2_server.connections_accepted(), grpc_multiplex_supported() ? 1u : 2u);
+}
+
+// Updates larger than the initial flow control window, and the client cancelling the stream
+TEST(Http2ServerTest, StreamsUpdatesAndNotifiesClose) {
+    std::string bundle(200000, 'b');
+    std::string trust_domain = "spiffe://example.org";
+    ProtoMapItem item;
+    item.key.set(proto_view(trust_domain));
+    item.value.set(proto_view(bundle));
+    ProtoJwtBundlesResponse response;
+    response.bundles.set({item});
+    Buffer update = GrpcFraming::pack_message(encode_proto_message(response));
+
+    std::atomic<int> closed{0};
+    Http2Server* server = nullptr;
+    Http2Server http2_server(
+        test_socket_path(),
+        [&](Http2Server::StreamId id, const Http2Request&) {
+            server->send_headers(id, RESPONSE_HEADERS, false);
+            server->send_data(id, update, false);
+            server->send_data(id, update, false);
+        },
+        [&](Http2Server::StreamId) { ++closed; });
+    server = &http2_server;
+    ASSERT_TRUE(http2_server.start());
+
+    CancellationSource cancellation;
+    int updates = 0;
+    Status status;
+    {
+        WorkloadApiClient client(http2_server.socket_path());
+        status = client.fetch_jwt_bundles(
+            [&](const JwtBundles& bundles) {
+                EXPECT_EQ(bundles.bundles.size(), 1u);
+                if (++updates == 2) {
+                    cancellation.cancel();
+                }
+                return Status{};
+            },
+            cancellation.token());
+
+        // cURL 8 may only send the RST_STREAM once the connection is driven again or closed
+    }
+
+    EXPECT_EQ(status.code, 1);
+    EXPECT_EQ(updates, 2);
+
+    for (int i = 0; i < 100 && closed.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(closed.load(), 1);
+}
+
+TEST(Http2ServerTest, ErrorTrailers) {
+    Http2Server* server = nullptr;
+    Http2Server http2_server(test_socket_path(), [&](Http2Server::StreamId id, const Http2Request&) {
+        server->send_headers(id,
+                             {{":status", "200"},
+                              {"content-type", "application/grpc"},
+                              {"grpc-status", "7"},
+                              {"grpc-message", "no identity issued"}},
+                             true);
+    });
+    server = &http2_server;
+    ASSERT_TRUE(http2_server.start());
+
+    WorkloadApiClient client(http2_server.socket_path());
+    std::vector<JwtSvid> svids;
+    Status status = client.fetch_jwt_svid(svids, {"a"});
+    EXPECT_EQ(status.code, 7);
+    EXPECT_EQ(status.message, "no identity issued");
+}
+
+}  // namespace mock
+}  // namespace spiffe
@@ -0,0 +1,75 @@
+#include "json.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "jwt.h"
+
+namespace spiffe {
+
+TEST(JsonTest, ParseObject) {
+    JsonValue value;
+    ASSERT_TRUE(parse_json(R"( {"a": 1, "b": [true, false, null], "c": {"d": "e"}, "f": -1.5e2} )", value));
+    ASSERT_TRUE(value.is_object());
+
+    ASSERT_NE(value.find("a"), nullptr);
+    EXPECT_EQ(value.find("a")->number, 1);
+
+    const JsonValue* b = value.find("b");
+    ASSERT_NE(b, nullptr);
+    ASSERT_TRUE(b->is_array());
+    ASSERT_EQ(b->array.size(), 3);
+    EXPECT_TRUE(b->array[0].boolean);
+    EXPECT_TRUE(b->array[2].is_null());
+
+    ASSERT_NE(value.find("c"), nullptr);
+    ASSERT_NE(value.find("c")->find("d"), nullptr);
+    EXPECT_EQ(value.find("c")->find("d")->string, "e");
+
+    EXPECT_EQ(value.find("f")->number, -150);
+    EXPECT_EQ(value.find("missing"), nullptr);
+}
+
+TEST(JsonTest, ParseStringEscapes) {
+    JsonValue value;
+    ASSERT_TRUE(parse_json(R"("a\"b\\c\/\n\u00e9\ud83d\ude00")", value));
+    ASSERT_TRUE(value.is_string());
+    EXPECT_EQ(value.string, "a\"b\\c/\n\xc3\xa9\xf0\x9f\x98\x80");
+}
+
+TEST(JsonTest, RejectMalformed) {
+    JsonValue value;
+    EXPECT_FALSE(parse_json("", value));
+    EXPECT_FALSE(parse_json("{", value));
+    EXPECT_FALSE(parse_json("{\"a\":}", value));
+    EXPECT_FALSE(parse_json("[1,]", value));
+    EXPECT_FALSE(parse_json("01", value));
+    EXPECT_FALSE(parse_json("\"\\ud800\"", value));
+    EXPECT_FALSE(parse_json("{} x", value));
+    EXPECT_FALSE(parse_json(std::string(100, '['), value));
+}
+
+TEST(JwtTest, Base64UrlDecode) {
+    std::string out;
+    ASSERT_TRUE(base64url_decode("aGVsbG8_-w", 10, out));
+    EXPECT_EQ(out, std::string("hello?\xfb", 7));
+    EXPECT_FALSE(base64url_decode("a", 1, out));
+    EXPECT_FALSE(base64url_decode("a+b=", 4, out));
+}
+
+TEST(JwtTest, ReadExpiry) {
+    // {"alg":"none"} . {"sub":"spiffe://example.org/w","exp":4102444800} . sig
+    std::string token = "eyJhbGciOiJub25lIn0.eyJzdWIiOiJzcGlmZmU6Ly9leGFtcGxlLm9yZy93IiwiZXhwIjo0MTAyNDQ0ODAwfQ.c2ln";
+
+    int64_t exp = 0;
+    ASSERT_TRUE(read_jwt_expiry(token, exp));
+    EXPECT_EQ(exp, 4102444800);
+
+    EXPECT_FALSE(read_jwt_expiry("not-a-token", exp));
+    EXPECT_FALSE(read_jwt_expiry("e30.e30.", exp));  // {} has no exp
+    EXPECT_FALSE(read_jwt_expiry("e30.eyJleHAiOjFlMzAwfQ.", exp));  // {"exp":1e300}
+    EXPECT_FALSE(read_jwt_expiry("e30.eyJleHAiOi0xfQ.", exp));      // {"exp":-1}
+}
+
+}  // namespace spiffe
@@ -0,0 +1,236 @@
+#include "jwt_svid_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace spiffe {
+
+static std::string base64url_encode(const std::string& in) {
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    std::string out;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (unsigned char c : in) {
+        acc = (acc << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out.push_back(alphabet[(acc >> bits) & 0x3f]);
+        }
+    }
+    if (bits > 0) {
+        out.push_back(alphabet[(acc << (6 - bits)) & 0x3f]);
+    }
+    return out;
+}
+
+static std::string make_token(int64_t exp) {
+    return base64url_encode("{\"alg\":\"none\"}") + "." + base64url_encode("{\"exp\":" + std::to_string(exp) + "}") +
+           ".c2ln";
+}
+
+static int64_t now_plus(int64_t seconds) {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+               .count() +
+           seconds;
+}
+
+static JwtSvidCacheOptions enabled_options() {
+    JwtSvidCacheOptions options;
+    options.enabled = true;
+    return options;
+}
+
+TEST(JwtSvidCacheTest, KeyIgnoresAudienceOrderAndDuplicates) {
+    EXPECT_EQ(JwtSvidCache::make_key({"b", "a", "b"}, "id"), JwtSvidCache::make_key({"a", "b"}, "id"));
+    EXPECT_NE(JwtSvidCache::make_key({"a", "b"}, "id"), JwtSvidCache::make_key({"a", "b"}, "other"));
+    EXPECT_NE(JwtSvidCache::make_key({"ab"}, ""), JwtSvidCache::make_key({"a", "b"}, ""));
+}
+
+TEST(JwtSvidCacheTest, ServesFreshTokens) {
+    JwtSvidCache cache(enabled_options());
+    int fetches = 0;
+    std::string token = make_token(now_plus(3600));
+
+    auto fetch = [&](std::vector<JwtSvid>& out) {
+        ++fetches;
+        out.push_back(JwtSvid{.spiffe_id = "spiffe://example.org/w", .svid = token});
+        return Status{};
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        std::vector<JwtSvid> out;
+        ASSERT_TRUE(cache.get(out, {"b", "a"}, "", fetch).is_ok());
+        ASSERT_EQ(out.size(), 1);
+        EXPECT_EQ(out[0].svid, token);
+    }
+    EXPECT_EQ(fetches, 1);
+
+    // Different audience set is a different key
+    std::vector<JwtSvid> out;
+    ASSERT_TRUE(cache.get(out, {"c"}, "", fetch).is_ok());
+    EXPECT_EQ(fetches, 2);
+}
+
+TEST(JwtSvidCacheTest, RefreshesAfterFraction) {
+    JwtSvidCache cache(enabled_options());
+    int fetches = 0;
+
+    // With refresh_fraction 0.5 and 1 second of lifetime, the entry is stale after 500ms
+    auto fetch = [&](std::vector<JwtSvid>& out) {
+        ++fetches;
+        out.push_back(JwtSvid{.svid = make_token(now_plus(1))});
+        return Status{};
+    };
+
+    std::vector<JwtSvid> out;
+    ASSERT_TRUE(cache.get(out, {"a"}, "", fetch).is_ok());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    ASSERT_TRUE(cache.get(out, {"a"}, "", fetch).is_ok());
+    EXPECT_EQ(fetches, 2);
+}
+
+TEST(JwtSvidCacheTest, ErrorsAndUnparsableTokensAreNotCached) {
+    JwtSvidCache cache(enabled_options());
+    int fetches = 0;
+
+    auto failing = [&](std::vector<JwtSvid>&) {
+        ++fetches;
+        return Status{.code = 14, .message = "unavailable"};
+    };
+    auto opaque = [&](std::vector<JwtSvid>& out) {
+        ++fetches;
+        out.push_back(JwtSvid{.svid = "opaque"});
+        return Status{};
+    };
+
+    std::vector<JwtSvid> out;
+    EXPECT_EQ(cache.get(out, {"a"}, "", failing).code, 14);
+    EXPECT_EQ(cache.get(out, {"a"}, "", failing).code, 14);
+    EXPECT_TRUE(cache.get(out, {"b"}, "", opaque).is_ok());
+    EXPECT_TRUE(cache.get(out, {"b"}, "", opaque).is_ok());
+    EXPECT_EQ(fetches, 4);
+}
+
+TEST(JwtSvidCacheTest, RefreshErrorsAreReturned) {
+    JwtSvidCacheOptions options = enabled_options();
+    options.refresh_fraction = 0.005;  // stale after half a second of 100
+    JwtSvidCache cache(options);
+
+    std::vector<JwtSvid> out;
+    ASSERT_TRUE(cache.get(out, {"a"}, "", [](std::vector<JwtSvid>& fetched) {
+                         fetched.push_back(JwtSvid{.svid = make_token(now_plus(100))});
+                         return Status{};
+                     })
+                    .is_ok());
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+
+    // The previous tokens are still valid, but the workload is no longer entitled to them
+    out.clear();
+    Status status = cache.get(out, {"a"}, "", [](std::vector<JwtSvid>&) {
+        return Status{.code = 7, .message = "permission denied"};
+    });
+    EXPECT_EQ(status.code, 7);
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(JwtSvidCacheTest, CoalescesConcurrentMisses) {
+    JwtSvidCache cache(enabled_options());
+    std::atomic<int> fetches{0};
+    std::string token = make_token(now_plus(3600));
+
+    auto fetch = [&](std::vector<JwtSvid>& out) {
+        ++fetches;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        out.push_back(JwtSvid{.svid = token});
+        return Status{};
+    };
+
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&] {
+            std::vector<JwtSvid> out;
+            if (cache.get(out, {"a"}, "", fetch).is_ok() && out.size() == 1 && out[0].svid == token) {
+                ++ok;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(fetches.load(), 1);
+    EXPECT_EQ(ok.load(), 16);
+}
+
+TEST(JwtSvidCacheTest, FetchThatThrowsIsNotInFlight) {
+    JwtSvidCache cache(enabled_options());
+    std::string token = make_token(now_plus(3600));
+
+    std::vector<JwtSvid> out;
+    EXPECT_THROW(cache.get(out, {"a"}, "", [](std::vector<JwtSvid>&) -> Status { throw std::runtime_error("fetch"); }),
+                 std::runtime_error);
+
+    // The next call fetches again instead of waiting for the failed one
+    int fetches = 0;
+    Status status = cache.get(out, {"a"}, "", [&](std::vector<JwtSvid>& fetched) {
+        ++fetches;
+        fetched.push_back(JwtSvid{.svid = token});
+        return Status{};
+    });
+    EXPECT_TRUE(status.is_ok());
+    EXPECT_EQ(fetches, 1);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].svid, token);
+}
+
+TEST(JwtSvidCacheTest, GetManyFetchesMissesInOneBatch) {
+    JwtSvidCache cache(enabled_options());
+    std::string token = make_token(now_plus(3600));
+
+    std::vector<JwtSvid> out;
+    ASSERT_TRUE(cache
+                    .get(out, {"cached"}, "",
+                         [&](std::vector<JwtSvid>& fetched) {
+                             fetched.push_back(JwtSvid{.svid = token});
+                             return Status{};
+                         })
+                    .is_ok());
+
+    // "a" repeats with another order, it is fetched once and shared
+    std::vector<JwtSvidRequest> requests = {{{"a", "x"}, ""}, {{"cached"}, ""}, {{"b"}, ""}, {{"x", "a"}, ""}};
+    std::vector<size_t> batch;
+    int batches = 0;
+    std::vector<JwtSvidResult> results;
+    cache.get_many(requests, results,
+                   [&](const std::vector<JwtSvidRequest>& all, const std::vector<size_t>& misses,
+                       std::vector<JwtSvidResult>& fetched) {
+                       ++batches;
+                       batch = misses;
+                       for (size_t i : misses) {
+                           if (all[i].audience[0] == "b") {
+                               fetched[i].status = Status{.code = 14, .message = "unavailable"};
+                           } else {
+                               fetched[i].svids.push_back(JwtSvid{.svid = token});
+                           }
+                       }
+                   });
+
+    EXPECT_EQ(batches, 1);
+    EXPECT_EQ(batch, (std::vector<size_t>{0, 2}));
+    ASSERT_EQ(results.size(), 4u);
+    EXPECT_TRUE(results[0].status.is_ok());
+    EXPECT_EQ(results[0].svids.size(), 1u);
+    EXPECT_EQ(results[1].svids.size(), 1u);
+    EXPECT_EQ(results[2].status.code, 14);
+    EXPECT_TRUE(results[3].status.is_ok());
+    EXPECT_EQ(results[3].svids.size(), 1u);
+}
+
+}  // namespace spiffe
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <spiffe/jwt_validator.h>
+
+#include <chrono>
+#include <string>
+
+#include "testdata/jwt_svids.h"
+
+// Validating an inbound ES256 JWT-SVID: parsing the JWKS on every request, as without a key
+// index, then with pre-parsed keys, then for a token already seen.
+
+namespace spiffe {
+
+namespace {
+
+const std::chrono::system_clock::time_point NOW = std::chrono::system_clock::time_point(std::chrono::seconds(1800000000));
+
+JwtBundles example_org() {
+    JwtBundles bundles;
+    bundles.bundles["spiffe://example.org"] = testdata::JWKS;
+    return bundles;
+}
+
+}  // namespace
+
+static void BM_ValidateJwtSvidParsingJwks(benchmark::State& state) {
+    JwtBundles bundles = example_org();
+    std::string token = testdata::ES256_TOKEN;
+    JwtSvidClaims claims;
+
+    for (auto _ : state) {
+        JwtBundleIndexSet keys(bundles);
+        benchmark::DoNotOptimize(validate_jwt_svid(token, "ingress", keys, claims, NOW).code);
+    }
+}
+BENCHMARK(BM_ValidateJwtSvidParsingJwks);
+
+static void BM_ValidateJwtSvid(benchmark::State& state) {
+    JwtBundleIndexSet keys(example_org());
+    std::string token = testdata::ES256_TOKEN;
+    JwtSvidClaims claims;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validate_jwt_svid(token, "ingress", keys, claims, NOW).code);
+    }
+}
+BENCHMARK(BM_ValidateJwtSvid);
+
+static void BM_ValidateJwtSvidCached(benchmark::State& state) {
+    static JwtSvidValidator validator;
+    if (state.thread_index() == 0) {
+        validator.update(example_org());
+    }
+    std::string token = testdata::ES256_TOKEN;
+    JwtSvidClaims claims;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validator.validate(token, "ingress", claims, NOW).code);
+    }
+}
+BENCHMARK(BM_ValidateJwtSvidCached)->ThreadRange(1, 8);
+
+}  // namespace spiffe
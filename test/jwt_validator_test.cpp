@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <spiffe/jwt_validator.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "testdata/jwt_svids.h"
+
+namespace spiffe {
+
+namespace {
+
+// 2027-01-15, before the "exp" of every test token
+const std::chrono::system_clock::time_point NOW = std::chrono::system_clock::time_point(std::chrono::seconds(1800000000));
+const std::chrono::system_clock::time_point EXPIRED =
+    std::chrono::system_clock::time_point(std::chrono::seconds(1900000000));
+
+JwtBundles example_org(const std::string& jwks) {
+    JwtBundles bundles;
+    bundles.bundles["spiffe://example.org"] = jwks;
+    return bundles;
+}
+
+// Copy of token with one character of its signature replaced
+std::string tampered(const std::string& token) {
+    std::string copy = token;
+    char& c = copy[copy.size() - 10];
+    c = c == 'A' ? 'B' : 'A';
+    return copy;
+}
+
+}  // namespace
+
+TEST(JwtBundleIndexTest, ParsesJwks) {
+    JwtKeySet keys(testdata::JWKS);
+    ASSERT_TRUE(keys.valid());
+    EXPECT_EQ(keys.size(), 2u);
+    EXPECT_NE(keys.find("ec-key"), nullptr);
+    EXPECT_NE(keys.find("rsa-key"), nullptr);
+    EXPECT_EQ(keys.find("x509"), nullptr);  // "use": "x509-svid"
+
+    // Unusable keys are skipped
+    JwtKeySet partial(R"({"keys":[{"kty":"EC","kid":"a","crv":"P-256","x":"AAAA","y":"AAAA"},{"kty":"oct","kid":"b"}]})");
+    EXPECT_TRUE(partial.valid());
+    EXPECT_EQ(partial.size(), 0u);
+
+    EXPECT_FALSE(JwtKeySet("{").valid());
+    EXPECT_FALSE(JwtKeySet("{\"keys\":{}}").valid());
+    EXPECT_NE(JwtKeySet("{\"keys\":[]}").id(), JwtKeySet("{\"keys\":[]}").id());
+}
+
+TEST(JwtBundleIndexTest, SetReusesUnchangedKeySets) {
+    JwtBundles bundles = example_org(testdata::JWKS);
+    bundles.bundles["spiffe://other.org"] = testdata::JWKS;
+    JwtBundleIndexSet first(bundles);
+
+    bundles.bundles["spiffe://other.org"] = "{\"keys\":[]}";
+    JwtBundleIndexSet second(bundles, &first);
+    EXPECT_EQ(second.size(), 2u);
+    EXPECT_EQ(second.get("spiffe://example.org"), first.get("spiffe://example.org"));
+    EXPECT_NE(second.get("spiffe://other.org"), first.get("spiffe://other.org"));
+    EXPECT_EQ(second.get("spiffe://missing.org"), nullptr);
+}
+
+TEST(JwtValidatorTest, ValidatesTokens) {
+    JwtBundleIndexSet bundles(example_org(testdata::JWKS));
+    JwtSvidClaims claims;
+
+    ASSERT_TRUE(validate_jwt_svid(testdata::ES256_TOKEN, "other", bundles, claims, NOW).is_ok());
+    EXPECT_EQ(claims.spiffe_id, "spiffe://example.org/workload");
+    EXPECT_EQ(claims.audience, (std::vector<std::string>{"ingress", "other"}));
+    EXPECT_EQ(claims.expiry, 1900000000);
+
+    for (const char* token : {testdata::RS256_TOKEN, testdata::PS256_TOKEN}) {
+        JwtSvidClaims rsa_claims;
+        EXPECT_TRUE(validate_jwt_svid(token, "ingress", bundles, rsa_claims, NOW).is_ok()) << token;
+        EXPECT_EQ(rsa_claims.audience, std::vector<std::string>{"ingress"});
+    }
+}
+
+TEST(JwtValidatorTest, RejectsInvalidTokens) {
+    JwtBundleIndexSet bundles(example_org(testdata::JWKS));
+    JwtSvidClaims claims;
+    auto code = [&](const std::string& token, const std::string& audience,
+                    std::chrono::system_clock::time_point now = NOW) {
+        return validate_jwt_svid(token, audience, bundles, claims, now).code;
+    };
+
+    EXPECT_EQ(code(testdata::ES256_TOKEN, "unknown"), 16);
+    EXPECT_EQ(code(testdata::ES256_TOKEN, "ingress", EXPIRED), 16);
+    EXPECT_EQ(code(tampered(testdata::ES256_TOKEN), "ingress"), 16);
+    EXPECT_EQ(code(tampered(testdata::PS256_TOKEN), "ingress"), 16);
+    EXPECT_EQ(code(testdata::X509_KEY_TOKEN, "ingress"), 16);
+    EXPECT_EQ(code(testdata::HTTPS_SUB_TOKEN, "ingress"), 16);
+    EXPECT_EQ(code(testdata::NO_EXP_TOKEN, "ingress"), 16);
+
+    // The header of one token on the signature of another
+    std::string es256 = testdata::ES256_TOKEN, rs256 = testdata::RS256_TOKEN;
+    EXPECT_EQ(code(rs256.substr(0, rs256.find('.')) + es256.substr(es256.find('.')), "ingress"), 16);
+
+    // Unsigned
+    EXPECT_EQ(code("eyJhbGciOiJub25lIiwia2lkIjoiZWMta2V5In0" + es256.substr(es256.find('.'), es256.rfind('.') -
+                                                                                               es256.find('.') + 1),
+                   "ingress"),
+              16);
+
+    JwtBundleIndexSet other;
+    EXPECT_EQ(validate_jwt_svid(testdata::ES256_TOKEN, "ingress", other, claims, NOW).code, 16);
+
+    EXPECT_EQ(code("", "ingress"), 3);
+    EXPECT_EQ(code("a.b", "ingress"), 3);
+    EXPECT_EQ(code(es256 + ".", "ingress"), 3);
+    EXPECT_EQ(code("e30.e30.!!", "ingress"), 3);
+
+    EXPECT_TRUE(claims.spiffe_id.empty());
+}
+
+TEST(JwtValidatorTest, CachesVerifiedTokens) {
+    JwtSvidValidator validator(JwtSvidValidatorOptions{.max_entries = 4, .shards = 1});
+    JwtSvidClaims claims;
+
+    // No bundles yet
+    EXPECT_EQ(validator.validate(testdata::ES256_TOKEN, "ingress", claims, NOW).code, 16);
+    EXPECT_EQ(validator.size(), 0u);
+
+    validator.update(example_org(testdata::JWKS));
+    EXPECT_TRUE(validator.validate(testdata::ES256_TOKEN, "ingress", claims, NOW).is_ok());
+    EXPECT_TRUE(validator.validate(testdata::ES256_TOKEN, "other", claims, NOW).is_ok());
+    EXPECT_EQ(claims.spiffe_id, "spiffe://example.org/workload");
+    EXPECT_EQ(validator.size(), 1u);
+
+    // Served from the cache, still checked for audience and expiry
+    EXPECT_EQ(validator.validate(testdata::ES256_TOKEN, "unknown", claims, NOW).code, 16);
+    EXPECT_EQ(validator.validate(testdata::ES256_TOKEN, "ingress", claims, EXPIRED).code, 16);
+
+    // Failures are not cached
+    EXPECT_EQ(validator.validate(tampered(testdata::RS256_TOKEN), "ingress", claims, NOW).code, 16);
+    EXPECT_EQ(validator.size(), 1u);
+
+    // The same JWKS again keeps the key set, and the cached tokens with it
+    const JwtKeySet* keys = validator.bundles()->get("spiffe://example.org");
+    uint64_t id = keys->id();
+    validator.update(example_org(testdata::JWKS));
+    EXPECT_EQ(validator.bundles()->get("spiffe://example.org")->id(), id);
+
+    // Rotated keys invalidate
+    std::string rsa_only = testdata::JWKS;
+    rsa_only.replace(rsa_only.find("\"ec-key\""), 8, "\"rotated\"");
+    validator.update(example_org(rsa_only));
+    EXPECT_EQ(validator.validate(testdata::ES256_TOKEN, "ingress", claims, NOW).code, 16);
+    EXPECT_TRUE(validator.validate(testdata::RS256_TOKEN, "ingress", claims, NOW).is_ok());
+
+    // Bounded
+    for (const char* token : {testdata::PS256_TOKEN, testdata::ES256_TOKEN}) {
+        validator.validate(token, "ingress", claims, NOW);
+    }
+    validator.update(example_org(testdata::JWKS));
+    for (const char* token : {testdata::PS256_TOKEN, testdata::ES256_TOKEN, testdata::RS256_TOKEN}) {
+        EXPECT_TRUE(validator.validate(token, "ingress", claims, NOW).is_ok());
+    }
+    EXPECT_LE(validator.size(), 4u);
+}
+
+}  // namespace spiffe
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <spiffe/metrics.h>
+#include <spiffe/spiffe.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mock/workload_api_server.h"
+
+namespace spiffe {
+
+namespace {
+
+std::string test_socket_path() { return "/tmp/spiffe-cpp-metrics-" + std::to_string(getpid()) + ".sock"; }
+
+}  // namespace
+
+TEST(HistogramTest, BucketsAreMonotonic) {
+    size_t previous = 0;
+    for (uint64_t ns = 0; ns < 100000; ++ns) {
+        size_t bucket = HistogramSnapshot::bucket_of(ns);
+        ASSERT_GE(bucket, previous);
+        ASSERT_LE(ns, HistogramSnapshot::bucket_upper_bound(bucket));
+        previous = bucket;
+    }
+    EXPECT_EQ(HistogramSnapshot::bucket_of(UINT64_MAX), HistogramSnapshot::BUCKETS - 1);
+}
+
+TEST(HistogramTest, PercentileWithin25Percent) {
+    AtomicMetrics metrics;
+    for (int i = 1; i <= 100; ++i) {
+        metrics.on_callback(RpcMethod::X509Svid, std::chrono::microseconds(i));
+    }
+
+    const HistogramSnapshot& callback = metrics.snapshot()[RpcMethod::X509Svid].callback;
+    EXPECT_EQ(callback.count, 100u);
+    EXPECT_EQ(callback.max, std::chrono::microseconds(100));
+    EXPECT_EQ(callback.sum, std::chrono::microseconds(5050));
+
+    std::chrono::nanoseconds p50 = callback.percentile(0.5);
+    EXPECT_GE(p50, std::chrono::microseconds(50));
+    EXPECT_LE(p50, std::chrono::microseconds(63));
+    EXPECT_EQ(callback.percentile(1.0), std::chrono::microseconds(100));
+    EXPECT_EQ(HistogramSnapshot().percentile(0.5), std::chrono::nanoseconds(0));
+}
+
+TEST(AtomicMetricsTest, CountsStatusCodes) {
+    AtomicMetrics metrics;
+    metrics.on_rpc_done(RpcMethod::JwtSvid, 0, std::chrono::milliseconds(1));
+    metrics.on_rpc_done(RpcMethod::JwtSvid, 14, std::chrono::milliseconds(1));
+    metrics.on_rpc_done(RpcMethod::JwtSvid, 99, std::chrono::milliseconds(1));
+
+    MetricsSnapshot snapshot = metrics.snapshot();
+    const RpcMetricsSnapshot& jwt_svid = snapshot[RpcMethod::JwtSvid];
+    EXPECT_EQ(jwt_svid.latency.count, 3u);
+    EXPECT_EQ(jwt_svid.status_codes[0], 1u);
+    EXPECT_EQ(jwt_svid.status_codes[14], 1u);
+    EXPECT_EQ(jwt_svid.status_codes[2], 1u);  // out of range, UNKNOWN
+    EXPECT_EQ(snapshot[RpcMethod::X509Svid].latency.count, 0u);
+}
+
+TEST(AtomicMetricsTest, RecordsWorkloadApiCalls) {
+    mock::WorkloadApiServerOptions options;
+    options.data_frame_size = 100;  // messages may span several chunks
+    mock::WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    auto metrics = std::make_shared<AtomicMetrics>();
+    ClientOptions client_options;
+    client_options.metrics = metrics;
+    WorkloadApiClient client(server.socket_path(), client_options);
+
+    CancellationSource cancellation;
+    int updates = 0;
+    Status status = client.fetch_x509_svid(
+        [&](const X509SvidContext&) {
+            if (++updates == 2) {
+                cancellation.cancel();
+            } else {
+                server.push_update();
+            }
+            return Status{};
+        },
+        cancellation.token());
+    EXPECT_EQ(updates, 2);
+    EXPECT_EQ(status.code, 1);  // CANCELLED
+
+    std::vector<JwtSvid> svids;
+    ASSERT_TRUE(client.fetch_jwt_svid(svids, {"audience"}).is_ok());
+
+    MetricsSnapshot snapshot = metrics->snapshot();
+    const RpcMetricsSnapshot& x509_svid = snapshot[RpcMethod::X509Svid];
+    EXPECT_EQ(x509_svid.first_update.count, 1u);
+    EXPECT_EQ(x509_svid.callback.count, 2u);
+    EXPECT_EQ(x509_svid.proto_decode.count, 2u);
+    EXPECT_EQ(x509_svid.der_split.count, 2u);
+    EXPECT_EQ(x509_svid.messages, 2u);
+    EXPECT_LE(x509_svid.messages_reassembled, x509_svid.messages);  // depends on how cURL buffers
+    EXPECT_GT(x509_svid.bytes_received, 2u * 1024);
+    EXPECT_EQ(x509_svid.status_codes[1], 1u);
+    EXPECT_EQ(x509_svid.stream_restarts, 0u);
+
+    const RpcMetricsSnapshot& jwt_svid = snapshot[RpcMethod::JwtSvid];
+    EXPECT_EQ(jwt_svid.latency.count, 1u);
+    EXPECT_EQ(jwt_svid.status_codes[0], 1u);
+    EXPECT_EQ(jwt_svid.messages, 1u);
+    EXPECT_EQ(jwt_svid.proto_decode.count, 1u);
+}
+
+TEST(AtomicMetricsTest, CountsStreamRestarts) {
+    mock::WorkloadApiServerOptions options;
+    options.error_code = 14;  // UNAVAILABLE
+    mock::WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    auto metrics = std::make_shared<AtomicMetrics>();
+    ClientOptions client_options;
+    client_options.metrics = metrics;
+    WorkloadApiClient client(server.socket_path(), client_options);
+
+    for (int i = 0; i < 3; ++i) {
+        Status status = client.fetch_jwt_bundles([](const JwtBundles&) { return Status{}; }, CancellationToken());
+        EXPECT_EQ(status.code, 14);
+    }
+
+    const RpcMetricsSnapshot& jwt_bundles = metrics->snapshot()[RpcMethod::JwtBundles];
+    EXPECT_EQ(jwt_bundles.stream_restarts, 2u);
+    EXPECT_EQ(jwt_bundles.status_codes[14], 3u);
+    EXPECT_EQ(jwt_bundles.first_update.count, 0u);
+}
+
+}  // namespace spiffe
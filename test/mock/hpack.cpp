@@ -0,0 +1,369 @@
+#include "hpack.h"
+
+#include <array>
+
+namespace spiffe {
+namespace mock {
+
+namespace {
+
+const std::array<std::pair<const char*, const char*>, 61> STATIC_TABLE = {{
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+}};
+
+// Huffman code and bit length of each symbol, 256 is EOS (RFC 7541 Appendix B)
+struct HuffmanCode {
+    uint32_t code;
+    uint8_t bits;
+};
+
+const HuffmanCode HUFFMAN_CODES[257] = {
+    {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28},
+    {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+    {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+    {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+    {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+    {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+    {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28},
+    {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+    {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+    {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11},
+    {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11},
+    {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+    {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6},
+    {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
+    {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8},
+    {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+    {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7},
+    {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+    {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7},
+    {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+    {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+    {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7},
+    {0xfc, 8}, {0x73, 7}, {0xfd, 8}, {0x1ffb, 13},
+    {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+    {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5},
+    {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6},
+    {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7},
+    {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5},
+    {0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5},
+    {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+    {0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15},
+    {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+    {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20},
+    {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23},
+    {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23},
+    {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+    {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23},
+    {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23},
+    {0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23},
+    {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24},
+    {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22},
+    {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+    {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24},
+    {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23},
+    {0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21},
+    {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23},
+    {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22},
+    {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+    {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19},
+    {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25},
+    {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27},
+    {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25},
+    {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27},
+    {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+    {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26},
+    {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27},
+    {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21},
+    {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23},
+    {0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25},
+    {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+    {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26},
+    {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+    {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
+    {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+    {0x3fffffff, 30},
+};
+
+// Binary decoding tree of HUFFMAN_CODES, leaves hold the symbol
+struct HuffmanTree {
+    struct Node {
+        int children[2] = {-1, -1};
+        int symbol = -1;
+    };
+    std::vector<Node> nodes;
+
+    HuffmanTree() : nodes(1) {
+        for (int symbol = 0; symbol < 257; ++symbol) {
+            int node = 0;
+            for (int bit = HUFFMAN_CODES[symbol].bits - 1; bit >= 0; --bit) {
+                int branch = (HUFFMAN_CODES[symbol].code >> bit) & 1;
+                if (nodes[node].children[branch] < 0) {
+                    nodes[node].children[branch] = static_cast<int>(nodes.size());
+                    nodes.emplace_back();
+                }
+                node = nodes[node].children[branch];
+            }
+            nodes[node].symbol = symbol;
+        }
+    }
+};
+
+const size_t ENTRY_OVERHEAD = 32;
+const size_t SETTINGS_HEADER_TABLE_SIZE = 4096;
+
+bool decode_integer(const uint8_t*& p, const uint8_t* end, int prefix_bits, uint64_t& value) {
+    if (p == end) {
+        return false;
+    }
+
+    uint64_t mask = (1u << prefix_bits) - 1;
+    value = *p++ & mask;
+    if (value < mask) {
+        return true;
+    }
+
+    for (int shift = 0; shift < 56; shift += 7) {
+        if (p == end) {
+            return false;
+        }
+        uint8_t byte = *p++;
+        value += static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool decode_string(const uint8_t*& p, const uint8_t* end, std::string& out) {
+    if (p == end) {
+        return false;
+    }
+
+    bool huffman = (*p & 0x80) != 0;
+    uint64_t length = 0;
+    if (!decode_integer(p, end, 7, length) || length > static_cast<uint64_t>(end - p)) {
+        return false;
+    }
+
+    const uint8_t* data = p;
+    p += length;
+    if (huffman) {
+        out.clear();
+        return huffman_decode(data, static_cast<size_t>(length), out);
+    }
+    out.assign(reinterpret_cast<const char*>(data), static_cast<size_t>(length));
+    return true;
+}
+
+void encode_integer(uint8_t first, int prefix_bits, uint64_t value, std::vector<uint8_t>& out) {
+    uint64_t mask = (1u << prefix_bits) - 1;
+    if (value < mask) {
+        out.push_back(static_cast<uint8_t>(first | value));
+        return;
+    }
+
+    out.push_back(static_cast<uint8_t>(first | mask));
+    value -= mask;
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void encode_string(const std::string& value, std::vector<uint8_t>& out) {
+    encode_integer(0, 7, value.size(), out);
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+}  // namespace
+
+bool huffman_decode(const uint8_t* data, size_t size, std::string& out) {
+    static const HuffmanTree tree;
+
+    int node = 0;
+    int pending_bits = 0;  // bits read since the last symbol
+    bool all_ones = true;
+    for (size_t i = 0; i < size; ++i) {
+        for (int bit = 7; bit >= 0; --bit) {
+            int branch = (data[i] >> bit) & 1;
+            node = tree.nodes[node].children[branch];
+            if (node < 0) {
+                return false;
+            }
+            ++pending_bits;
+            all_ones = all_ones && branch == 1;
+
+            int symbol = tree.nodes[node].symbol;
+            if (symbol == 256) {
+                return false;  // EOS must not appear in the string
+            }
+            if (symbol >= 0) {
+                out.push_back(static_cast<char>(symbol));
+                node = 0;
+                pending_bits = 0;
+                all_ones = true;
+            }
+        }
+    }
+
+    // Padding is a prefix of EOS, all ones and shorter than a byte
+    return pending_bits < 8 && all_ones;
+}
+
+bool HpackDecoder::lookup(uint64_t index, std::pair<std::string, std::string>& field) const {
+    if (index == 0) {
+        return false;
+    }
+    if (index <= STATIC_TABLE.size()) {
+        field.first = STATIC_TABLE[index - 1].first;
+        field.second = STATIC_TABLE[index - 1].second;
+        return true;
+    }
+
+    index -= STATIC_TABLE.size() + 1;
+    if (index >= table_.size()) {
+        return false;
+    }
+    field = table_[index];
+    return true;
+}
+
+void HpackDecoder::insert(const std::pair<std::string, std::string>& field) {
+    table_.push_front(field);
+    table_size_ += field.first.size() + field.second.size() + ENTRY_OVERHEAD;
+    evict();
+}
+
+void HpackDecoder::evict() {
+    while (table_size_ > max_table_size_ && !table_.empty()) {
+        table_size_ -= table_.back().first.size() + table_.back().second.size() + ENTRY_OVERHEAD;
+        table_.pop_back();
+    }
+}
+
+bool HpackDecoder::decode(const uint8_t* data, size_t size, HeaderList& headers) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+
+    while (p < end) {
+        uint8_t first = *p;
+        uint64_t index = 0;
+        std::pair<std::string, std::string> field;
+
+        if (first & 0x80) {
+            // Indexed header field
+            if (!decode_integer(p, end, 7, index) || !lookup(index, field)) {
+                return false;
+            }
+            headers.push_back(std::move(field));
+            continue;
+        }
+
+        if ((first & 0xe0) == 0x20) {
+            // Dynamic table size update, bounded by the default SETTINGS_HEADER_TABLE_SIZE
+            if (!decode_integer(p, end, 5, index) || index > SETTINGS_HEADER_TABLE_SIZE) {
+                return false;
+            }
+            max_table_size_ = static_cast<size_t>(index);
+            evict();
+            continue;
+        }
+
+        // Literal header field, with incremental indexing or without (never) indexing
+        bool indexing = (first & 0xc0) == 0x40;
+        if (!decode_integer(p, end, indexing ? 6 : 4, index)) {
+            return false;
+        }
+        if (index > 0) {
+            if (!lookup(index, field)) {
+                return false;
+            }
+        } else if (!decode_string(p, end, field.first)) {
+            return false;
+        }
+        if (!decode_string(p, end, field.second)) {
+            return false;
+        }
+
+        if (indexing) {
+            insert(field);
+        }
+        headers.push_back(std::move(field));
+    }
+
+    return true;
+}
+
+void hpack_encode(const HeaderList& headers, std::vector<uint8_t>& out) {
+    for (const auto& field : headers) {
+        out.push_back(0x00);  // literal without indexing, new name
+        encode_string(field.first, out);
+        encode_string(field.second, out);
+    }
+}
+
+}  // namespace mock
+}  // namespace spiffe
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spiffe {
+namespace mock {
+
+using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+// HPACK (RFC 7541) decoder for the header blocks of one connection, keeps its dynamic table
+class HpackDecoder {
+   public:
+    // Appends the fields of a complete header block to headers.
+    // Returns false if the block is malformed, the connection is unusable after that.
+    bool decode(const uint8_t* data, size_t size, HeaderList& headers);
+
+   private:
+    std::deque<std::pair<std::string, std::string>> table_;  // most recent first
+    size_t table_size_ = 0;
+    size_t max_table_size_ = 4096;
+
+    bool lookup(uint64_t index, std::pair<std::string, std::string>& field) const;
+    void insert(const std::pair<std::string, std::string>& field);
+    void evict();
+};
+
+// Encodes a header block with literals that are never indexed nor Huffman coded, so the
+// encoder keeps no state
+void hpack_encode(const HeaderList& headers, std::vector<uint8_t>& out);
+
+// Decodes a Huffman coded string literal, false on invalid codes or padding
+bool huffman_decode(const uint8_t* data, size_t size, std::string& out);
+
+}  // namespace mock
+}  // namespace spiffe
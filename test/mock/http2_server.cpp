@@ -0,0 +1,701 @@
+#include "http2_server.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+namespace spiffe {
+namespace mock {
+
+namespace {
+
+const char CLIENT_PREFACE[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+const size_t CLIENT_PREFACE_LEN = sizeof(CLIENT_PREFACE) - 1;
+
+const size_t FRAME_HEADER_LEN = 9;
+const size_t MAX_FRAME_SIZE = 16384;  // initial SETTINGS_MAX_FRAME_SIZE of both sides
+const int64_t DEFAULT_WINDOW_SIZE = 65535;
+
+const uint8_t FRAME_DATA = 0x0;
+const uint8_t FRAME_HEADERS = 0x1;
+const uint8_t FRAME_RST_STREAM = 0x3;
+const uint8_t FRAME_SETTINGS = 0x4;
+const uint8_t FRAME_PING = 0x6;
+const uint8_t FRAME_GOAWAY = 0x7;
+const uint8_t FRAME_WINDOW_UPDATE = 0x8;
+const uint8_t FRAME_CONTINUATION = 0x9;
+
+const uint8_t FLAG_END_STREAM = 0x1;
+const uint8_t FLAG_ACK = 0x1;
+const uint8_t FLAG_END_HEADERS = 0x4;
+const uint8_t FLAG_PADDED = 0x8;
+const uint8_t FLAG_PRIORITY = 0x20;
+
+const uint16_t SETTINGS_INITIAL_WINDOW_SIZE = 0x4;
+
+uint32_t read_u32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+void write_frame(Buffer& out, uint8_t type, uint8_t flags, uint32_t stream_id, const uint8_t* payload,
+                 size_t length) {
+    uint8_t header[FRAME_HEADER_LEN] = {
+        static_cast<uint8_t>(length >> 16),    static_cast<uint8_t>(length >> 8),
+        static_cast<uint8_t>(length),          type,
+        flags,                                 static_cast<uint8_t>((stream_id >> 24) & 0x7f),
+        static_cast<uint8_t>(stream_id >> 16), static_cast<uint8_t>(stream_id >> 8),
+        static_cast<uint8_t>(stream_id),
+    };
+    out.insert(out.end(), header, header + FRAME_HEADER_LEN);
+    out.insert(out.end(), payload, payload + length);
+}
+
+void write_window_update(Buffer& out, uint32_t stream_id, uint32_t increment) {
+    uint8_t payload[4] = {
+        static_cast<uint8_t>((increment >> 24) & 0x7f),
+        static_cast<uint8_t>(increment >> 16),
+        static_cast<uint8_t>(increment >> 8),
+        static_cast<uint8_t>(increment),
+    };
+    write_frame(out, FRAME_WINDOW_UPDATE, 0, stream_id, payload, sizeof(payload));
+}
+
+// Strips the padding of a DATA or HEADERS payload, false if it is longer than the payload
+bool strip_padding(uint8_t flags, const uint8_t*& payload, size_t& length) {
+    if (!(flags & FLAG_PADDED)) {
+        return true;
+    }
+    if (length < 1 || payload[0] >= length) {
+        return false;
+    }
+    length -= 1 + payload[0];
+    payload += 1;
+    return true;
+}
+
+}  // namespace
+
+struct Http2Server::Stream {
+    uint32_t id = 0;
+    Http2Request request;
+    bool request_done = false;
+    bool local_closed = false;  // END_STREAM queued, nothing more is accepted
+    bool end_sent = false;      // END_STREAM written
+    int64_t send_window = DEFAULT_WINDOW_SIZE;
+
+    // HEADERS and DATA in send order
+    struct Output {
+        bool headers = false;
+        Buffer bytes;
+        size_t offset = 0;
+        bool end_stream = false;
+    };
+    std::deque<Output> output;
+};
+
+struct Http2Server::Connection {
+    uint32_t id = 0;
+    int fd = -1;
+
+    Buffer in;
+    bool preface_received = false;
+    Buffer out;
+    size_t out_offset = 0;
+
+    HpackDecoder decoder;
+    uint32_t header_stream = 0;  // stream of a header block awaiting CONTINUATION
+    Buffer header_block;
+    bool header_end_stream = false;
+
+    int64_t send_window = DEFAULT_WINDOW_SIZE;
+    int64_t initial_window = DEFAULT_WINDOW_SIZE;
+    std::map<uint32_t, Stream> streams;
+
+    ~Connection() {
+        if (fd >= 0) close(fd);
+    }
+};
+
+Http2Server::Http2Server(const std::string& socket_path, RequestHandler on_request, CloseHandler on_close)
+    : socket_path_(socket_path), on_request_(std::move(on_request)), on_close_(std::move(on_close)) {}
+
+Http2Server::~Http2Server() { stop(); }
+
+bool Http2Server::start() {
+    if (running_) {
+        return true;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(socket_path_.c_str());
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, 64) != 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&Http2Server::run, this);
+    return true;
+}
+
+void Http2Server::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    wake();
+    thread_.join();
+
+    // Server is going away, handlers are not told about the streams
+    connections_.clear();
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        tasks_.clear();
+    }
+
+    close(listen_fd_);
+    close(wake_fd_);
+    listen_fd_ = -1;
+    wake_fd_ = -1;
+    unlink(socket_path_.c_str());
+}
+
+void Http2Server::wake() {
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd_, &one, sizeof(one));
+    (void)written;
+}
+
+void Http2Server::post(std::function<void()> task, std::chrono::milliseconds delay) {
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        tasks_.emplace(std::chrono::steady_clock::now() + delay, std::move(task));
+    }
+    wake();
+}
+
+int Http2Server::next_timeout_ms() {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    if (tasks_.empty()) {
+        return -1;
+    }
+
+    auto remaining = tasks_.begin()->first - std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count();
+    return static_cast<int>(std::max<long long>(ms + 1, 0));
+}
+
+void Http2Server::run_due_tasks() {
+    std::vector<std::function<void()>> due;
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        auto end = tasks_.upper_bound(now);
+        for (auto it = tasks_.begin(); it != end; ++it) {
+            due.push_back(std::move(it->second));
+        }
+        tasks_.erase(tasks_.begin(), end);
+    }
+
+    for (auto& task : due) {
+        task();
+    }
+}
+
+void Http2Server::run() {
+    while (running_) {
+        std::vector<pollfd> fds;
+        fds.push_back(pollfd{wake_fd_, POLLIN, 0});
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        for (const auto& entry : connections_) {
+            const Connection& connection = *entry.second;
+            short events = POLLIN;
+            if (connection.out_offset < connection.out.size()) events |= POLLOUT;
+            fds.push_back(pollfd{connection.fd, events, 0});
+        }
+
+        poll(fds.data(), fds.size(), next_timeout_ms());
+        if (!running_) {
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            uint64_t count = 0;
+            ssize_t n = read(wake_fd_, &count, sizeof(count));
+            (void)n;
+        }
+        if (fds[1].revents & POLLIN) {
+            accept_connections();
+        }
+
+        std::vector<uint32_t> closed;
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            for (auto& entry : connections_) {
+                if (entry.second->fd == fds[i].fd) {
+                    if (!read_connection(*entry.second)) {
+                        closed.push_back(entry.first);
+                    }
+                    break;
+                }
+            }
+        }
+
+        run_due_tasks();
+
+        for (auto& entry : connections_) {
+            flush_streams(*entry.second);
+            if (!write_connection(*entry.second)) {
+                closed.push_back(entry.first);
+            }
+        }
+
+        std::sort(closed.begin(), closed.end());
+        closed.erase(std::unique(closed.begin(), closed.end()), closed.end());
+        for (uint32_t id : closed) {
+            close_connection(id);
+        }
+    }
+}
+
+void Http2Server::accept_connections() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        std::unique_ptr<Connection> connection(new Connection);
+        connection->id = next_connection_id_++;
+        connection->fd = fd;
+
+        // Server preface, default settings
+        write_frame(connection->out, FRAME_SETTINGS, 0, 0, nullptr, 0);
+
+        connections_.emplace(connection->id, std::move(connection));
+        connections_accepted_.fetch_add(1);
+    }
+}
+
+void Http2Server::close_connection(uint32_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) {
+        return;
+    }
+
+    std::unique_ptr<Connection> connection = std::move(it->second);
+    connections_.erase(it);
+
+    if (on_close_) {
+        for (const auto& entry : connection->streams) {
+            if (!entry.second.end_sent) {
+                on_close_((static_cast<StreamId>(connection->id) << 32) | entry.first);
+            }
+        }
+    }
+}
+
+bool Http2Server::read_connection(Connection& connection) {
+    uint8_t chunk[65536];
+    while (true) {
+        ssize_t n = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            connection.in.insert(connection.in.end(), chunk, chunk + n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return false;  // closed by the client or failed
+    }
+
+    return process_frames(connection);
+}
+
+bool Http2Server::process_frames(Connection& connection) {
+    size_t pos = 0;
+    if (!connection.preface_received) {
+        if (connection.in.size() < CLIENT_PREFACE_LEN) {
+            return true;
+        }
+        if (std::memcmp(connection.in.data(), CLIENT_PREFACE, CLIENT_PREFACE_LEN) != 0) {
+            return false;
+        }
+        connection.preface_received = true;
+        pos = CLIENT_PREFACE_LEN;
+    }
+
+    while (connection.in.size() - pos >= FRAME_HEADER_LEN) {
+        const uint8_t* header = connection.in.data() + pos;
+        size_t length = (static_cast<size_t>(header[0]) << 16) | (static_cast<size_t>(header[1]) << 8) | header[2];
+        if (length > MAX_FRAME_SIZE) {
+            return false;
+        }
+        if (connection.in.size() - pos - FRAME_HEADER_LEN < length) {
+            break;
+        }
+
+        uint32_t stream_id = read_u32(header + 5) & 0x7fffffff;
+        if (!process_frame(connection, header[3], header[4], stream_id, header + FRAME_HEADER_LEN, length)) {
+            return false;
+        }
+        pos += FRAME_HEADER_LEN + length;
+    }
+
+    connection.in.erase(connection.in.begin(), connection.in.begin() + pos);
+    return true;
+}
+
+bool Http2Server::process_frame(Connection& connection, uint8_t type, uint8_t flags, uint32_t stream_id,
+                                const uint8_t* payload, size_t length) {
+    // A header block must be continued right away by the same stream
+    if (connection.header_stream != 0 && (type != FRAME_CONTINUATION || stream_id != connection.header_stream)) {
+        return false;
+    }
+
+    switch (type) {
+        case FRAME_DATA: {
+            if (stream_id == 0) {
+                return false;
+            }
+
+            // Give the credit back right away, requests are consumed as they arrive
+            if (length > 0) {
+                write_window_update(connection.out, 0, static_cast<uint32_t>(length));
+            }
+
+            size_t frame_length = length;
+            if (!strip_padding(flags, payload, length)) {
+                return false;
+            }
+
+            auto it = connection.streams.find(stream_id);
+            if (it == connection.streams.end() || it->second.request_done) {
+                return true;
+            }
+            if (frame_length > 0 && !(flags & FLAG_END_STREAM)) {
+                write_window_update(connection.out, stream_id, static_cast<uint32_t>(frame_length));
+            }
+
+            Buffer& body = it->second.request.body;
+            body.insert(body.end(), payload, payload + length);
+            if (flags & FLAG_END_STREAM) {
+                request_complete(connection, it->second);
+            }
+            return true;
+        }
+
+        case FRAME_HEADERS: {
+            if (stream_id == 0 || !strip_padding(flags, payload, length)) {
+                return false;
+            }
+            if (flags & FLAG_PRIORITY) {
+                if (length < 5) {
+                    return false;
+                }
+                payload += 5;
+                length -= 5;
+            }
+
+            connection.header_block.assign(payload, payload + length);
+            connection.header_end_stream = (flags & FLAG_END_STREAM) != 0;
+            connection.header_stream = stream_id;
+            if (flags & FLAG_END_HEADERS) {
+                return process_headers(connection, stream_id, connection.header_end_stream);
+            }
+            return true;
+        }
+
+        case FRAME_CONTINUATION: {
+            if (stream_id == 0 || stream_id != connection.header_stream) {
+                return false;
+            }
+
+            connection.header_block.insert(connection.header_block.end(), payload, payload + length);
+            if (flags & FLAG_END_HEADERS) {
+                return process_headers(connection, stream_id, connection.header_end_stream);
+            }
+            return true;
+        }
+
+        case FRAME_RST_STREAM: {
+            auto it = connection.streams.find(stream_id);
+            if (it != connection.streams.end()) {
+                bool ended = it->second.end_sent;
+                connection.streams.erase(it);
+                if (!ended && on_close_) {
+                    on_close_((static_cast<StreamId>(connection.id) << 32) | stream_id);
+                }
+            }
+            return true;
+        }
+
+        case FRAME_SETTINGS: {
+            if (flags & FLAG_ACK) {
+                return true;
+            }
+            if (stream_id != 0 || length % 6 != 0) {
+                return false;
+            }
+
+            for (size_t i = 0; i < length; i += 6) {
+                uint16_t id = static_cast<uint16_t>((payload[i] << 8) | payload[i + 1]);
+                uint32_t value = read_u32(payload + i + 2);
+                if (id == SETTINGS_INITIAL_WINDOW_SIZE) {
+                    int64_t delta = static_cast<int64_t>(value) - connection.initial_window;
+                    for (auto& entry : connection.streams) {
+                        entry.second.send_window += delta;
+                    }
+                    connection.initial_window = value;
+                }
+            }
+            write_frame(connection.out, FRAME_SETTINGS, FLAG_ACK, 0, nullptr, 0);
+            return true;
+        }
+
+        case FRAME_PING: {
+            if (length != 8) {
+                return false;
+            }
+            if (!(flags & FLAG_ACK)) {
+                write_frame(connection.out, FRAME_PING, FLAG_ACK, 0, payload, length);
+            }
+            return true;
+        }
+
+        case FRAME_GOAWAY:
+            return false;
+
+        case FRAME_WINDOW_UPDATE: {
+            if (length != 4) {
+                return false;
+            }
+
+            uint32_t increment = read_u32(payload) & 0x7fffffff;
+            if (stream_id == 0) {
+                connection.send_window += increment;
+            } else {
+                auto it = connection.streams.find(stream_id);
+                if (it != connection.streams.end()) {
+                    it->second.send_window += increment;
+                }
+            }
+            return true;
+        }
+
+        default:  // PRIORITY and unknown frames
+            return true;
+    }
+}
+
+bool Http2Server::process_headers(Connection& connection, uint32_t stream_id, bool end_stream) {
+    connection.header_stream = 0;
+
+    // Always decoded, the dynamic table must follow every block
+    HeaderList headers;
+    if (!connection.decoder.decode(connection.header_block.data(), connection.header_block.size(), headers)) {
+        return false;
+    }
+
+    auto it = connection.streams.find(stream_id);
+    if (it == connection.streams.end()) {
+        Stream& stream = connection.streams[stream_id];
+        stream.id = stream_id;
+        stream.send_window = connection.initial_window;
+        for (const auto& field : headers) {
+            if (field.first == ":path") {
+                stream.request.path = field.second;
+            }
+        }
+        stream.request.headers = std::move(headers);
+        it = connection.streams.find(stream_id);
+    }
+
+    // Trailers of a request only end it
+    if (end_stream && !it->second.request_done) {
+        request_complete(connection, it->second);
+    }
+    return true;
+}
+
+void Http2Server::request_complete(Connection& connection, Stream& stream) {
+    stream.request_done = true;
+    if (on_request_) {
+        on_request_((static_cast<StreamId>(connection.id) << 32) | stream.id, stream.request);
+    }
+}
+
+Http2Server::Stream* Http2Server::find_stream(StreamId id, Connection** connection) {
+    auto connection_it = connections_.find(static_cast<uint32_t>(id >> 32));
+    if (connection_it == connections_.end()) {
+        return nullptr;
+    }
+
+    auto stream_it = connection_it->second->streams.find(static_cast<uint32_t>(id));
+    if (stream_it == connection_it->second->streams.end()) {
+        return nullptr;
+    }
+
+    *connection = connection_it->second.get();
+    return &stream_it->second;
+}
+
+void Http2Server::send_headers(StreamId id, const HeaderList& headers, bool end_stream) {
+    Stream::Output output;
+    output.headers = true;
+    hpack_encode(headers, output.bytes);
+    output.end_stream = end_stream;
+
+    auto shared = std::make_shared<Stream::Output>(std::move(output));
+    post([this, id, shared] {
+        Connection* connection = nullptr;
+        Stream* stream = find_stream(id, &connection);
+        if (stream && !stream->local_closed) {
+            stream->local_closed = shared->end_stream;
+            stream->output.push_back(std::move(*shared));
+        }
+    });
+}
+
+void Http2Server::send_data(StreamId id, Buffer data, bool end_stream) {
+    Stream::Output output;
+    output.bytes = std::move(data);
+    output.end_stream = end_stream;
+
+    auto shared = std::make_shared<Stream::Output>(std::move(output));
+    post([this, id, shared] {
+        Connection* connection = nullptr;
+        Stream* stream = find_stream(id, &connection);
+        if (stream && !stream->local_closed) {
+            stream->local_closed = shared->end_stream;
+            stream->output.push_back(std::move(*shared));
+        }
+    });
+}
+
+void Http2Server::reset(StreamId id, uint32_t error_code) {
+    post([this, id, error_code] {
+        Connection* connection = nullptr;
+        Stream* stream = find_stream(id, &connection);
+        if (!stream) {
+            return;
+        }
+
+        uint8_t payload[4] = {
+            static_cast<uint8_t>(error_code >> 24),
+            static_cast<uint8_t>(error_code >> 16),
+            static_cast<uint8_t>(error_code >> 8),
+            static_cast<uint8_t>(error_code),
+        };
+        write_frame(connection->out, FRAME_RST_STREAM, 0, stream->id, payload, sizeof(payload));
+        connection->streams.erase(stream->id);
+    });
+}
+
+void Http2Server::flush_streams(Connection& connection) {
+    for (auto it = connection.streams.begin(); it != connection.streams.end();) {
+        Stream& stream = it->second;
+
+        while (!stream.output.empty()) {
+            Stream::Output& output = stream.output.front();
+
+            if (output.headers) {
+                // Header blocks over one frame continue in CONTINUATION frames
+                size_t size = output.bytes.size();
+                size_t first = std::min(size, MAX_FRAME_SIZE);
+                uint8_t flags = (output.end_stream ? FLAG_END_STREAM : 0) | (first == size ? FLAG_END_HEADERS : 0);
+                write_frame(connection.out, FRAME_HEADERS, flags, stream.id, output.bytes.data(), first);
+                for (size_t pos = first; pos < size; pos += MAX_FRAME_SIZE) {
+                    size_t length = std::min(size - pos, MAX_FRAME_SIZE);
+                    uint8_t last = pos + length == size ? FLAG_END_HEADERS : 0;
+                    write_frame(connection.out, FRAME_CONTINUATION, last, stream.id, output.bytes.data() + pos,
+                                length);
+                }
+            } else {
+                size_t remaining = output.bytes.size() - output.offset;
+                int64_t window = std::min(connection.send_window, stream.send_window);
+                if (remaining > 0 && window <= 0) {
+                    break;  // until the client sends WINDOW_UPDATE
+                }
+
+                size_t length = std::min({remaining, MAX_FRAME_SIZE, static_cast<size_t>(std::max<int64_t>(window, 0))});
+                bool last = length == remaining;
+                uint8_t flags = last && output.end_stream ? FLAG_END_STREAM : 0;
+                write_frame(connection.out, FRAME_DATA, flags, stream.id, output.bytes.data() + output.offset, length);
+
+                output.offset += length;
+                connection.send_window -= static_cast<int64_t>(length);
+                stream.send_window -= static_cast<int64_t>(length);
+                if (!last) {
+                    continue;
+                }
+            }
+
+            stream.end_sent = output.end_stream;
+            stream.output.pop_front();
+        }
+
+        if (stream.end_sent) {
+            it = connection.streams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool Http2Server::write_connection(Connection& connection) {
+    while (connection.out_offset < connection.out.size()) {
+        ssize_t n = send(connection.fd, connection.out.data() + connection.out_offset,
+                         connection.out.size() - connection.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.out_offset += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return false;
+    }
+
+    connection.out.clear();
+    connection.out_offset = 0;
+    return true;
+}
+
+}  // namespace mock
+}  // namespace spiffe
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <spiffe/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hpack.h"
+
+namespace spiffe {
+namespace mock {
+
+struct Http2Request {
+    std::string path;
+    HeaderList headers;
+    Buffer body;
+};
+
+// Minimal HTTP/2 server with prior knowledge (h2c) on a Unix socket, enough to serve gRPC to the
+// clients under test.
+//
+// One thread serves all connections and runs the handlers. Responses are queued with the
+// send_*() methods, from handlers or any other thread; frames of a stream go out in order and
+// DATA respects the client's flow control windows.
+class Http2Server {
+   public:
+    // Identifies a stream across connections
+    using StreamId = uint64_t;
+
+    // Runs once the request body is complete
+    using RequestHandler = std::function<void(StreamId id, const Http2Request& request)>;
+
+    // Runs when the client resets a stream, or closes the connection, before the server ended it
+    using CloseHandler = std::function<void(StreamId id)>;
+
+    Http2Server(const std::string& socket_path, RequestHandler on_request, CloseHandler on_close = nullptr);
+    ~Http2Server();
+
+    // Disable copy
+    Http2Server(const Http2Server&) = delete;
+    Http2Server& operator=(const Http2Server&) = delete;
+
+    // Binds the socket, replacing a stale one, and starts serving. False if it could not bind.
+    bool start();
+
+    // Closes all connections and removes the socket
+    void stop();
+
+    const std::string& socket_path() const { return socket_path_; }
+
+    // Thread-safe, no-ops for streams that are gone
+    void send_headers(StreamId id, const HeaderList& headers, bool end_stream);
+    void send_data(StreamId id, Buffer data, bool end_stream);
+    void reset(StreamId id, uint32_t error_code);
+
+    // Runs task on the server thread, after delay
+    void post(std::function<void()> task, std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+
+    // Accepted connections so far
+    size_t connections_accepted() const { return connections_accepted_.load(); }
+
+   private:
+    struct Stream;
+    struct Connection;
+
+    std::string socket_path_;
+    RequestHandler on_request_;
+    CloseHandler on_close_;
+
+    int listen_fd_ = -1;
+    int wake_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> connections_accepted_{0};
+
+    // Server thread only
+    uint32_t next_connection_id_ = 1;
+    std::map<uint32_t, std::unique_ptr<Connection>> connections_;
+
+    std::mutex tasks_mutex_;
+    std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> tasks_;
+
+    void run();
+    void wake();
+    int next_timeout_ms();
+    void run_due_tasks();
+
+    void accept_connections();
+    bool read_connection(Connection& connection);
+    bool process_frames(Connection& connection);
+    bool process_frame(Connection& connection, uint8_t type, uint8_t flags, uint32_t stream_id, const uint8_t* payload,
+                       size_t length);
+    bool process_headers(Connection& connection, uint32_t stream_id, bool end_stream);
+    void request_complete(Connection& connection, Stream& stream);
+
+    Stream* find_stream(StreamId id, Connection** connection);
+    void flush_streams(Connection& connection);
+    bool write_connection(Connection& connection);
+    void close_connection(uint32_t id);
+};
+
+}  // namespace mock
+}  // namespace spiffe
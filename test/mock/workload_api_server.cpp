@@ -0,0 +1,463 @@
+#include "workload_api_server.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "http2_client.h"
+#include "proto/workloadapi.h"
+
+namespace spiffe {
+namespace mock {
+
+namespace {
+
+const HeaderList RESPONSE_HEADERS = {{":status", "200"}, {"content-type", "application/grpc"}};
+
+const size_t MAX_DATA_FRAME_SIZE = 16384;
+
+// Strings the proto_view fields of a message being encoded point into, deque keeps them in place
+class ViewStore {
+   public:
+    proto_view keep(std::string value) {
+        strings_.push_back(std::move(value));
+        return proto_view(strings_.back());
+    }
+
+   private:
+    std::deque<std::string> strings_;
+};
+
+std::string base64url_encode(const std::string& data) {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    std::string out;
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t n = (static_cast<uint8_t>(data[i]) << 16) | (static_cast<uint8_t>(data[i + 1]) << 8) |
+                     static_cast<uint8_t>(data[i + 2]);
+        out += ALPHABET[(n >> 18) & 63];
+        out += ALPHABET[(n >> 12) & 63];
+        out += ALPHABET[(n >> 6) & 63];
+        out += ALPHABET[n & 63];
+    }
+    if (i + 1 == data.size()) {
+        uint32_t n = static_cast<uint8_t>(data[i]) << 16;
+        out += ALPHABET[(n >> 18) & 63];
+        out += ALPHABET[(n >> 12) & 63];
+    } else if (i + 2 == data.size()) {
+        uint32_t n = (static_cast<uint8_t>(data[i]) << 16) | (static_cast<uint8_t>(data[i + 1]) << 8);
+        out += ALPHABET[(n >> 18) & 63];
+        out += ALPHABET[(n >> 12) & 63];
+        out += ALPHABET[(n >> 6) & 63];
+    }
+    return out;
+}
+
+std::string svid_id(const WorkloadApiServerOptions& options, size_t i) {
+    return "spiffe://" + options.trust_domain + "/workload/" + std::to_string(i);
+}
+
+std::string federated_id(const WorkloadApiServerOptions& options, size_t i) {
+    return "spiffe://federated-" + std::to_string(i) + "." + options.trust_domain;
+}
+
+std::string own_bundle(const WorkloadApiServerOptions& options) {
+    return fake_chain(options.bundle_certificates, options.certificate_size, 0xb0);
+}
+
+std::string federated_bundle(const WorkloadApiServerOptions& options, size_t i) {
+    return fake_chain(options.federated_bundle_certificates, options.certificate_size, static_cast<uint8_t>(i));
+}
+
+std::string jwks(const std::string& trust_domain) {
+    std::string coordinate = base64url_encode(std::string(32, 'c'));
+    return "{\"keys\":[{\"kty\":\"EC\",\"kid\":\"" + trust_domain + "\",\"crv\":\"P-256\",\"x\":\"" + coordinate +
+           "\",\"y\":\"" + coordinate + "\"}]}";
+}
+
+std::string jwt_token(const std::string& spiffe_id, const std::vector<std::string>& audience,
+                      std::chrono::seconds ttl) {
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+
+    std::string aud;
+    for (const std::string& value : audience) {
+        aud += (aud.empty() ? "\"" : ",\"") + value + "\"";
+    }
+    std::string claims = "{\"aud\":[" + aud + "],\"exp\":" + std::to_string(now + ttl.count()) +
+                         ",\"iat\":" + std::to_string(now) + ",\"sub\":\"" + spiffe_id + "\"}";
+
+    return base64url_encode("{\"alg\":\"ES256\",\"kid\":\"mock\",\"typ\":\"JWT\"}") + "." + base64url_encode(claims) +
+           "." + base64url_encode(std::string(64, 's'));
+}
+
+Buffer encode_x509_svid_response(const WorkloadApiServerOptions& options, uint64_t generation) {
+    ViewStore store;
+    proto_view bundle = store.keep(own_bundle(options));
+
+    std::vector<ProtoX509Svid> svids;
+    for (size_t i = 0; i < options.svids; ++i) {
+        uint8_t fill = static_cast<uint8_t>(generation * 16 + i);
+        ProtoX509Svid svid;
+        svid.spiffe_id.set(store.keep(svid_id(options, i)));
+        svid.x509_svid.set(store.keep(fake_chain(options.svid_chain_length, options.certificate_size, fill)));
+        svid.x509_svid_key.set(store.keep(std::string(121, static_cast<char>(fill))));
+        svid.bundle.set(bundle);
+        if (i > 0) {
+            svid.hint.set(store.keep("hint-" + std::to_string(i)));
+        }
+        svids.push_back(svid);
+    }
+
+    std::vector<ProtoMapItem> federated;
+    for (size_t i = 0; i < options.federated_trust_domains; ++i) {
+        ProtoMapItem item;
+        item.key.set(store.keep(federated_id(options, i)));
+        item.value.set(store.keep(federated_bundle(options, i)));
+        federated.push_back(item);
+    }
+
+    ProtoX509SvidResponse response;
+    response.svids.set(svids);
+    response.federated_bundles.set(federated);
+    return encode_proto_message(response);
+}
+
+Buffer encode_x509_bundles_response(const WorkloadApiServerOptions& options) {
+    ViewStore store;
+    std::vector<ProtoMapItem> bundles;
+
+    ProtoMapItem own;
+    own.key.set(store.keep("spiffe://" + options.trust_domain));
+    own.value.set(store.keep(own_bundle(options)));
+    bundles.push_back(own);
+
+    for (size_t i = 0; i < options.federated_trust_domains; ++i) {
+        ProtoMapItem item;
+        item.key.set(store.keep(federated_id(options, i)));
+        item.value.set(store.keep(federated_bundle(options, i)));
+        bundles.push_back(item);
+    }
+
+    ProtoX509BundlesResponse response;
+    response.bundles.set(bundles);
+    return encode_proto_message(response);
+}
+
+Buffer encode_jwt_bundles_response(const WorkloadApiServerOptions& options) {
+    ViewStore store;
+    std::vector<ProtoMapItem> bundles;
+
+    ProtoMapItem own;
+    own.key.set(store.keep("spiffe://" + options.trust_domain));
+    own.value.set(store.keep(jwks(options.trust_domain)));
+    bundles.push_back(own);
+
+    for (size_t i = 0; i < options.federated_trust_domains; ++i) {
+        std::string trust_domain = federated_id(options, i);
+        ProtoMapItem item;
+        item.key.set(store.keep(trust_domain));
+        item.value.set(store.keep(jwks(trust_domain)));
+        bundles.push_back(item);
+    }
+
+    ProtoJwtBundlesResponse response;
+    response.bundles.set(bundles);
+    return encode_proto_message(response);
+}
+
+}  // namespace
+
+std::string fake_certificate(size_t size, uint8_t fill) {
+    size = std::max<size_t>(size, 4);
+
+    // Long form length on two bytes, enough for any certificate_size up to 64 KiB
+    std::string cert;
+    cert.push_back(0x30);
+    cert.push_back(static_cast<char>(0x82));
+    cert.push_back(static_cast<char>(((size - 4) >> 8) & 0xff));
+    cert.push_back(static_cast<char>((size - 4) & 0xff));
+    cert.append(size - 4, static_cast<char>(fill));
+    return cert;
+}
+
+std::string fake_chain(size_t count, size_t size, uint8_t fill) {
+    std::string chain;
+    for (size_t i = 0; i < count; ++i) {
+        chain += fake_certificate(size, static_cast<uint8_t>(fill + i));
+    }
+    return chain;
+}
+
+WorkloadApiServer::WorkloadApiServer(const std::string& socket_path, const WorkloadApiServerOptions& options)
+    : options_(options),
+      server_(
+          socket_path, [this](Http2Server::StreamId id, const Http2Request& request) { on_request(id, request); },
+          [this](Http2Server::StreamId id) { on_close(id); }) {}
+
+WorkloadApiServer::~WorkloadApiServer() { stop(); }
+
+bool WorkloadApiServer::start() {
+    if (!server_.start()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options_.update_interval.count() > 0) {
+        schedule_update(++timer_, options_.update_interval);
+    }
+    return true;
+}
+
+void WorkloadApiServer::stop() {
+    server_.stop();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.clear();
+}
+
+void WorkloadApiServer::set_options(const WorkloadApiServerOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+    ++timer_;
+    if (options_.update_interval.count() > 0) {
+        schedule_update(timer_, options_.update_interval);
+    }
+}
+
+uint64_t WorkloadApiServer::generation() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+size_t WorkloadApiServer::open_streams() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.size();
+}
+
+size_t WorkloadApiServer::requests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+}
+
+bool WorkloadApiServer::wait_for_streams(size_t count, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return streams_cv_.wait_for(lock, timeout, [&] {
+        return std::count_if(streams_.begin(), streams_.end(),
+                             [](const std::pair<const Http2Server::StreamId, StreamState>& entry) {
+                                 return entry.second.responded;
+                             }) >= static_cast<std::ptrdiff_t>(count);
+    });
+}
+
+void WorkloadApiServer::schedule_update(uint64_t timer, std::chrono::milliseconds interval) {
+    server_.post(
+        [this, timer, interval] {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (timer != timer_) {
+                    return;
+                }
+            }
+            push_update();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (timer == timer_) {
+                schedule_update(timer, interval);
+            }
+        },
+        interval);
+}
+
+void WorkloadApiServer::on_request(Http2Server::StreamId id, const Http2Request& request) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++requests_;
+
+    bool secured = std::any_of(request.headers.begin(), request.headers.end(),
+                               [](const std::pair<std::string, std::string>& field) {
+                                   return field.first == "workload.spiffe.io" && field.second == "true";
+                               });
+    if (!secured) {
+        send_error(id, 3, "security header missing from request", true);
+        return;
+    }
+
+    std::chrono::milliseconds delay = options_.response_delay;
+    std::function<void()> respond;
+    if (request.path == "/SpiffeWorkloadAPI/FetchJWTSVID") {
+        Buffer body = request.body;
+        respond = [this, id, body] { answer_jwt_svid(id, body); };
+    } else {
+        Method method;
+        if (request.path == "/SpiffeWorkloadAPI/FetchX509SVID") {
+            method = Method::X509Svid;
+        } else if (request.path == "/SpiffeWorkloadAPI/FetchX509Bundles") {
+            method = Method::X509Bundles;
+        } else if (request.path == "/SpiffeWorkloadAPI/FetchJWTBundles") {
+            method = Method::JwtBundles;
+        } else {
+            send_error(id, 12, "unknown method " + request.path, true);
+            return;
+        }
+
+        // Registered now, so a stream closed during the delay is not opened afterwards
+        streams_[id].method = method;
+        respond = [this, id] { open_stream(id); };
+    }
+    lock.unlock();
+
+    if (delay.count() > 0) {
+        server_.post(respond, delay);
+    } else {
+        respond();
+    }
+}
+
+void WorkloadApiServer::on_close(Http2Server::StreamId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.erase(id);
+}
+
+void WorkloadApiServer::open_stream(Http2Server::StreamId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(id);
+    if (it == streams_.end()) {
+        return;
+    }
+
+    if (options_.error_code != 0 && options_.error_after_messages == 0) {
+        send_error(id, options_.error_code, options_.error_message, true);
+        streams_.erase(it);
+        return;
+    }
+
+    server_.send_headers(id, RESPONSE_HEADERS, false);
+    it->second.responded = true;
+    if (!send_update(id, it->second, encode_update(it->second.method))) {
+        streams_.erase(it);
+    }
+    streams_cv_.notify_all();
+}
+
+void WorkloadApiServer::push_update() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+
+    // Encoded once per method, shared by all its streams
+    std::map<Method, Buffer> updates;
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        if (!it->second.responded) {
+            ++it;
+            continue;
+        }
+
+        auto update = updates.find(it->second.method);
+        if (update == updates.end()) {
+            update = updates.emplace(it->second.method, encode_update(it->second.method)).first;
+        }
+
+        if (send_update(it->first, it->second, update->second)) {
+            ++it;
+        } else {
+            it = streams_.erase(it);
+        }
+    }
+}
+
+bool WorkloadApiServer::send_update(Http2Server::StreamId id, StreamState& stream, const Buffer& message) {
+    send_message(id, message);
+    ++stream.messages;
+
+    if (options_.error_code != 0 && stream.messages >= options_.error_after_messages) {
+        send_error(id, options_.error_code, options_.error_message, false);
+        return false;
+    }
+    return true;
+}
+
+void WorkloadApiServer::answer_jwt_svid(Http2Server::StreamId id, const Buffer& body) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options_.error_code != 0) {
+        send_error(id, options_.error_code, options_.error_message, true);
+        return;
+    }
+
+    Buffer message;
+    ProtoJwtSvidRequest request;
+    if (!GrpcFraming::unpack_message(body, message) || !decode_proto_message(message, request)) {
+        send_error(id, 3, "malformed request", true);
+        return;
+    }
+    if (request.audience.get().empty()) {
+        send_error(id, 3, "audience must be specified", true);
+        return;
+    }
+
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < options_.svids; ++i) {
+        std::string spiffe_id = svid_id(options_, i);
+        if (request.spiffe_id.get().empty() || request.spiffe_id.get() == spiffe_id) {
+            ids.push_back(spiffe_id);
+        }
+    }
+    if (ids.empty()) {
+        send_error(id, 7, "no identity issued", true);
+        return;
+    }
+
+    ViewStore store;
+    std::vector<ProtoJwtSvid> svids;
+    for (const std::string& spiffe_id : ids) {
+        ProtoJwtSvid svid;
+        svid.spiffe_id.set(store.keep(spiffe_id));
+        svid.svid.set(store.keep(jwt_token(spiffe_id, request.audience.get(), options_.jwt_ttl)));
+        svids.push_back(svid);
+    }
+
+    ProtoJwtSvidResponse response;
+    response.svids.set(svids);
+
+    server_.send_headers(id, RESPONSE_HEADERS, false);
+    send_message(id, encode_proto_message(response));
+    server_.send_headers(id, {{"grpc-status", "0"}}, true);
+}
+
+void WorkloadApiServer::send_message(Http2Server::StreamId id, const Buffer& message) {
+    Buffer framed = GrpcFraming::pack_message(message);
+    size_t frame_size = std::min(std::max<size_t>(options_.data_frame_size, 1), MAX_DATA_FRAME_SIZE);
+
+    // Each send_data call goes out as its own DATA frames
+    for (size_t pos = 0; pos < framed.size(); pos += frame_size) {
+        size_t end = std::min(pos + frame_size, framed.size());
+        server_.send_data(id, Buffer(framed.begin() + pos, framed.begin() + end), false);
+    }
+}
+
+void WorkloadApiServer::send_error(Http2Server::StreamId id, int code, const std::string& message, bool trailers_only) {
+    HeaderList trailers;
+    if (trailers_only) {
+        trailers = RESPONSE_HEADERS;
+    }
+    trailers.emplace_back("grpc-status", std::to_string(code));
+    if (!message.empty()) {
+        trailers.emplace_back("grpc-message", message);
+    }
+    server_.send_headers(id, trailers, true);
+}
+
+Buffer WorkloadApiServer::encode_update(Method method) const {
+    switch (method) {
+        case Method::X509Svid:
+            return encode_x509_svid_response(options_, generation_);
+        case Method::X509Bundles:
+            return encode_x509_bundles_response(options_);
+        case Method::JwtBundles:
+        default:
+            return encode_jwt_bundles_response(options_);
+    }
+}
+
+}  // namespace mock
+}  // namespace spiffe
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <spiffe/types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "http2_server.h"
+
+namespace spiffe {
+namespace mock {
+
+// DER SEQUENCE of size bytes (at least 4). Splits like a certificate, does not parse as one.
+std::string fake_certificate(size_t size, uint8_t fill);
+
+// count fake certificates of size bytes each, concatenated
+std::string fake_chain(size_t count, size_t size, uint8_t fill);
+
+struct WorkloadApiServerOptions {
+    // Identities served. SVID certificates change on every rotation, bundles never do.
+    std::string trust_domain = "example.org";
+    size_t svids = 1;
+    size_t svid_chain_length = 2;
+    size_t bundle_certificates = 3;
+    size_t federated_trust_domains = 0;
+    size_t federated_bundle_certificates = 2;
+    size_t certificate_size = 1024;
+    std::chrono::seconds jwt_ttl = std::chrono::seconds(300);
+
+    // Delay before answering a request, like a slow agent
+    std::chrono::milliseconds response_delay = std::chrono::milliseconds(0);
+
+    // Rotate and push an update on every open stream at this interval, 0 to only push on
+    // push_update()
+    std::chrono::milliseconds update_interval = std::chrono::milliseconds(0);
+
+    // Size of the DATA frames a message is sent in, 1 to 16384. Small sizes split the gRPC
+    // header and the message at arbitrary byte boundaries.
+    size_t data_frame_size = 16384;
+
+    // Non-zero to fail calls with this gRPC status. Streams first send error_after_messages
+    // updates, unary calls and streams with 0 get a trailers-only response.
+    int error_code = 0;
+    std::string error_message;
+    size_t error_after_messages = 0;
+};
+
+// In-process SpiffeWorkloadAPI over a Unix socket (h2c), for hermetic tests and benchmarks.
+//
+// Serves FetchX509SVID, FetchX509Bundles, FetchJWTBundles and FetchJWTSVID with synthetic
+// identities shaped by WorkloadApiServerOptions. JWT-SVIDs carry real claims (sub, aud, exp)
+// and a fake signature. Requests without the workload.spiffe.io header are rejected, like an
+// agent does.
+//
+// Thread-safe.
+class WorkloadApiServer {
+   public:
+    explicit WorkloadApiServer(const std::string& socket_path,
+                               const WorkloadApiServerOptions& options = WorkloadApiServerOptions());
+    ~WorkloadApiServer();
+
+    // Disable copy
+    WorkloadApiServer(const WorkloadApiServer&) = delete;
+    WorkloadApiServer& operator=(const WorkloadApiServer&) = delete;
+
+    bool start();
+    void stop();
+
+    const std::string& socket_path() const { return server_.socket_path(); }
+
+    // Applies to responses and updates from now on
+    void set_options(const WorkloadApiServerOptions& options);
+
+    // Rotates the SVIDs and sends the new state on every open stream
+    void push_update();
+
+    // Starts at 1, incremented by every rotation
+    uint64_t generation() const;
+
+    // Streams currently open, and requests received so far
+    size_t open_streams() const;
+    size_t requests() const;
+
+    // Waits until at least count streams are open
+    bool wait_for_streams(size_t count, std::chrono::milliseconds timeout);
+
+   private:
+    enum class Method { X509Svid, X509Bundles, JwtBundles };
+
+    struct StreamState {
+        Method method;
+        bool responded = false;  // headers sent, updates go out
+        size_t messages = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable streams_cv_;
+    WorkloadApiServerOptions options_;
+    uint64_t generation_ = 1;
+    uint64_t timer_ = 0;  // invalidates the update timer of previous options
+    size_t requests_ = 0;
+    std::map<Http2Server::StreamId, StreamState> streams_;
+
+    Http2Server server_;
+
+    void on_request(Http2Server::StreamId id, const Http2Request& request);
+    void on_close(Http2Server::StreamId id);
+
+    void open_stream(Http2Server::StreamId id);
+    void answer_jwt_svid(Http2Server::StreamId id, const Buffer& body);
+    void schedule_update(uint64_t timer, std::chrono::milliseconds interval);
+
+    // Sends message on a stream and ends it if the options say so, false once ended. mutex_ held.
+    bool send_update(Http2Server::StreamId id, StreamState& stream, const Buffer& message);
+    void send_message(Http2Server::StreamId id, const Buffer& message);
+    void send_error(Http2Server::StreamId id, int code, const std::string& message, bool trailers_only);
+
+    Buffer encode_update(Method method) const;
+};
+
+}  // namespace mock
+}  // namespace spiffe
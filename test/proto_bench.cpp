@@ -0,0 +1,396 @@
+#include <benchmark/benchmark.h>
+#include <malloc.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "context_decoder.h"
+#include "der.h"
+#include "grpc_client.h"
+#include "http2_client.h"
+#include "proto/workloadapi.h"
+
+// Every copy of a length-delimited field lands in a fresh heap allocation, so bytes allocated
+// per decoded update is the number of bytes copied out of the received frame.
+static std::atomic<size_t> g_alloc_count{0};
+static std::atomic<size_t> g_alloc_bytes{0};
+
+// Live heap, in malloc usable sizes, and its high-water mark since the last reset
+static std::atomic<size_t> g_live_count{0};
+static std::atomic<size_t> g_live_bytes{0};
+static std::atomic<size_t> g_peak_bytes{0};
+
+void* operator new(size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        g_live_count.fetch_add(1, std::memory_order_relaxed);
+        size_t live = g_live_bytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed) + malloc_usable_size(p);
+        if (live > g_peak_bytes.load(std::memory_order_relaxed)) {
+            g_peak_bytes.store(live, std::memory_order_relaxed);
+        }
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        g_live_count.fetch_sub(1, std::memory_order_relaxed);
+        g_live_bytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    }
+    std::free(p);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+namespace spiffe {
+
+// Owned counterparts of the response messages, the representation used before proto_view
+struct OwnedProtoMapItem {
+    FIELDS(                     //
+        FIELD_BUFFER(1, key)    // string
+        FIELD_BUFFER(2, value)  // string
+    )
+
+    ADD_FIELD_OPTIONAL(std::string, key);
+    ADD_FIELD_OPTIONAL(std::string, value);
+};
+
+struct OwnedProtoX509Svid {
+    FIELDS(                             //
+        FIELD_BUFFER(1, spiffe_id)      // string
+        FIELD_BUFFER(2, x509_svid)      // bytes
+        FIELD_BUFFER(3, x509_svid_key)  // bytes
+        FIELD_BUFFER(4, bundle)         // bytes
+        FIELD_BUFFER(5, hint)           // string
+    )
+
+    ADD_FIELD_OPTIONAL(std::string, spiffe_id);
+    ADD_FIELD_OPTIONAL(std::string, x509_svid);
+    ADD_FIELD_OPTIONAL(std::string, x509_svid_key);
+    ADD_FIELD_OPTIONAL(std::string, bundle);
+    ADD_FIELD_OPTIONAL(std::string, hint);
+};
+
+struct OwnedProtoX509SvidResponse {
+    FIELDS(                                           //
+        REPEATED_FIELD_MESSAGE(1, svids)              // repeated ProtoX509Svid
+        REPEATED_FIELD_BUFFER(2, crl)                 // repeated bytes
+        REPEATED_FIELD_MESSAGE(3, federated_bundles)  // map<string, bytes>
+    )
+
+    ADD_FIELD_OPTIONAL(std::vector<OwnedProtoX509Svid>, svids);
+    ADD_FIELD_OPTIONAL(std::vector<std::string>, crl);
+    ADD_FIELD_OPTIONAL(std::vector<OwnedProtoMapItem>, federated_bundles);
+};
+
+struct OwnedProtoJwtBundlesResponse {
+    FIELDS(                                 //
+        REPEATED_FIELD_MESSAGE(1, bundles)  //  map<string, string>
+    )
+
+    ADD_FIELD_OPTIONAL(std::vector<OwnedProtoMapItem>, bundles);
+};
+
+// DER SEQUENCE of the given total size, looks like a certificate to extract_all_certificates
+static std::string fake_certificate(size_t size, uint8_t fill) {
+    std::string cert;
+    cert.push_back(0x30);
+    cert.push_back(static_cast<char>(0x82));
+    cert.push_back(static_cast<char>(((size - 4) >> 8) & 0xff));
+    cert.push_back(static_cast<char>((size - 4) & 0xff));
+    cert.append(size - 4, static_cast<char>(fill));
+    return cert;
+}
+
+static std::string fake_chain(size_t certs, uint8_t fill) {
+    std::string chain;
+    for (size_t i = 0; i < certs; ++i) {
+        chain += fake_certificate(1024, static_cast<uint8_t>(fill + i));
+    }
+    return chain;
+}
+
+// One SVID (2 certs, 3 bundle certs) plus trust_domains federated bundles of 2 certs each
+static std::vector<uint8_t> make_x509_svid_response(size_t trust_domains) {
+    OwnedProtoX509SvidResponse response;
+
+    OwnedProtoX509Svid svid;
+    svid.spiffe_id.set("spiffe://example.org/workload");
+    svid.x509_svid.set(fake_chain(2, 1));
+    svid.x509_svid_key.set(std::string(121, 'k'));
+    svid.bundle.set(fake_chain(3, 3));
+    svid.hint.set("internal");
+    response.svids.set({svid});
+
+    std::vector<OwnedProtoMapItem> bundles;
+    for (size_t i = 0; i < trust_domains; ++i) {
+        OwnedProtoMapItem item;
+        item.key.set("spiffe://federated-" + std::to_string(i) + ".example.org");
+        item.value.set(fake_chain(2, static_cast<uint8_t>(i)));
+        bundles.push_back(item);
+    }
+    response.federated_bundles.set(bundles);
+
+    return encode_proto_message(response);
+}
+
+static void report_allocations(benchmark::State& state, size_t count, size_t bytes, size_t frame_size) {
+    double iterations = static_cast<double>(state.iterations());
+    state.counters["allocs_per_update"] = benchmark::Counter(static_cast<double>(count) / iterations);
+    state.counters["bytes_copied_per_update"] = benchmark::Counter(static_cast<double>(bytes) / iterations);
+    state.counters["frame_bytes"] = benchmark::Counter(static_cast<double>(frame_size));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame_size));
+}
+
+template <typename Message>
+static void BM_DecodeX509SvidResponse(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_x509_svid_response(static_cast<size_t>(state.range(0)));
+
+    size_t count = g_alloc_count.load();
+    size_t bytes = g_alloc_bytes.load();
+    for (auto _ : state) {
+        Message message;
+        benchmark::DoNotOptimize(decode_proto_message(frame, message));
+        benchmark::DoNotOptimize(message);
+    }
+    report_allocations(state, g_alloc_count.load() - count, g_alloc_bytes.load() - bytes, frame.size());
+}
+BENCHMARK_TEMPLATE(BM_DecodeX509SvidResponse, OwnedProtoX509SvidResponse)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DecodeX509SvidResponse, ProtoX509SvidResponse)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// trust_domains JWKS of a few hundred bytes each, many small fields per byte
+static std::vector<uint8_t> make_jwt_bundles_response(size_t trust_domains) {
+    OwnedProtoJwtBundlesResponse response;
+
+    std::vector<OwnedProtoMapItem> bundles;
+    for (size_t i = 0; i < trust_domains; ++i) {
+        OwnedProtoMapItem item;
+        item.key.set("spiffe://federated-" + std::to_string(i) + ".example.org");
+        item.value.set("{\"keys\":[{\"kty\":\"EC\",\"kid\":\"key-" + std::to_string(i) +
+                       "\",\"crv\":\"P-256\",\"x\":\"" + std::string(43, 'x') + "\",\"y\":\"" +
+                       std::string(43, 'y') + "\",\"use\":\"jwt-svid\"}]}");
+        bundles.push_back(item);
+    }
+    response.bundles.set(bundles);
+
+    return encode_proto_message(response);
+}
+
+static void BM_DecodeJwtBundlesResponse(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_jwt_bundles_response(static_cast<size_t>(state.range(0)));
+
+    size_t count = g_alloc_count.load();
+    size_t bytes = g_alloc_bytes.load();
+    for (auto _ : state) {
+        ProtoJwtBundlesResponse message;
+        benchmark::DoNotOptimize(decode_proto_message(frame, message));
+        benchmark::DoNotOptimize(message);
+    }
+    report_allocations(state, g_alloc_count.load() - count, g_alloc_bytes.load() - bytes, frame.size());
+}
+BENCHMARK(BM_DecodeJwtBundlesResponse)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Framed and ready to send, nested messages written in place
+static void BM_EncodeJwtBundlesResponse(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_jwt_bundles_response(static_cast<size_t>(state.range(0)));
+    ProtoJwtBundlesResponse message;
+    decode_proto_message(frame, message);
+
+    size_t count = g_alloc_count.load();
+    size_t bytes = g_alloc_bytes.load();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(encode_grpc_message(message));
+    }
+    report_allocations(state, g_alloc_count.load() - count, g_alloc_bytes.load() - bytes, frame.size());
+}
+BENCHMARK(BM_EncodeJwtBundlesResponse)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_EncodeJwtSvidRequest(benchmark::State& state) {
+    ProtoJwtSvidRequest request;
+    std::vector<std::string> audience;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        audience.push_back("spiffe://example.org/audience-" + std::to_string(i));
+    }
+    request.audience.set(audience);
+    request.spiffe_id.set("spiffe://example.org/workload");
+
+    size_t count = g_alloc_count.load();
+    size_t bytes = g_alloc_bytes.load();
+    size_t size = 0;
+    for (auto _ : state) {
+        std::vector<uint8_t> framed = encode_grpc_message(request);
+        size = framed.size();
+        benchmark::DoNotOptimize(framed);
+    }
+    report_allocations(state, g_alloc_count.load() - count, g_alloc_bytes.load() - bytes, size);
+}
+BENCHMARK(BM_EncodeJwtSvidRequest)->Arg(1)->Arg(100);
+
+// Heap held by one decoded update, the peak heap while decoding it, and the process max RSS
+template <typename Context, typename Decode>
+static void report_footprint(benchmark::State& state, const std::vector<uint8_t>& frame, Decode decode) {
+    size_t live_count = g_live_count.load();
+    size_t live_bytes = g_live_bytes.load();
+    g_peak_bytes.store(live_bytes);
+    {
+        Context context;
+        decode(frame.data(), frame.size(), context);
+
+        state.counters["retained_allocs"] = benchmark::Counter(static_cast<double>(g_live_count.load() - live_count));
+        state.counters["retained_bytes"] = benchmark::Counter(static_cast<double>(g_live_bytes.load() - live_bytes));
+        state.counters["peak_heap_bytes"] = benchmark::Counter(static_cast<double>(g_peak_bytes.load() - live_bytes));
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    state.counters["max_rss_kb"] = benchmark::Counter(static_cast<double>(usage.ru_maxrss));
+}
+
+// Full update: decode plus materializing the public X509SvidContext
+static void BM_DecodeX509SvidContext(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_x509_svid_response(static_cast<size_t>(state.range(0)));
+
+    size_t count = g_alloc_count.load();
+    size_t bytes = g_alloc_bytes.load();
+    for (auto _ : state) {
+        X509SvidContext context;
+        benchmark::DoNotOptimize(decode_x509_svid_context(frame.data(), frame.size(), context));
+        benchmark::DoNotOptimize(context);
+    }
+    report_allocations(state, g_alloc_count.load() - count, g_alloc_bytes.load() - bytes, frame.size());
+    report_footprint<X509SvidContext>(state, frame, [](const uint8_t* data, size_t size, X509SvidContext& context) {
+        return decode_x509_svid_context(data, size, context);
+    });
+}
+BENCHMARK(BM_DecodeX509SvidContext)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Same update into the single arena CompactX509SvidContext
+static void BM_DecodeCompactX509SvidContext(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_x509_svid_response(static_cast<size_t>(state.range(0)));
+
+    size_t count = g_alloc_count.load();
+    size_t bytes = g_alloc_bytes.load();
+    for (auto _ : state) {
+        CompactX509SvidContext context;
+        benchmark::DoNotOptimize(decode_compact_x509_svid_context(frame.data(), frame.size(), context));
+        benchmark::DoNotOptimize(context);
+    }
+    report_allocations(state, g_alloc_count.load() - count, g_alloc_bytes.load() - bytes, frame.size());
+    report_footprint<CompactX509SvidContext>(
+        state, frame, [](const uint8_t* data, size_t size, CompactX509SvidContext& context) {
+            return decode_compact_x509_svid_context(data, size, context);
+        });
+}
+BENCHMARK(BM_DecodeCompactX509SvidContext)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Walking every federated bundle certificate of an update
+static void BM_IterateBundleCertificates(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_x509_svid_response(static_cast<size_t>(state.range(0)));
+    X509SvidContext context;
+    decode_x509_svid_context(frame.data(), frame.size(), context);
+
+    for (auto _ : state) {
+        size_t total = 0;
+        for (const auto& bundle : context.federated_bundles) {
+            for (const BufferView& cert : bundle.second) {
+                total += cert.size();
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+BENCHMARK(BM_IterateBundleCertificates)->Arg(10)->Arg(1000);
+
+static void BM_IterateCompactBundleCertificates(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_x509_svid_response(static_cast<size_t>(state.range(0)));
+    CompactX509SvidContext context;
+    decode_compact_x509_svid_context(frame.data(), frame.size(), context);
+
+    for (auto _ : state) {
+        size_t total = 0;
+        for (const BufferView& cert : context.federated_bundles().all_certificates()) {
+            total += cert.size();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+BENCHMARK(BM_IterateCompactBundleCertificates)->Arg(10)->Arg(1000);
+
+// Splitting a bundle of concatenated DER certificates
+static void BM_ExtractAllCertificates(benchmark::State& state) {
+    std::string bundle = fake_chain(static_cast<size_t>(state.range(0)), 1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(extract_all_certificates(bundle));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bundle.size()));
+}
+BENCHMARK(BM_ExtractAllCertificates)->Arg(1)->Arg(10)->Arg(100);
+
+static void BM_CertificateListFromDer(benchmark::State& state) {
+    std::string bundle = fake_chain(static_cast<size_t>(state.range(0)), 1);
+    Buffer der(bundle.begin(), bundle.end());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CertificateList::from_der(der.data(), der.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * der.size()));
+}
+BENCHMARK(BM_CertificateListFromDer)->Arg(1)->Arg(10)->Arg(100);
+
+static void BM_GrpcFramingPack(benchmark::State& state) {
+    std::vector<uint8_t> frame = make_x509_svid_response(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(GrpcFraming::pack_message(frame));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame.size()));
+}
+BENCHMARK(BM_GrpcFramingPack)->Arg(1)->Arg(1000);
+
+static void BM_GrpcFramingUnpack(benchmark::State& state) {
+    Buffer packed = GrpcFraming::pack_message(make_x509_svid_response(static_cast<size_t>(state.range(0))));
+
+    for (auto _ : state) {
+        size_t message_size = 0;
+        Buffer message;
+        benchmark::DoNotOptimize(GrpcFraming::has_complete_message(packed, message_size));
+        benchmark::DoNotOptimize(GrpcFraming::unpack_message(packed, message));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packed.size()));
+}
+BENCHMARK(BM_GrpcFramingUnpack)->Arg(1)->Arg(1000);
+
+// A framed update handed to grpc_stream_write in chunks of the given size, as cURL does with
+// the DATA frames it receives
+static void BM_StreamWriteReassembly(benchmark::State& state) {
+    Buffer body = GrpcFraming::pack_message(make_x509_svid_response(static_cast<size_t>(state.range(0))));
+    size_t chunk_size = static_cast<size_t>(state.range(1));
+
+    size_t count = g_alloc_count.load();
+    size_t bytes = g_alloc_bytes.load();
+    for (auto _ : state) {
+        size_t messages = 0;
+        GrpcStreamData stream;
+        stream.on_response = [&](BufferView) {
+            ++messages;
+            return GrpcStatus{};
+        };
+
+        for (size_t pos = 0; pos < body.size(); pos += chunk_size) {
+            size_t size = std::min(chunk_size, body.size() - pos);
+            grpc_stream_write(body.data() + pos, 1, size, &stream);
+        }
+        benchmark::DoNotOptimize(messages);
+    }
+    report_allocations(state, g_alloc_count.load() - count, g_alloc_bytes.load() - bytes, body.size());
+}
+BENCHMARK(BM_StreamWriteReassembly)->Args({1, 16384})->Args({100, 16384})->Args({1000, 1024})->Args({1000, 16384});
+
+}  // namespace spiffe
@@ -0,0 +1,243 @@
+#include <benchmark/benchmark.h>
+#include <curl/curl.h>
+#include <spiffe/spiffe.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http2_client.h"
+#include "mock/http2_server.h"
+#include "mock/workload_api_server.h"
+#include "proto/workloadapi.h"
+
+// End-to-end latency through cURL, the I/O thread and decoding, against an in-process h2c
+// server on a Unix socket. Each iteration is timed on its own to report percentiles.
+
+namespace spiffe {
+
+namespace {
+
+const mock::HeaderList RESPONSE_HEADERS = {{":status", "200"}, {"content-type", "application/grpc"}};
+const mock::HeaderList OK_TRAILERS = {{"grpc-status", "0"}};
+
+// Recorded in the JSON output, results are only comparable on the same cURL
+struct CurlContext {
+    CurlContext() { benchmark::AddCustomContext("libcurl", curl_version_info(CURLVERSION_NOW)->version); }
+} curl_context;
+
+// FetchX509SVID update with one SVID and trust_domains federated bundles, gRPC framed
+Buffer make_x509_svid_update(size_t trust_domains) {
+    std::vector<std::string> strings;
+    strings.reserve(4 + 2 * trust_domains);
+    auto keep = [&](std::string value) -> const std::string& {
+        strings.push_back(std::move(value));
+        return strings.back();
+    };
+
+    ProtoX509Svid svid;
+    svid.spiffe_id.set(proto_view(keep("spiffe://example.org/workload")));
+    svid.x509_svid.set(proto_view(keep(mock::fake_chain(2, 1024, 1))));
+    svid.x509_svid_key.set(proto_view(keep(std::string(121, 'k'))));
+    svid.bundle.set(proto_view(keep(mock::fake_chain(3, 1024, 3))));
+
+    ProtoX509SvidResponse response;
+    response.svids.set({svid});
+
+    std::vector<ProtoMapItem> bundles;
+    for (size_t i = 0; i < trust_domains; ++i) {
+        ProtoMapItem item;
+        item.key.set(proto_view(keep("spiffe://federated-" + std::to_string(i) + ".example.org")));
+        item.value.set(proto_view(keep(mock::fake_chain(2, 1024, static_cast<uint8_t>(i)))));
+        bundles.push_back(item);
+    }
+    response.federated_bundles.set(bundles);
+
+    return GrpcFraming::pack_message(encode_proto_message(response));
+}
+
+Buffer make_jwt_svid_response() {
+    std::string spiffe_id = "spiffe://example.org/workload";
+    std::string token = "eyJhbGciOiJFUzI1NiJ9." + std::string(300, 'p') + "." + std::string(86, 's');
+
+    ProtoJwtSvid svid;
+    svid.spiffe_id.set(proto_view(spiffe_id));
+    svid.svid.set(proto_view(token));
+
+    ProtoJwtSvidResponse response;
+    response.svids.set({svid});
+    return GrpcFraming::pack_message(encode_proto_message(response));
+}
+
+// Answers FetchJWTSVID right away and keeps FetchX509SVID streams open for the benchmark to
+// push updates on
+class BenchServer {
+   public:
+    BenchServer()
+        : jwt_response_(make_jwt_svid_response()),
+          server_("/tmp/spiffe-bench-" + std::to_string(getpid()) + ".sock",
+                  [this](mock::Http2Server::StreamId id, const mock::Http2Request& request) { on_request(id, request); }) {
+        server_.start();
+    }
+
+    const std::string& socket_path() const { return server_.socket_path(); }
+    mock::Http2Server& server() { return server_; }
+
+    // FetchX509SVID streams opened so far
+    uint64_t x509_streams_opened() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return x509_streams_opened_;
+    }
+
+    // Waits for the stream opened after the given count, a previous one may not be closed yet
+    bool wait_x509_stream(uint64_t opened_before, mock::Http2Server::StreamId& id) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool opened =
+            cv_.wait_for(lock, std::chrono::seconds(5), [&] { return x509_streams_opened_ > opened_before; });
+        id = x509_stream_;
+        return opened;
+    }
+
+   private:
+    Buffer jwt_response_;
+    mock::Http2Server server_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    mock::Http2Server::StreamId x509_stream_ = 0;  // latest
+    uint64_t x509_streams_opened_ = 0;
+
+    void on_request(mock::Http2Server::StreamId id, const mock::Http2Request& request) {
+        if (request.path == "/SpiffeWorkloadAPI/FetchJWTSVID") {
+            server_.send_headers(id, RESPONSE_HEADERS, false);
+            server_.send_data(id, jwt_response_, false);
+            server_.send_headers(id, OK_TRAILERS, true);
+        } else if (request.path == "/SpiffeWorkloadAPI/FetchX509SVID") {
+            server_.send_headers(id, RESPONSE_HEADERS, false);
+            std::lock_guard<std::mutex> lock(mutex_);
+            x509_stream_ = id;
+            ++x509_streams_opened_;
+            cv_.notify_all();
+        } else {
+            server_.send_headers(id, {{":status", "200"}, {"content-type", "application/grpc"}, {"grpc-status", "12"}},
+                                 true);
+        }
+    }
+
+};
+
+BenchServer& bench_server() {
+    static BenchServer server;
+    return server;
+}
+
+void report_latency(benchmark::State& state, std::vector<double>& samples_us) {
+    if (samples_us.empty()) {
+        return;
+    }
+
+    std::sort(samples_us.begin(), samples_us.end());
+    size_t n = samples_us.size();
+    state.counters["p50_us"] = benchmark::Counter(samples_us[n / 2]);
+    state.counters["p99_us"] = benchmark::Counter(samples_us[std::min(n - 1, n * 99 / 100)]);
+    state.counters["max_us"] = benchmark::Counter(samples_us.back());
+}
+
+double elapsed_us(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+}  // namespace
+
+// Unary round trip over an established connection
+static void BM_FetchJwtSvid(benchmark::State& state) {
+    WorkloadApiClient client(bench_server().socket_path());
+
+    // Warm up the connection
+    std::vector<JwtSvid> svids;
+    if (!client.fetch_jwt_svid(svids, {"bench"}).is_ok()) {
+        state.SkipWithError("FetchJWTSVID failed");
+        return;
+    }
+
+    std::vector<double> samples_us;
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        Status status = client.fetch_jwt_svid(svids, {"bench"});
+        auto end = std::chrono::steady_clock::now();
+
+        if (!status.is_ok()) {
+            state.SkipWithError(status.message.c_str());
+            break;
+        }
+        state.SetIterationTime(elapsed_us(start, end) / 1e6);
+        samples_us.push_back(elapsed_us(start, end));
+    }
+    report_latency(state, samples_us);
+}
+BENCHMARK(BM_FetchJwtSvid)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+// From the server queuing an X.509 update to the fetch_x509_svid callback receiving it decoded
+static void BM_X509SvidUpdateLatency(benchmark::State& state) {
+    BenchServer& server = bench_server();
+    Buffer update = make_x509_svid_update(static_cast<size_t>(state.range(0)));
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint64_t received = 0;
+    std::chrono::steady_clock::time_point received_at;
+
+    uint64_t opened_before = server.x509_streams_opened();
+    WorkloadApiClient client(server.socket_path());
+    CancellationSource cancellation;
+    std::thread stream([&] {
+        client.fetch_x509_svid(
+            [&](const X509SvidContext&) {
+                auto now = std::chrono::steady_clock::now();
+                std::lock_guard<std::mutex> lock(mutex);
+                received_at = now;
+                ++received;
+                cv.notify_all();
+                return Status{};
+            },
+            cancellation.token());
+    });
+
+    mock::Http2Server::StreamId id = 0;
+    if (!server.wait_x509_stream(opened_before, id)) {
+        state.SkipWithError("FetchX509SVID stream not opened");
+    }
+
+    std::vector<double> samples_us;
+    for (auto _ : state) {
+        if (id == 0) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t expected = received + 1;
+        auto start = std::chrono::steady_clock::now();
+        server.server().send_data(id, update, false);
+
+        if (!cv.wait_for(lock, std::chrono::seconds(5), [&] { return received >= expected; })) {
+            state.SkipWithError("update not received");
+            break;
+        }
+        state.SetIterationTime(elapsed_us(start, received_at) / 1e6);
+        samples_us.push_back(elapsed_us(start, received_at));
+    }
+    report_latency(state, samples_us);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * update.size()));
+
+    cancellation.cancel();
+    stream.join();
+}
+BENCHMARK(BM_X509SvidUpdateLatency)->Arg(1)->Arg(100)->Arg(1000)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+}  // namespace spiffe
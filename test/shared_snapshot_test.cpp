@@ -0,0 +1,328 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <spiffe/shared_snapshot.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mock/workload_api_server.h"
+
+namespace spiffe {
+
+namespace {
+
+std::string test_socket_path() { return "/tmp/spiffe-cpp-snapshot-" + std::to_string(getpid()) + ".sock"; }
+
+// Region directory, removed with its files
+struct TempDirectory {
+    std::string path;
+
+    TempDirectory() {
+        char pattern[] = "/tmp/spiffe-cpp-snapshot-XXXXXX";
+        path = mkdtemp(pattern);
+    }
+
+    ~TempDirectory() {
+        for (const std::string& file : files()) {
+            unlink((path + "/" + file).c_str());
+        }
+        rmdir(path.c_str());
+    }
+
+    std::vector<std::string> files() const {
+        std::vector<std::string> names;
+        DIR* dir = opendir(path.c_str());
+        while (dirent* entry = dir ? readdir(dir) : nullptr) {
+            if (entry->d_name[0] != '.') {
+                names.push_back(entry->d_name);
+            }
+        }
+        if (dir) {
+            closedir(dir);
+        }
+        return names;
+    }
+
+    unsigned mode(const std::string& file) const {
+        struct stat st;
+        return stat((path + "/" + file).c_str(), &st) == 0 ? st.st_mode & 0777 : 0;
+    }
+};
+
+template <typename Condition>
+bool wait_until(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+std::string text(BufferView view) { return std::string(reinterpret_cast<const char*>(view.data()), view.size()); }
+
+off_t file_size(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_size : -1;
+}
+
+// Overwrites a 32 bit field of a published file in place
+bool patch(const std::string& path, off_t offset, uint32_t value) {
+    int fd = open(path.c_str(), O_WRONLY);
+    bool written = fd >= 0 && pwrite(fd, &value, sizeof(value), offset) == sizeof(value);
+    if (fd >= 0) {
+        close(fd);
+    }
+    return written;
+}
+
+}  // namespace
+
+TEST(SharedSnapshotTest, PublishesAgentUpdates) {
+    mock::WorkloadApiServer server(test_socket_path());
+    ASSERT_TRUE(server.start());
+    TempDirectory directory;
+    SharedSnapshotOptions options;
+    options.directory = directory.path;
+
+    SharedSnapshotPublisher publisher(server.socket_path(), options);
+    ASSERT_TRUE(publisher.start().is_ok());
+
+    SharedSnapshotReader reader(options);
+    ASSERT_TRUE(wait_until([&] { return reader.x509_svid() && reader.x509_bundles() && reader.jwt_bundles(); }));
+    EXPECT_EQ(server.requests(), 3u);
+
+    const CompactX509SvidContext* svid = reader.x509_svid();
+    ASSERT_EQ(svid->svid_count(), 1u);
+    EXPECT_EQ(text(svid->svid(0).spiffe_id), "spiffe://example.org/workload/0");
+    EXPECT_EQ(svid->svid(0).x509_svid.size(), 2u);
+    EXPECT_FALSE(svid->svid(0).x509_svid_key.empty());
+    EXPECT_EQ(reader.x509_bundles()->bundles().size(), 1u);
+    StringView jwks;
+    EXPECT_TRUE(reader.jwt_bundles()->find("spiffe://example.org", jwks));
+
+    // Nothing new, the same snapshot
+    uint64_t generation = reader.x509_svid_generation();
+    EXPECT_EQ(reader.x509_svid(), svid);
+    EXPECT_EQ(reader.x509_svid_generation(), generation);
+    std::string first_certificate = text(svid->svid(0).x509_svid.der());
+
+    server.push_update();
+    ASSERT_TRUE(wait_until([&] { return reader.x509_svid() && reader.x509_svid_generation() > generation; }));
+    EXPECT_NE(text(reader.x509_svid()->svid(0).x509_svid.der()), first_certificate);
+    publisher.close();
+
+    // The region and the current file of each RPC, owner only
+    ASSERT_TRUE(wait_until([&] { return directory.files().size() == 4; }));
+    for (const std::string& file : directory.files()) {
+        EXPECT_EQ(directory.mode(file), 0600u) << file;
+    }
+}
+
+TEST(SharedSnapshotTest, ReadFromOtherProcesses) {
+    TempDirectory directory;
+    SharedSnapshotOptions options;
+    options.directory = directory.path;
+    options.name = "region";
+
+    // A reader may come first
+    SharedSnapshotReader reader(options);
+    EXPECT_EQ(reader.jwt_bundles(), nullptr);
+
+    SharedSnapshotPublisher publisher("/nonexistent/spiffe-cpp-snapshot.sock", options);
+    ASSERT_TRUE(publisher.open().is_ok());
+    JwtBundles bundles;
+    bundles.bundles["spiffe://example.org"] = "{\"keys\":[]}";
+    bundles.bundles["spiffe://a.org"] = "{\"keys\":[{}]}";
+    ASSERT_TRUE(publisher.publish(bundles).is_ok());
+
+    ASSERT_NE(reader.jwt_bundles(), nullptr);
+    EXPECT_EQ(reader.jwt_bundles()->trust_domain(0), StringView("spiffe://a.org"));
+    EXPECT_EQ(reader.jwt_bundles()->to_jwt_bundles().bundles, bundles.bundles);
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        SharedSnapshotReader other(options);
+        StringView jwks;
+        bool ok = other.jwt_bundles() && other.jwt_bundles()->size() == 2 &&
+                  other.jwt_bundles()->find("spiffe://example.org", jwks) && jwks == StringView("{\"keys\":[]}") &&
+                  !other.jwt_bundles()->find("spiffe://b.org", jwks) && other.x509_svid() == nullptr;
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+TEST(SharedSnapshotTest, OnePublisherPerRegion) {
+    TempDirectory directory;
+    SharedSnapshotOptions options;
+    options.directory = directory.path;
+    SharedSnapshotReader reader(options);
+
+    JwtBundles bundles;
+    bundles.bundles["spiffe://example.org"] = "first";
+    {
+        SharedSnapshotPublisher publisher("/nonexistent/spiffe-cpp-snapshot.sock", options);
+        ASSERT_TRUE(publisher.open().is_ok());
+        ASSERT_TRUE(publisher.publish(bundles).is_ok());
+
+        SharedSnapshotPublisher second("/nonexistent/spiffe-cpp-snapshot.sock", options);
+        EXPECT_EQ(second.open().code, 9);
+        EXPECT_EQ(second.publish(bundles).code, 9);
+    }
+
+    // Published files outlive the publisher, the next one continues the generations
+    ASSERT_NE(reader.jwt_bundles(), nullptr);
+    EXPECT_EQ(reader.jwt_bundles_generation(), 1u);
+
+    SharedSnapshotPublisher next("/nonexistent/spiffe-cpp-snapshot.sock", options);
+    ASSERT_TRUE(next.open().is_ok());
+    bundles.bundles["spiffe://example.org"] = "second";
+    ASSERT_TRUE(next.publish(bundles).is_ok());
+
+    StringView jwks;
+    ASSERT_TRUE(reader.jwt_bundles()->find("spiffe://example.org", jwks));
+    EXPECT_EQ(jwks, StringView("second"));
+    EXPECT_EQ(reader.jwt_bundles_generation(), 2u);
+}
+
+TEST(SharedSnapshotTest, RemovesStaleFiles) {
+    TempDirectory directory;
+    SharedSnapshotOptions options;
+    options.directory = directory.path;
+
+    JwtBundles bundles;
+    bundles.bundles["spiffe://example.org"] = "jwks";
+    {
+        SharedSnapshotPublisher publisher("/nonexistent/spiffe-cpp-snapshot.sock", options);
+        ASSERT_TRUE(publisher.open().is_ok());
+        ASSERT_TRUE(publisher.publish(bundles).is_ok());
+        ASSERT_TRUE(publisher.publish(bundles).is_ok());
+    }
+
+    // Left by publishers that died between writing and unlinking, and files of others
+    for (const char* file : {"spiffe.jwt_bundles.1", "spiffe.jwt_bundles.3", "spiffe.x509_svid.7",
+                             "spiffe.jwt_bundles.x", "other.jwt_bundles.1"}) {
+        int fd = open((directory.path + "/" + file).c_str(), O_WRONLY | O_CREAT, 0600);
+        ASSERT_GE(fd, 0);
+        close(fd);
+    }
+
+    SharedSnapshotPublisher next("/nonexistent/spiffe-cpp-snapshot.sock", options);
+    ASSERT_TRUE(next.open().is_ok());
+    std::vector<std::string> files = directory.files();
+    std::sort(files.begin(), files.end());
+    EXPECT_EQ(files, (std::vector<std::string>{"other.jwt_bundles.1", "spiffe", "spiffe.jwt_bundles.2",
+                                               "spiffe.jwt_bundles.x"}));
+}
+
+TEST(SharedSnapshotTest, RemapsReplacedRegion) {
+    TempDirectory directory;
+    SharedSnapshotOptions options;
+    options.directory = directory.path;
+    options.region_check_interval = std::chrono::milliseconds(0);
+    SharedSnapshotReader reader(options);
+
+    JwtBundles bundles;
+    bundles.bundles["spiffe://example.org"] = "first";
+    {
+        SharedSnapshotPublisher publisher("/nonexistent/spiffe-cpp-snapshot.sock", options);
+        ASSERT_TRUE(publisher.open().is_ok());
+        ASSERT_TRUE(publisher.publish(bundles).is_ok());
+    }
+    ASSERT_NE(reader.jwt_bundles(), nullptr);
+    EXPECT_EQ(reader.jwt_bundles_generation(), 1u);
+
+    // The directory cleared, the next publisher starts a new region from generation 1
+    for (const std::string& file : directory.files()) {
+        unlink((directory.path + "/" + file).c_str());
+    }
+    EXPECT_NE(reader.jwt_bundles(), nullptr);  // the old mapping is kept until then
+
+    SharedSnapshotPublisher next("/nonexistent/spiffe-cpp-snapshot.sock", options);
+    ASSERT_TRUE(next.open().is_ok());
+    bundles.bundles["spiffe://example.org"] = "second";
+    ASSERT_TRUE(next.publish(bundles).is_ok());
+
+    StringView jwks;
+    ASSERT_NE(reader.jwt_bundles(), nullptr);
+    ASSERT_TRUE(reader.jwt_bundles()->find("spiffe://example.org", jwks));
+    EXPECT_EQ(jwks, StringView("second"));
+    EXPECT_EQ(reader.jwt_bundles_generation(), 1u);
+}
+
+TEST(SharedSnapshotTest, RejectsUntrustedFiles) {
+    TempDirectory directory;
+    SharedSnapshotOptions options;
+    options.directory = directory.path;
+
+    SharedSnapshotPublisher publisher("/nonexistent/spiffe-cpp-snapshot.sock", options);
+    ASSERT_TRUE(publisher.open().is_ok());
+    JwtBundles bundles;
+    bundles.bundles["spiffe://example.org"] = "{\"keys\":[]}";
+    ASSERT_TRUE(publisher.publish(bundles).is_ok());
+    EXPECT_NE(SharedSnapshotReader(options).jwt_bundles(), nullptr);
+
+    // Files of another user
+    SharedSnapshotOptions other = options;
+    other.owner = geteuid() + 1;
+    EXPECT_EQ(SharedSnapshotReader(other).jwt_bundles(), nullptr);
+
+    // Files or a directory others could have replaced
+    std::string data = directory.path + "/spiffe.jwt_bundles.1";
+    ASSERT_EQ(chmod(data.c_str(), 0620), 0);
+    EXPECT_EQ(SharedSnapshotReader(options).jwt_bundles(), nullptr);
+    ASSERT_EQ(chmod(data.c_str(), 0600), 0);
+    EXPECT_NE(SharedSnapshotReader(options).jwt_bundles(), nullptr);
+
+    ASSERT_EQ(chmod(directory.path.c_str(), 0777), 0);
+    EXPECT_EQ(SharedSnapshotReader(options).jwt_bundles(), nullptr);
+    SharedSnapshotPublisher second("/nonexistent/spiffe-cpp-snapshot.sock", options);
+    publisher.close();
+    EXPECT_EQ(second.open().code, 9);
+    ASSERT_EQ(chmod(directory.path.c_str(), 0700), 0);
+}
+
+TEST(SharedSnapshotTest, RejectsOffsetsOutsideTheArena) {
+    mock::WorkloadApiServer server(test_socket_path());
+    ASSERT_TRUE(server.start());
+    TempDirectory directory;
+    SharedSnapshotOptions options;
+    options.directory = directory.path;
+
+    SharedSnapshotPublisher publisher(server.socket_path(), options);
+    ASSERT_TRUE(publisher.start().is_ok());
+    SharedSnapshotReader reader(options);
+    ASSERT_TRUE(wait_until([&] { return reader.x509_svid() && reader.jwt_bundles(); }));
+    publisher.close();
+
+    // The arena ends the file, each starts with its first record: a JWT bundle's trust domain
+    // offset, the SPIFFE ID offset of an SVID
+    std::string svid_path = directory.path + "/spiffe.x509_svid." + std::to_string(reader.x509_svid_generation());
+    std::string jwt_path = directory.path + "/spiffe.jwt_bundles." + std::to_string(reader.jwt_bundles_generation());
+    off_t svid_arena = file_size(svid_path) - static_cast<off_t>(reader.x509_svid()->arena_size());
+    const SharedJwtBundles& bundles = *reader.jwt_bundles();
+    off_t jwt_arena = file_size(jwt_path);
+    for (size_t i = 0; i < bundles.size(); ++i) {
+        jwt_arena -= static_cast<off_t>(sizeof(uint32_t) * 4 + bundles.trust_domain(i).size() + bundles.jwks(i).size());
+    }
+
+    ASSERT_TRUE(patch(svid_path, svid_arena, 0xfffffff0));
+    ASSERT_TRUE(patch(jwt_path, jwt_arena, 0xfffffff0));
+    SharedSnapshotReader forged(options);
+    EXPECT_EQ(forged.x509_svid(), nullptr);
+    EXPECT_EQ(forged.jwt_bundles(), nullptr);
+}
+
+}  // namespace spiffe
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <spiffe/spiffe_id_matcher.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Authorizing a peer against an allowlist of state.range(0) exact IDs and prefixes: comparing
+// the ID with every rule in turn, then with the compiled matcher. The peer matches the last rule.
+
+namespace spiffe {
+
+namespace {
+
+std::vector<std::string> allowlist(int64_t size) {
+    std::vector<std::string> rules;
+    for (int64_t i = 0; i < size; ++i) {
+        rules.push_back("spiffe://example.org/ns/ns" + std::to_string(i) + (i % 2 ? "/sa/web" : "/**"));
+    }
+    return rules;
+}
+
+const char* PEER = "spiffe://example.org/ns/ns%lld/sa/web";
+
+std::string peer(int64_t size) {
+    char id[64];
+    snprintf(id, sizeof(id), PEER, static_cast<long long>(size - 1));
+    return id;
+}
+
+}  // namespace
+
+static void BM_AuthorizeLinear(benchmark::State& state) {
+    std::vector<std::string> rules = allowlist(state.range(0));
+    std::string id = peer(state.range(0));
+
+    for (auto _ : state) {
+        bool allowed = false;
+        for (const std::string& rule : rules) {
+            size_t prefix = rule.size() - 2;
+            if (rule.compare(prefix, 2, "**") == 0 ? id.compare(0, prefix, rule, 0, prefix) == 0 : id == rule) {
+                allowed = true;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(allowed);
+    }
+}
+BENCHMARK(BM_AuthorizeLinear)->Arg(10)->Arg(1000);
+
+static void BM_AuthorizeCompiled(benchmark::State& state) {
+    SpiffeIdMatcher matcher;
+    SpiffeIdMatcher::compile(allowlist(state.range(0)), matcher);
+    std::string id = peer(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matcher.matches(id));
+    }
+}
+BENCHMARK(BM_AuthorizeCompiled)->Arg(10)->Arg(1000);
+
+}  // namespace spiffe
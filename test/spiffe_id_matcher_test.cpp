@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <spiffe/spiffe_id_matcher.h>
+
+#include <string>
+#include <vector>
+
+namespace spiffe {
+
+TEST(SpiffeIdMatcherTest, MatchesRules) {
+    SpiffeIdMatcher matcher;
+    ASSERT_TRUE(SpiffeIdMatcher::compile(
+                    {
+                        "spiffe://example.org/web",
+                        "spiffe://example.org/ns/*/sa/api",
+                        "spiffe://example.org/ns/prod/**",
+                        "spiffe://federated.org/**",
+                        "spiffe://other.org",
+                    },
+                    matcher)
+                    .is_ok());
+    EXPECT_EQ(matcher.size(), 5u);
+
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/web"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/web/1"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/we"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org"));
+
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/ns/dev/sa/api"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/ns/dev/sa/db"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/ns/sa/api"));
+
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/ns/prod"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/ns/prod/sa/db"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/ns/production"));
+
+    EXPECT_TRUE(matcher.matches("spiffe://federated.org"));
+    EXPECT_TRUE(matcher.matches("spiffe://federated.org/any/workload"));
+
+    EXPECT_TRUE(matcher.matches("spiffe://other.org"));
+    EXPECT_FALSE(matcher.matches("spiffe://other.org/web"));
+
+    EXPECT_FALSE(matcher.matches("spiffe://unknown.org/web"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/web/"));
+    EXPECT_FALSE(matcher.matches("not a spiffe id"));
+
+    SpiffeId id;
+    ASSERT_TRUE(SpiffeId::parse("spiffe://example.org/ns/prod/x", id));
+    EXPECT_TRUE(matcher.matches(id));
+}
+
+TEST(SpiffeIdMatcherTest, OverlappingWildcards) {
+    // A literal segment may take the literal and the wildcard branch at once
+    SpiffeIdMatcher matcher;
+    ASSERT_TRUE(SpiffeIdMatcher::compile(
+                    {
+                        "spiffe://example.org/*/b/c",
+                        "spiffe://example.org/a/*/d",
+                        "spiffe://example.org/a/b/e/**",
+                        "spiffe://example.org/*/*",
+                    },
+                    matcher)
+                    .is_ok());
+
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/a/b/c"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/a/b/d"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/a/b/e"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/a/b/e/f/g"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/x/b/c"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/a/b"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/x/y"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/x/b/d"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/a/b/f"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/a"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org"));
+}
+
+TEST(SpiffeIdMatcherTest, ScalesWithIdNotRules) {
+    std::vector<std::string> rules;
+    for (int i = 0; i < 1000; ++i) {
+        rules.push_back("spiffe://example.org/ns/ns" + std::to_string(i) + "/sa/web");
+    }
+    rules.push_back("spiffe://example.org/ns/*/sa/api");
+
+    SpiffeIdMatcher matcher;
+    ASSERT_TRUE(SpiffeIdMatcher::compile(rules, matcher).is_ok());
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/ns/ns999/sa/web"));
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/ns/ns999/sa/api"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/ns/ns1000/sa/web"));
+
+    // The wildcard branch is shared, not copied into every namespace
+    EXPECT_LT(matcher.node_count(), 4u * 1000 + 10);
+}
+
+TEST(SpiffeIdMatcherTest, RejectsInvalidRules) {
+    SpiffeIdMatcher matcher;
+    ASSERT_TRUE(SpiffeIdMatcher::compile({"spiffe://example.org/web"}, matcher).is_ok());
+
+    const char* invalid[] = {
+        "",
+        "example.org/web",
+        "spiffe://Example.org/web",
+        "spiffe://*/web",
+        "spiffe://example.org/web/",
+        "spiffe://example.org/web*",
+        "spiffe://example.org/**/web",
+        "spiffe://example.org/***",
+        "spiffe://example.org/../web",
+    };
+    for (const char* rule : invalid) {
+        Status status = SpiffeIdMatcher::compile({"spiffe://example.org/api", rule}, matcher);
+        EXPECT_EQ(status.code, 3) << rule;
+        EXPECT_NE(status.message.find(rule), std::string::npos) << rule;
+    }
+
+    // Left unchanged
+    EXPECT_TRUE(matcher.matches("spiffe://example.org/web"));
+    EXPECT_FALSE(matcher.matches("spiffe://example.org/api"));
+}
+
+TEST(SpiffeIdAuthorizerTest, ReloadsAtomically) {
+    SpiffeIdAuthorizer authorizer;
+    EXPECT_FALSE(authorizer.authorized("spiffe://example.org/web"));
+
+    ASSERT_TRUE(authorizer.reload({"spiffe://example.org/web"}).is_ok());
+    EXPECT_TRUE(authorizer.authorized("spiffe://example.org/web"));
+    std::shared_ptr<const SpiffeIdMatcher> held = authorizer.matcher();
+
+    ASSERT_TRUE(authorizer.reload({"spiffe://example.org/api"}).is_ok());
+    EXPECT_FALSE(authorizer.authorized("spiffe://example.org/web"));
+    EXPECT_TRUE(authorizer.authorized("spiffe://example.org/api"));
+
+    // A held matcher keeps the policy it was compiled from
+    EXPECT_TRUE(held->matches("spiffe://example.org/web"));
+
+    // An invalid policy is not loaded
+    EXPECT_EQ(authorizer.reload({"spiffe://example.org/**/web"}).code, 3);
+    EXPECT_TRUE(authorizer.authorized("spiffe://example.org/api"));
+}
+
+}  // namespace spiffe
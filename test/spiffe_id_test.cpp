@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <spiffe/jwt_bundle_index.h>
+#include <spiffe/spiffe_id.h>
+#include <spiffe/x509_bundle_index.h>
+
+#include <string>
+
+namespace spiffe {
+
+TEST(SpiffeIdTest, ParsesValidIds) {
+    std::string text = "spiffe://example.org/ns/default/sa/web-1_a.b";
+    SpiffeId id;
+    ASSERT_TRUE(SpiffeId::parse(text, id));
+    EXPECT_EQ(id.str(), StringView(text));
+    EXPECT_EQ(id.trust_domain_name(), StringView("example.org"));
+    EXPECT_EQ(id.trust_domain_id(), StringView("spiffe://example.org"));
+    EXPECT_EQ(id.path(), StringView("/ns/default/sa/web-1_a.b"));
+
+    // Views into the input
+    EXPECT_EQ(id.trust_domain_name().data(), text.data() + 9);
+
+    ASSERT_TRUE(SpiffeId::parse("spiffe://td-1_x.io", id));
+    EXPECT_TRUE(id.path().empty());
+    EXPECT_TRUE(SpiffeId::parse("spiffe://a/.../..a/a..", id));
+    EXPECT_TRUE(SpiffeId::parse("spiffe://" + std::string(255, 'a'), id));
+}
+
+TEST(SpiffeIdTest, RejectsInvalidIds) {
+    const char* invalid[] = {
+        "",
+        "spiffe://",
+        "spiffe:///path",
+        "SPIFFE://example.org",
+        "https://example.org/path",
+        "spiffe:/example.org",
+        "spiffe://Example.org",
+        "spiffe://example.org:8080",
+        "spiffe://user@example.org",
+        "spiffe://example.org/",
+        "spiffe://example.org//a",
+        "spiffe://example.org/a/",
+        "spiffe://example.org/./a",
+        "spiffe://example.org/a/..",
+        "spiffe://example.org/a%20b",
+        "spiffe://example.org/a?b",
+        "spiffe://example.org/a#b",
+        "spiffe://example.org/a b",
+    };
+    for (const char* text : invalid) {
+        SpiffeId id;
+        EXPECT_FALSE(SpiffeId::parse(text, id)) << text;
+        EXPECT_TRUE(id.str().empty()) << text;
+    }
+
+    SpiffeId id;
+    EXPECT_FALSE(SpiffeId::parse("spiffe://" + std::string(256, 'a'), id));
+    EXPECT_FALSE(SpiffeId::parse("spiffe://a/" + std::string(2048, 'a'), id));
+    EXPECT_FALSE(SpiffeId::parse(StringView("spiffe://a\0b", 12), id));
+}
+
+TEST(SpiffeIdTest, InternsTrustDomains) {
+    EXPECT_TRUE(InternedTrustDomain::find("never-interned.org").is_null());
+    EXPECT_TRUE(InternedTrustDomain::intern("Not Valid").is_null());
+
+    InternedTrustDomain first = InternedTrustDomain::intern("interned.org");
+    ASSERT_FALSE(first.is_null());
+    EXPECT_EQ(first.name(), StringView("interned.org"));
+    EXPECT_EQ(first.id(), StringView("spiffe://interned.org"));
+
+    // One instance per name
+    std::string name = "interned.org";
+    EXPECT_EQ(InternedTrustDomain::intern(name), first);
+    EXPECT_EQ(InternedTrustDomain::find(name), first);
+    EXPECT_NE(InternedTrustDomain::intern("other-interned.org"), first);
+    EXPECT_EQ(InternedTrustDomainHash()(first), InternedTrustDomainHash()(InternedTrustDomain::find(name)));
+
+    SpiffeId id;
+    ASSERT_TRUE(SpiffeId::parse("spiffe://interned.org/workload", id));
+    EXPECT_EQ(id.trust_domain(), first);
+}
+
+TEST(SpiffeIdTest, BundleSetsIndexInternedTrustDomains) {
+    X509BundleIndexSet x509;
+    x509.set("spiffe://x509-interned.org", X509Bundle(), nullptr);
+    x509.set("not a trust domain", X509Bundle(), nullptr);
+
+    SpiffeId id;
+    ASSERT_TRUE(SpiffeId::parse("spiffe://x509-interned.org/workload", id));
+    ASSERT_FALSE(id.trust_domain().is_null());
+    EXPECT_EQ(x509.get(id.trust_domain()), x509.get("spiffe://x509-interned.org"));
+    EXPECT_EQ(x509.get(InternedTrustDomain::intern("elsewhere.org")), nullptr);
+
+    JwtBundles bundles;
+    bundles.bundles["spiffe://jwt-interned.org"] = "{\"keys\":[]}";
+    JwtBundleIndexSet jwt(bundles);
+    ASSERT_NE(jwt.get(InternedTrustDomain::find("jwt-interned.org")), nullptr);
+    EXPECT_EQ(jwt.get(InternedTrustDomain::find("jwt-interned.org")), jwt.get("spiffe://jwt-interned.org"));
+}
+
+}  // namespace spiffe
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <spiffe/spiffe.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "mock/workload_api_server.h"
+#include "stream_retry.h"
+
+namespace spiffe {
+
+namespace {
+
+std::string test_socket_path() { return "/tmp/spiffe-cpp-retry-" + std::to_string(getpid()) + ".sock"; }
+
+StreamRetryOptions fast_retry() {
+    StreamRetryOptions options;
+    options.enabled = true;
+    options.initial_backoff = std::chrono::milliseconds(10);
+    options.max_backoff = std::chrono::milliseconds(40);
+    return options;
+}
+
+}  // namespace
+
+TEST(StreamBackoffTest, GrowsWithJitterUpToMax) {
+    StreamRetryOptions options;
+    options.initial_backoff = std::chrono::milliseconds(100);
+    options.max_backoff = std::chrono::milliseconds(1000);
+    options.multiplier = 2.0;
+    options.jitter = 0.5;
+    StreamBackoff backoff(options, 42);
+
+    int64_t ceilings[] = {100, 200, 400, 800, 1000, 1000};
+    for (int64_t ceiling : ceilings) {
+        std::chrono::milliseconds delay = backoff.next();
+        EXPECT_GE(delay.count(), ceiling / 2);
+        EXPECT_LE(delay.count(), ceiling);
+    }
+    EXPECT_EQ(backoff.attempts(), 6u);
+
+    backoff.reset();
+    EXPECT_EQ(backoff.attempts(), 0u);
+    EXPECT_LE(backoff.next().count(), 100);
+}
+
+TEST(StreamBackoffTest, SpreadsClientsApart) {
+    StreamRetryOptions options;
+    StreamBackoff first(options, 1);
+    StreamBackoff second(options, 2);
+    EXPECT_NE(first.next(), second.next());
+
+    options.jitter = 0;
+    StreamBackoff fixed(options, 1);
+    EXPECT_EQ(fixed.next(), options.initial_backoff);
+}
+
+TEST(StreamBackoffTest, RetryableCodes) {
+    EXPECT_TRUE(stream_retryable(0));    // stream ended by the agent
+    EXPECT_TRUE(stream_retryable(13));   // connection lost
+    EXPECT_TRUE(stream_retryable(14));   // UNAVAILABLE
+    EXPECT_FALSE(stream_retryable(1));   // CANCELLED
+    EXPECT_FALSE(stream_retryable(3));   // INVALID_ARGUMENT
+}
+
+TEST(StreamBackoffTest, SleepWakesOnCancel) {
+    CancellationSource source;
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        source.cancel();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(sleep_unless_cancelled(source.token(), std::chrono::seconds(30)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    canceller.join();
+
+    EXPECT_TRUE(sleep_unless_cancelled(CancellationToken(), std::chrono::milliseconds(1)));
+}
+
+TEST(StreamRetryTest, ReconnectsAndSkipsUnchangedUpdate) {
+    mock::WorkloadApiServerOptions options;
+    options.error_code = 14;  // UNAVAILABLE after the first update, like an agent going away
+    options.error_after_messages = 1;
+    mock::WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    ClientOptions client_options;
+    client_options.stream_retry = fast_retry();
+    WorkloadApiClient client(server.socket_path(), client_options);
+
+    CancellationSource cancellation;
+    int updates = 0;
+    Status status;
+    std::thread stream([&] {
+        status = client.fetch_x509_svid(
+            [&](const X509SvidContext&) {
+                if (++updates == 1) {
+                    server.set_options(mock::WorkloadApiServerOptions());
+                } else {
+                    cancellation.cancel();
+                }
+                return Status{};
+            },
+            cancellation.token());
+    });
+
+    // The reconnected stream starts with the same update, which is not delivered again
+    ASSERT_TRUE(server.wait_for_streams(1, std::chrono::seconds(5)));
+    while (server.requests() < 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(updates, 1);
+
+    server.push_update();
+    stream.join();
+    EXPECT_EQ(updates, 2);
+    EXPECT_EQ(status.code, 1);  // CANCELLED
+}
+
+TEST(StreamRetryTest, WatchKeepsContextAcrossReconnects) {
+    mock::WorkloadApiServerOptions options;
+    options.error_code = 14;
+    options.error_after_messages = 1;
+    mock::WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    ClientOptions client_options;
+    client_options.stream_retry = fast_retry();
+    client_options.stream_retry.max_attempts = 2;
+    WorkloadApiClient client(server.socket_path(), client_options);
+
+    // The agent restarts after every update and replays it. Each attempt got an update, so the
+    // stream outlasts max_attempts, and the callback receives the update once.
+    CancellationSource cancellation;
+    int updates = 0;
+    Status status;
+    std::thread stream([&] {
+        status = client.watch_jwt_bundles([&](const JwtBundles&, const JwtBundlesDelta&) { return ++updates, Status{}; },
+                                          cancellation.token());
+    });
+    while (server.requests() < 5) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    cancellation.cancel();
+    stream.join();
+    EXPECT_EQ(status.code, 1);  // CANCELLED
+    EXPECT_EQ(updates, 1);
+}
+
+TEST(StreamRetryTest, GivesUpWithoutUpdates) {
+    mock::WorkloadApiServerOptions options;
+    options.error_code = 14;
+    mock::WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    ClientOptions client_options;
+    client_options.stream_retry = fast_retry();
+    client_options.stream_retry.max_attempts = 3;
+    WorkloadApiClient client(server.socket_path(), client_options);
+
+    // Every reconnect fails before an update, until the attempts run out
+    int updates = 0;
+    Status status = client.watch_jwt_bundles(
+        [&](const JwtBundles&, const JwtBundlesDelta&) { return ++updates, Status{}; }, CancellationToken());
+    EXPECT_EQ(status.code, 14);
+    EXPECT_EQ(updates, 0);
+    EXPECT_EQ(server.requests(), 4u);
+}
+
+TEST(StreamRetryTest, CallbackErrorIsFinal) {
+    mock::WorkloadApiServer server(test_socket_path());
+    ASSERT_TRUE(server.start());
+
+    ClientOptions client_options;
+    client_options.stream_retry = fast_retry();
+    WorkloadApiClient client(server.socket_path(), client_options);
+
+    Status status = client.fetch_jwt_bundles(
+        [](const JwtBundles&) { return Status{.code = 9, .message = "stop"}; }, CancellationToken());
+    EXPECT_EQ(status.code, 9);
+    EXPECT_EQ(server.requests(), 1u);
+}
+
+TEST(StreamRetryTest, DisabledByDefault) {
+    mock::WorkloadApiServerOptions options;
+    options.error_code = 14;
+    mock::WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+    Status status = client.fetch_jwt_bundles([](const JwtBundles&) { return Status{}; }, CancellationToken());
+    EXPECT_EQ(status.code, 14);
+    EXPECT_EQ(server.requests(), 1u);
+}
+
+}  // namespace spiffe
@@ -0,0 +1,64 @@
+#pragma once
+
+// JWT-SVIDs for validation tests, signed with OpenSSL 3. JWKS holds an EC P-256 key "ec-key"
+// and an RSA 2048 key "rsa-key", both "use": "jwt-svid", and the EC key again as "x509" with
+// "use": "x509-svid". Every token has "sub" spiffe://example.org/workload, "exp" 1900000000
+// (2030-03-17) and "aud" ingress, unless noted.
+
+namespace spiffe {
+namespace testdata {
+
+static const char JWKS[] =
+    "{\"keys\":[{\"kty\":\"EC\",\"kid\":\"ec-key\",\"use\":\"jwt-svid\",\"crv\":\"P-256\",\"x\":\"fbvcjzWSENq6m8mS"
+    "8bSDnREPpSRcWJCVjNDTlUjSMI0\",\"y\":\"FrgS5sOaut-glqC9_jQGoxIs9MutDHXAesF6aGaQp4w\"},{\"kty\":\""
+    "RSA\",\"kid\":\"rsa-key\",\"use\":\"jwt-svid\",\"n\":\"o1rS4TvvAf52yYuvHdU2_QXlaVti_rPXVQ6OjZiL2tU36"
+    "N-fAy04jC5qqDTZ3bsVkHZAAa4XoBHLUoIpgu0NNFeih-F7BfafujWBNoQeZoN1veVHfI8BObu3vRSc3SSHKc1I_"
+    "mrIKzZLiis3hpxwNJCqNzgazZkcxsIP4ohaBD_j-Pc8hRPv2CIqdGhPgdiFSl6-RBNo67muTwB_H11qnjYb5Cumn"
+    "V7cmllnE3M6fN3TCTYxFMmf_ogmtZ4P0MHRh22C7e39XFNNisNwnfEpIqD-3d6Fhcp3AoSQxk_jiLTM_hfoq69BG"
+    "FgmqKAZKZik3gVJjXlrFu-Hp2aJe4P09w\",\"e\":\"AQAB\"},{\"kty\":\"EC\",\"kid\":\"x509\",\"use\":\"x509-svid"
+    "\",\"crv\":\"P-256\",\"x\":\"fbvcjzWSENq6m8mS8bSDnREPpSRcWJCVjNDTlUjSMI0\",\"y\":\"FrgS5sOaut-glqC9_"
+    "jQGoxIs9MutDHXAesF6aGaQp4w\"}]}";
+
+// "aud": ["ingress", "other"]
+static const char ES256_TOKEN[] =
+    "eyJhbGciOiJFUzI1NiIsImtpZCI6ImVjLWtleSIsInR5cCI6IkpXVCJ9.eyJzdWIiOiJzcGlmZmU6Ly9leGFtcGx"
+    "lLm9yZy93b3JrbG9hZCIsImF1ZCI6WyJpbmdyZXNzIiwib3RoZXIiXSwiZXhwIjoxOTAwMDAwMDAwLCJpYXQiOjE"
+    "3OTAwMDAwMDB9.zD2CrOdupVDOrGaV0lfIkop3lexcSj3A57nwlmBt-ynqiAu5vkLls-ed9RhVVsR8uVYeLpYjkB"
+    "ajEPL6efK2uQ";
+
+static const char RS256_TOKEN[] =
+    "eyJhbGciOiJSUzI1NiIsImtpZCI6InJzYS1rZXkiLCJ0eXAiOiJKV1QifQ.eyJzdWIiOiJzcGlmZmU6Ly9leGFtc"
+    "GxlLm9yZy93b3JrbG9hZCIsImF1ZCI6ImluZ3Jlc3MiLCJleHAiOjE5MDAwMDAwMDB9.hEnzDxPgi6qNkHx6OBVI"
+    "kgaBbAvo1pIrhohlc9pqYWK58AdhtS62R8KuY3GmZs6JGyc_Rn-rTqMCmxIZ4L-uc3PPX1mqiXtoAJLbef0XWqKL"
+    "FZ-JzSZfiYSoGUR4zotTtMB4l-dimozLs4gg8MeYMF-MEJnNBMa0SOJhXqqy3JKIngLaAxqgML7eARJX_fYHaqLm"
+    "VM35X2VYvOP__GlWe-Fs0W156negIDIm1u0xV5mwS4mnOAbk9QUCAsVHaleJzPtdfnN8WKhur9ZAvLUDBXcGoxqi"
+    "QRT6qN7vxEKe1q7pG5rAiUcRrDahMNSw23dZUhg9p9VWcnE-FI6t7Uzc4w";
+
+static const char PS256_TOKEN[] =
+    "eyJhbGciOiJQUzI1NiIsImtpZCI6InJzYS1rZXkiLCJ0eXAiOiJKV1QifQ.eyJzdWIiOiJzcGlmZmU6Ly9leGFtc"
+    "GxlLm9yZy93b3JrbG9hZCIsImF1ZCI6ImluZ3Jlc3MiLCJleHAiOjE5MDAwMDAwMDB9.JHh30LAWfwGEQC8CoQuX"
+    "vv5kQiH0V0llIAqKv9GmlYJ6qJK2cyulZK2oJUwbxctcBo93yOq4tuLXqQtbiKr8kE8JOUNogoBeuDJ9gIbIN03T"
+    "1xiZMr9uYOH9aNQfSZ1coqX8nVy6bsNZj7fznlPIpHaWGRwj71b--bQlkBw36RXnBLbYx2NZH-GX-NqgYR9Wn9lV"
+    "VJexkqfS81GclN3Xy9j_zI4emqaz_6VjqTdEAvXFiLBxRjs9lEBLU1BLaGjkfUbxswm3ZViSNYEWDsvA71BoRHi9"
+    "qxClIDcVkwUoC7uI6qf5S_wwpKZ-48gRoo-zCqcsBPkzIWEDKDVb7A7Zaw";
+
+// Signed by the key whose "use" is x509-svid
+static const char X509_KEY_TOKEN[] =
+    "eyJhbGciOiJFUzI1NiIsImtpZCI6Ing1MDkiLCJ0eXAiOiJKV1QifQ.eyJzdWIiOiJzcGlmZmU6Ly9leGFtcGxlL"
+    "m9yZy93b3JrbG9hZCIsImF1ZCI6ImluZ3Jlc3MiLCJleHAiOjE5MDAwMDAwMDB9.8KzX3DFuEgBd-4Z4Kn9VAgns"
+    "MRVrmDgsdWulgs3orNArd4uWIEVmfBpo4STVbRM4kqX-qBdosht6ZRIS8znncg";
+
+// "sub" https://example.org/workload
+static const char HTTPS_SUB_TOKEN[] =
+    "eyJhbGciOiJFUzI1NiIsImtpZCI6ImVjLWtleSIsInR5cCI6IkpXVCJ9.eyJzdWIiOiJodHRwczovL2V4YW1wbGU"
+    "ub3JnL3dvcmtsb2FkIiwiYXVkIjoiaW5ncmVzcyIsImV4cCI6MTkwMDAwMDAwMH0.fyFgDyoRLHjAjzv8WsAmLtS"
+    "GIk2NUZQdamIISwcJSRg8XC6DGHOP2jxZkD1wFzseFKoWgfZtIn5jEGXOC3xaNg";
+
+// Without "exp"
+static const char NO_EXP_TOKEN[] =
+    "eyJhbGciOiJFUzI1NiIsImtpZCI6ImVjLWtleSIsInR5cCI6IkpXVCJ9.eyJzdWIiOiJzcGlmZmU6Ly9leGFtcGx"
+    "lLm9yZy93b3JrbG9hZCIsImF1ZCI6ImluZ3Jlc3MifQ.IAvr_KCjYtNzEpGpOmyFzNs4qtOLj7KQe9IPSmVA9T-K"
+    "cBRXnXYhLGmYs6y0vfHzYaRFi3peoV_OIqK9MWcZhA";
+
+}  // namespace testdata
+}  // namespace spiffe
@@ -0,0 +1,853 @@
+#pragma once
+
+#include <spiffe/types.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+// Real certificates for parsing tests, EC P-256, generated with OpenSSL 3:
+//
+// CA:   O=SPIFFE, CN=example.org CA, serial 1, URI SAN spiffe://example.org, CA:TRUE, SKI,
+//       valid 2026-10-16 22:58:30 (UTCTime) to 2126-09-22 22:58:30 (GeneralizedTime)
+// Leaf: O=SPIFFE, serial 0x1234567890abcdef, URI SAN spiffe://example.org/workload, CA:FALSE,
+//       SKI, AKI of the CA, valid 2026-10-16 22:58:30 to 2081-07-19 22:58:30, signed by the CA
+//
+// For verification, all leaves CA:FALSE with SKI and AKI:
+// Intermediate: O=SPIFFE, CN=example.org intermediate, serial 0x1000, CA:TRUE, signed by the CA,
+//       valid 2026-10-16 to 2126-01-01
+// Chained leaf: serial 0x1001, URI SAN spiffe://example.org/chained, signed by the
+//       intermediate, valid 2026-10-16 to 2081-01-01
+// Expired leaf: serial 0x1002, spiffe://example.org/expired, signed by the CA, valid 2020-01-01
+//       to 2021-01-01
+// Forged leaf: serial 0x1003, spiffe://example.org/forged, issuer name of the CA but signed by
+//       another key with the same name
+// Revoked leaf: serial 0x1004, spiffe://example.org/revoked, signed by the CA
+// CRL: issued by the CA, revokes serial 0x1004
+
+namespace spiffe {
+namespace testdata {
+
+static const uint8_t CA_DER[] = {
+    0x30, 0x82, 0x01, 0xcb, 0x30, 0x82, 0x01, 0x71, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x01,
+    0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x2a, 0x31, 0x0f,
+    0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x31,
+    0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c,
+    0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30,
+    0x31, 0x36, 0x32, 0x32, 0x35, 0x38, 0x33, 0x30, 0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30,
+    0x39, 0x32, 0x32, 0x32, 0x32, 0x35, 0x38, 0x33, 0x30, 0x5a, 0x30, 0x2a, 0x31, 0x0f, 0x30, 0x0d,
+    0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x17, 0x30,
+    0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e,
+    0x6f, 0x72, 0x67, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce,
+    0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00,
+    0x04, 0x27, 0x0f, 0x08, 0x3c, 0xc0, 0x69, 0xf2, 0x4b, 0x90, 0xdc, 0xf3, 0x42, 0xe0, 0x67, 0x5c,
+    0xb3, 0x7c, 0xf4, 0x54, 0x1e, 0xdb, 0x08, 0x4f, 0xeb, 0x5f, 0x19, 0xad, 0x8e, 0x5f, 0xe6, 0x84,
+    0xa7, 0xc3, 0xc3, 0xb0, 0x1d, 0x43, 0xac, 0xc9, 0xd5, 0xf8, 0x32, 0x3b, 0xda, 0xd0, 0x96, 0xfb,
+    0xa3, 0xe2, 0xa0, 0x29, 0x0c, 0x22, 0x0a, 0xfa, 0x68, 0x98, 0x65, 0x16, 0xb6, 0x76, 0x58, 0x72,
+    0x85, 0xa3, 0x81, 0x85, 0x30, 0x81, 0x82, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18,
+    0x30, 0x16, 0x80, 0x14, 0xd5, 0x17, 0xe2, 0x2c, 0x9c, 0xcb, 0xaa, 0x87, 0x3a, 0xf6, 0x50, 0xb0,
+    0x4d, 0x21, 0x76, 0x50, 0x2b, 0xc4, 0x39, 0x03, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01,
+    0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f,
+    0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x11,
+    0x04, 0x18, 0x30, 0x16, 0x86, 0x14, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65,
+    0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d,
+    0x0e, 0x04, 0x16, 0x04, 0x14, 0xd5, 0x17, 0xe2, 0x2c, 0x9c, 0xcb, 0xaa, 0x87, 0x3a, 0xf6, 0x50,
+    0xb0, 0x4d, 0x21, 0x76, 0x50, 0x2b, 0xc4, 0x39, 0x03, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48,
+    0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x74, 0xe9, 0xf4, 0x05,
+    0xc7, 0xc6, 0x7b, 0xcb, 0xac, 0x79, 0xed, 0xbb, 0x19, 0x4b, 0x7b, 0x25, 0xb9, 0x7e, 0x8c, 0xce,
+    0x98, 0xdb, 0xf3, 0x01, 0x5d, 0x75, 0xb6, 0x11, 0x6d, 0x7f, 0xab, 0x81, 0x02, 0x21, 0x00, 0x84,
+    0xd7, 0x97, 0xcc, 0x55, 0x55, 0x00, 0xa3, 0x18, 0xfe, 0xe9, 0x12, 0x44, 0x93, 0xf6, 0xb0, 0xa8,
+    0x55, 0xe8, 0x78, 0x46, 0x7c, 0x95, 0x30, 0xcf, 0x56, 0x6a, 0xda, 0x41, 0x00, 0x7d, 0xff,
+};
+
+static const uint8_t LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xbf, 0x30, 0x82, 0x01, 0x65, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x08, 0x12,
+    0x34, 0x56, 0x78, 0x90, 0xab, 0xcd, 0xef, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x04, 0x03, 0x02, 0x30, 0x2a, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06,
+    0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c,
+    0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x43, 0x41, 0x30,
+    0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x36, 0x32, 0x32, 0x35, 0x38, 0x33, 0x30, 0x5a,
+    0x18, 0x0f, 0x32, 0x30, 0x38, 0x31, 0x30, 0x37, 0x31, 0x39, 0x32, 0x32, 0x35, 0x38, 0x33, 0x30,
+    0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50,
+    0x49, 0x46, 0x46, 0x45, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02,
+    0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x76,
+    0x3c, 0x5a, 0x0f, 0x71, 0xf8, 0xde, 0xd0, 0xdb, 0xb6, 0x6f, 0xab, 0x2a, 0x39, 0xfb, 0x0d, 0xb6,
+    0x5d, 0x8d, 0xe9, 0x9c, 0x6d, 0x95, 0x25, 0xcd, 0x23, 0xe8, 0x0e, 0x02, 0x71, 0x1e, 0xa5, 0x91,
+    0x36, 0x97, 0x30, 0xc7, 0x57, 0xf0, 0x91, 0xab, 0x70, 0x40, 0xff, 0x2d, 0x5b, 0x95, 0x51, 0x4a,
+    0x46, 0x5c, 0xf1, 0x12, 0xea, 0x59, 0x07, 0x1a, 0x72, 0x45, 0x9a, 0xb6, 0x10, 0x1c, 0xc4, 0xa3,
+    0x81, 0x8b, 0x30, 0x81, 0x88, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04,
+    0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03,
+    0x02, 0x07, 0x80, 0x30, 0x28, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x21, 0x30, 0x1f, 0x86, 0x1d,
+    0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65,
+    0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x77, 0x6f, 0x72, 0x6b, 0x6c, 0x6f, 0x61, 0x64, 0x30, 0x1d, 0x06,
+    0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xef, 0xc1, 0x52, 0x83, 0x41, 0xad, 0x83, 0x37,
+    0xbb, 0xdb, 0x55, 0x99, 0x03, 0xde, 0xdf, 0x7c, 0xdf, 0x86, 0x5b, 0xa8, 0x30, 0x1f, 0x06, 0x03,
+    0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0xd5, 0x17, 0xe2, 0x2c, 0x9c, 0xcb, 0xaa,
+    0x87, 0x3a, 0xf6, 0x50, 0xb0, 0x4d, 0x21, 0x76, 0x50, 0x2b, 0xc4, 0x39, 0x03, 0x30, 0x0a, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20,
+    0x7b, 0xb8, 0x28, 0x5c, 0x76, 0x39, 0x41, 0x35, 0x60, 0x13, 0x42, 0xf4, 0xf7, 0x95, 0x7c, 0x42,
+    0x69, 0x8d, 0xf6, 0x01, 0xd8, 0x88, 0xc7, 0xcd, 0x45, 0xd0, 0xe7, 0x5b, 0xb6, 0x55, 0x43, 0xa8,
+    0x02, 0x21, 0x00, 0x9a, 0x1c, 0xe3, 0x08, 0xd1, 0xa8, 0x03, 0x5e, 0x21, 0xc7, 0x0b, 0x00, 0x79,
+    0x5c, 0x2f, 0x3e, 0x8d, 0x7d, 0xb2, 0xe4, 0x56, 0x86, 0xd0, 0x47, 0xe0, 0xc7, 0xc8, 0x99, 0xc4,
+    0x3a, 0xba, 0xf0,
+};
+
+static const uint8_t INTERMEDIATE_DER[] = {
+    0x30, 0x82, 0x01, 0xd6, 0x30, 0x82, 0x01, 0x7c, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x10,
+    0x00, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x2a, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31,
+    0x30, 0x31, 0x36, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36,
+    0x30, 0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x30, 0x34, 0x31, 0x0f, 0x30,
+    0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x21,
+    0x30, 0x1f, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x18, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65,
+    0x2e, 0x6f, 0x72, 0x67, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74,
+    0x65, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08,
+    0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x5f, 0xe1, 0x8c, 0xa9,
+    0xa7, 0xcf, 0xa0, 0x73, 0xc0, 0xef, 0x71, 0x64, 0xa7, 0x14, 0x3c, 0xc7, 0xe4, 0x98, 0x25, 0x79,
+    0x9c, 0xbd, 0x13, 0xd8, 0x0c, 0xdd, 0xe4, 0xfb, 0xb4, 0x8d, 0x14, 0xe1, 0xdb, 0xa9, 0x80, 0xe9,
+    0x84, 0x9a, 0x31, 0x94, 0x80, 0x92, 0x02, 0x2c, 0xfa, 0x86, 0xed, 0xaf, 0xd1, 0xff, 0x70, 0xbf,
+    0xe0, 0x01, 0xcd, 0x7e, 0x40, 0x50, 0x9e, 0x81, 0xfc, 0x47, 0x25, 0x96, 0xa3, 0x81, 0x85, 0x30,
+    0x81, 0x82, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03,
+    0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03,
+    0x02, 0x01, 0x06, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x18, 0x30, 0x16, 0x86, 0x14,
+    0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65,
+    0x2e, 0x6f, 0x72, 0x67, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x8f,
+    0x2e, 0xaf, 0xed, 0x04, 0x6f, 0x2f, 0x30, 0xaf, 0xa1, 0x5b, 0xdc, 0x1b, 0x3b, 0x76, 0x69, 0xe8,
+    0x5b, 0xe7, 0x97, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+    0xd5, 0x17, 0xe2, 0x2c, 0x9c, 0xcb, 0xaa, 0x87, 0x3a, 0xf6, 0x50, 0xb0, 0x4d, 0x21, 0x76, 0x50,
+    0x2b, 0xc4, 0x39, 0x03, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02,
+    0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xc7, 0x1b, 0x24, 0xa1, 0xf7, 0x3c, 0x7d, 0x34,
+    0xb1, 0x7e, 0x37, 0x92, 0xad, 0x46, 0x3a, 0xbf, 0xa8, 0xd9, 0xdf, 0x56, 0x83, 0xd4, 0x64, 0x8e,
+    0x58, 0x4c, 0xac, 0xee, 0xff, 0x6b, 0xb4, 0x19, 0x02, 0x20, 0x52, 0x64, 0xfa, 0x7b, 0x80, 0x8b,
+    0x41, 0x06, 0xd9, 0x02, 0xe7, 0x62, 0xda, 0xad, 0xdd, 0xad, 0xd5, 0xbb, 0x5f, 0x44, 0x4e, 0xb9,
+    0xc7, 0x7e, 0x69, 0x1f, 0x84, 0xbc, 0xaf, 0x83, 0x8f, 0x4c,
+};
+
+static const uint8_t CHAINED_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xc2, 0x30, 0x82, 0x01, 0x68, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x10,
+    0x01, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x34, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x21, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x18, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69,
+    0x61, 0x74, 0x65, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x36, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x5a, 0x18, 0x0f, 0x32, 0x30, 0x38, 0x31, 0x30, 0x31, 0x30, 0x31, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a,
+    0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86,
+    0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03,
+    0x42, 0x00, 0x04, 0x6c, 0x25, 0xc3, 0x25, 0xe8, 0x1c, 0x34, 0xa7, 0xc5, 0x8c, 0x8a, 0x4e, 0x82,
+    0xe9, 0xd8, 0x02, 0x95, 0xed, 0x7d, 0x57, 0xfa, 0xfc, 0xfa, 0x29, 0xca, 0xa3, 0x63, 0x71, 0xa3,
+    0x92, 0x87, 0xad, 0xc8, 0xc6, 0xff, 0x57, 0x61, 0x3b, 0x21, 0xcd, 0xd1, 0x3a, 0x42, 0x32, 0xe0,
+    0x3a, 0xce, 0x01, 0x13, 0xc3, 0x40, 0xf9, 0xea, 0xc2, 0x86, 0xc5, 0x06, 0x26, 0xa9, 0x20, 0x4d,
+    0xb7, 0xbf, 0x78, 0xa3, 0x81, 0x8a, 0x30, 0x81, 0x87, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13,
+    0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01,
+    0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x27, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x20,
+    0x30, 0x1e, 0x86, 0x1c, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61,
+    0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x63, 0x68, 0x61, 0x69, 0x6e, 0x65, 0x64,
+    0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xf6, 0xa2, 0xde, 0x98, 0xdc,
+    0xe8, 0x23, 0x59, 0xf5, 0xf7, 0xe2, 0x85, 0x47, 0x9d, 0xf6, 0xb1, 0x96, 0x60, 0x78, 0x29, 0x30,
+    0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x8f, 0x2e, 0xaf, 0xed,
+    0x04, 0x6f, 0x2f, 0x30, 0xaf, 0xa1, 0x5b, 0xdc, 0x1b, 0x3b, 0x76, 0x69, 0xe8, 0x5b, 0xe7, 0x97,
+    0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30,
+    0x45, 0x02, 0x21, 0x00, 0x8f, 0x45, 0xc8, 0x73, 0xe5, 0x8b, 0x5d, 0xca, 0x92, 0xf2, 0x3e, 0x5a,
+    0x42, 0xd9, 0xb6, 0xa0, 0xbf, 0xda, 0x6c, 0xb1, 0xa6, 0x0d, 0xbf, 0x7f, 0x1a, 0xab, 0x98, 0x44,
+    0xfe, 0x47, 0xff, 0x69, 0x02, 0x20, 0x4d, 0xa8, 0xba, 0x41, 0x9b, 0x82, 0xbf, 0x83, 0xf9, 0xc8,
+    0x59, 0xe5, 0x36, 0xaf, 0x53, 0x49, 0x37, 0x71, 0x1f, 0x0d, 0xb3, 0xb8, 0x50, 0x9e, 0xf1, 0x83,
+    0xab, 0xec, 0x55, 0x15, 0x0a, 0x01,
+};
+
+static const uint8_t EXPIRED_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xb6, 0x30, 0x82, 0x01, 0x5c, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x10,
+    0x02, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x2a, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x30, 0x30,
+    0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x17, 0x0d, 0x32, 0x31, 0x30, 0x31,
+    0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06,
+    0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x30, 0x59, 0x30, 0x13,
+    0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x6c, 0x25, 0xc3, 0x25, 0xe8, 0x1c, 0x34, 0xa7, 0xc5,
+    0x8c, 0x8a, 0x4e, 0x82, 0xe9, 0xd8, 0x02, 0x95, 0xed, 0x7d, 0x57, 0xfa, 0xfc, 0xfa, 0x29, 0xca,
+    0xa3, 0x63, 0x71, 0xa3, 0x92, 0x87, 0xad, 0xc8, 0xc6, 0xff, 0x57, 0x61, 0x3b, 0x21, 0xcd, 0xd1,
+    0x3a, 0x42, 0x32, 0xe0, 0x3a, 0xce, 0x01, 0x13, 0xc3, 0x40, 0xf9, 0xea, 0xc2, 0x86, 0xc5, 0x06,
+    0x26, 0xa9, 0x20, 0x4d, 0xb7, 0xbf, 0x78, 0xa3, 0x81, 0x8a, 0x30, 0x81, 0x87, 0x30, 0x0c, 0x06,
+    0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55,
+    0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x27, 0x06, 0x03, 0x55,
+    0x1d, 0x11, 0x04, 0x20, 0x30, 0x1e, 0x86, 0x1c, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f,
+    0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x65, 0x78, 0x70,
+    0x69, 0x72, 0x65, 0x64, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xf6,
+    0xa2, 0xde, 0x98, 0xdc, 0xe8, 0x23, 0x59, 0xf5, 0xf7, 0xe2, 0x85, 0x47, 0x9d, 0xf6, 0xb1, 0x96,
+    0x60, 0x78, 0x29, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+    0xd5, 0x17, 0xe2, 0x2c, 0x9c, 0xcb, 0xaa, 0x87, 0x3a, 0xf6, 0x50, 0xb0, 0x4d, 0x21, 0x76, 0x50,
+    0x2b, 0xc4, 0x39, 0x03, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02,
+    0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x5c, 0xeb, 0x92, 0xb5, 0x92, 0xbe, 0x3d, 0x31, 0x7d,
+    0x65, 0x04, 0x7c, 0x0a, 0xc6, 0x91, 0x08, 0x97, 0x5b, 0x62, 0x3a, 0x58, 0xae, 0x15, 0xee, 0x7c,
+    0x66, 0x18, 0xef, 0xca, 0xea, 0xa1, 0xb7, 0x02, 0x21, 0x00, 0x8b, 0x19, 0x6e, 0x6e, 0x60, 0x8e,
+    0x8b, 0x01, 0xd1, 0x2e, 0x7d, 0xa0, 0xea, 0xf6, 0xc1, 0xec, 0x8d, 0xff, 0x21, 0x65, 0x41, 0x99,
+    0x85, 0xec, 0xf9, 0xb0, 0xa4, 0x76, 0xa0, 0x8c, 0xdb, 0x7a,
+};
+
+static const uint8_t FORGED_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xb7, 0x30, 0x82, 0x01, 0x5d, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x10,
+    0x03, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x2a, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31,
+    0x30, 0x31, 0x36, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x18, 0x0f, 0x32, 0x30, 0x38, 0x31,
+    0x30, 0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30,
+    0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x30, 0x59,
+    0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48,
+    0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x6c, 0x25, 0xc3, 0x25, 0xe8, 0x1c, 0x34,
+    0xa7, 0xc5, 0x8c, 0x8a, 0x4e, 0x82, 0xe9, 0xd8, 0x02, 0x95, 0xed, 0x7d, 0x57, 0xfa, 0xfc, 0xfa,
+    0x29, 0xca, 0xa3, 0x63, 0x71, 0xa3, 0x92, 0x87, 0xad, 0xc8, 0xc6, 0xff, 0x57, 0x61, 0x3b, 0x21,
+    0xcd, 0xd1, 0x3a, 0x42, 0x32, 0xe0, 0x3a, 0xce, 0x01, 0x13, 0xc3, 0x40, 0xf9, 0xea, 0xc2, 0x86,
+    0xc5, 0x06, 0x26, 0xa9, 0x20, 0x4d, 0xb7, 0xbf, 0x78, 0xa3, 0x81, 0x89, 0x30, 0x81, 0x86, 0x30,
+    0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06,
+    0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x26, 0x06,
+    0x03, 0x55, 0x1d, 0x11, 0x04, 0x1f, 0x30, 0x1d, 0x86, 0x1b, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65,
+    0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x66,
+    0x6f, 0x72, 0x67, 0x65, 0x64, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14,
+    0xf6, 0xa2, 0xde, 0x98, 0xdc, 0xe8, 0x23, 0x59, 0xf5, 0xf7, 0xe2, 0x85, 0x47, 0x9d, 0xf6, 0xb1,
+    0x96, 0x60, 0x78, 0x29, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80,
+    0x14, 0x02, 0x76, 0x36, 0x72, 0xfd, 0x3b, 0x5b, 0x76, 0x70, 0x55, 0x0f, 0x7d, 0x54, 0x5c, 0x17,
+    0xd2, 0xcd, 0x53, 0x06, 0xab, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03,
+    0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0x89, 0x41, 0x46, 0xfb, 0x02, 0xa5, 0x55,
+    0xc4, 0x8d, 0x60, 0x14, 0x6b, 0xd4, 0x8d, 0x5f, 0x4e, 0x51, 0x60, 0x30, 0x6f, 0x0e, 0x69, 0xc2,
+    0x63, 0x1a, 0x27, 0x08, 0x55, 0xc2, 0x78, 0x85, 0x90, 0x02, 0x20, 0x06, 0x6c, 0x4a, 0x72, 0xd8,
+    0xdb, 0x9a, 0xbc, 0xba, 0xff, 0x19, 0x9f, 0xca, 0x1f, 0x3b, 0xee, 0xd1, 0xa1, 0xb0, 0x18, 0x29,
+    0x22, 0x5b, 0xf7, 0x7b, 0x7e, 0xd5, 0x7d, 0xa0, 0xb7, 0x73, 0x11,
+};
+
+static const uint8_t REVOKED_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xb8, 0x30, 0x82, 0x01, 0x5e, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x10,
+    0x04, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x2a, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31,
+    0x30, 0x31, 0x36, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x18, 0x0f, 0x32, 0x30, 0x38, 0x31,
+    0x30, 0x31, 0x30, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30,
+    0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x30, 0x59,
+    0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48,
+    0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x6c, 0x25, 0xc3, 0x25, 0xe8, 0x1c, 0x34,
+    0xa7, 0xc5, 0x8c, 0x8a, 0x4e, 0x82, 0xe9, 0xd8, 0x02, 0x95, 0xed, 0x7d, 0x57, 0xfa, 0xfc, 0xfa,
+    0x29, 0xca, 0xa3, 0x63, 0x71, 0xa3, 0x92, 0x87, 0xad, 0xc8, 0xc6, 0xff, 0x57, 0x61, 0x3b, 0x21,
+    0xcd, 0xd1, 0x3a, 0x42, 0x32, 0xe0, 0x3a, 0xce, 0x01, 0x13, 0xc3, 0x40, 0xf9, 0xea, 0xc2, 0x86,
+    0xc5, 0x06, 0x26, 0xa9, 0x20, 0x4d, 0xb7, 0xbf, 0x78, 0xa3, 0x81, 0x8a, 0x30, 0x81, 0x87, 0x30,
+    0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06,
+    0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x27, 0x06,
+    0x03, 0x55, 0x1d, 0x11, 0x04, 0x20, 0x30, 0x1e, 0x86, 0x1c, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65,
+    0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x72,
+    0x65, 0x76, 0x6f, 0x6b, 0x65, 0x64, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04,
+    0x14, 0xf6, 0xa2, 0xde, 0x98, 0xdc, 0xe8, 0x23, 0x59, 0xf5, 0xf7, 0xe2, 0x85, 0x47, 0x9d, 0xf6,
+    0xb1, 0x96, 0x60, 0x78, 0x29, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16,
+    0x80, 0x14, 0xd5, 0x17, 0xe2, 0x2c, 0x9c, 0xcb, 0xaa, 0x87, 0x3a, 0xf6, 0x50, 0xb0, 0x4d, 0x21,
+    0x76, 0x50, 0x2b, 0xc4, 0x39, 0x03, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04,
+    0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x50, 0xee, 0x53, 0xea, 0x4d, 0x76, 0xf2,
+    0x30, 0x48, 0xb6, 0x73, 0x29, 0xb6, 0x42, 0x1c, 0x69, 0xb6, 0xfc, 0x15, 0x28, 0xa3, 0xcb, 0xbe,
+    0xf2, 0x59, 0x87, 0xfd, 0x6a, 0x1b, 0x8d, 0x58, 0x8f, 0x02, 0x21, 0x00, 0x93, 0x9f, 0xdd, 0x61,
+    0x7a, 0xae, 0x6f, 0xf4, 0x16, 0x06, 0x58, 0x81, 0xb4, 0xa1, 0xb2, 0xae, 0x90, 0x3d, 0xb6, 0x72,
+    0xe8, 0x59, 0x1d, 0xd3, 0x25, 0x4b, 0xb0, 0x55, 0x0f, 0x42, 0x30, 0xc7,
+};
+
+static const uint8_t CA_CRL_DER[] = {
+    0x30, 0x81, 0xdc, 0x30, 0x81, 0x82, 0x02, 0x01, 0x01, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48,
+    0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x2a, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a,
+    0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04,
+    0x03, 0x0c, 0x0e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x43,
+    0x41, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x36, 0x32, 0x33, 0x30, 0x38, 0x35, 0x31, 0x5a,
+    0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30, 0x39, 0x32, 0x32, 0x32, 0x33, 0x30, 0x38, 0x35, 0x31,
+    0x5a, 0x30, 0x15, 0x30, 0x13, 0x02, 0x02, 0x10, 0x04, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31,
+    0x36, 0x32, 0x33, 0x30, 0x38, 0x35, 0x31, 0x5a, 0xa0, 0x0e, 0x30, 0x0c, 0x30, 0x0a, 0x06, 0x03,
+    0x55, 0x1d, 0x14, 0x04, 0x03, 0x02, 0x01, 0x01, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce,
+    0x3d, 0x04, 0x03, 0x02, 0x03, 0x49, 0x00, 0x30, 0x46, 0x02, 0x21, 0x00, 0xf6, 0x5c, 0x7c, 0x61,
+    0x82, 0x56, 0x4f, 0x34, 0xde, 0x0e, 0x0a, 0xb0, 0x68, 0x31, 0x05, 0xa3, 0x8b, 0xe1, 0x74, 0x10,
+    0xc5, 0x25, 0x4a, 0xaf, 0xa3, 0x33, 0x01, 0x86, 0x80, 0x49, 0x80, 0xac, 0x02, 0x21, 0x00, 0x81,
+    0x3f, 0x56, 0x14, 0x7e, 0x31, 0x59, 0x4d, 0xc0, 0xa9, 0x94, 0xfb, 0xf6, 0x51, 0x5a, 0x7a, 0x48,
+    0x14, 0xd8, 0x92, 0x11, 0x7b, 0x44, 0x74, 0xb1, 0x64, 0x83, 0xf4, 0xd7, 0x83, 0xb4, 0x69,
+};
+
+// Chain policy, another hierarchy under the policy CA (O=SPIFFE, CN=example.org policy CA, serial
+// 0x2000, URI SAN spiffe://example.org), every CA with keyUsage keyCertSign and cRLSign unless
+// noted, every leaf with keyUsage digitalSignature, SKI and AKI unless noted, all valid from
+// 2026-10-17 for at least 54 years:
+// Rotated policy CA: same subject as the policy CA, another key
+// Rotated intermediates: two CAs named CN=example.org rotated intermediate, with different keys
+// Signing intermediate: CA with keyUsage digitalSignature only
+// Pathlen intermediate: pathLenConstraint 0, issuer of the nested intermediate
+// Permitted / other.org intermediates: nameConstraints permitted URI example.org / other.org
+// Cert sign leaf: spiffe://example.org/key-usage, keyUsage keyCertSign only, by the policy CA
+// Signing intermediate leaf: spiffe://example.org/signed-by-signing
+// Nested leaf: spiffe://example.org/nested, by the nested intermediate
+// Critical leaf: spiffe://example.org/critical, an unknown critical extension 1.3.6.1.4.1.55555.1
+// Permitted / other.org leaves: spiffe://example.org/permitted and /excluded
+// Rotated leaf: spiffe://example.org/rotated by the rotated policy CA, without AKI
+// Rotated intermediate leaf: spiffe://example.org/rotated-intermediate by the second rotated
+//       intermediate, without AKI
+
+static const uint8_t POLICY_CA_DER[] = {
+    0x30, 0x82, 0x01, 0xb6, 0x30, 0x82, 0x01, 0x5d, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x00, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30, 0x39, 0x32, 0x33, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x31, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69,
+    0x63, 0x79, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04,
+    0xff, 0x6d, 0xcc, 0x77, 0xf0, 0x24, 0xcc, 0xec, 0xc4, 0xd6, 0xec, 0x54, 0xdd, 0x6c, 0xe8, 0xee,
+    0x6d, 0xcf, 0x51, 0x25, 0x3a, 0xfc, 0xb6, 0x3e, 0x24, 0x2d, 0xaf, 0x3a, 0x23, 0x0a, 0x66, 0xce,
+    0x36, 0xbf, 0x6a, 0x32, 0x3b, 0xaa, 0x9e, 0x91, 0x6c, 0x8d, 0x77, 0xbe, 0x04, 0xcf, 0x23, 0xe7,
+    0x2a, 0xa2, 0x28, 0x37, 0x50, 0xeb, 0xcf, 0x4a, 0x8d, 0x97, 0xcc, 0x0c, 0x95, 0xc4, 0x74, 0xe1,
+    0xa3, 0x63, 0x30, 0x61, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05,
+    0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04,
+    0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14,
+    0x41, 0xfe, 0xfb, 0x37, 0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7,
+    0x9b, 0x64, 0x41, 0x87, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x18, 0x30, 0x16, 0x86,
+    0x14, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c,
+    0x65, 0x2e, 0x6f, 0x72, 0x67, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03,
+    0x02, 0x03, 0x47, 0x00, 0x30, 0x44, 0x02, 0x20, 0x24, 0xa0, 0xd5, 0x42, 0x4f, 0x68, 0x52, 0x5f,
+    0xa3, 0x25, 0x78, 0x93, 0xa4, 0x1c, 0x2a, 0xc2, 0x4f, 0x70, 0xc5, 0xfe, 0x36, 0x0f, 0xb9, 0x2e,
+    0x07, 0x6c, 0x88, 0x78, 0x8e, 0xc1, 0x11, 0x53, 0x02, 0x20, 0x02, 0x7e, 0xee, 0x18, 0x5e, 0xe7,
+    0x8a, 0xc6, 0x55, 0x17, 0x08, 0x9f, 0x85, 0x08, 0x5f, 0x1a, 0xaf, 0xe5, 0xb1, 0x98, 0x27, 0x19,
+    0x6b, 0xd9, 0xb4, 0x0e, 0xc0, 0xd6, 0x19, 0x9e, 0xc2, 0x6b,
+};
+
+static const uint8_t ROTATED_POLICY_CA_DER[] = {
+    0x30, 0x82, 0x01, 0xb7, 0x30, 0x82, 0x01, 0x5d, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x01, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30, 0x39, 0x32, 0x33, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x31, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69,
+    0x63, 0x79, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04,
+    0xfa, 0xb2, 0xfe, 0x59, 0x94, 0xfb, 0xeb, 0x94, 0x7c, 0xb1, 0x82, 0x29, 0xea, 0x31, 0x8a, 0x76,
+    0x68, 0x7b, 0xf2, 0x7a, 0x77, 0xb1, 0x98, 0x79, 0x64, 0xcc, 0x68, 0xf4, 0x4e, 0x58, 0x05, 0xf8,
+    0x94, 0xe4, 0x27, 0x3e, 0x25, 0xf7, 0xe2, 0x20, 0xa0, 0x11, 0x52, 0x12, 0x01, 0xf8, 0x8e, 0xd1,
+    0x42, 0x7b, 0x28, 0x36, 0x09, 0x51, 0x81, 0x80, 0x75, 0x48, 0xdc, 0x58, 0x0e, 0x98, 0xfa, 0x3c,
+    0xa3, 0x63, 0x30, 0x61, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05,
+    0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04,
+    0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14,
+    0x5e, 0x04, 0x25, 0x17, 0x79, 0x68, 0x2e, 0x65, 0xb6, 0x7e, 0xaa, 0x1b, 0x24, 0xa2, 0x29, 0x48,
+    0x5e, 0x46, 0xd0, 0x24, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x18, 0x30, 0x16, 0x86,
+    0x14, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c,
+    0x65, 0x2e, 0x6f, 0x72, 0x67, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03,
+    0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xf5, 0x2d, 0x99, 0x21, 0xfe, 0x04, 0xbd,
+    0x1b, 0x8d, 0x21, 0x8d, 0xd8, 0xe6, 0xa3, 0x9b, 0xeb, 0xae, 0x01, 0xfb, 0x03, 0x79, 0x44, 0x6b,
+    0x9a, 0x29, 0x7f, 0x52, 0x9f, 0xe8, 0x92, 0x24, 0x11, 0x02, 0x20, 0x04, 0x65, 0x4c, 0x3f, 0x84,
+    0x1d, 0x52, 0xa3, 0x05, 0xb3, 0xa0, 0xda, 0xac, 0x9f, 0x05, 0x31, 0x91, 0x6d, 0x77, 0x9b, 0x4f,
+    0x83, 0x71, 0x59, 0x7f, 0x7a, 0x2d, 0x0d, 0x98, 0xb1, 0xef, 0xa2,
+};
+
+static const uint8_t ROTATED_INTERMEDIATE_OLD_DER[] = {
+    0x30, 0x82, 0x01, 0xc2, 0x30, 0x82, 0x01, 0x68, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x02, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x35, 0x30, 0x35, 0x31, 0x31, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x3c, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x29, 0x30, 0x27, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x20,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x72, 0x6f, 0x74, 0x61,
+    0x74, 0x65, 0x64, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65,
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x32, 0x71, 0x97, 0x87, 0x30,
+    0xdb, 0x7c, 0x0b, 0xf0, 0x36, 0xce, 0xf2, 0xb6, 0x28, 0x65, 0x40, 0x85, 0xf9, 0x28, 0x36, 0xa7,
+    0x15, 0x30, 0x07, 0xca, 0x81, 0x35, 0xc7, 0x1b, 0xed, 0x97, 0x4f, 0xb9, 0x81, 0x9b, 0x74, 0x6b,
+    0x7b, 0xba, 0x4f, 0x63, 0xa5, 0x65, 0xd0, 0xca, 0x30, 0x7f, 0xa6, 0xe6, 0x74, 0xa4, 0x44, 0x88,
+    0x12, 0xaa, 0xfb, 0xfc, 0x55, 0xa1, 0xd6, 0xe7, 0x7c, 0x94, 0xb2, 0xa3, 0x63, 0x30, 0x61, 0x30,
+    0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff,
+    0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06,
+    0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xea, 0x8d, 0x0b, 0x87, 0x15,
+    0xae, 0x5f, 0x35, 0x62, 0x0a, 0xd3, 0xca, 0x2b, 0xf8, 0x72, 0xd9, 0xc8, 0x80, 0x9b, 0x1f, 0x30,
+    0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x41, 0xfe, 0xfb, 0x37,
+    0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7, 0x9b, 0x64, 0x41, 0x87,
+    0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30,
+    0x45, 0x02, 0x21, 0x00, 0xc6, 0x26, 0x29, 0x12, 0x26, 0x2c, 0x87, 0x73, 0xf2, 0xb1, 0xfd, 0x6a,
+    0x87, 0xb8, 0xb4, 0x4d, 0xaf, 0xdf, 0xf7, 0x85, 0x61, 0x9e, 0xa3, 0x1c, 0x71, 0xea, 0x63, 0x7c,
+    0x3c, 0x4c, 0x50, 0xca, 0x02, 0x20, 0x0c, 0x02, 0x96, 0xfb, 0xcc, 0x80, 0xb9, 0x67, 0x71, 0x95,
+    0x3a, 0xba, 0x22, 0x99, 0xc8, 0x58, 0x22, 0x46, 0x2e, 0x81, 0xee, 0x1d, 0x33, 0x39, 0x16, 0x73,
+    0xa9, 0xed, 0x17, 0x10, 0x4e, 0x8c,
+};
+
+static const uint8_t ROTATED_INTERMEDIATE_DER[] = {
+    0x30, 0x82, 0x01, 0xc1, 0x30, 0x82, 0x01, 0x68, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x03, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x35, 0x30, 0x35, 0x31, 0x31, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x3c, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x29, 0x30, 0x27, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x20,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x72, 0x6f, 0x74, 0x61,
+    0x74, 0x65, 0x64, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65,
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x70, 0xdd, 0x79, 0xb1, 0x72,
+    0xed, 0x50, 0xe0, 0x07, 0x99, 0x7f, 0x90, 0x24, 0x50, 0x12, 0x92, 0x64, 0x34, 0x89, 0x8a, 0xf5,
+    0x98, 0x9e, 0x08, 0x1e, 0xe2, 0xe6, 0xcb, 0x74, 0x0f, 0x90, 0x55, 0x82, 0xa9, 0x50, 0x4a, 0x38,
+    0xe6, 0xc5, 0xd4, 0x7f, 0xdc, 0xc0, 0xe7, 0xcd, 0x87, 0x64, 0xd2, 0x3a, 0x20, 0xeb, 0xdf, 0xb9,
+    0x22, 0x8a, 0x9c, 0x31, 0x57, 0x8f, 0x5c, 0x77, 0x11, 0x23, 0x6e, 0xa3, 0x63, 0x30, 0x61, 0x30,
+    0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff,
+    0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06,
+    0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x0b, 0xe4, 0x7f, 0x1d, 0x21,
+    0xec, 0xef, 0x98, 0x02, 0xf4, 0xe4, 0xba, 0x10, 0x77, 0xef, 0xc3, 0xc2, 0x61, 0x38, 0xb5, 0x30,
+    0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x41, 0xfe, 0xfb, 0x37,
+    0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7, 0x9b, 0x64, 0x41, 0x87,
+    0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x47, 0x00, 0x30,
+    0x44, 0x02, 0x20, 0x39, 0x91, 0x05, 0xd3, 0x1a, 0x0d, 0x89, 0xd6, 0xb9, 0x98, 0x56, 0xd8, 0xc1,
+    0x57, 0x92, 0x81, 0xd2, 0x44, 0xbf, 0xa4, 0x45, 0xca, 0x34, 0x9c, 0x27, 0x7f, 0x89, 0x4f, 0xdf,
+    0x9a, 0xd9, 0xc9, 0x02, 0x20, 0x4d, 0xde, 0xdf, 0x50, 0xc3, 0xda, 0x87, 0x97, 0xb9, 0x93, 0x50,
+    0xa6, 0x4f, 0x31, 0x1f, 0xb9, 0x4f, 0xbb, 0x34, 0xf6, 0x5b, 0xa7, 0xd5, 0x2c, 0x5f, 0x47, 0x30,
+    0x51, 0xc7, 0xf4, 0xa4, 0x9d,
+};
+
+static const uint8_t SIGNING_INTERMEDIATE_DER[] = {
+    0x30, 0x82, 0x01, 0xc2, 0x30, 0x82, 0x01, 0x68, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x04, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x35, 0x30, 0x35, 0x31, 0x31, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x3c, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x29, 0x30, 0x27, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x20,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x73, 0x69, 0x67, 0x6e,
+    0x69, 0x6e, 0x67, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65,
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xd3, 0x51, 0x1e, 0x7b, 0xd5,
+    0xe1, 0x1b, 0x91, 0xc6, 0x1c, 0x32, 0x2a, 0x01, 0x05, 0xfd, 0xd2, 0xda, 0x33, 0x48, 0xcd, 0x84,
+    0x7d, 0xd3, 0x0a, 0x71, 0x91, 0x4b, 0x82, 0x77, 0x75, 0xb6, 0xe2, 0x3b, 0x97, 0xb4, 0x12, 0x4b,
+    0xdb, 0xd8, 0xc9, 0x49, 0xc0, 0x12, 0x2c, 0x6f, 0x47, 0x6a, 0x45, 0xe3, 0x7b, 0x6e, 0x27, 0xe0,
+    0xce, 0x60, 0x89, 0x31, 0x52, 0x81, 0x0f, 0x20, 0xf9, 0x0b, 0x67, 0xa3, 0x63, 0x30, 0x61, 0x30,
+    0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff,
+    0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80,
+    0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x16, 0x1e, 0x17, 0x18, 0x40,
+    0xaa, 0xa0, 0x4c, 0x8e, 0x62, 0x33, 0x8a, 0xa6, 0xa4, 0x26, 0x59, 0x7a, 0x71, 0x1c, 0xe2, 0x30,
+    0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x41, 0xfe, 0xfb, 0x37,
+    0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7, 0x9b, 0x64, 0x41, 0x87,
+    0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30,
+    0x45, 0x02, 0x21, 0x00, 0xa8, 0x55, 0xf7, 0x65, 0x9e, 0x49, 0x40, 0xd8, 0x1e, 0x03, 0x82, 0x7a,
+    0xbb, 0x63, 0xce, 0xeb, 0xaf, 0x24, 0x5d, 0xbd, 0xea, 0x4c, 0xce, 0xef, 0xd3, 0x4f, 0x65, 0x42,
+    0x15, 0x22, 0x4c, 0xdd, 0x02, 0x20, 0x1f, 0x14, 0xf1, 0x2a, 0x64, 0x1a, 0x6d, 0x44, 0x13, 0x43,
+    0xd8, 0xd6, 0x7f, 0x0f, 0x0c, 0x70, 0x1d, 0xee, 0xaa, 0x19, 0xad, 0x2a, 0xe5, 0xff, 0xbf, 0x60,
+    0x9d, 0x31, 0x46, 0xf5, 0x5b, 0x3f,
+};
+
+static const uint8_t PATHLEN_INTERMEDIATE_DER[] = {
+    0x30, 0x82, 0x01, 0xc6, 0x30, 0x82, 0x01, 0x6d, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x05, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x35, 0x30, 0x35, 0x31, 0x31, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x3e, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x61, 0x74, 0x68,
+    0x6c, 0x65, 0x6e, 0x20, 0x30, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61,
+    0x74, 0x65, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x5c, 0x5c, 0x4d,
+    0xdb, 0x92, 0xfc, 0x85, 0x47, 0x9d, 0x5b, 0x47, 0xb6, 0xff, 0x71, 0xd9, 0x13, 0x76, 0x80, 0xec,
+    0x0c, 0x09, 0xa6, 0xdb, 0xc2, 0x2e, 0xf9, 0xe1, 0x39, 0xfe, 0x69, 0x87, 0x2e, 0xa3, 0xf4, 0x57,
+    0x34, 0xbc, 0x60, 0xef, 0x0d, 0x6e, 0x64, 0xce, 0x8e, 0xb7, 0xfc, 0x3d, 0x3a, 0x4f, 0x30, 0x0f,
+    0xd2, 0x0d, 0xd6, 0x5d, 0x65, 0x0a, 0x6e, 0xe4, 0xcf, 0x8f, 0x90, 0x00, 0x95, 0xa3, 0x66, 0x30,
+    0x64, 0x30, 0x12, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x08, 0x30, 0x06, 0x01,
+    0x01, 0xff, 0x02, 0x01, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04,
+    0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14,
+    0x6e, 0xd7, 0xea, 0xb8, 0xff, 0x72, 0x02, 0x47, 0x7e, 0xc4, 0x7f, 0xfc, 0x5f, 0xed, 0x07, 0x3c,
+    0xc2, 0x12, 0x98, 0xc0, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80,
+    0x14, 0x41, 0xfe, 0xfb, 0x37, 0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06,
+    0xd7, 0x9b, 0x64, 0x41, 0x87, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03,
+    0x02, 0x03, 0x47, 0x00, 0x30, 0x44, 0x02, 0x20, 0x51, 0x45, 0x2d, 0xaa, 0x90, 0x25, 0x96, 0xeb,
+    0xf2, 0x19, 0x13, 0xc5, 0xfb, 0xb6, 0xc7, 0x87, 0x63, 0xa2, 0xdf, 0xe3, 0xea, 0x67, 0x43, 0xbc,
+    0xdb, 0x25, 0x64, 0x2c, 0x54, 0xdd, 0xa8, 0x1a, 0x02, 0x20, 0x62, 0x47, 0xf6, 0x28, 0xcf, 0x98,
+    0x24, 0xcd, 0xbe, 0xb2, 0x55, 0x58, 0x32, 0x93, 0xe6, 0x9c, 0xcd, 0xd8, 0x78, 0x55, 0xbc, 0xf3,
+    0x59, 0x84, 0x48, 0xbd, 0xa6, 0x7b, 0xe6, 0x28, 0x5e, 0x4c,
+};
+
+static const uint8_t NESTED_INTERMEDIATE_DER[] = {
+    0x30, 0x82, 0x01, 0xce, 0x30, 0x82, 0x01, 0x74, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x06, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x3e, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x61, 0x74, 0x68, 0x6c, 0x65, 0x6e, 0x20, 0x30,
+    0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x20, 0x17,
+    0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31, 0x5a, 0x18, 0x0f,
+    0x32, 0x31, 0x32, 0x32, 0x30, 0x38, 0x31, 0x35, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31, 0x5a, 0x30,
+    0x3b, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46,
+    0x46, 0x45, 0x31, 0x28, 0x30, 0x26, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x1f, 0x65, 0x78, 0x61,
+    0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x6e, 0x65, 0x73, 0x74, 0x65, 0x64, 0x20,
+    0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x59, 0x30, 0x13,
+    0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x5f, 0x32, 0xdc, 0xee, 0xa4, 0xe4, 0xc1, 0x78, 0x50,
+    0x0e, 0x05, 0x2a, 0xad, 0x31, 0x20, 0x3b, 0x89, 0xe2, 0x4e, 0xc0, 0xbb, 0x0b, 0x7a, 0xcb, 0xd5,
+    0xe0, 0xd7, 0x7a, 0xbf, 0xb9, 0xbe, 0xf6, 0xa8, 0x0a, 0x14, 0x5a, 0x7b, 0x01, 0xb8, 0x1f, 0xcd,
+    0xbe, 0x68, 0xed, 0x38, 0xe5, 0xfe, 0xe8, 0x2e, 0x63, 0x48, 0x8a, 0x66, 0x02, 0xb2, 0xf8, 0x86,
+    0x51, 0xaa, 0x63, 0x50, 0x37, 0x1e, 0x93, 0xa3, 0x63, 0x30, 0x61, 0x30, 0x0f, 0x06, 0x03, 0x55,
+    0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03,
+    0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03,
+    0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x4d, 0xed, 0x6c, 0x23, 0x68, 0x89, 0x19, 0x15, 0xa1,
+    0x61, 0x9e, 0x46, 0xa2, 0xb2, 0x84, 0x59, 0x8f, 0x55, 0x80, 0x12, 0x30, 0x1f, 0x06, 0x03, 0x55,
+    0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x6e, 0xd7, 0xea, 0xb8, 0xff, 0x72, 0x02, 0x47,
+    0x7e, 0xc4, 0x7f, 0xfc, 0x5f, 0xed, 0x07, 0x3c, 0xc2, 0x12, 0x98, 0xc0, 0x30, 0x0a, 0x06, 0x08,
+    0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x4e,
+    0x64, 0x4e, 0x6f, 0xb8, 0x18, 0x76, 0xc0, 0x65, 0xeb, 0x85, 0x39, 0x78, 0xa9, 0xda, 0x25, 0x95,
+    0xbd, 0x9d, 0x9c, 0xfe, 0x9f, 0x8a, 0x41, 0x62, 0xd9, 0x5b, 0xe0, 0x67, 0x3a, 0x9e, 0xdf, 0x02,
+    0x21, 0x00, 0xf2, 0x28, 0xed, 0x76, 0x1a, 0x95, 0x13, 0xbb, 0xf1, 0x6d, 0x9f, 0x42, 0x80, 0x6c,
+    0x3d, 0x68, 0xcc, 0x30, 0x32, 0xd5, 0x07, 0xba, 0x34, 0x76, 0x40, 0x64, 0x7b, 0xeb, 0x92, 0x33,
+    0xce, 0x2b,
+};
+
+static const uint8_t PERMITTED_INTERMEDIATE_DER[] = {
+    0x30, 0x82, 0x01, 0xe5, 0x30, 0x82, 0x01, 0x8b, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x07, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x35, 0x30, 0x35, 0x31, 0x31, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x3e, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x65, 0x72, 0x6d,
+    0x69, 0x74, 0x74, 0x65, 0x64, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61,
+    0x74, 0x65, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x74, 0xa4, 0xc5,
+    0x77, 0x36, 0xe4, 0x11, 0x55, 0x82, 0xa6, 0xfa, 0x0d, 0xd5, 0xac, 0x70, 0xed, 0x81, 0xe4, 0x24,
+    0xe9, 0xe0, 0xc2, 0xca, 0xba, 0xf2, 0x33, 0x1c, 0xea, 0x2b, 0xc9, 0xb9, 0x67, 0x7d, 0xf4, 0x98,
+    0x8c, 0xce, 0x06, 0x5b, 0x1c, 0x4d, 0xe5, 0x09, 0xf3, 0x61, 0xfc, 0x37, 0x03, 0x2f, 0x9a, 0x0f,
+    0xfd, 0x61, 0x2a, 0x08, 0x82, 0x31, 0xb4, 0x07, 0xac, 0x7a, 0x29, 0x22, 0xc6, 0xa3, 0x81, 0x83,
+    0x30, 0x81, 0x80, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30,
+    0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04,
+    0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x29,
+    0x15, 0x01, 0xcf, 0x85, 0x64, 0x6c, 0xab, 0xcd, 0xaa, 0xdf, 0x74, 0x36, 0x1d, 0x17, 0x8a, 0x66,
+    0x93, 0xba, 0xce, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+    0x41, 0xfe, 0xfb, 0x37, 0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7,
+    0x9b, 0x64, 0x41, 0x87, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x1e, 0x01, 0x01, 0xff, 0x04, 0x13,
+    0x30, 0x11, 0xa0, 0x0f, 0x30, 0x0d, 0x86, 0x0b, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e,
+    0x6f, 0x72, 0x67, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03,
+    0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x71, 0x2c, 0x46, 0x7a, 0x0c, 0x16, 0x57, 0xd8, 0x76, 0x81,
+    0xc4, 0x53, 0x68, 0x45, 0x8f, 0xbb, 0xd4, 0x49, 0xff, 0x96, 0x57, 0xef, 0x90, 0x31, 0x2f, 0x9b,
+    0x4e, 0x74, 0xe9, 0x59, 0xf0, 0xe3, 0x02, 0x21, 0x00, 0xc0, 0xc6, 0x53, 0x25, 0x7c, 0x3d, 0x84,
+    0x5c, 0x78, 0x11, 0x5e, 0xf3, 0x7f, 0x70, 0x36, 0x57, 0xec, 0x4c, 0xfe, 0xc2, 0x37, 0xd2, 0x83,
+    0xb4, 0x91, 0xdc, 0x4a, 0x49, 0x34, 0x93, 0x73, 0xf7,
+};
+
+static const uint8_t OTHER_ORG_INTERMEDIATE_DER[] = {
+    0x30, 0x82, 0x01, 0xe2, 0x30, 0x82, 0x01, 0x88, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x08, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x35, 0x30, 0x35, 0x31, 0x31, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x3e, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x31, 0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22,
+    0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x6f, 0x74, 0x68, 0x65,
+    0x72, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61,
+    0x74, 0x65, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x6e, 0xf1, 0x28,
+    0x84, 0x98, 0xc8, 0x16, 0x18, 0x4e, 0xb0, 0x12, 0x41, 0xe1, 0xb6, 0xf3, 0xb5, 0xdd, 0x83, 0x69,
+    0xcd, 0x82, 0xe9, 0xcb, 0xf1, 0x91, 0x68, 0x4f, 0x5d, 0xdc, 0xb8, 0xc2, 0xca, 0x5d, 0x7f, 0x2d,
+    0x16, 0x46, 0xbf, 0xe6, 0xb2, 0x57, 0x60, 0x14, 0xd9, 0x7f, 0x6d, 0x22, 0x00, 0x25, 0xe1, 0xf2,
+    0xff, 0x93, 0xdc, 0x14, 0xd6, 0xa3, 0x29, 0x61, 0x91, 0x4e, 0xff, 0x40, 0x49, 0xa3, 0x81, 0x80,
+    0x30, 0x7e, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03,
+    0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03,
+    0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x4e, 0xe9,
+    0xb2, 0x7c, 0xc2, 0xb6, 0x2f, 0xff, 0x04, 0xfd, 0x88, 0xc7, 0x09, 0xc1, 0x22, 0x9b, 0x52, 0xaf,
+    0x52, 0x6c, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x41,
+    0xfe, 0xfb, 0x37, 0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7, 0x9b,
+    0x64, 0x41, 0x87, 0x30, 0x1b, 0x06, 0x03, 0x55, 0x1d, 0x1e, 0x01, 0x01, 0xff, 0x04, 0x11, 0x30,
+    0x0f, 0xa0, 0x0d, 0x30, 0x0b, 0x86, 0x09, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x2e, 0x6f, 0x72, 0x67,
+    0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30,
+    0x45, 0x02, 0x20, 0x17, 0x56, 0x74, 0xcd, 0x22, 0x0f, 0xd5, 0x9d, 0x00, 0x90, 0x5d, 0x3e, 0x23,
+    0x3b, 0x62, 0x5a, 0x62, 0xf7, 0x35, 0x44, 0x4f, 0x93, 0xbb, 0x1c, 0xc3, 0xf8, 0x8c, 0xf4, 0x03,
+    0x68, 0xf3, 0x3d, 0x02, 0x21, 0x00, 0xa2, 0xac, 0x65, 0xcb, 0x48, 0xed, 0x81, 0x9b, 0xd7, 0x7a,
+    0x63, 0x4d, 0x55, 0x7e, 0xd2, 0x68, 0xaa, 0x6c, 0xab, 0x9f, 0x43, 0xe9, 0xf9, 0x08, 0x69, 0x04,
+    0xf1, 0x84, 0x82, 0x7c, 0x62, 0xf6,
+};
+
+static const uint8_t CERT_SIGN_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xc1, 0x30, 0x82, 0x01, 0x67, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x09, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x31,
+    0x5a, 0x18, 0x0f, 0x32, 0x30, 0x38, 0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x31, 0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04,
+    0xe2, 0x95, 0xc0, 0xf3, 0xdf, 0x51, 0x03, 0xcf, 0x56, 0xeb, 0x12, 0x86, 0x71, 0xc4, 0xe9, 0x91,
+    0x3f, 0xa5, 0xb8, 0xfb, 0x8d, 0x65, 0xc5, 0xe2, 0x9f, 0xaf, 0x3d, 0x60, 0x11, 0xd6, 0x3f, 0xa6,
+    0x15, 0x4b, 0xf3, 0x0f, 0x15, 0x02, 0xbd, 0xb5, 0xf4, 0xf2, 0xe6, 0xfa, 0xf4, 0xef, 0xbd, 0x10,
+    0x00, 0xff, 0x89, 0xaf, 0x3b, 0x57, 0x50, 0x75, 0xf4, 0x61, 0xe8, 0xc7, 0x45, 0xbf, 0xfd, 0x32,
+    0xa3, 0x81, 0x8c, 0x30, 0x81, 0x89, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff,
+    0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04,
+    0x03, 0x02, 0x02, 0x04, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x97,
+    0x3f, 0x6b, 0xd9, 0x8e, 0xd3, 0xdb, 0x57, 0xf8, 0x06, 0x80, 0x5f, 0x46, 0xd9, 0x81, 0x9e, 0x32,
+    0xbf, 0x88, 0x9f, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+    0x41, 0xfe, 0xfb, 0x37, 0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7,
+    0x9b, 0x64, 0x41, 0x87, 0x30, 0x29, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x22, 0x30, 0x20, 0x86,
+    0x1e, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c,
+    0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x6b, 0x65, 0x79, 0x2d, 0x75, 0x73, 0x61, 0x67, 0x65, 0x30,
+    0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45,
+    0x02, 0x21, 0x00, 0xd2, 0x79, 0x05, 0x9f, 0x42, 0xb1, 0x55, 0xfa, 0x58, 0xc9, 0x57, 0x7b, 0x27,
+    0x72, 0x89, 0xb4, 0x21, 0xaa, 0xb2, 0x2f, 0xb6, 0x7f, 0xc5, 0x57, 0x5a, 0x16, 0x1b, 0x0d, 0xda,
+    0xd5, 0x59, 0x41, 0x02, 0x20, 0x07, 0x0a, 0x51, 0xbf, 0x10, 0xcc, 0x9c, 0x75, 0x19, 0xb2, 0x99,
+    0xec, 0x76, 0x8b, 0xbf, 0x83, 0x03, 0xc9, 0x74, 0x66, 0x60, 0xa0, 0xcc, 0x75, 0x67, 0x32, 0xc9,
+    0x66, 0xc7, 0xd2, 0x3d, 0xbe,
+};
+
+static const uint8_t SIGNING_INTERMEDIATE_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xd5, 0x30, 0x82, 0x01, 0x7a, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x0a, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x3c, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x29, 0x30, 0x27, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x20, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x73, 0x69, 0x67, 0x6e, 0x69, 0x6e, 0x67, 0x20, 0x69,
+    0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x20, 0x17, 0x0d, 0x32,
+    0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x18, 0x0f, 0x32, 0x30,
+    0x38, 0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x30, 0x11, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x55, 0xae, 0x20, 0xee, 0xf7,
+    0x6f, 0xf7, 0xaf, 0xac, 0x86, 0x16, 0xc8, 0x14, 0x61, 0x7f, 0xdd, 0x14, 0xe3, 0xe6, 0x16, 0x33,
+    0xe2, 0xd5, 0xca, 0x7d, 0x93, 0x0a, 0x71, 0xe6, 0x0b, 0x2e, 0x6a, 0x35, 0xbd, 0xbf, 0x78, 0xf5,
+    0xe5, 0xa1, 0x57, 0xcf, 0x1a, 0x0a, 0x85, 0x02, 0x4e, 0x21, 0x8d, 0x2a, 0x0c, 0x26, 0xa3, 0xef,
+    0x79, 0xd1, 0xc1, 0x77, 0xb9, 0x70, 0xba, 0xa8, 0x92, 0x61, 0x70, 0xa3, 0x81, 0x94, 0x30, 0x81,
+    0x91, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30,
+    0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30,
+    0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xcb, 0x50, 0xfd, 0x73, 0x85, 0x12,
+    0x2d, 0x6d, 0xe4, 0x4d, 0x03, 0x37, 0xca, 0x6d, 0x7f, 0xae, 0xd7, 0x41, 0xaa, 0xb4, 0x30, 0x1f,
+    0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x16, 0x1e, 0x17, 0x18, 0x40,
+    0xaa, 0xa0, 0x4c, 0x8e, 0x62, 0x33, 0x8a, 0xa6, 0xa4, 0x26, 0x59, 0x7a, 0x71, 0x1c, 0xe2, 0x30,
+    0x31, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x2a, 0x30, 0x28, 0x86, 0x26, 0x73, 0x70, 0x69, 0x66,
+    0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67,
+    0x2f, 0x73, 0x69, 0x67, 0x6e, 0x65, 0x64, 0x2d, 0x62, 0x79, 0x2d, 0x73, 0x69, 0x67, 0x6e, 0x69,
+    0x6e, 0x67, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x49,
+    0x00, 0x30, 0x46, 0x02, 0x21, 0x00, 0xde, 0xdd, 0xd4, 0x17, 0x8f, 0x69, 0x9d, 0xbc, 0xfd, 0x77,
+    0x7d, 0x3b, 0x36, 0x55, 0xb0, 0xc8, 0x82, 0x4e, 0x17, 0x8d, 0x2e, 0x4b, 0x17, 0xe5, 0xac, 0xc4,
+    0x3f, 0xfd, 0x33, 0x99, 0xf1, 0xa6, 0x02, 0x21, 0x00, 0xe4, 0xc8, 0x36, 0xf3, 0x4e, 0x0f, 0xfb,
+    0x4a, 0x4f, 0xb7, 0x48, 0x9b, 0xe1, 0x37, 0x86, 0x53, 0x58, 0xf5, 0x43, 0x31, 0x79, 0x52, 0x97,
+    0x66, 0x33, 0xae, 0x55, 0x20, 0xb0, 0xb1, 0x7a, 0xd0,
+};
+
+static const uint8_t NESTED_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xc7, 0x30, 0x82, 0x01, 0x6e, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x0b, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x3b, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x28, 0x30, 0x26, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x1f, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x6e, 0x65, 0x73, 0x74, 0x65, 0x64, 0x20, 0x69, 0x6e,
+    0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36,
+    0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x18, 0x0f, 0x32, 0x30, 0x38,
+    0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x30, 0x11, 0x31, 0x0f,
+    0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45, 0x30,
+    0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86,
+    0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x3b, 0xbc, 0x52, 0x48, 0xbc, 0xc5,
+    0x8b, 0x8a, 0xe3, 0xec, 0xa6, 0x36, 0x02, 0xe4, 0xb5, 0x9b, 0x62, 0x83, 0x4c, 0xe6, 0x10, 0x05,
+    0xa6, 0xec, 0x99, 0xea, 0xd7, 0x0e, 0x80, 0x49, 0xc7, 0x9b, 0x67, 0x91, 0xa0, 0xab, 0x3e, 0xdc,
+    0xf9, 0xbf, 0xc9, 0x13, 0x5f, 0x45, 0x01, 0x6b, 0x60, 0xf2, 0x93, 0xfd, 0xc1, 0x73, 0xde, 0xf9,
+    0x80, 0xdd, 0x45, 0xfa, 0x5a, 0x8d, 0x57, 0x46, 0x1e, 0xf5, 0xa3, 0x81, 0x89, 0x30, 0x81, 0x86,
+    0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e,
+    0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x1d,
+    0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xc9, 0x58, 0xce, 0x6c, 0x9c, 0xd7, 0x80,
+    0x11, 0x08, 0x17, 0x95, 0xf9, 0xf1, 0xaa, 0x14, 0x5c, 0x89, 0xed, 0x98, 0x9e, 0x30, 0x1f, 0x06,
+    0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x4d, 0xed, 0x6c, 0x23, 0x68, 0x89,
+    0x19, 0x15, 0xa1, 0x61, 0x9e, 0x46, 0xa2, 0xb2, 0x84, 0x59, 0x8f, 0x55, 0x80, 0x12, 0x30, 0x26,
+    0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x1f, 0x30, 0x1d, 0x86, 0x1b, 0x73, 0x70, 0x69, 0x66, 0x66,
+    0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f,
+    0x6e, 0x65, 0x73, 0x74, 0x65, 0x64, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04,
+    0x03, 0x02, 0x03, 0x47, 0x00, 0x30, 0x44, 0x02, 0x20, 0x05, 0xfc, 0xd6, 0xb2, 0x3e, 0x54, 0x52,
+    0x60, 0xc5, 0xa1, 0x2b, 0x02, 0x16, 0xdc, 0xdd, 0x7f, 0x31, 0x32, 0xad, 0x83, 0x47, 0x18, 0xeb,
+    0xae, 0x51, 0x5d, 0xb5, 0xf6, 0x06, 0x73, 0xce, 0x2e, 0x02, 0x20, 0x73, 0xda, 0xec, 0x50, 0xc6,
+    0xb9, 0xe2, 0x27, 0x30, 0x1f, 0xa0, 0x1a, 0xcb, 0xc3, 0x9f, 0x89, 0x9b, 0xbb, 0xfc, 0x25, 0x3e,
+    0x97, 0x8e, 0x4c, 0x2b, 0xc8, 0x4f, 0xaa, 0x91, 0xef, 0x2e, 0xec,
+};
+
+static const uint8_t CRITICAL_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xd4, 0x30, 0x82, 0x01, 0x7a, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x0c, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32,
+    0x5a, 0x18, 0x0f, 0x32, 0x30, 0x38, 0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x32, 0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04,
+    0x96, 0x2a, 0x13, 0x4a, 0x75, 0x60, 0x83, 0x5d, 0xe4, 0x44, 0x95, 0x44, 0x77, 0x92, 0xc4, 0xec,
+    0x82, 0x9e, 0x73, 0x0f, 0xad, 0xcc, 0xa0, 0xee, 0xc2, 0x4b, 0x06, 0xf3, 0x7a, 0x84, 0x6a, 0x3e,
+    0x2a, 0xc3, 0xf5, 0x79, 0xd0, 0x12, 0x99, 0x4a, 0xcf, 0x07, 0xb7, 0x1a, 0xe3, 0x22, 0x1c, 0xf3,
+    0xa9, 0x4e, 0xc0, 0x1e, 0xe6, 0x12, 0x2d, 0x11, 0xfb, 0x11, 0xf1, 0x45, 0xcf, 0x36, 0x03, 0x92,
+    0xa3, 0x81, 0x9f, 0x30, 0x81, 0x9c, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff,
+    0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04,
+    0x03, 0x02, 0x07, 0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xe5,
+    0x75, 0xb6, 0xdc, 0x49, 0xc8, 0x35, 0xa8, 0xfe, 0xf9, 0x81, 0xb2, 0x77, 0x7e, 0x0c, 0x8b, 0x5c,
+    0x89, 0x35, 0x46, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+    0x41, 0xfe, 0xfb, 0x37, 0xaa, 0xfb, 0xed, 0x86, 0x0d, 0x1c, 0x3b, 0x70, 0x64, 0x4c, 0x06, 0xd7,
+    0x9b, 0x64, 0x41, 0x87, 0x30, 0x28, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x21, 0x30, 0x1f, 0x86,
+    0x1d, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c,
+    0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x63, 0x72, 0x69, 0x74, 0x69, 0x63, 0x61, 0x6c, 0x30, 0x12,
+    0x06, 0x09, 0x2b, 0x06, 0x01, 0x04, 0x01, 0x83, 0xb2, 0x03, 0x01, 0x01, 0x01, 0xff, 0x04, 0x02,
+    0x05, 0x00, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48,
+    0x00, 0x30, 0x45, 0x02, 0x20, 0x68, 0xc3, 0x10, 0x0d, 0x20, 0xae, 0xa5, 0xdb, 0xab, 0x05, 0x44,
+    0xc9, 0xfc, 0x07, 0x30, 0x91, 0xc4, 0xa3, 0x3c, 0xa5, 0x0a, 0x65, 0x85, 0x3d, 0x85, 0x8d, 0xa7,
+    0x11, 0x1f, 0xe4, 0x84, 0x06, 0x02, 0x21, 0x00, 0xfa, 0x96, 0x2e, 0x5f, 0x7e, 0x8f, 0xe3, 0x57,
+    0x97, 0xb5, 0x91, 0x6d, 0x95, 0x13, 0x4d, 0x5f, 0x10, 0x13, 0xb3, 0x5b, 0x67, 0x9d, 0xca, 0xaf,
+    0x26, 0x80, 0xb0, 0xfb, 0x20, 0x0c, 0xbf, 0x73,
+};
+
+static const uint8_t PERMITTED_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xce, 0x30, 0x82, 0x01, 0x74, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x0d, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x3e, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x65, 0x72, 0x6d, 0x69, 0x74, 0x74, 0x65, 0x64,
+    0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x20, 0x17,
+    0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x18, 0x0f,
+    0x32, 0x30, 0x38, 0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x30,
+    0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46,
+    0x46, 0x45, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xf0, 0xe3, 0x4b,
+    0xc3, 0x40, 0x6c, 0x82, 0x47, 0x2d, 0x8f, 0x5a, 0x42, 0x9e, 0x19, 0x11, 0x40, 0xc5, 0xec, 0xe0,
+    0x75, 0x37, 0x77, 0x2a, 0x75, 0xb6, 0x84, 0xfe, 0xe9, 0xcb, 0x0b, 0x2f, 0x19, 0x04, 0xbd, 0x8b,
+    0x94, 0x13, 0x63, 0xfc, 0xc3, 0xa4, 0xa0, 0xf3, 0xbf, 0x1a, 0xa9, 0x57, 0xe3, 0xb0, 0xf4, 0x0e,
+    0xda, 0xe8, 0xec, 0xf5, 0x6f, 0x11, 0x80, 0x38, 0xc1, 0xbe, 0xfe, 0x92, 0x86, 0xa3, 0x81, 0x8c,
+    0x30, 0x81, 0x89, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30,
+    0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07,
+    0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xf5, 0x66, 0xd1, 0x70,
+    0xf3, 0x09, 0xba, 0xa2, 0x94, 0x2a, 0xc5, 0x53, 0xe1, 0xea, 0xc3, 0xa5, 0x05, 0x31, 0x3c, 0x59,
+    0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x29, 0x15, 0x01,
+    0xcf, 0x85, 0x64, 0x6c, 0xab, 0xcd, 0xaa, 0xdf, 0x74, 0x36, 0x1d, 0x17, 0x8a, 0x66, 0x93, 0xba,
+    0xce, 0x30, 0x29, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x22, 0x30, 0x20, 0x86, 0x1e, 0x73, 0x70,
+    0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f,
+    0x72, 0x67, 0x2f, 0x70, 0x65, 0x72, 0x6d, 0x69, 0x74, 0x74, 0x65, 0x64, 0x30, 0x0a, 0x06, 0x08,
+    0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00,
+    0xe0, 0x4e, 0x0a, 0xc1, 0x5c, 0x60, 0x6a, 0xd9, 0x22, 0xcf, 0xdd, 0xf4, 0x7d, 0x15, 0xa0, 0xf3,
+    0xa0, 0xb5, 0x3b, 0x66, 0x02, 0x5e, 0xe0, 0x7a, 0xed, 0xcd, 0x86, 0x20, 0xd1, 0xea, 0xd2, 0x29,
+    0x02, 0x20, 0x29, 0x7c, 0x48, 0xe5, 0xd7, 0xc9, 0x3a, 0xec, 0x67, 0xba, 0x80, 0xe8, 0xa0, 0x8c,
+    0x2b, 0xf9, 0xd8, 0x97, 0xc0, 0x43, 0x59, 0xa3, 0xec, 0xb1, 0x01, 0x83, 0xb1, 0xd8, 0xd4, 0xda,
+    0x96, 0x2a,
+};
+
+static const uint8_t OTHER_ORG_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xcd, 0x30, 0x82, 0x01, 0x73, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x0e, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x3e, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x2e, 0x6f, 0x72, 0x67,
+    0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x20, 0x17,
+    0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x18, 0x0f,
+    0x32, 0x30, 0x38, 0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x30,
+    0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46,
+    0x46, 0x45, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x2b, 0x13, 0xc2,
+    0x45, 0x1d, 0x83, 0xc7, 0xb2, 0xe2, 0xd5, 0x0e, 0x37, 0x61, 0xfc, 0x5f, 0x47, 0x6a, 0xfc, 0x61,
+    0xaa, 0x0c, 0x70, 0x1e, 0x39, 0xf0, 0x1f, 0x1e, 0x16, 0xa1, 0xd5, 0x1b, 0x72, 0x89, 0x6c, 0x68,
+    0x51, 0x2d, 0xa4, 0xef, 0xe0, 0x71, 0x9c, 0x92, 0x9c, 0x98, 0x9e, 0x5d, 0x9c, 0x16, 0x3d, 0x5a,
+    0x1c, 0x8d, 0x23, 0xd8, 0xea, 0xb3, 0x14, 0x2a, 0xd5, 0xe9, 0x2b, 0xd5, 0x82, 0xa3, 0x81, 0x8b,
+    0x30, 0x81, 0x88, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30,
+    0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07,
+    0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xec, 0x22, 0x95, 0x78,
+    0xdc, 0x53, 0x40, 0xbb, 0xad, 0x66, 0x9e, 0x4a, 0x51, 0x06, 0x1b, 0x69, 0xd6, 0xbb, 0xe3, 0xdc,
+    0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x4e, 0xe9, 0xb2,
+    0x7c, 0xc2, 0xb6, 0x2f, 0xff, 0x04, 0xfd, 0x88, 0xc7, 0x09, 0xc1, 0x22, 0x9b, 0x52, 0xaf, 0x52,
+    0x6c, 0x30, 0x28, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x21, 0x30, 0x1f, 0x86, 0x1d, 0x73, 0x70,
+    0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f,
+    0x72, 0x67, 0x2f, 0x65, 0x78, 0x63, 0x6c, 0x75, 0x64, 0x65, 0x64, 0x30, 0x0a, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xb7,
+    0x10, 0x01, 0xfd, 0x79, 0x35, 0x1f, 0x5b, 0x88, 0x7f, 0x64, 0x82, 0x95, 0x83, 0xfa, 0xec, 0x4c,
+    0x31, 0x4b, 0xa6, 0x28, 0x54, 0xa4, 0x43, 0xdb, 0xc2, 0xf1, 0xd2, 0x5e, 0x55, 0x90, 0x93, 0x02,
+    0x20, 0x59, 0xf2, 0xa5, 0x25, 0x6d, 0x7a, 0x8d, 0x4f, 0x33, 0xec, 0x37, 0x00, 0xa1, 0x7c, 0x45,
+    0xfa, 0x4a, 0x96, 0xad, 0x15, 0x53, 0xaf, 0x79, 0x85, 0x89, 0xd4, 0x0c, 0xf2, 0x0d, 0x66, 0x5f,
+    0xf8,
+};
+
+static const uint8_t ROTATED_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xc0, 0x30, 0x82, 0x01, 0x65, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x0f, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x31, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x15, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x70, 0x6f, 0x6c, 0x69, 0x63, 0x79, 0x20, 0x43, 0x41,
+    0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32,
+    0x5a, 0x18, 0x0f, 0x32, 0x30, 0x38, 0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32,
+    0x32, 0x5a, 0x30, 0x11, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x45, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04,
+    0x0a, 0xb1, 0xed, 0x41, 0xd5, 0x8b, 0xb2, 0x31, 0xf6, 0x76, 0x2d, 0x35, 0x5e, 0x32, 0x9a, 0x9c,
+    0x0c, 0xab, 0xc0, 0xb5, 0x4e, 0xde, 0x54, 0x2c, 0x45, 0x7e, 0x20, 0x9a, 0xf5, 0xde, 0xca, 0xe5,
+    0xdc, 0xa6, 0xb0, 0xf3, 0x28, 0xa0, 0x86, 0x1c, 0x03, 0xf3, 0xca, 0x8e, 0xe3, 0xd3, 0xe6, 0x51,
+    0x53, 0xda, 0x21, 0x88, 0xc2, 0xe6, 0xf8, 0x22, 0x21, 0x5d, 0xa5, 0xc9, 0x32, 0x5f, 0x87, 0xf9,
+    0xa3, 0x81, 0x8a, 0x30, 0x81, 0x87, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff,
+    0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04,
+    0x03, 0x02, 0x07, 0x80, 0x30, 0x27, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x20, 0x30, 0x1e, 0x86,
+    0x1c, 0x73, 0x70, 0x69, 0x66, 0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c,
+    0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x72, 0x6f, 0x74, 0x61, 0x74, 0x65, 0x64, 0x30, 0x1d, 0x06,
+    0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x72, 0xb1, 0x1b, 0x74, 0xb8, 0xe6, 0xcb, 0xb1,
+    0x0e, 0x00, 0xd8, 0x67, 0x3c, 0x97, 0x18, 0xfb, 0x43, 0x6e, 0xac, 0x8c, 0x30, 0x1f, 0x06, 0x03,
+    0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x5e, 0x04, 0x25, 0x17, 0x79, 0x68, 0x2e,
+    0x65, 0xb6, 0x7e, 0xaa, 0x1b, 0x24, 0xa2, 0x29, 0x48, 0x5e, 0x46, 0xd0, 0x24, 0x30, 0x0a, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x49, 0x00, 0x30, 0x46, 0x02, 0x21,
+    0x00, 0x8b, 0x08, 0x04, 0x1d, 0xdc, 0xca, 0x19, 0x57, 0xcc, 0x06, 0x2f, 0x0e, 0x79, 0xd2, 0x8d,
+    0x21, 0x3f, 0xa2, 0xed, 0x22, 0x91, 0xc5, 0xa9, 0x95, 0xb3, 0x67, 0x9e, 0x71, 0xfa, 0x32, 0xa8,
+    0x32, 0x02, 0x21, 0x00, 0x8e, 0x06, 0xaf, 0x5c, 0xa4, 0xd3, 0xa8, 0x0d, 0x0d, 0x0f, 0x27, 0xf9,
+    0xba, 0x4c, 0x4a, 0x20, 0x57, 0xd6, 0x74, 0x60, 0x27, 0xa3, 0x87, 0xc8, 0xa3, 0xd9, 0x49, 0x9b,
+    0x5c, 0x65, 0x21, 0xb6,
+};
+
+static const uint8_t ROTATED_INTERMEDIATE_LEAF_DER[] = {
+    0x30, 0x82, 0x01, 0xd7, 0x30, 0x82, 0x01, 0x7d, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x02, 0x20,
+    0x10, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x3c, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x31, 0x29, 0x30, 0x27, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x20, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x20, 0x72, 0x6f, 0x74, 0x61, 0x74, 0x65, 0x64, 0x20, 0x69,
+    0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x20, 0x17, 0x0d, 0x32,
+    0x36, 0x31, 0x30, 0x31, 0x37, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x18, 0x0f, 0x32, 0x30,
+    0x38, 0x31, 0x30, 0x37, 0x32, 0x30, 0x30, 0x30, 0x31, 0x32, 0x32, 0x32, 0x5a, 0x30, 0x11, 0x31,
+    0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x06, 0x53, 0x50, 0x49, 0x46, 0x46, 0x45,
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x2c, 0xa7, 0x9c, 0x8e, 0xa2,
+    0xd3, 0x2a, 0xf1, 0x5e, 0xeb, 0x7b, 0xeb, 0xfc, 0xaf, 0x48, 0xf2, 0xd7, 0xb6, 0xdd, 0xf7, 0x09,
+    0xe0, 0xbd, 0xb4, 0xcf, 0x72, 0x74, 0xe2, 0x99, 0x94, 0xc8, 0xa9, 0x31, 0xbb, 0xed, 0x84, 0x12,
+    0x12, 0xae, 0x58, 0x64, 0x88, 0x88, 0x1b, 0x01, 0x2e, 0x18, 0x28, 0xda, 0x40, 0x2a, 0x78, 0x5d,
+    0x85, 0x9e, 0x99, 0x44, 0x22, 0x48, 0x65, 0x75, 0x44, 0xec, 0xad, 0xa3, 0x81, 0x97, 0x30, 0x81,
+    0x94, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30,
+    0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30,
+    0x34, 0x06, 0x03, 0x55, 0x1d, 0x11, 0x04, 0x2d, 0x30, 0x2b, 0x86, 0x29, 0x73, 0x70, 0x69, 0x66,
+    0x66, 0x65, 0x3a, 0x2f, 0x2f, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x6f, 0x72, 0x67,
+    0x2f, 0x72, 0x6f, 0x74, 0x61, 0x74, 0x65, 0x64, 0x2d, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65,
+    0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14,
+    0xeb, 0xb6, 0xa4, 0x7b, 0x05, 0xff, 0xef, 0x9f, 0x0f, 0x61, 0x8d, 0x2a, 0x36, 0x11, 0x1f, 0x8f,
+    0xdd, 0x6c, 0x90, 0x97, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80,
+    0x14, 0x0b, 0xe4, 0x7f, 0x1d, 0x21, 0xec, 0xef, 0x98, 0x02, 0xf4, 0xe4, 0xba, 0x10, 0x77, 0xef,
+    0xc3, 0xc2, 0x61, 0x38, 0xb5, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03,
+    0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x3f, 0x4d, 0x66, 0x84, 0x80, 0xd7, 0x11, 0xad,
+    0x40, 0x26, 0xad, 0x48, 0xde, 0x1d, 0xc9, 0xf3, 0xfb, 0x1a, 0x0c, 0x3b, 0xd0, 0x30, 0x13, 0x8f,
+    0x35, 0xf6, 0xe7, 0xec, 0x8f, 0x30, 0xe2, 0x75, 0x02, 0x21, 0x00, 0xab, 0x90, 0xe3, 0xb5, 0xb1,
+    0x89, 0xb9, 0x8e, 0xfa, 0xd9, 0xc2, 0x8e, 0x24, 0xe3, 0xda, 0xc5, 0xf4, 0xb3, 0x07, 0x92, 0x6e,
+    0xba, 0x6c, 0xe1, 0x19, 0x4f, 0xde, 0xff, 0x65, 0xbe, 0xff, 0xd1,
+};
+
+// Copy of der with the first occurrence of from, which must be there, overwritten by to
+template <size_t N>
+Buffer patched(const uint8_t (&der)[N], const std::string& from, const std::string& to) {
+    Buffer copy(der, der + N);
+    Buffer needle(from.begin(), from.end());
+    auto at = std::search(copy.begin(), copy.end(), needle.begin(), needle.end());
+    if (at != copy.end()) {
+        std::copy(to.begin(), to.end(), at);
+    }
+    return copy;
+}
+
+}  // namespace testdata
+}  // namespace spiffe
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <spiffe/workload_api_hub.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mock/workload_api_server.h"
+
+namespace spiffe {
+
+namespace {
+
+std::string test_socket_path() { return "/tmp/spiffe-cpp-hub-" + std::to_string(getpid()) + ".sock"; }
+
+template <typename Condition>
+bool wait_until(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Contexts received by one subscriber
+struct Received {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<const X509SvidContext>> contexts;
+
+    WorkloadApiHub::Callback<X509SvidContext> callback() {
+        return [this](const std::shared_ptr<const X509SvidContext>& context) {
+            std::lock_guard<std::mutex> lock(mutex);
+            contexts.push_back(context);
+        };
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return contexts.size();
+    }
+};
+
+}  // namespace
+
+TEST(WorkloadApiHubTest, FansOutOneStream) {
+    mock::WorkloadApiServer server(test_socket_path());
+    ASSERT_TRUE(server.start());
+    WorkloadApiHub hub(server.socket_path());
+
+    Received first, second;
+    Subscription a = hub.subscribe_x509_svid(first.callback());
+    Subscription b = hub.subscribe_x509_svid(second.callback());
+    ASSERT_TRUE(wait_until([&] { return first.size() == 1 && second.size() == 1; }));
+
+    server.push_update();
+    ASSERT_TRUE(wait_until([&] { return first.size() == 2 && second.size() == 2; }));
+
+    // One stream, every subscriber gets the same decoded context
+    EXPECT_EQ(server.requests(), 1u);
+    EXPECT_EQ(first.contexts[1], second.contexts[1]);
+    EXPECT_NE(first.contexts[0], first.contexts[1]);
+    EXPECT_EQ(hub.x509_svid(), first.contexts[1]);
+    EXPECT_EQ(first.contexts[1]->svids.size(), 1u);
+
+    // A late subscriber gets the latest update before subscribe returns
+    Received late;
+    Subscription c = hub.subscribe_x509_svid(late.callback());
+    ASSERT_EQ(late.size(), 1u);
+    EXPECT_EQ(late.contexts[0], first.contexts[1]);
+
+    // Other RPCs get their own stream once subscribed to
+    EXPECT_EQ(hub.jwt_bundles(), nullptr);
+    std::atomic<int> jwt_updates{0};
+    Subscription d = hub.subscribe_jwt_bundles([&](const std::shared_ptr<const JwtBundles>& bundles) {
+        EXPECT_EQ(bundles->bundles.count("spiffe://example.org"), 1u);
+        ++jwt_updates;
+    });
+    ASSERT_TRUE(wait_until([&] { return jwt_updates == 1; }));
+    EXPECT_EQ(server.requests(), 2u);
+}
+
+TEST(WorkloadApiHubTest, Unsubscribe) {
+    mock::WorkloadApiServer server(test_socket_path());
+    ASSERT_TRUE(server.start());
+    WorkloadApiHub hub(server.socket_path());
+
+    Received kept, dropped;
+    Subscription a = hub.subscribe_x509_svid(kept.callback());
+    Subscription b = hub.subscribe_x509_svid(dropped.callback());
+
+    // Unsubscribing from within the callback, on the second update
+    std::mutex self_mutex;
+    Subscription self;
+    std::atomic<int> self_updates{0};
+    Subscription subscribed = hub.subscribe_x509_svid([&](const std::shared_ptr<const X509SvidContext>&) {
+        if (++self_updates == 2) {
+            std::lock_guard<std::mutex> lock(self_mutex);
+            self.unsubscribe();
+        }
+    });
+    {
+        std::lock_guard<std::mutex> lock(self_mutex);
+        self = std::move(subscribed);
+    }
+    ASSERT_TRUE(wait_until([&] { return kept.size() == 1 && dropped.size() == 1 && self_updates == 1; }));
+
+    b.unsubscribe();
+    EXPECT_FALSE(b.active());
+    b.unsubscribe();
+
+    server.push_update();
+    server.push_update();
+    ASSERT_TRUE(wait_until([&] { return kept.size() == 3; }));
+    EXPECT_EQ(dropped.size(), 1u);
+    EXPECT_EQ(self_updates, 2);
+
+    // Moved subscriptions stay subscribed, and may outlive the hub
+    Subscription moved = std::move(a);
+    EXPECT_FALSE(a.active());
+    EXPECT_TRUE(moved.active());
+}
+
+TEST(WorkloadApiHubTest, ReopensEndedStreams) {
+    // One update, then a status that is not retried
+    mock::WorkloadApiServerOptions options;
+    options.error_code = 3;
+    options.error_after_messages = 1;
+    mock::WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+    WorkloadApiHub hub(server.socket_path());
+
+    Received first;
+    Subscription a = hub.subscribe_x509_svid(first.callback());
+    ASSERT_TRUE(wait_until([&] { return first.size() == 1; }));
+    EXPECT_EQ(server.requests(), 1u);
+
+    // The next subscription reopens the stream, existing subscribers get its updates too
+    server.set_options(mock::WorkloadApiServerOptions());
+    Received second;
+    ASSERT_TRUE(wait_until([&] {
+        Subscription b = hub.subscribe_x509_svid(second.callback());
+        return server.requests() == 2;
+    }));
+    ASSERT_TRUE(wait_until([&] { return first.size() == 2; }));
+    EXPECT_NE(first.contexts[1], first.contexts[0]);
+    EXPECT_EQ(hub.x509_svid(), first.contexts[1]);
+    EXPECT_EQ(server.requests(), 2u);
+}
+
+TEST(WorkloadApiHubTest, ProcessWideHubs) {
+    std::shared_ptr<WorkloadApiHub> hub = WorkloadApiHub::get("/nonexistent/spiffe-cpp-hub-a.sock");
+    EXPECT_EQ(WorkloadApiHub::get("/nonexistent/spiffe-cpp-hub-a.sock"), hub);
+    EXPECT_NE(WorkloadApiHub::get("/nonexistent/spiffe-cpp-hub-b.sock"), hub);
+
+    // Unreachable agent, subscribers just get nothing
+    int updates = 0;
+    Subscription subscription = hub->subscribe_x509_bundles([&](const std::shared_ptr<const X509BundlesContext>&) {
+        ++updates;
+    });
+    EXPECT_EQ(hub->x509_bundles(), nullptr);
+
+    // Subscriptions do not keep the hub alive
+    std::weak_ptr<WorkloadApiHub> weak = hub;
+    hub.reset();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(updates, 0);
+}
+
+}  // namespace spiffe
@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+#include <spiffe/spiffe.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "jwt.h"
+#include "mock/workload_api_server.h"
+
+namespace spiffe {
+namespace mock {
+
+namespace {
+
+std::string test_socket_path() { return "/tmp/spiffe-cpp-mock-" + std::to_string(getpid()) + ".sock"; }
+
+// First update of the FetchX509SVID stream
+Status first_x509_svid_update(WorkloadApiClient& client, X509SvidContext& out) {
+    CancellationSource cancellation;
+    bool received = false;
+    Status status = client.fetch_x509_svid(
+        [&](const X509SvidContext& context) {
+            out = context;
+            received = true;
+            cancellation.cancel();
+            return Status{};
+        },
+        cancellation.token());
+    return received ? Status{} : status;
+}
+
+}  // namespace
+
+TEST(WorkloadApiServerTest, ServesConfiguredIdentities) {
+    WorkloadApiServerOptions options;
+    options.svids = 2;
+    options.svid_chain_length = 3;
+    options.federated_trust_domains = 5;
+    options.certificate_size = 300;
+    WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+
+    X509SvidContext svid_context;
+    ASSERT_TRUE(first_x509_svid_update(client, svid_context).is_ok());
+    ASSERT_EQ(svid_context.svids.size(), 2u);
+    EXPECT_EQ(svid_context.svids[0].spiffe_id, "spiffe://example.org/workload/0");
+    EXPECT_EQ(svid_context.svids[1].hint, "hint-1");
+    EXPECT_EQ(svid_context.svids[0].x509_svid.size(), 3u);
+    EXPECT_EQ(svid_context.svids[0].x509_svid.front().size(), 300u);
+    EXPECT_EQ(svid_context.svids[0].bundle.size(), 3u);
+    EXPECT_EQ(svid_context.federated_bundles.size(), 5u);
+    EXPECT_EQ(svid_context.federated_bundles.count("spiffe://federated-4.example.org"), 1u);
+
+    CancellationSource cancellation;
+    X509BundlesContext bundles_context;
+    client.fetch_x509_bundles(
+        [&](const X509BundlesContext& context) {
+            bundles_context = context;
+            cancellation.cancel();
+            return Status{};
+        },
+        cancellation.token());
+    EXPECT_EQ(bundles_context.bundles.size(), 6u);
+
+    std::vector<JwtSvid> svids;
+    ASSERT_TRUE(client.fetch_jwt_svid(svids, {"audience"}, "spiffe://example.org/workload/1").is_ok());
+    ASSERT_EQ(svids.size(), 1u);
+    EXPECT_EQ(svids[0].spiffe_id, "spiffe://example.org/workload/1");
+
+    JsonValue claims;
+    ASSERT_TRUE(decode_jwt_claims(svids[0].svid, claims));
+    int64_t exp = 0;
+    EXPECT_TRUE(read_jwt_expiry(svids[0].svid, exp));
+    EXPECT_GT(exp, 0);
+
+    Status status = client.fetch_jwt_svid(svids, {"audience"}, "spiffe://example.org/other");
+    EXPECT_EQ(status.code, 7);
+}
+
+TEST(WorkloadApiServerTest, PushesUpdatesAtInterval) {
+    WorkloadApiServerOptions options;
+    options.update_interval = std::chrono::milliseconds(5);
+    WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+    CancellationSource cancellation;
+    std::vector<uint8_t> fills;
+    client.fetch_x509_svid(
+        [&](const X509SvidContext& context) {
+            // Rotated certificates, the fill byte follows the generation
+            fills.push_back(context.svids[0].x509_svid.front().data()[4]);
+            if (fills.size() == 5) {
+                cancellation.cancel();
+            }
+            return Status{};
+        },
+        cancellation.token());
+
+    ASSERT_EQ(fills.size(), 5u);
+    for (size_t i = 1; i < fills.size(); ++i) {
+        EXPECT_NE(fills[i], fills[i - 1]);
+    }
+    EXPECT_GE(server.generation(), 5u);
+}
+
+TEST(WorkloadApiServerTest, PushUpdateReachesAllStreams) {
+    WorkloadApiServer server(test_socket_path());
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+    CancellationSource cancellation;
+    int svid_updates = 0;
+    int bundle_updates = 0;
+    std::thread svid_stream([&] {
+        client.fetch_x509_svid([&](const X509SvidContext&) { return ++svid_updates, Status{}; }, cancellation.token());
+    });
+    std::thread bundle_stream([&] {
+        client.fetch_jwt_bundles([&](const JwtBundles&) { return ++bundle_updates, Status{}; }, cancellation.token());
+    });
+
+    ASSERT_TRUE(server.wait_for_streams(2, std::chrono::seconds(5)));
+    server.push_update();
+    server.push_update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    cancellation.cancel();
+    svid_stream.join();
+    bundle_stream.join();
+
+    EXPECT_EQ(svid_updates, 3);
+    EXPECT_EQ(bundle_updates, 3);
+    EXPECT_EQ(server.requests(), 2u);
+}
+
+// Messages split into DATA frames of a few bytes still reassemble
+TEST(WorkloadApiServerTest, SplitsFramesAtArbitraryBoundaries) {
+    WorkloadApiServerOptions options;
+    options.federated_trust_domains = 3;
+    options.certificate_size = 200;
+    WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+    X509SvidContext expected;
+    ASSERT_TRUE(first_x509_svid_update(client, expected).is_ok());
+
+    for (size_t frame_size : {1, 3, 7, 1000}) {
+        options.data_frame_size = frame_size;
+        server.set_options(options);
+
+        X509SvidContext context;
+        ASSERT_TRUE(first_x509_svid_update(client, context).is_ok()) << frame_size;
+        ASSERT_EQ(context.svids.size(), 1u);
+        EXPECT_EQ(context.svids[0].x509_svid, expected.svids[0].x509_svid);
+        EXPECT_EQ(context.federated_bundles, expected.federated_bundles);
+    }
+}
+
+TEST(WorkloadApiServerTest, MaxMessageSizeIsConfigurable) {
+    WorkloadApiServerOptions options;
+    options.federated_trust_domains = 8;
+    options.certificate_size = 1000;
+    options.data_frame_size = 1000;
+    WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    ClientOptions small;
+    small.max_message_size = 4096;
+    WorkloadApiClient rejects(server.socket_path(), small);
+    X509SvidContext context;
+    EXPECT_EQ(first_x509_svid_update(rejects, context).code, 13);
+
+    ClientOptions large;
+    large.max_message_size = 64 * 1024;
+    WorkloadApiClient accepts(server.socket_path(), large);
+    ASSERT_TRUE(first_x509_svid_update(accepts, context).is_ok());
+    EXPECT_EQ(context.federated_bundles.size(), 8u);
+}
+
+TEST(WorkloadApiServerTest, ErrorTrailers) {
+    WorkloadApiServerOptions options;
+    options.error_code = 14;
+    options.error_message = "agent is shutting down";
+    WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+    std::vector<JwtSvid> svids;
+    Status status = client.fetch_jwt_svid(svids, {"audience"});
+    EXPECT_EQ(status.code, 14);
+    EXPECT_EQ(status.message, "agent is shutting down");
+
+    // Stream fails after two updates
+    options.error_after_messages = 2;
+    server.set_options(options);
+
+    int updates = 0;
+    std::thread stream([&] {
+        status = client.fetch_jwt_bundles([&](const JwtBundles&) { return ++updates, Status{}; }, CancellationToken());
+    });
+    ASSERT_TRUE(server.wait_for_streams(1, std::chrono::seconds(5)));
+    server.push_update();
+    stream.join();
+
+    EXPECT_EQ(status.code, 14);
+    EXPECT_EQ(updates, 2);
+}
+
+TEST(WorkloadApiServerTest, ResponseDelay) {
+    WorkloadApiServerOptions options;
+    options.response_delay = std::chrono::milliseconds(100);
+    WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+    std::vector<JwtSvid> svids;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(client.fetch_jwt_svid(svids, {"audience"}).is_ok());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+
+    // Timing out before the slow agent answers
+    options.response_delay = std::chrono::milliseconds(2000);
+    server.set_options(options);
+    Status status = client.fetch_jwt_svid(svids, {"audience"}, "", std::chrono::milliseconds(100));
+    EXPECT_NE(status.code, 0);
+}
+
+TEST(WorkloadApiServerTest, BatchedJwtSvidsShareOneRoundTrip) {
+    WorkloadApiServerOptions options;
+    options.svids = 2;
+    options.response_delay = std::chrono::milliseconds(200);
+    WorkloadApiServer server(test_socket_path(), options);
+    ASSERT_TRUE(server.start());
+
+    WorkloadApiClient client(server.socket_path());
+    std::vector<JwtSvidRequest> requests;
+    for (int i = 0; i < 20; ++i) {
+        requests.push_back(JwtSvidRequest{{"audience-" + std::to_string(i)}, "spiffe://example.org/workload/1"});
+    }
+
+    std::vector<JwtSvidResult> results;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(client.fetch_jwt_svids(requests, results).is_ok());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_EQ(server.requests(), 20u);
+
+    ASSERT_EQ(results.size(), 20u);
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_EQ(results[i].svids.size(), 1u);
+        EXPECT_EQ(results[i].svids[0].spiffe_id, "spiffe://example.org/workload/1");
+
+        JsonValue claims;
+        ASSERT_TRUE(decode_jwt_claims(results[i].svids[0].svid, claims));
+    }
+
+    // One deadline for the whole batch, every request times out on a slow agent
+    options.response_delay = std::chrono::milliseconds(2000);
+    server.set_options(options);
+    start = std::chrono::steady_clock::now();
+    Status status = client.fetch_jwt_svids(requests, results, std::chrono::milliseconds(100));
+    EXPECT_NE(status.code, 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    for (const auto& result : results) {
+        EXPECT_NE(result.status.code, 0);
+    }
+}
+
+}  // namespace mock
+}  // namespace spiffe
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <spiffe/x509_bundle_index.h>
+#include <spiffe/x509_source.h>
+
+#include <string>
+
+#include "testdata/x509_certificates.h"
+
+namespace spiffe {
+
+namespace {
+
+Buffer ca_der() { return Buffer(testdata::CA_DER, testdata::CA_DER + sizeof(testdata::CA_DER)); }
+Buffer leaf_der() { return Buffer(testdata::LEAF_DER, testdata::LEAF_DER + sizeof(testdata::LEAF_DER)); }
+
+}  // namespace
+
+TEST(X509BundleIndexTest, FindsIssuer) {
+    Buffer leaf_buffer = leaf_der();
+    X509CertificateView leaf{BufferView(leaf_buffer)};
+
+    // Malformed certificates are left out of the index
+    X509BundleIndex index(X509Bundle{Buffer{0x30, 0x00}, ca_der()});
+    ASSERT_EQ(index.certificates().size(), 1u);
+    const X509CertificateView* ca = &index.certificates()[0];
+
+    EXPECT_EQ(index.find_issuer(leaf), ca);
+    EXPECT_EQ(index.find_issuer(*ca), ca);  // self-signed
+    EXPECT_EQ(index.find_by_subject_key_id(ca->subject_key_id()), ca);
+    EXPECT_EQ(index.find_by_subject(leaf.issuer()), ca);
+    EXPECT_EQ(index.find_by_subject(leaf.subject()), nullptr);
+
+    X509BundleIndex leaves(X509Bundle{leaf_der()});
+    EXPECT_EQ(leaves.find_issuer(leaf), nullptr);
+    EXPECT_EQ(X509BundleIndex(X509Bundle()).find_issuer(leaf), nullptr);
+}
+
+TEST(X509BundleIndexTest, FallsBackToIssuerName) {
+    X509BundleIndex index(X509Bundle{ca_der()});
+
+    // Unknown authority key identifier, the name still matches
+    Buffer other_key = testdata::patched(testdata::LEAF_DER, "\x80\x14\xd5\x17", "\x80\x14\xff\xff");
+    X509CertificateView leaf{BufferView(other_key)};
+    ASSERT_TRUE(leaf.valid());
+    EXPECT_EQ(index.find_issuer(leaf), &index.certificates()[0]);
+
+    // A matching key identifier is not enough on its own
+    Buffer other_name = testdata::patched(testdata::LEAF_DER, "example.org CA", "example.org XX");
+    EXPECT_EQ(index.find_issuer(X509CertificateView(BufferView(other_name))), nullptr);
+}
+
+TEST(X509BundleIndexTest, SetReusesUnchangedBundles) {
+    std::unordered_map<TrustDomain, X509Bundle> bundles = {
+        {"spiffe://a.org", X509Bundle{ca_der()}},
+        {"spiffe://b.org", X509Bundle{ca_der()}},
+        {"spiffe://c.org", X509Bundle{ca_der()}},
+    };
+    X509BundleIndexSet first(bundles);
+    ASSERT_EQ(first.size(), 3u);
+
+    // Same bytes in a new backing, changed, removed
+    bundles["spiffe://a.org"] = X509Bundle{ca_der()};
+    bundles["spiffe://b.org"] = X509Bundle{ca_der(), leaf_der()};
+    bundles.erase("spiffe://c.org");
+    X509BundleIndexSet second(bundles, &first);
+
+    EXPECT_EQ(second.size(), 2u);
+    EXPECT_EQ(second.get("spiffe://a.org"), first.get("spiffe://a.org"));
+    ASSERT_NE(second.get("spiffe://b.org"), nullptr);
+    EXPECT_NE(second.get("spiffe://b.org"), first.get("spiffe://b.org"));
+    EXPECT_EQ(second.get("spiffe://b.org")->certificates().size(), 2u);
+    EXPECT_EQ(second.get("spiffe://c.org"), nullptr);
+
+    // Setting a trust domain again replaces its index, unless the previous one can be reused
+    second.set("spiffe://a.org", X509Bundle{ca_der(), leaf_der()}, &first);
+    ASSERT_NE(second.get("spiffe://a.org"), nullptr);
+    EXPECT_EQ(second.get("spiffe://a.org")->certificates().size(), 2u);
+    second.set("spiffe://a.org", X509Bundle{ca_der()}, &first);
+    EXPECT_EQ(second.get("spiffe://a.org"), first.get("spiffe://a.org"));
+}
+
+TEST(X509BundleIndexTest, SnapshotIndexesOwnAndFederatedBundles) {
+    X509SvidContext context;
+    context.svids.push_back(X509Svid{
+        .spiffe_id = "spiffe://example.org/workload",
+        .x509_svid = X509CertificateChain{leaf_der()},
+        .bundle = X509Bundle{ca_der()},
+    });
+    context.federated_bundles["spiffe://federated.org"] = X509Bundle{ca_der()};
+
+    X509SvidSnapshot first(context, 1);
+    const X509BundleIndex* own = first.bundle_indexes().get("spiffe://example.org");
+    ASSERT_NE(own, nullptr);
+    X509CertificateView leaf(first.svid()->x509_svid.front());
+    EXPECT_NE(own->find_issuer(leaf), nullptr);
+    EXPECT_NE(first.bundle_indexes().get("spiffe://federated.org"), nullptr);
+
+    // The next update only rotates the federated bundle
+    context.federated_bundles["spiffe://federated.org"] = X509Bundle{ca_der(), ca_der()};
+    X509SvidSnapshot second(context, 2, &first);
+    EXPECT_EQ(second.bundle_indexes().get("spiffe://example.org"), own);
+    EXPECT_NE(second.bundle_indexes().get("spiffe://federated.org"),
+              first.bundle_indexes().get("spiffe://federated.org"));
+}
+
+}  // namespace spiffe
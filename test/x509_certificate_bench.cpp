@@ -0,0 +1,198 @@
+#include <benchmark/benchmark.h>
+#include <spiffe/x509_bundle_index.h>
+#include <spiffe/x509_certificate.h>
+#include <spiffe/x509_verifier.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "testdata/x509_certificates.h"
+
+#ifdef SPIFFE_BENCH_OPENSSL
+#include <openssl/asn1.h>
+#include <openssl/opensslv.h>
+#include <openssl/x509.h>
+#include <openssl/x509v3.h>
+#endif
+
+// Reading the fields an SVID consumer needs (SPIFFE ID, validity, key identifiers) out of one
+// DER certificate, with X509CertificateView and with a full OpenSSL parse.
+
+namespace spiffe {
+
+namespace {
+
+const BufferView LEAF(testdata::LEAF_DER, sizeof(testdata::LEAF_DER));
+
+void replace_all(Buffer& der, const std::string& from, const std::string& to) {
+    Buffer needle(from.begin(), from.end());
+    for (auto it = std::search(der.begin(), der.end(), needle.begin(), needle.end()); it != der.end();
+         it = std::search(it + 1, der.end(), needle.begin(), needle.end())) {
+        std::copy(to.begin(), to.end(), it);
+    }
+}
+
+// count CAs with distinct names and key identifiers, the issuer of LEAF last. The names keep the
+// length of "example.org CA" and the key identifiers differ in the last three digits, up to 1000.
+X509Bundle make_bundle(size_t count) {
+    std::vector<Buffer> certificates;
+    for (size_t i = 0; i + 1 < count; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "example.%06zu", i % 1000000);
+        Buffer ca(testdata::CA_DER, testdata::CA_DER + sizeof(testdata::CA_DER));
+        replace_all(ca, "example.org CA", name);
+        replace_all(ca, "\x04\x14\xd5\x17\xe2", std::string("\x04\x14") + name[11] + name[12] + name[13]);
+        certificates.push_back(ca);
+    }
+    certificates.push_back(Buffer(testdata::CA_DER, testdata::CA_DER + sizeof(testdata::CA_DER)));
+    return X509Bundle(certificates);
+}
+
+}  // namespace
+
+static void BM_X509ViewSpiffeId(benchmark::State& state) {
+    for (auto _ : state) {
+        X509CertificateView view(LEAF);
+        benchmark::DoNotOptimize(view.uri_san());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * LEAF.size()));
+}
+BENCHMARK(BM_X509ViewSpiffeId);
+
+static void BM_X509ViewAllFields(benchmark::State& state) {
+    for (auto _ : state) {
+        X509CertificateView view(LEAF);
+        benchmark::DoNotOptimize(view.uri_san());
+        benchmark::DoNotOptimize(view.not_before());
+        benchmark::DoNotOptimize(view.not_after());
+        benchmark::DoNotOptimize(view.serial());
+        benchmark::DoNotOptimize(view.issuer());
+        benchmark::DoNotOptimize(view.subject());
+        benchmark::DoNotOptimize(view.subject_key_id());
+        benchmark::DoNotOptimize(view.authority_key_id());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * LEAF.size()));
+}
+BENCHMARK(BM_X509ViewAllFields);
+
+// Issuer of a leaf in a bundle of N CAs: re-parsing every CA, as without an index...
+static void BM_FindIssuerScan(benchmark::State& state) {
+    X509Bundle bundle = make_bundle(static_cast<size_t>(state.range(0)));
+    X509CertificateView leaf(LEAF);
+
+    for (auto _ : state) {
+        BufferView issuer;
+        for (const BufferView& der : bundle) {
+            X509CertificateView ca(der);
+            if (ca.subject() == leaf.issuer() && ca.subject_key_id() == leaf.authority_key_id()) {
+                issuer = der;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(issuer);
+    }
+}
+BENCHMARK(BM_FindIssuerScan)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// ...and through an X509BundleIndex, built once per bundle update
+static void BM_FindIssuerIndexed(benchmark::State& state) {
+    X509BundleIndex index(make_bundle(static_cast<size_t>(state.range(0))));
+    X509CertificateView leaf(LEAF);
+    leaf.valid();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.find_issuer(leaf));
+    }
+}
+BENCHMARK(BM_FindIssuerIndexed)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_BuildBundleIndex(benchmark::State& state) {
+    X509Bundle bundle = make_bundle(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        X509BundleIndex index(bundle);
+        benchmark::DoNotOptimize(index.certificates().data());
+    }
+}
+BENCHMARK(BM_BuildBundleIndex)->Arg(10)->Arg(1000);
+
+// Peer verification of a leaf signed by the bundle's CA, building the path and checking the
+// signature on every connection...
+static void BM_VerifyX509Svid(benchmark::State& state) {
+    X509BundleIndexSet bundles;
+    bundles.set("spiffe://example.org", make_bundle(10), nullptr);
+    X509CertificateChain chain{LEAF.to_buffer()};
+    std::string spiffe_id;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(verify_x509_svid(chain, bundles, spiffe_id).code);
+    }
+}
+BENCHMARK(BM_VerifyX509Svid);
+
+// ...and for a repeat peer, served by the verified-chain cache
+static void BM_VerifyX509SvidCached(benchmark::State& state) {
+    X509BundleIndexSet bundles;
+    bundles.set("spiffe://example.org", make_bundle(10), nullptr);
+    X509CertificateChain chain{LEAF.to_buffer()};
+    X509SvidVerifier verifier;
+    std::string spiffe_id;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(verifier.verify(chain, bundles, spiffe_id).code);
+    }
+}
+BENCHMARK(BM_VerifyX509SvidCached)->ThreadRange(1, 8);
+
+#ifdef SPIFFE_BENCH_OPENSSL
+
+struct OpenSslContext {
+    OpenSslContext() { benchmark::AddCustomContext("openssl", OPENSSL_VERSION_TEXT); }
+} openssl_context;
+
+static void BM_OpenSslD2iX509(benchmark::State& state) {
+    for (auto _ : state) {
+        const unsigned char* data = LEAF.data();
+        X509* cert = d2i_X509(nullptr, &data, static_cast<long>(LEAF.size()));
+        benchmark::DoNotOptimize(cert);
+        X509_free(cert);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * LEAF.size()));
+}
+BENCHMARK(BM_OpenSslD2iX509);
+
+static void BM_OpenSslAllFields(benchmark::State& state) {
+    for (auto _ : state) {
+        const unsigned char* data = LEAF.data();
+        X509* cert = d2i_X509(nullptr, &data, static_cast<long>(LEAF.size()));
+
+        GENERAL_NAMES* names =
+            static_cast<GENERAL_NAMES*>(X509_get_ext_d2i(cert, NID_subject_alt_name, nullptr, nullptr));
+        for (int i = 0; i < sk_GENERAL_NAME_num(names); ++i) {
+            const GENERAL_NAME* name = sk_GENERAL_NAME_value(names, i);
+            if (name->type == GEN_URI) {
+                benchmark::DoNotOptimize(ASN1_STRING_get0_data(name->d.uniformResourceIdentifier));
+                break;
+            }
+        }
+        GENERAL_NAMES_free(names);
+
+        benchmark::DoNotOptimize(X509_get0_notBefore(cert));
+        benchmark::DoNotOptimize(X509_get0_notAfter(cert));
+        benchmark::DoNotOptimize(X509_get0_serialNumber(cert));
+        benchmark::DoNotOptimize(X509_get_issuer_name(cert));
+        benchmark::DoNotOptimize(X509_get_subject_name(cert));
+        benchmark::DoNotOptimize(X509_get0_subject_key_id(cert));
+        benchmark::DoNotOptimize(X509_get0_authority_key_id(cert));
+        X509_free(cert);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * LEAF.size()));
+}
+BENCHMARK(BM_OpenSslAllFields);
+
+#endif
+
+}  // namespace spiffe
@@ -0,0 +1,24 @@
+#include <spiffe/types.h>
+#include <spiffe/x509_certificate.h>
+
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
+    spiffe::X509CertificateView view(spiffe::BufferView(Data, Size));
+
+    // Extension fields first, so they also run before the TBSCertificate was parsed on its own
+    volatile size_t sink = view.uri_san().size() + view.uri_san_count() + view.subject_key_id().size() +
+                           view.authority_key_id().size() + view.is_ca();
+    sink = sink + view.valid() + view.serial().size() + view.issuer().size() + view.subject().size() +
+           view.subject_public_key_info().size() + view.tbs_certificate().size() +
+           static_cast<size_t>(view.not_before().time_since_epoch().count()) +
+           static_cast<size_t>(view.not_after().time_since_epoch().count());
+
+    // Every certificate of a chain, as handed out by CertificateList
+    spiffe::CertificateList list = spiffe::CertificateList::from_der(Data, Size);
+    for (const auto& cert : list) {
+        sink = sink + spiffe::X509CertificateView(cert).uri_san().size();
+    }
+    (void)sink;
+    return 0;
+}
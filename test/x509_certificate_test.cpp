@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <spiffe/x509_certificate.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "testdata/x509_certificates.h"
+
+namespace spiffe {
+
+namespace {
+
+BufferView view_of(const uint8_t* data, size_t size) { return BufferView(data, size); }
+
+std::string text(BufferView view) { return view.to_string(); }
+
+X509Time unix_time(int64_t seconds) { return X509Time(std::chrono::seconds(seconds)); }
+
+const Buffer CA_KEY_ID = {0xd5, 0x17, 0xe2, 0x2c, 0x9c, 0xcb, 0xaa, 0x87, 0x3a, 0xf6,
+                          0x50, 0xb0, 0x4d, 0x21, 0x76, 0x50, 0x2b, 0xc4, 0x39, 0x03};
+
+}  // namespace
+
+TEST(X509CertificateViewTest, ParsesLeaf) {
+    X509CertificateView leaf(view_of(testdata::LEAF_DER, sizeof(testdata::LEAF_DER)));
+    X509CertificateView ca(view_of(testdata::CA_DER, sizeof(testdata::CA_DER)));
+
+    ASSERT_TRUE(leaf.valid());
+    EXPECT_EQ(text(leaf.uri_san()), "spiffe://example.org/workload");
+    EXPECT_EQ(leaf.uri_san_count(), 1u);
+    EXPECT_EQ(leaf.serial(), BufferView(Buffer{0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xcd, 0xef}));
+    EXPECT_EQ(leaf.not_before(), unix_time(1792191510));  // 2026-10-16 22:58:30, UTCTime
+    EXPECT_EQ(leaf.not_after(), unix_time(3520191510));   // 2081-07-19 22:58:30, GeneralizedTime
+    EXPECT_FALSE(leaf.is_ca());
+    EXPECT_EQ(leaf.authority_key_id(), BufferView(CA_KEY_ID));
+    EXPECT_EQ(leaf.subject_key_id().size(), 20u);
+    EXPECT_EQ(leaf.issuer(), ca.subject());
+    EXPECT_EQ(leaf.subject_public_key_info()[0], 0x30);
+
+    // Views point into the input
+    EXPECT_EQ(leaf.der().data(), testdata::LEAF_DER);
+    EXPECT_EQ(leaf.tbs_certificate().data(), testdata::LEAF_DER + 4);
+    EXPECT_GE(leaf.uri_san().data(), testdata::LEAF_DER);
+    EXPECT_LT(leaf.uri_san().data(), testdata::LEAF_DER + sizeof(testdata::LEAF_DER));
+}
+
+TEST(X509CertificateViewTest, ParsesCa) {
+    X509CertificateView ca(view_of(testdata::CA_DER, sizeof(testdata::CA_DER)));
+
+    ASSERT_TRUE(ca.valid());
+    EXPECT_TRUE(ca.is_ca());
+    EXPECT_EQ(text(ca.uri_san()), "spiffe://example.org");
+    EXPECT_EQ(ca.serial(), BufferView(Buffer{0x01}));
+    EXPECT_EQ(ca.not_after(), unix_time(4945791510));  // 2126-09-22 22:58:30
+    EXPECT_EQ(ca.subject_key_id(), BufferView(CA_KEY_ID));
+    EXPECT_EQ(ca.issuer(), ca.subject());
+    EXPECT_EQ(ca.key_usage(), X509CertificateView::KEY_USAGE_KEY_CERT_SIGN | X509CertificateView::KEY_USAGE_CRL_SIGN);
+    EXPECT_EQ(ca.path_len_constraint(), -1);
+}
+
+TEST(X509CertificateViewTest, ParsesPolicyExtensions) {
+    X509CertificateView pathlen(
+        view_of(testdata::PATHLEN_INTERMEDIATE_DER, sizeof(testdata::PATHLEN_INTERMEDIATE_DER)));
+    ASSERT_TRUE(pathlen.valid());
+    EXPECT_EQ(pathlen.path_len_constraint(), 0);
+
+    X509CertificateView permitted(
+        view_of(testdata::PERMITTED_INTERMEDIATE_DER, sizeof(testdata::PERMITTED_INTERMEDIATE_DER)));
+    ASSERT_TRUE(permitted.valid());
+    EXPECT_FALSE(permitted.permitted_subtrees().empty());
+    EXPECT_TRUE(permitted.excluded_subtrees().empty());
+    EXPECT_FALSE(permitted.has_unknown_critical_extension());
+
+    X509CertificateView leaf(view_of(testdata::CRITICAL_LEAF_DER, sizeof(testdata::CRITICAL_LEAF_DER)));
+    ASSERT_TRUE(leaf.valid());
+    EXPECT_TRUE(leaf.has_key_usage());
+    EXPECT_EQ(leaf.key_usage(), X509CertificateView::KEY_USAGE_DIGITAL_SIGNATURE);
+    EXPECT_TRUE(leaf.has_unknown_critical_extension());
+}
+
+TEST(X509CertificateViewTest, ViewsCertificateList) {
+    Buffer chain(testdata::LEAF_DER, testdata::LEAF_DER + sizeof(testdata::LEAF_DER));
+    chain.insert(chain.end(), testdata::CA_DER, testdata::CA_DER + sizeof(testdata::CA_DER));
+    CertificateList list = CertificateList::from_der(chain.data(), chain.size());
+    ASSERT_EQ(list.size(), 2u);
+
+    std::vector<std::string> ids;
+    for (const BufferView& der : list) {
+        ids.push_back(text(X509CertificateView(der).uri_san()));
+    }
+    EXPECT_EQ(ids, (std::vector<std::string>{"spiffe://example.org/workload", "spiffe://example.org"}));
+}
+
+TEST(X509CertificateViewTest, ParsesTimes) {
+    // The RFC 5280 "no well-defined expiration date"
+    Buffer forever = testdata::patched(testdata::LEAF_DER, "20810719225830Z", "99991231235959Z");
+    X509CertificateView view{BufferView(forever)};
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.not_after(), unix_time(253402300799));
+
+    // UTCTime years 50 to 99 are 19xx
+    Buffer old = testdata::patched(testdata::LEAF_DER, "261016225830Z", "700101000000Z");
+    EXPECT_EQ(X509CertificateView(BufferView(old)).not_before(), unix_time(0));
+
+    const char* invalid[] = {"20811319225830Z", "20810700225830Z", "20810719245830Z", "2081071922583AZ",
+                             "20810719225830+"};
+    for (const char* time : invalid) {
+        Buffer bad = testdata::patched(testdata::LEAF_DER, "20810719225830Z", time);
+        X509CertificateView bad_view{BufferView(bad)};
+        EXPECT_FALSE(bad_view.valid()) << time;
+        EXPECT_EQ(bad_view.not_after(), X509Time()) << time;
+    }
+}
+
+TEST(X509CertificateViewTest, RejectsMalformed) {
+    const size_t size = sizeof(testdata::LEAF_DER);
+
+    // Every truncation, and trailing bytes after the certificate
+    for (size_t length = 0; length < size; ++length) {
+        X509CertificateView view(view_of(testdata::LEAF_DER, length));
+        EXPECT_FALSE(view.valid()) << length;
+        EXPECT_TRUE(view.uri_san().empty());
+        EXPECT_TRUE(view.serial().empty());
+    }
+    Buffer trailing(testdata::LEAF_DER, testdata::LEAF_DER + size);
+    trailing.push_back(0);
+    EXPECT_FALSE(X509CertificateView(BufferView(trailing)).valid());
+
+    // A broken extension leaves the TBSCertificate fields readable
+    Buffer bad_san = testdata::patched(testdata::LEAF_DER, "\x86\x1dspiffe", "\x86\x7f");  // URI past its SAN
+    X509CertificateView view{BufferView(bad_san)};
+    EXPECT_FALSE(view.valid());
+    EXPECT_TRUE(view.uri_san().empty());
+    EXPECT_EQ(view.not_after(), unix_time(3520191510));
+
+    EXPECT_FALSE(X509CertificateView().valid());
+}
+
+}  // namespace spiffe
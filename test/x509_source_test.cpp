@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <spiffe/x509_source.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "mock/workload_api_server.h"
+
+namespace spiffe {
+
+static X509SvidContext make_context() {
+    X509SvidContext context;
+    context.svids.push_back(X509Svid{.spiffe_id = "spiffe://example.org/a", .hint = "internal"});
+    context.svids.push_back(X509Svid{.spiffe_id = "spiffe://example.org/b", .hint = "external"});
+    context.svids.push_back(X509Svid{.spiffe_id = "spiffe://example.org/a", .hint = ""});
+    context.federated_bundles["spiffe://federated.org"] = X509Bundle{Buffer{0x30, 0x00}};
+    return context;
+}
+
+TEST(X509SourceTest, SnapshotLookups) {
+    X509SvidSnapshot snapshot(make_context(), 7);
+
+    EXPECT_EQ(snapshot.generation(), 7);
+    ASSERT_NE(snapshot.svid(), nullptr);
+    EXPECT_EQ(snapshot.svid()->spiffe_id, "spiffe://example.org/a");
+
+    // First SVID with a given ID wins
+    const X509Svid* by_id = snapshot.svid_by_id("spiffe://example.org/a");
+    ASSERT_NE(by_id, nullptr);
+    EXPECT_EQ(by_id->hint, "internal");
+
+    const X509Svid* by_hint = snapshot.svid_by_hint("external");
+    ASSERT_NE(by_hint, nullptr);
+    EXPECT_EQ(by_hint->spiffe_id, "spiffe://example.org/b");
+
+    // Empty hints are not indexed
+    EXPECT_EQ(snapshot.svid_by_hint(""), nullptr);
+    EXPECT_EQ(snapshot.svid_by_id("spiffe://example.org/c"), nullptr);
+
+    ASSERT_NE(snapshot.federated_bundle("spiffe://federated.org"), nullptr);
+    EXPECT_EQ(snapshot.federated_bundle("spiffe://federated.org")->size(), 1);
+    EXPECT_EQ(snapshot.federated_bundle("spiffe://other.org"), nullptr);
+}
+
+TEST(X509SourceTest, EmptySnapshot) {
+    X509SvidSnapshot snapshot(X509SvidContext{}, 1);
+    EXPECT_EQ(snapshot.svid(), nullptr);
+}
+
+TEST(X509SourceTest, UnreachableAgent) {
+    X509Source source("/nonexistent/spiffe-cpp-test.sock");
+    X509SourceReader reader(source);
+
+    source.start();
+    Status status = source.wait_until_ready(std::chrono::seconds(5));
+    EXPECT_FALSE(status.is_ok());
+    EXPECT_NE(status.code, 4);  // failed, not timed out
+
+    EXPECT_EQ(source.snapshot(), nullptr);
+    EXPECT_EQ(reader.get(), nullptr);
+
+    source.close();
+}
+
+TEST(X509SourceTest, RestartsAfterClose) {
+    mock::WorkloadApiServerOptions options;
+    options.error_code = 14;
+    mock::WorkloadApiServer server("/tmp/spiffe-cpp-source-" + std::to_string(getpid()) + ".sock", options);
+    ASSERT_TRUE(server.start());
+
+    X509Source source(server.socket_path());
+    X509SourceReader reader(source);
+    source.start();
+    EXPECT_EQ(source.wait_until_ready(std::chrono::seconds(5)).code, 14);
+    source.close();
+
+    // The new stream is waited for, the failure of the previous one is not reported again
+    server.set_options(mock::WorkloadApiServerOptions());
+    source.start();
+    ASSERT_TRUE(source.wait_until_ready(std::chrono::seconds(5)).is_ok());
+    ASSERT_NE(source.snapshot(), nullptr);
+    EXPECT_EQ(reader.get(), source.snapshot().get());
+    EXPECT_EQ(reader.get()->svid()->spiffe_id, "spiffe://example.org/workload/0");
+
+    source.close();
+}
+
+}  // namespace spiffe
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <spiffe/x509_verifier.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "testdata/x509_certificates.h"
+
+namespace spiffe {
+
+namespace {
+
+template <size_t N>
+Buffer der(const uint8_t (&data)[N]) {
+    return Buffer(data, data + N);
+}
+
+// 2027-01-15, within the validity of every test certificate but the expired leaf
+const X509Time NOW = X509Time(std::chrono::seconds(1800000000));
+
+X509BundleIndexSet example_org(const X509Bundle& bundle, const std::vector<Buffer>& crls = {}) {
+    X509BundleIndexSet bundles;
+    bundles.set("spiffe://example.org", bundle, nullptr);
+    bundles.set_crls(crls);
+    return bundles;
+}
+
+}  // namespace
+
+TEST(X509VerifierTest, VerifiesPathToBundle) {
+    X509BundleIndexSet bundles = example_org(X509Bundle{der(testdata::CA_DER)});
+    std::string spiffe_id;
+
+    EXPECT_TRUE(verify_x509_svid(X509CertificateChain{der(testdata::LEAF_DER)}, bundles, spiffe_id, NOW).is_ok());
+    EXPECT_EQ(spiffe_id, "spiffe://example.org/workload");
+
+    X509CertificateChain chained{der(testdata::CHAINED_LEAF_DER), der(testdata::INTERMEDIATE_DER)};
+    EXPECT_TRUE(verify_x509_svid(chained, bundles, spiffe_id, NOW).is_ok());
+    EXPECT_EQ(spiffe_id, "spiffe://example.org/chained");
+
+    // Without the intermediate, or against another trust domain
+    EXPECT_EQ(verify_x509_svid(X509CertificateChain{der(testdata::CHAINED_LEAF_DER)}, bundles, spiffe_id, NOW).code,
+              16);
+    X509BundleIndexSet other;
+    other.set("spiffe://other.org", X509Bundle{der(testdata::CA_DER)}, nullptr);
+    EXPECT_EQ(verify_x509_svid(X509CertificateChain{der(testdata::LEAF_DER)}, other, spiffe_id, NOW).code, 16);
+}
+
+TEST(X509VerifierTest, RejectsInvalidChains) {
+    X509BundleIndexSet bundles = example_org(X509Bundle{der(testdata::CA_DER)});
+    std::string spiffe_id = "unchanged";
+
+    auto code = [&](const X509CertificateChain& chain, X509Time now) {
+        return verify_x509_svid(chain, bundles, spiffe_id, now).code;
+    };
+
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::EXPIRED_LEAF_DER)}, NOW), 16);
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::LEAF_DER)}, X509Time(std::chrono::seconds(1600000000))), 16);
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::FORGED_LEAF_DER)}, NOW), 16);
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::CA_DER)}, NOW), 16);  // CA as leaf
+
+    // Last byte of the signature flipped
+    Buffer tampered = der(testdata::LEAF_DER);
+    tampered.back() ^= 1;
+    EXPECT_EQ(code(X509CertificateChain{tampered}, NOW), 16);
+
+    // Not a SPIFFE ID
+    Buffer http = testdata::patched(testdata::LEAF_DER, "spiffe://example.org/workload", "https://example.org/workload");
+    EXPECT_EQ(code(X509CertificateChain{http}, NOW), 16);
+
+    EXPECT_EQ(code(X509CertificateChain(), NOW), 3);
+    Buffer bad_san = testdata::patched(testdata::LEAF_DER, "\x86\x1dspiffe", "\x86\x7f");
+    EXPECT_EQ(code(X509CertificateChain{bad_san}, NOW), 3);
+
+    EXPECT_EQ(spiffe_id, "unchanged");
+}
+
+TEST(X509VerifierTest, EnforcesChainPolicy) {
+    X509BundleIndexSet bundles = example_org(X509Bundle{der(testdata::POLICY_CA_DER)});
+    std::string spiffe_id;
+
+    auto code = [&](const X509CertificateChain& chain) {
+        return verify_x509_svid(chain, bundles, spiffe_id, NOW).code;
+    };
+
+    // Key usage of the leaf and of its issuer
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::CERT_SIGN_LEAF_DER)}), 16);
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::SIGNING_INTERMEDIATE_LEAF_DER),
+                                        der(testdata::SIGNING_INTERMEDIATE_DER)}),
+              16);
+
+    // Path length constraint 0 with an intermediate below
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::NESTED_LEAF_DER), der(testdata::NESTED_INTERMEDIATE_DER),
+                                        der(testdata::PATHLEN_INTERMEDIATE_DER)}),
+              16);
+
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::CRITICAL_LEAF_DER)}), 16);
+
+    // Name constraints
+    EXPECT_TRUE(verify_x509_svid(X509CertificateChain{der(testdata::PERMITTED_LEAF_DER),
+                                                      der(testdata::PERMITTED_INTERMEDIATE_DER)},
+                                 bundles, spiffe_id, NOW)
+                    .is_ok());
+    EXPECT_EQ(spiffe_id, "spiffe://example.org/permitted");
+    EXPECT_EQ(code(X509CertificateChain{der(testdata::OTHER_ORG_LEAF_DER), der(testdata::OTHER_ORG_INTERMEDIATE_DER)}),
+              16);
+}
+
+TEST(X509VerifierTest, TriesEveryCandidateIssuer) {
+    std::string spiffe_id;
+
+    // Both CAs of a rotation in the bundle, under the same name
+    X509CertificateChain rotated{der(testdata::ROTATED_LEAF_DER)};
+    X509BundleIndexSet bundles =
+        example_org(X509Bundle{der(testdata::POLICY_CA_DER), der(testdata::ROTATED_POLICY_CA_DER)});
+    EXPECT_TRUE(verify_x509_svid(rotated, bundles, spiffe_id, NOW).is_ok());
+    EXPECT_EQ(spiffe_id, "spiffe://example.org/rotated");
+    X509BundleIndexSet old_only = example_org(X509Bundle{der(testdata::POLICY_CA_DER)});
+    EXPECT_EQ(verify_x509_svid(rotated, old_only, spiffe_id, NOW).code, 16);
+
+    // Both intermediates of a rotation in the chain, the one that signed the leaf last
+    X509CertificateChain chain{der(testdata::ROTATED_INTERMEDIATE_LEAF_DER),
+                               der(testdata::ROTATED_INTERMEDIATE_OLD_DER), der(testdata::ROTATED_INTERMEDIATE_DER)};
+    EXPECT_TRUE(verify_x509_svid(chain, bundles, spiffe_id, NOW).is_ok());
+    EXPECT_EQ(spiffe_id, "spiffe://example.org/rotated-intermediate");
+}
+
+TEST(X509VerifierTest, ChecksCrls) {
+    X509CertificateChain revoked{der(testdata::REVOKED_LEAF_DER)};
+    std::string spiffe_id;
+
+    X509BundleIndexSet without = example_org(X509Bundle{der(testdata::CA_DER)});
+    EXPECT_TRUE(verify_x509_svid(revoked, without, spiffe_id, NOW).is_ok());
+    EXPECT_EQ(without.crl_revision(), 0u);
+
+    X509BundleIndexSet with = example_org(X509Bundle{der(testdata::CA_DER)}, {der(testdata::CA_CRL_DER)});
+    EXPECT_EQ(verify_x509_svid(revoked, with, spiffe_id, NOW).code, 16);
+    EXPECT_TRUE(verify_x509_svid(X509CertificateChain{der(testdata::LEAF_DER)}, with, spiffe_id, NOW).is_ok());
+
+    // Unchanged CRLs and bundles keep their revision, malformed CRLs are skipped
+    X509BundleIndexSet same;
+    same.set("spiffe://example.org", X509Bundle{der(testdata::CA_DER)}, &with);
+    same.set_crls({der(testdata::CA_CRL_DER)}, &with);
+    EXPECT_EQ(same.crl_revision(), with.crl_revision());
+    X509BundleIndexSet changed;
+    changed.set("spiffe://example.org", X509Bundle{der(testdata::CA_DER)}, &with);
+    changed.set_crls({der(testdata::CA_CRL_DER), Buffer{0x30, 0x00}}, &with);
+    EXPECT_NE(changed.crl_revision(), with.crl_revision());
+    EXPECT_TRUE(changed.is_revoked(X509CertificateView(BufferView(revoked.front()))));
+}
+
+TEST(X509VerifierTest, IgnoresUnverifiedCrls) {
+    X509CertificateChain revoked{der(testdata::REVOKED_LEAF_DER)};
+    X509CertificateView revoked_view{BufferView(revoked.front())};
+    std::string spiffe_id;
+
+    // Last byte of the signature flipped, and a CRL of a CA that is in no bundle
+    Buffer tampered = der(testdata::CA_CRL_DER);
+    tampered.back() ^= 1;
+    X509BundleIndexSet forged = example_org(X509Bundle{der(testdata::CA_DER)}, {tampered});
+    EXPECT_FALSE(forged.is_revoked(revoked_view));
+    EXPECT_TRUE(forged.crls().empty());
+    EXPECT_TRUE(verify_x509_svid(revoked, forged, spiffe_id, NOW).is_ok());
+
+    X509BundleIndexSet unknown = example_org(X509Bundle{der(testdata::POLICY_CA_DER)}, {der(testdata::CA_CRL_DER)});
+    EXPECT_FALSE(unknown.is_revoked(revoked_view));
+
+    // The CRLs are checked again once the bundle of their CA is set
+    unknown.set("spiffe://example.org", X509Bundle{der(testdata::CA_DER)}, nullptr);
+    EXPECT_TRUE(unknown.is_revoked(revoked_view));
+    EXPECT_EQ(unknown.crls().size(), 1u);
+    EXPECT_EQ(verify_x509_svid(revoked, unknown, spiffe_id, NOW).code, 16);
+
+    // Same CRLs against other bundles are not reused
+    X509BundleIndexSet other;
+    other.set("spiffe://example.org", X509Bundle{der(testdata::POLICY_CA_DER)}, nullptr);
+    other.set_crls({der(testdata::CA_CRL_DER)}, &unknown);
+    EXPECT_FALSE(other.is_revoked(revoked_view));
+}
+
+TEST(X509VerifierTest, CachesVerifiedChains) {
+    X509SvidVerifier verifier(X509SvidVerifierOptions{.max_entries = 4, .shards = 1});
+    X509CertificateChain leaf{der(testdata::LEAF_DER)};
+    X509CertificateChain revoked{der(testdata::REVOKED_LEAF_DER)};
+    X509BundleIndexSet bundles = example_org(X509Bundle{der(testdata::CA_DER)});
+    std::string spiffe_id;
+
+    EXPECT_TRUE(verifier.verify(leaf, bundles, spiffe_id, NOW).is_ok());
+    EXPECT_TRUE(verifier.verify(leaf, bundles, spiffe_id, NOW).is_ok());
+    EXPECT_EQ(spiffe_id, "spiffe://example.org/workload");
+    EXPECT_TRUE(verifier.verify(revoked, bundles, spiffe_id, NOW).is_ok());
+    EXPECT_EQ(verifier.size(), 2u);
+
+    // Failures are not cached
+    EXPECT_EQ(verifier.verify(X509CertificateChain{der(testdata::FORGED_LEAF_DER)}, bundles, spiffe_id, NOW).code, 16);
+    EXPECT_EQ(verifier.size(), 2u);
+
+    // A rebuilt set with the same bundle keeps its index, and the cached results with it
+    std::unordered_map<TrustDomain, X509Bundle> same = {{"spiffe://example.org", X509Bundle{der(testdata::CA_DER)}}};
+    X509BundleIndexSet rebuilt(same, &bundles);
+    EXPECT_EQ(rebuilt.get("spiffe://example.org")->id(), bundles.get("spiffe://example.org")->id());
+
+    // New CRLs, a rotated bundle and the end of the validity period all invalidate
+    X509BundleIndexSet with_crl = example_org(X509Bundle{der(testdata::CA_DER)}, {der(testdata::CA_CRL_DER)});
+    with_crl.set("spiffe://example.org", X509Bundle{der(testdata::CA_DER)}, &bundles);
+    EXPECT_EQ(verifier.verify(revoked, with_crl, spiffe_id, NOW).code, 16);
+    EXPECT_TRUE(verifier.verify(leaf, with_crl, spiffe_id, NOW).is_ok());
+
+    X509BundleIndexSet rotated = example_org(X509Bundle{der(testdata::INTERMEDIATE_DER)});
+    EXPECT_EQ(verifier.verify(leaf, rotated, spiffe_id, NOW).code, 16);
+
+    X509Time expired = X509Time(std::chrono::seconds(3520191511));  // after 2081-07-19 22:58:30
+    EXPECT_EQ(verifier.verify(leaf, bundles, spiffe_id, expired).code, 16);
+    EXPECT_TRUE(verifier.verify(leaf, bundles, spiffe_id, NOW).is_ok());
+
+    // Bounded
+    for (const Buffer& other : {der(testdata::CHAINED_LEAF_DER), der(testdata::EXPIRED_LEAF_DER)}) {
+        X509CertificateChain chain{other, der(testdata::INTERMEDIATE_DER)};
+        verifier.verify(chain, bundles, spiffe_id, NOW);
+    }
+    EXPECT_LE(verifier.size(), 4u);
+}
+
+}  // namespace spiffe
@@ -17,7 +17,7 @@
 	If a future employer ever sees this, ~~no you didnt~~
 */
 
-#define FIELD(n, name, wire_type, read_op, write_op) case n: { if (is_deserialize) { decltype(name.m_value) proto_value; if (varint_key.m_wire_type != wire_type) return 0; read_op; name.set(proto_value); break; }	\
+#define FIELD(n, name, wire_type, read_op, write_op) case n: { if (is_deserialize) { decltype(name.m_value) proto_value; if (varint_key.m_wire_type != wire_type) return 0; read_op; name.set(std::move(proto_value)); break; }	\
 													 else { if (name.m_exists) { proto_write->write_key(proto_key(n, wire_type)); write_op; } } }
 
 #define FIELD_VARINT_ENCODED(n, name, zigzag) FIELD(n, name, VARINT, if (!proto_read.read_varint(proto_value, zigzag)) return 0;, proto_write->write_varint(name.get(), zigzag))
@@ -27,9 +27,9 @@
 #define FIELD_FIXED32(n, name) FIELD(n, name, FIXED32, if (!proto_read.read_fixed(proto_value)) return 0;, proto_write->write_fixed(name.get()))
 #define FIELD_FIXED64(n, name) FIELD(n, name, FIXED64, if (!proto_read.read_fixed(proto_value)) return 0;, proto_write->write_fixed(name.get()))
 #define FIELD_BUFFER(n, name) FIELD(n, name, LENGTH_DELIMITED, if (!proto_read.read_buffer(proto_value)) return 0;, proto_write->write_buffer(name.get()))
-#define FIELD_MESSAGE(n, name) FIELD(n, name, LENGTH_DELIMITED, std::string proto_message_buf; if (!proto_read.read_buffer(proto_message_buf) || !proto_value.deserialize((uint8_t*)proto_message_buf.data(), proto_message_buf.length())) return 0;, proto_writer* proto_message_writer = name.get().serialize(); proto_write->write_buffer((void*)proto_message_writer->m_buf, proto_message_writer->m_pos); delete proto_message_writer;)
+#define FIELD_MESSAGE(n, name) FIELD(n, name, LENGTH_DELIMITED, proto_view proto_message_buf; if (!proto_read.read_buffer(proto_message_buf) || !proto_value.deserialize(proto_message_buf.m_data, proto_message_buf.m_size)) return 0;, proto_write->write_message(name.get());)
 
-#define REPEATED_FIELD(n, name, wire_type, read_op, write_op) case n: { if (is_deserialize) { std::remove_reference<decltype(name.m_value.front())>::type proto_value; if (varint_key.m_wire_type != wire_type) return 0; read_op; name.m_exists = true; name.m_value.push_back(proto_value); break; }	\
+#define REPEATED_FIELD(n, name, wire_type, read_op, write_op) case n: { if (is_deserialize) { std::remove_reference<decltype(name.m_value.front())>::type proto_value; if (varint_key.m_wire_type != wire_type) return 0; if (name.m_value.empty()) name.m_value.reserve(proto_read.count_occurrences(varint_key)); read_op; name.m_exists = true; name.m_value.push_back(std::move(proto_value)); break; }	\
 													 else { if (name.m_exists) { for (auto& proto_iter : name.get()) { proto_write->write_key(proto_key(n, wire_type)); write_op; } } } }
 
 #define REPEATED_FIELD_VARINT_ENCODED(n, name, zigzag) REPEATED_FIELD(n, name, VARINT, if (!proto_read.read_varint(proto_value, zigzag)) return 0;, proto_write->write_varint(proto_iter, zigzag))
@@ -38,10 +38,10 @@
 #define REPEATED_FIELD_FIXED32(n, name) REPEATED_FIELD(n, name, FIXED32, if (!proto_read.read_fixed(proto_value)) return 0;, proto_write->write_fixed(proto_iter))
 #define REPEATED_FIELD_FIXED64(n, name) REPEATED_FIELD(n, name, FIXED64, if (!proto_read.read_fixed(proto_value)) return 0;, proto_write->write_fixed(proto_iter))
 #define REPEATED_FIELD_BUFFER(n, name) REPEATED_FIELD(n, name, LENGTH_DELIMITED, if (!proto_read.read_buffer(proto_value)) return 0;, proto_write->write_buffer(proto_iter))
-#define REPEATED_FIELD_MESSAGE(n, name) REPEATED_FIELD(n, name, LENGTH_DELIMITED, std::string proto_message_buf; if (!proto_read.read_buffer(proto_message_buf) || !proto_value.deserialize((uint8_t*)proto_message_buf.data(), proto_message_buf.length())) return 0;, proto_writer* proto_message_writer = proto_iter.serialize(); proto_write->write_buffer((void*)proto_message_writer->m_buf, proto_message_writer->m_pos); delete proto_message_writer;)
+#define REPEATED_FIELD_MESSAGE(n, name) REPEATED_FIELD(n, name, LENGTH_DELIMITED, proto_view proto_message_buf; if (!proto_read.read_buffer(proto_message_buf) || !proto_value.deserialize(proto_message_buf.m_data, proto_message_buf.m_size)) return 0;, proto_write->write_message(proto_iter);)
 
 #define PACKED_FIELD(n, name, wire_type, read_op, write_op) case n: { if (is_deserialize) { std::remove_reference<decltype(name.m_value.front())>::type proto_value; size_t proto_packed_size; if (varint_key.m_wire_type != LENGTH_DELIMITED || !proto_read.read_varint(proto_packed_size)) return 0; size_t proto_packed_end = proto_read.m_pos + proto_packed_size; while (proto_read.m_pos < proto_packed_end) { read_op; name.m_exists = true; name.m_value.push_back(proto_value); } break; }	\
-													 else { if (name.m_exists) { std::string proto_packed_buf; proto_writer* proto_write_packed = new proto_writer(); for (auto& proto_iter : name.get()) { write_op; } proto_write->write_key(proto_key(n, LENGTH_DELIMITED)); proto_write->write_buffer((void*)proto_write_packed->m_buf, proto_write_packed->m_pos); delete proto_write_packed; } } }
+													 else { if (name.m_exists) { proto_writer proto_packed_size = proto_writer::measure(); proto_writer* proto_write_packed = &proto_packed_size; for (auto& proto_iter : name.get()) { write_op; } proto_write->write_key(proto_key(n, LENGTH_DELIMITED)); proto_write->write_varint(proto_packed_size.m_pos); proto_write_packed = proto_write; for (auto& proto_iter : name.get()) { write_op; } } } }
 
 #define PACKED_FIELD_VARINT_ENCODED(n, name, zigzag) PACKED_FIELD(n, name, VARINT, if (!proto_read.read_varint(proto_value, zigzag)) return 0;, proto_write_packed->write_varint(proto_iter, zigzag))
 #define PACKED_FIELD_VARINT(n, name) PACKED_FIELD_VARINT_ENCODED(n, name, false)
@@ -49,7 +49,7 @@
 #define PACKED_FIELD_FIXED32(n, name) PACKED_FIELD(n, name, FIXED32, if (!proto_read.read_fixed(proto_value)) return 0;, proto_write_packed->write_fixed(proto_iter))
 #define PACKED_FIELD_FIXED64(n, name) PACKED_FIELD(n, name, FIXED64, if (!proto_read.read_fixed(proto_value)) return 0;, proto_write_packed->write_fixed(proto_iter))
 
-#define DESERIALIZE(args)   bool deserialize(uint8_t* buf, size_t size) {                                       \
+#define DESERIALIZE(args)   bool deserialize(const uint8_t* buf, size_t size) {                                 \
                                 proto_reader proto_read = proto_reader(buf, size);                              \
 								proto_writer* proto_write = nullptr;											\
 								bool is_deserialize = true;														\
@@ -57,14 +57,20 @@
                                     proto_key varint_key; if(!proto_read.read_key(varint_key)) return false;    \
                                     switch (varint_key.m_field_number) {                                        \
                                         args                                                                    \
-                                        default: { return false; }                                              \
+                                        default: { if (varint_key.m_field_number == 0 ||                        \
+                                                       !proto_read.skip_field(varint_key.m_wire_type))          \
+                                                       return false; }                                          \
                                     }                                                                           \
                                 }                                                                               \
                                 return true;                                                                    \
                             }
 
-#define SERIALIZE(args)		proto_writer* serialize() {															\
-								proto_writer* proto_write = new proto_writer(true);								\
+/*
+	serialize_to() writes the message into any proto_writer, serialized_size() runs it against a
+	measuring writer first so callers can allocate the exact size once. Nested messages are written
+	in place, after their measured length.
+*/
+#define SERIALIZE(args)		bool serialize_to(proto_writer* proto_write) {										\
 								proto_reader proto_read = proto_reader();										\
 								bool is_deserialize = false;													\
 								proto_key varint_key; /* not actually used here but we need it declared... */	\
@@ -72,6 +78,16 @@
 								case -1:																		\
 									args																		\
 								}																				\
+								return true; /* the read ops return 0, never reached here */					\
+							}																					\
+							size_t serialized_size() {															\
+								proto_writer proto_size = proto_writer::measure();								\
+								serialize_to(&proto_size);														\
+								return proto_size.m_pos;														\
+							}																					\
+							proto_writer* serialize() {															\
+								proto_writer* proto_write = new proto_writer(serialized_size());				\
+								serialize_to(proto_write);														\
 								return proto_write;																\
 							}
 
@@ -91,12 +107,37 @@ template <typename t>
 struct optional_field {
 	optional_field(bool e = false) : m_exists(e) {}
 	t& get() { return m_value; }
-	void set(t val) { m_value = val; m_exists = true; }
+	const t& get() const { return m_value; }
+	void set(const t& val) { m_value = val; m_exists = true; }
+	void set(t&& val) { m_value = std::move(val); m_exists = true; }
 
 	bool m_exists = false;
 	t m_value;
 };
 
+/*
+	Non-owning view of a length-delimited field, pointing into the buffer passed to deserialize().
+	Declaring a bytes/string field as proto_view instead of std::string decodes it without copying,
+	the caller must keep the input buffer alive while the message is in use.
+*/
+struct proto_view {
+	proto_view() : m_data(nullptr), m_size(0) {}
+	proto_view(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+	proto_view(const std::string& str) : m_data((const uint8_t*)str.data()), m_size(str.size()) {}
+
+	const uint8_t* begin() const { return m_data; }
+	const uint8_t* end() const { return m_data + m_size; }
+	const uint8_t* data() const { return m_data; }
+	size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	// materialize an owned copy
+	std::string str() const { return std::string((const char*)m_data, m_size); }
+
+	const uint8_t* m_data;
+	size_t m_size;
+};
+
 enum wire_types {
 	VARINT,
 	FIXED64,
@@ -111,11 +152,19 @@ static void print_ascii(uint8_t* data, uint16_t size, int num_indents);
 class proto_reader {
 public:
 	proto_reader() : m_buf(nullptr), m_size(0), m_pos(0) {}
-	proto_reader(uint8_t* buf, size_t size) : m_buf(buf), m_size(size), m_pos(0) { }
+	proto_reader(const uint8_t* buf, size_t size) : m_buf(buf), m_size(size), m_pos(0) { }
 
 	bool read_key(proto_key& key) {
+		// keys of fields 1 to 15 are a single byte
+		if (m_pos < m_size && m_buf[m_pos] < 0x80) {
+			uint8_t c = m_buf[m_pos++];
+			key.m_wire_type = c & 0x7;
+			key.m_field_number = c >> 3;
+			return true;
+		}
+
 		uint64_t value;
-		if (!read_varint(value))
+		if (!read_varint64(value))
 			return false;
 
 		key.m_wire_type = value & 0x7;
@@ -125,23 +174,9 @@ public:
 
 	template <typename t>
 	bool read_varint(t& val, bool zigzag = false) {
-		uint64_t value = 0;
-		size_t offset = 0;
-
-		while (true) {
-			if (m_pos >= m_size) {
-				return false;
-			}
-
-			unsigned char c;
-			c = m_buf[m_pos++];
-			// transfer 7 bits per byte
-			value |= uint64_t(c & 0x7f) << offset;
-			// check terminator
-			if ((c & 0x80) == 0)
-				break;
-			offset += 7;
-		}
+		uint64_t value;
+		if (!read_varint64(value))
+			return false;
 
 		// decode ZigZag encoding
 		if (zigzag) {
@@ -152,19 +187,100 @@ public:
 		return true;
 	}
 
+	bool read_varint64(uint64_t& value) {
+		const uint8_t* p = m_buf + m_pos;
+		size_t available = m_size - m_pos;
+
+		// 1 and 2 byte varints (keys, lengths below 16 KiB) are by far the most common
+		if (available >= 1 && p[0] < 0x80) {
+			value = p[0];
+			m_pos += 1;
+			return true;
+		}
+		if (available >= 2 && p[1] < 0x80) {
+			value = uint64_t(p[0] & 0x7f) | (uint64_t(p[1]) << 7);
+			m_pos += 2;
+			return true;
+		}
+
+		// transfer 7 bits per byte, a 64-bit varint takes at most 10 bytes
+		size_t limit = available < 10 ? available : 10;
+		value = 0;
+		for (size_t i = 0; i < limit; ++i) {
+			uint64_t c = p[i];
+			value |= (c & 0x7f) << (7 * i);
+			// check terminator
+			if (c < 0x80) {
+				m_pos += i + 1;
+				return true;
+			}
+		}
+		return false;
+	}
+
 	template <typename t>
 	bool read_fixed(t& val) {
-		if (m_pos + sizeof(t) > m_size)
+		if (sizeof(t) > m_size - m_pos)
 			return false;
 
-		val = *(t*)(m_buf + m_pos);
+		memcpy(&val, m_buf + m_pos, sizeof(t));
 		m_pos += sizeof(t);
 		return true;
 	}
 
+	// skips the value of a field the message does not declare, e.g. one added by a newer peer
+	bool skip_field(uint8_t wire_type) {
+		switch (wire_type) {
+		case VARINT:
+		{
+			uint64_t value;
+			return read_varint64(value);
+		}
+		case FIXED64:
+			return skip(8);
+		case LENGTH_DELIMITED:
+		{
+			uint64_t length;
+			return read_varint64(length) && skip(length);
+		}
+		case FIXED32:
+			return skip(4);
+		default:
+			// groups are deprecated and not supported
+			return false;
+		}
+	}
+
+	// number of times the field of key occurs among the next limit fields, starting with its value
+	// at the current position, so a repeated field can reserve its storage up front. The scan is
+	// bounded to stay cheap on large messages, whose fields are far apart.
+	size_t count_occurrences(const proto_key& key, size_t limit = 16) const {
+		proto_reader scan = *this;
+		size_t count = 1;
+		if (!scan.skip_field(key.m_wire_type))
+			return count;
+
+		proto_key next;
+		for (size_t i = 1; i < limit && !scan.finished(); ++i) {
+			if (!scan.read_key(next) || !scan.skip_field(next.m_wire_type))
+				break;
+			if (next.m_field_number == key.m_field_number)
+				++count;
+		}
+		return count;
+	}
+
+	bool skip(uint64_t size) {
+		if (size > m_size - m_pos)
+			return false;
+
+		m_pos += size;
+		return true;
+	}
+
 	bool read_buffer(std::string& val) {
 		uint64_t length; // read the length of the buffer first
-		if (!read_varint(length) || m_pos + length > m_size)
+		if (!read_varint(length) || length > m_size - m_pos)
 			return false;
 
 		val = std::string((const char*)(m_buf + m_pos), length);
@@ -172,7 +288,17 @@ public:
 		return true;
 	}
 
-	bool finished() {
+	bool read_buffer(proto_view& val) {
+		uint64_t length;
+		if (!read_varint(length) || length > m_size - m_pos)
+			return false;
+
+		val = proto_view(m_buf + m_pos, length);
+		m_pos += length;
+		return true;
+	}
+
+	bool finished() const {
 		return m_pos == m_size;
 	}
 
@@ -236,91 +362,146 @@ public:
 	size_t m_pos;
 private:
 
-	uint8_t* m_buf;
+	const uint8_t* m_buf;
 	size_t m_size;
 };
 
 class proto_writer {
 public:
-	proto_writer(bool alloc = true) : m_buf(nullptr), m_buf_size(0), m_pos(0) {
-		if (alloc) {
-			m_buf = new uint8_t[0x1000];
-			m_buf_size = 0x1000;
-			m_pos = 0;
+	// owned buffer, growing as needed
+	proto_writer(bool alloc = true) : proto_writer(alloc ? size_t(0x1000) : size_t(0)) {}
+
+	explicit proto_writer(size_t initial_size) : m_buf(nullptr), m_pos(0), m_buf_size(0), m_owned(true), m_measuring(false) {
+		if (initial_size) {
+			m_buf = new uint8_t[initial_size];
+			m_buf_size = initial_size;
 		}
 	}
 
+	// writes into size bytes at buf, owned by the caller and sized with serialized_size()
+	proto_writer(uint8_t* buf, size_t size) : m_buf(buf), m_pos(0), m_buf_size(size), m_owned(false), m_measuring(false) {}
+
+	// only counts the bytes that would be written, in m_pos
+	static proto_writer measure() {
+		proto_writer writer(size_t(0));
+		writer.m_measuring = true;
+		return writer;
+	}
+
+	proto_writer(const proto_writer&) = delete;
+	proto_writer& operator=(const proto_writer&) = delete;
+
+	proto_writer(proto_writer&& other) : m_buf(other.m_buf), m_pos(other.m_pos), m_buf_size(other.m_buf_size), m_owned(other.m_owned), m_measuring(other.m_measuring) {
+		other.m_buf = nullptr;
+		other.m_buf_size = 0;
+	}
+
 	~proto_writer() {
-		delete[] m_buf;
+		if (m_owned)
+			delete[] m_buf;
 	}
 
-	void expand_buffer() {
-		auto tmp = new uint8_t[m_buf_size + 0x1000];
+	// makes room for size more bytes, doubling an owned buffer so appends stay linear overall
+	bool reserve(size_t size) {
+		if (m_pos + size <= m_buf_size)
+			return true;
+		if (!m_owned)
+			return false;
+
+		size_t new_size = m_buf_size ? m_buf_size * 2 : 0x1000;
+		while (new_size < m_pos + size)
+			new_size *= 2;
 
+		auto tmp = new uint8_t[new_size];
 		if (m_buf) {
 			memcpy(tmp, m_buf, m_pos);
 			delete[] m_buf;
 		}
 
-		m_buf_size += 0x1000;
+		m_buf_size = new_size;
 		m_buf = tmp;
+		return true;
 	}
 
 	void write_key(proto_key key) {
 		write_varint((key.m_field_number << 3) | key.m_wire_type);
 	}
 
+	static size_t varint_size(uint64_t val) {
+		size_t size = 1;
+		while (val >= 0x80) {
+			val >>= 7;
+			++size;
+		}
+		return size;
+	}
+
 	void write_varint(uint64_t val, bool zigzag = false) {
 		if (zigzag) {
 			val = (val << 1) ^ ((int64_t)val >> 63);
 		}
 
-		while (true) {
-			if (m_pos >= m_buf_size)
-				expand_buffer();
+		size_t size = varint_size(val);
+		if (m_measuring || !reserve(size)) {
+			m_pos += size;
+			return;
+		}
 
-			unsigned char c = val & 0x7f;
+		while (val >= 0x80) {
+			m_buf[m_pos++] = (unsigned char)(val | 0x80);
 			val >>= 7;
-			if (val) {
-				c |= 0x80;
-				m_buf[m_pos++] = c;
-			}
-			else {
-				// no more bits left
-				m_buf[m_pos++] = c;
-				break;
-			}
 		}
+		// no more bits left
+		m_buf[m_pos++] = (unsigned char)val;
 	}
 
 	template <typename t>
 	void write_fixed(t val) {
-		if (m_pos + sizeof(t) > m_buf_size)
-			expand_buffer(); // no need for a while loop here, fixed values can only be 32 or 64 bits anyways.
-
-		*(t*)(m_buf + m_pos) = val;
+		if (!m_measuring && reserve(sizeof(t)))
+			memcpy(m_buf + m_pos, &val, sizeof(t));
 		m_pos += sizeof(t);
 	}
 
-	void write_buffer(std::string val) {
-		write_buffer((void*)val.data(), val.length());
+	void write_buffer(const std::string& val) {
+		write_buffer(val.data(), val.length());
 	}
 
-	void write_buffer(void* buf, size_t size) {
-		write_varint(size);
+	void write_buffer(const proto_view& val) {
+		write_buffer(val.m_data, val.m_size);
+	}
 
-		// can be arbitrary size, we need to loop until our buffer is big enough.
-		while (m_pos + size > m_buf_size)
-			expand_buffer();
+	void write_buffer(const void* buf, size_t size) {
+		write_varint(size);
 
-		memcpy((void*)(m_buf + m_pos), buf, size);
+		if (!m_measuring && size && reserve(size))
+			memcpy((void*)(m_buf + m_pos), buf, size);
 		m_pos += size;
 	}
 
+	// nested message, length first, then the message in place
+	template <typename message>
+	void write_message(message& msg) {
+		size_t size = msg.serialized_size();
+		write_varint(size);
+
+		if (m_measuring) {
+			m_pos += size;
+		} else {
+			msg.serialize_to(this);
+		}
+	}
+
+	// a write past the end of a caller's buffer only advances m_pos, see overflowed()
+	bool overflowed() const {
+		return m_pos > m_buf_size && !m_measuring;
+	}
+
 	uint8_t* m_buf;
 	size_t m_pos;
 private:
 	size_t m_buf_size;
+	bool m_owned;
+	bool m_measuring;
 };
 
 /* PRINT-RELATED FUNCTIONS */